@@ -35,6 +35,7 @@
 #include "core/input/input_map.h"
 #include "core/io/dir_access.h"
 #include "core/io/file_access.h"
+#include "core/io/file_access_compressed.h"
 #include "core/io/file_access_network.h"
 #include "core/io/file_access_pack.h"
 #include "core/io/marshalls.h"
@@ -600,6 +601,10 @@ Error ProjectSettings::setup(const String &p_path, const String &p_main_pack, bo
 
 	Compression::zlib_level = GLOBAL_GET("compression/formats/zlib/compression_level");
 
+	// Also guards against dividing by zero, the setting can be overridden with anything.
+	FileAccessCompressed::default_block_size = MAX(int(GLOBAL_GET("compression/files/block_size")), int(FileAccessCompressed::MIN_BLOCK_SIZE));
+	FileAccessCompressed::read_ahead_size = GLOBAL_GET("compression/files/read_ahead_size");
+
 	Compression::gzip_level = GLOBAL_GET("compression/formats/gzip/compression_level");
 
 	return err;
@@ -1218,6 +1223,11 @@ ProjectSettings::ProjectSettings() {
 
 	GLOBAL_DEF("compression/formats/gzip/compression_level", Compression::gzip_level);
 	custom_prop_info["compression/formats/gzip/compression_level"] = PropertyInfo(Variant::INT, "compression/formats/gzip/compression_level", PROPERTY_HINT_RANGE, "-1,9,1");
+
+	GLOBAL_DEF("compression/files/block_size", FileAccessCompressed::default_block_size);
+	custom_prop_info["compression/files/block_size"] = PropertyInfo(Variant::INT, "compression/files/block_size", PROPERTY_HINT_RANGE, "4096,4194304,4096");
+	GLOBAL_DEF("compression/files/read_ahead_size", FileAccessCompressed::read_ahead_size);
+	custom_prop_info["compression/files/read_ahead_size"] = PropertyInfo(Variant::INT, "compression/files/read_ahead_size", PROPERTY_HINT_RANGE, "0,16777216,4096");
 }
 
 ProjectSettings::~ProjectSettings() {
@@ -72,6 +72,14 @@ Ref<Resource> ResourceLoader::load(const String &p_path, const String &p_type_hi
 	return ret;
 }
 
+Ref<Resource> ResourceLoader::load_sub_resource(const String &p_path, const String &p_id, CacheMode p_cache_mode) {
+	Error err = OK;
+	Ref<Resource> ret = ::ResourceLoader::load_sub_resource(p_path, p_id, ResourceFormatLoader::CacheMode(p_cache_mode), &err);
+
+	ERR_FAIL_COND_V_MSG(err != OK, ret, "Error loading sub-resource '" + p_id + "' from: '" + p_path + "'.");
+	return ret;
+}
+
 Vector<String> ResourceLoader::get_recognized_extensions_for_type(const String &p_type) {
 	List<String> exts;
 	::ResourceLoader::get_recognized_extensions_for_type(p_type, &exts);
@@ -118,6 +126,7 @@ void ResourceLoader::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("load_threaded_get", "path"), &ResourceLoader::load_threaded_get);
 
 	ClassDB::bind_method(D_METHOD("load", "path", "type_hint", "cache_mode"), &ResourceLoader::load, DEFVAL(""), DEFVAL(CACHE_MODE_REUSE));
+	ClassDB::bind_method(D_METHOD("load_sub_resource", "path", "id", "cache_mode"), &ResourceLoader::load_sub_resource, DEFVAL(CACHE_MODE_REUSE));
 	ClassDB::bind_method(D_METHOD("get_recognized_extensions_for_type", "type"), &ResourceLoader::get_recognized_extensions_for_type);
 	ClassDB::bind_method(D_METHOD("set_abort_on_missing_resources", "abort"), &ResourceLoader::set_abort_on_missing_resources);
 	ClassDB::bind_method(D_METHOD("get_dependencies", "path"), &ResourceLoader::get_dependencies);
@@ -180,6 +180,75 @@ int Compression::decompress(uint8_t *p_dst, int p_dst_max_size, const uint8_t *p
 	ERR_FAIL_V(-1);
 }
 
+int Compression::compress(uint8_t *p_dst, const uint8_t *p_src, int p_src_size, Mode p_mode, const Vector<uint8_t> &p_dictionary) {
+	if (p_dictionary.is_empty()) {
+		return compress(p_dst, p_src, p_src_size, p_mode);
+	}
+	ERR_FAIL_COND_V_MSG(p_mode != MODE_ZSTD, -1, "Compression dictionaries are only supported by Zstandard.");
+
+	ZSTD_CDict *cdict = create_zstd_compression_dictionary(p_dictionary);
+	ERR_FAIL_COND_V(!cdict, -1);
+	int ret = compress_zstd(p_dst, p_src, p_src_size, cdict);
+	free_zstd_dictionary(cdict);
+	return ret;
+}
+
+int Compression::decompress(uint8_t *p_dst, int p_dst_max_size, const uint8_t *p_src, int p_src_size, Mode p_mode, const Vector<uint8_t> &p_dictionary) {
+	if (p_dictionary.is_empty()) {
+		return decompress(p_dst, p_dst_max_size, p_src, p_src_size, p_mode);
+	}
+	ERR_FAIL_COND_V_MSG(p_mode != MODE_ZSTD, -1, "Compression dictionaries are only supported by Zstandard.");
+
+	ZSTD_DDict *ddict = create_zstd_decompression_dictionary(p_dictionary);
+	ERR_FAIL_COND_V(!ddict, -1);
+	int ret = decompress_zstd(p_dst, p_dst_max_size, p_src, p_src_size, ddict);
+	free_zstd_dictionary(ddict);
+	return ret;
+}
+
+ZSTD_CDict *Compression::create_zstd_compression_dictionary(const Vector<uint8_t> &p_dictionary) {
+	ERR_FAIL_COND_V(p_dictionary.is_empty(), nullptr);
+	return ZSTD_createCDict(p_dictionary.ptr(), p_dictionary.size(), zstd_level);
+}
+
+ZSTD_DDict *Compression::create_zstd_decompression_dictionary(const Vector<uint8_t> &p_dictionary) {
+	ERR_FAIL_COND_V(p_dictionary.is_empty(), nullptr);
+	return ZSTD_createDDict(p_dictionary.ptr(), p_dictionary.size());
+}
+
+void Compression::free_zstd_dictionary(ZSTD_CDict *p_dictionary) {
+	ZSTD_freeCDict(p_dictionary);
+}
+
+void Compression::free_zstd_dictionary(ZSTD_DDict *p_dictionary) {
+	ZSTD_freeDDict(p_dictionary);
+}
+
+int Compression::compress_zstd(uint8_t *p_dst, const uint8_t *p_src, int p_src_size, const ZSTD_CDict *p_dictionary) {
+	ZSTD_CCtx *cctx = ZSTD_createCCtx();
+	// The compression level was set when digesting the dictionary.
+	ZSTD_CCtx_refCDict(cctx, p_dictionary);
+	if (zstd_long_distance_matching) {
+		ZSTD_CCtx_setParameter(cctx, ZSTD_c_enableLongDistanceMatching, 1);
+		ZSTD_CCtx_setParameter(cctx, ZSTD_c_windowLog, zstd_window_log_size);
+	}
+	int max_dst_size = get_max_compressed_buffer_size(p_src_size, MODE_ZSTD);
+	size_t ret = ZSTD_compress2(cctx, p_dst, max_dst_size, p_src, p_src_size);
+	ZSTD_freeCCtx(cctx);
+	return ZSTD_isError(ret) ? -1 : int(ret);
+}
+
+int Compression::decompress_zstd(uint8_t *p_dst, int p_dst_max_size, const uint8_t *p_src, int p_src_size, const ZSTD_DDict *p_dictionary) {
+	ZSTD_DCtx *dctx = ZSTD_createDCtx();
+	if (zstd_long_distance_matching) {
+		ZSTD_DCtx_setParameter(dctx, ZSTD_d_windowLogMax, zstd_window_log_size);
+	}
+	ZSTD_DCtx_refDDict(dctx, p_dictionary);
+	size_t ret = ZSTD_decompressDCtx(dctx, p_dst, p_dst_max_size, p_src, p_src_size);
+	ZSTD_freeDCtx(dctx);
+	return ZSTD_isError(ret) ? -1 : int(ret);
+}
+
 /**
 	This will handle both Gzip and Deflate streams. It will automatically allocate the output buffer into the provided p_dst_vect Vector.
 	This is required for compressed data whose final uncompressed size is unknown, as is the case for HTTP response bodies.
@@ -34,6 +34,9 @@
 #include "core/templates/vector.h"
 #include "core/typedefs.h"
 
+struct ZSTD_CDict_s;
+struct ZSTD_DDict_s;
+
 class Compression {
 public:
 	static int zlib_level;
@@ -53,6 +56,16 @@ public:
 	static int compress(uint8_t *p_dst, const uint8_t *p_src, int p_src_size, Mode p_mode = MODE_ZSTD);
 	static int get_max_compressed_buffer_size(int p_src_size, Mode p_mode = MODE_ZSTD);
 	static int decompress(uint8_t *p_dst, int p_dst_max_size, const uint8_t *p_src, int p_src_size, Mode p_mode = MODE_ZSTD);
+	// Zstandard only, the data must be decompressed with the same dictionary it was compressed with.
+	static int compress(uint8_t *p_dst, const uint8_t *p_src, int p_src_size, Mode p_mode, const Vector<uint8_t> &p_dictionary);
+	static int decompress(uint8_t *p_dst, int p_dst_max_size, const uint8_t *p_src, int p_src_size, Mode p_mode, const Vector<uint8_t> &p_dictionary);
+	// Digested Zstandard dictionaries, to compress or decompress many blocks without loading the dictionary again.
+	static ZSTD_CDict_s *create_zstd_compression_dictionary(const Vector<uint8_t> &p_dictionary);
+	static ZSTD_DDict_s *create_zstd_decompression_dictionary(const Vector<uint8_t> &p_dictionary);
+	static void free_zstd_dictionary(ZSTD_CDict_s *p_dictionary);
+	static void free_zstd_dictionary(ZSTD_DDict_s *p_dictionary);
+	static int compress_zstd(uint8_t *p_dst, const uint8_t *p_src, int p_src_size, const ZSTD_CDict_s *p_dictionary);
+	static int decompress_zstd(uint8_t *p_dst, int p_dst_max_size, const uint8_t *p_src, int p_src_size, const ZSTD_DDict_s *p_dictionary);
 	static int decompress_dynamic(Vector<uint8_t> *p_dst_vect, int p_max_dst_size, const uint8_t *p_src, int p_src_size, Mode p_mode);
 };
 
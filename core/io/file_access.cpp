@@ -377,6 +377,22 @@ uint64_t FileAccess::get_buffer(uint8_t *p_dst, uint64_t p_length) const {
 	return i;
 }
 
+const uint8_t *FileAccess::borrow_buffer(uint64_t p_length, Ref<FileMapping> &r_mapping) {
+	Ref<FileMapping> mapping = get_mapping();
+	if (mapping.is_null()) {
+		return nullptr;
+	}
+
+	uint64_t pos = get_position();
+	if (pos + p_length > mapping->get_size()) {
+		return nullptr;
+	}
+
+	seek(pos + p_length);
+	r_mapping = mapping;
+	return mapping->ptr() + pos;
+}
+
 String FileAccess::get_as_utf8_string() const {
 	Vector<uint8_t> sourcef;
 	uint64_t len = get_length();
@@ -37,6 +37,21 @@
 #include "core/string/ustring.h"
 #include "core/typedefs.h"
 
+/**
+ * Read-only view of a file's contents in memory, as returned by FileAccess::get_mapping().
+ * The memory stays valid for as long as the mapping is referenced, even after the file is closed.
+ */
+
+class FileMapping : public RefCounted {
+protected:
+	const uint8_t *data = nullptr;
+	uint64_t size = 0;
+
+public:
+	_FORCE_INLINE_ const uint8_t *ptr() const { return data; }
+	_FORCE_INLINE_ uint64_t get_size() const { return size; }
+};
+
 /**
  * Multi-Platform abstraction for accessing to files.
  */
@@ -110,6 +125,8 @@ public:
 	virtual real_t get_real() const;
 
 	virtual uint64_t get_buffer(uint8_t *p_dst, uint64_t p_length) const; ///< get an array of bytes
+	virtual Ref<FileMapping> get_mapping() { return Ref<FileMapping>(); } ///< map the whole file for reading, returns null if not supported
+	virtual const uint8_t *borrow_buffer(uint64_t p_length, Ref<FileMapping> &r_mapping); ///< get the next bytes without copying them, returns null if not possible (use get_buffer then), r_mapping keeps them valid
 	virtual String get_line() const;
 	virtual String get_token() const;
 	virtual Vector<String> get_csv_line(const String &p_delim = ",") const;
@@ -30,6 +30,7 @@
 
 #include "file_access_compressed.h"
 
+#include "core/io/marshalls.h"
 #include "core/string/print_string.h"
 
 void FileAccessCompressed::configure(const String &p_magic, Compression::Mode p_mode, uint32_t p_block_size) {
@@ -43,7 +44,23 @@ void FileAccessCompressed::configure(const String &p_magic, Compression::Mode p_
 	}
 
 	cmode = p_mode;
-	block_size = p_block_size;
+	block_size = MAX(p_block_size > 0 ? p_block_size : default_block_size, MIN_BLOCK_SIZE);
+}
+
+void FileAccessCompressed::set_dictionary(const Vector<uint8_t> &p_dictionary) {
+	_free_dictionaries();
+	dictionary = p_dictionary;
+}
+
+void FileAccessCompressed::_free_dictionaries() {
+	if (zstd_cdict) {
+		Compression::free_zstd_dictionary(zstd_cdict);
+		zstd_cdict = nullptr;
+	}
+	if (zstd_ddict) {
+		Compression::free_zstd_dictionary(zstd_ddict);
+		zstd_ddict = nullptr;
+	}
 }
 
 #define WRITE_FIT(m_bytes)                                  \
@@ -66,6 +83,17 @@ Error FileAccessCompressed::open_after_magic(Ref<FileAccess> p_base) {
 		f.unref();
 		ERR_FAIL_V_MSG(ERR_FILE_CORRUPT, "Can't open compressed file '" + p_base->get_path() + "' with block size 0, it is corrupted.");
 	}
+	if (!dictionary.is_empty() && zstd_ddict == nullptr) {
+		if (cmode != Compression::MODE_ZSTD) {
+			f.unref();
+			ERR_FAIL_V_MSG(ERR_FILE_CORRUPT, "Can't open compressed file '" + p_base->get_path() + "' with a dictionary, only Zstandard files use one.");
+		}
+		zstd_ddict = Compression::create_zstd_decompression_dictionary(dictionary);
+		if (zstd_ddict == nullptr) {
+			f.unref();
+			ERR_FAIL_V_MSG(ERR_INVALID_DATA, "Can't digest the dictionary to open compressed file '" + p_base->get_path() + "'.");
+		}
+	}
 	read_total = f->get_32();
 	uint32_t bc = (read_total / block_size) + 1;
 	uint64_t acc_ofs = f->get_position() + bc * 4;
@@ -82,17 +110,115 @@ Error FileAccessCompressed::open_after_magic(Ref<FileAccess> p_base) {
 	comp_buffer.resize(max_bs);
 	buffer.resize(block_size);
 	read_ptr = buffer.ptrw();
-	f->get_buffer(comp_buffer.ptrw(), read_blocks[0].csize);
 	at_end = false;
 	read_eof = false;
 	read_block_count = bc;
-	read_block_size = read_blocks.size() == 1 ? read_total : block_size;
 
-	int ret = Compression::decompress(buffer.ptrw(), read_block_size, comp_buffer.ptr(), read_blocks[0].csize, cmode);
+	read_ahead_blocks = 0;
+	if (bc > 1 && read_ahead_size > 0 && WorkerThreadPool::get_singleton()) {
+		read_ahead_blocks = MAX(2u, read_ahead_size / block_size);
+	}
+
 	read_block = 0;
 	read_pos = 0;
+	read_last_fetched = 0;
+
+	return _fetch_block(0) ? OK : ERR_FILE_CORRUPT;
+}
+
+void FileAccessCompressed::_decompress_window_block(void *p_userdata, uint32_t p_index) {
+	ReadWindow &window = *(ReadWindow *)p_userdata;
+	const FileAccessCompressed *fac = window.owner;
+	const ReadBlock &rb = fac->read_blocks[window.first + p_index];
+
+	const uint8_t *src = window.comp.ptr() + (rb.offset - fac->read_blocks[window.first].offset);
+	uint8_t *dst = window.data.ptr() + (uint64_t)p_index * fac->block_size;
+	if (fac->zstd_ddict) {
+		window.results[p_index] = Compression::decompress_zstd(dst, fac->block_size, src, rb.csize, fac->zstd_ddict);
+	} else {
+		window.results[p_index] = Compression::decompress(dst, fac->block_size, src, rb.csize, fac->cmode);
+	}
+}
+
+void FileAccessCompressed::_wait_window(ReadWindow &p_window) const {
+	if (p_window.task != WorkerThreadPool::INVALID_TASK_ID) {
+		WorkerThreadPool::get_singleton()->wait_for_group_task_completion(p_window.task);
+		p_window.task = WorkerThreadPool::INVALID_TASK_ID;
+	}
+}
+
+void FileAccessCompressed::_start_window(ReadWindow &p_window, uint32_t p_first) const {
+	_wait_window(p_window);
+
+	p_window.owner = this;
+	p_window.first = p_first;
+	p_window.count = MIN(read_ahead_blocks, read_block_count - p_first);
+
+	// Blocks are stored back to back, so the whole window is read at once.
+	const ReadBlock &first = read_blocks[p_first];
+	const ReadBlock &last = read_blocks[p_first + p_window.count - 1];
+	uint64_t span = last.offset + last.csize - first.offset;
+	p_window.comp.resize(span);
+	f->seek(first.offset);
+	if (f->get_buffer(p_window.comp.ptr(), span) != span) {
+		p_window.count = 0; // Truncated, let reading the blocks one by one report it.
+		return;
+	}
 
-	return ret == -1 ? ERR_FILE_CORRUPT : OK;
+	p_window.data.resize(p_window.count * block_size);
+	p_window.results.resize(p_window.count);
+	p_window.task = WorkerThreadPool::get_singleton()->add_native_group_task(&_decompress_window_block, &p_window, p_window.count);
+}
+
+bool FileAccessCompressed::_fetch_block(uint32_t p_block) const {
+	bool found = false;
+	for (int i = 0; i < 2; i++) {
+		ReadWindow &window = read_windows[i];
+		if (window.count == 0 || p_block < window.first || p_block >= window.first + window.count) {
+			continue;
+		}
+
+		_wait_window(window);
+		uint32_t index = p_block - window.first;
+		if (window.results[index] == -1) {
+			return false;
+		}
+		read_ptr = window.data.ptr() + (uint64_t)index * block_size;
+
+		// Reading got into this window, so start on the next one.
+		uint32_t next = window.first + window.count;
+		ReadWindow &other = read_windows[1 - i];
+		if (next < read_block_count && (other.count == 0 || other.first != next)) {
+			_start_window(other, next);
+		}
+		found = true;
+		break;
+	}
+
+	if (!found) {
+		f->seek(read_blocks[p_block].offset);
+		f->get_buffer(comp_buffer.ptrw(), read_blocks[p_block].csize);
+		int dst_size = read_blocks.size() == 1 ? read_total : block_size;
+		int ret;
+		if (zstd_ddict) {
+			ret = Compression::decompress_zstd(buffer.ptrw(), dst_size, comp_buffer.ptr(), read_blocks[p_block].csize, zstd_ddict);
+		} else {
+			ret = Compression::decompress(buffer.ptrw(), dst_size, comp_buffer.ptr(), read_blocks[p_block].csize, cmode);
+		}
+		if (ret == -1) {
+			return false;
+		}
+		read_ptr = buffer.ptrw();
+
+		// Only read ahead once reading is sequential, random access would waste the work.
+		if (read_ahead_blocks > 0 && p_block == read_last_fetched + 1 && p_block + 1 < read_block_count) {
+			_start_window(read_windows[0], p_block + 1);
+		}
+	}
+
+	read_last_fetched = p_block;
+	read_block_size = p_block == read_block_count - 1 ? read_total % block_size : block_size;
+	return true;
 }
 
 Error FileAccessCompressed::_open(const String &p_path, int p_mode_flags) {
@@ -138,41 +264,15 @@ void FileAccessCompressed::_close() {
 
 	if (writing) {
 		//save block table and all compressed blocks
-
-		CharString mgc = magic.utf8();
-		f->store_buffer((const uint8_t *)mgc.get_data(), mgc.length()); //write header 4
-		f->store_32(cmode); //write compression mode 4
-		f->store_32(block_size); //write block size 4
-		f->store_32(write_max); //max amount of data written 4
-		uint32_t bc = (write_max / block_size) + 1;
-
-		for (uint32_t i = 0; i < bc; i++) {
-			f->store_32(0); //compressed sizes, will update later
-		}
-
-		Vector<int> block_sizes;
-		for (uint32_t i = 0; i < bc; i++) {
-			uint32_t bl = i == (bc - 1) ? write_max % block_size : block_size;
-			uint8_t *bp = &write_ptr[i * block_size];
-
-			Vector<uint8_t> cblock;
-			cblock.resize(Compression::get_max_compressed_buffer_size(bl, cmode));
-			int s = Compression::compress(cblock.ptrw(), bp, bl, cmode);
-
-			f->store_buffer(cblock.ptr(), s);
-			block_sizes.push_back(s);
-		}
-
-		f->seek(16); //ok write block sizes
-		for (uint32_t i = 0; i < bc; i++) {
-			f->store_32(block_sizes[i]);
-		}
-		f->seek_end();
-		f->store_buffer((const uint8_t *)mgc.get_data(), mgc.length()); //magic at the end too
-
+		Vector<uint8_t> data = compress_buffer(write_ptr, write_max);
+		f->store_buffer(data.ptr(), data.size());
 		buffer.clear();
 
 	} else {
+		for (int i = 0; i < 2; i++) {
+			_wait_window(read_windows[i]);
+			read_windows[i] = ReadWindow();
+		}
 		comp_buffer.clear();
 		buffer.clear();
 		read_blocks.clear();
@@ -180,6 +280,45 @@ void FileAccessCompressed::_close() {
 	f.unref();
 }
 
+Vector<uint8_t> FileAccessCompressed::compress_buffer(const uint8_t *p_data, uint64_t p_size) const {
+	ERR_FAIL_COND_V_MSG(p_size > UINT32_MAX, Vector<uint8_t>(), "Compressed files can't be larger than 4 GiB.");
+	if (!dictionary.is_empty() && zstd_cdict == nullptr) {
+		ERR_FAIL_COND_V_MSG(cmode != Compression::MODE_ZSTD, Vector<uint8_t>(), "Compression dictionaries are only supported by Zstandard.");
+		zstd_cdict = Compression::create_zstd_compression_dictionary(dictionary);
+		ERR_FAIL_COND_V(zstd_cdict == nullptr, Vector<uint8_t>());
+	}
+
+	uint32_t bc = (p_size / block_size) + 1;
+	Vector<uint8_t> ret;
+	ret.resize(16 + bc * 4);
+	uint8_t *w = ret.ptrw();
+	CharString mgc = magic.utf8();
+	memcpy(w, mgc.get_data(), 4); //write header 4
+	encode_uint32(cmode, &w[4]); //write compression mode 4
+	encode_uint32(block_size, &w[8]); //write block size 4
+	encode_uint32(p_size, &w[12]); //max amount of data written 4
+
+	for (uint32_t i = 0; i < bc; i++) {
+		uint32_t bl = i == (bc - 1) ? p_size % block_size : block_size;
+		uint64_t ofs = ret.size();
+		ret.resize(ofs + Compression::get_max_compressed_buffer_size(bl, cmode));
+		int s;
+		if (zstd_cdict) {
+			s = Compression::compress_zstd(ret.ptrw() + ofs, &p_data[(uint64_t)i * block_size], bl, zstd_cdict);
+		} else {
+			s = Compression::compress(ret.ptrw() + ofs, &p_data[(uint64_t)i * block_size], bl, cmode);
+		}
+		ERR_FAIL_COND_V(s < 0, Vector<uint8_t>());
+		ret.resize(ofs + s);
+		encode_uint32(s, ret.ptrw() + 16 + i * 4); //compressed sizes
+	}
+
+	uint64_t ofs = ret.size();
+	ret.resize(ofs + 4);
+	memcpy(ret.ptrw() + ofs, mgc.get_data(), 4); //magic at the end too
+	return ret;
+}
+
 bool FileAccessCompressed::is_open() const {
 	return f.is_valid();
 }
@@ -202,11 +341,7 @@ void FileAccessCompressed::seek(uint64_t p_position) {
 			uint32_t block_idx = p_position / block_size;
 			if (block_idx != read_block) {
 				read_block = block_idx;
-				f->seek(read_blocks[read_block].offset);
-				f->get_buffer(comp_buffer.ptrw(), read_blocks[read_block].csize);
-				int ret = Compression::decompress(buffer.ptrw(), read_blocks.size() == 1 ? read_total : block_size, comp_buffer.ptr(), read_blocks[read_block].csize, cmode);
-				ERR_FAIL_COND_MSG(ret == -1, "Compressed file is corrupt.");
-				read_block_size = read_block == read_block_count - 1 ? read_total % block_size : block_size;
+				ERR_FAIL_COND_MSG(!_fetch_block(read_block), "Compressed file is corrupt.");
 			}
 
 			read_pos = p_position % block_size;
@@ -267,10 +402,7 @@ uint8_t FileAccessCompressed::get_8() const {
 
 		if (read_block < read_block_count) {
 			//read another block of compressed data
-			f->get_buffer(comp_buffer.ptrw(), read_blocks[read_block].csize);
-			int total = Compression::decompress(buffer.ptrw(), read_blocks.size() == 1 ? read_total : block_size, comp_buffer.ptr(), read_blocks[read_block].csize, cmode);
-			ERR_FAIL_COND_V_MSG(total == -1, 0, "Compressed file is corrupt.");
-			read_block_size = read_block == read_block_count - 1 ? read_total % block_size : block_size;
+			ERR_FAIL_COND_V_MSG(!_fetch_block(read_block), 0, "Compressed file is corrupt.");
 			read_pos = 0;
 
 		} else {
@@ -292,27 +424,28 @@ uint64_t FileAccessCompressed::get_buffer(uint8_t *p_dst, uint64_t p_length) con
 		return 0;
 	}
 
-	for (uint64_t i = 0; i < p_length; i++) {
-		p_dst[i] = read_ptr[read_pos];
-		read_pos++;
+	uint64_t dst_pos = 0;
+	while (dst_pos < p_length) {
+		uint64_t to_copy = MIN((uint64_t)(read_block_size - read_pos), p_length - dst_pos);
+		memcpy(p_dst + dst_pos, read_ptr + read_pos, to_copy);
+		dst_pos += to_copy;
+		read_pos += to_copy;
+
 		if (read_pos >= read_block_size) {
 			read_block++;
 
 			if (read_block < read_block_count) {
 				//read another block of compressed data
-				f->get_buffer(comp_buffer.ptrw(), read_blocks[read_block].csize);
-				int ret = Compression::decompress(buffer.ptrw(), read_blocks.size() == 1 ? read_total : block_size, comp_buffer.ptr(), read_blocks[read_block].csize, cmode);
-				ERR_FAIL_COND_V_MSG(ret == -1, -1, "Compressed file is corrupt.");
-				read_block_size = read_block == read_block_count - 1 ? read_total % block_size : block_size;
+				ERR_FAIL_COND_V_MSG(!_fetch_block(read_block), -1, "Compressed file is corrupt.");
 				read_pos = 0;
 
 			} else {
 				read_block--;
 				at_end = true;
-				if (i + 1 < p_length) {
+				if (dst_pos < p_length) {
 					read_eof = true;
 				}
-				return i + 1;
+				return dst_pos;
 			}
 		}
 	}
@@ -369,6 +502,10 @@ Error FileAccessCompressed::_set_unix_permissions(const String &p_file, uint32_t
 	return FAILED;
 }
 
+uint32_t FileAccessCompressed::default_block_size = 65536;
+uint32_t FileAccessCompressed::read_ahead_size = 524288;
+
 FileAccessCompressed::~FileAccessCompressed() {
 	_close();
+	_free_dictionaries();
 }
@@ -33,6 +33,8 @@
 
 #include "core/io/compression.h"
 #include "core/io/file_access.h"
+#include "core/os/worker_thread_pool.h"
+#include "core/templates/local_vector.h"
 
 class FileAccessCompressed : public FileAccess {
 	Compression::Mode cmode = Compression::MODE_ZSTD;
@@ -50,8 +52,35 @@ class FileAccessCompressed : public FileAccess {
 		uint64_t offset;
 	};
 
+	// Blocks past the one being read are decompressed ahead of time on the worker pool,
+	// one window while the previous one is consumed.
+	struct ReadWindow {
+		const FileAccessCompressed *owner = nullptr;
+		uint32_t first = 0;
+		uint32_t count = 0;
+		LocalVector<uint8_t> comp;
+		LocalVector<uint8_t> data;
+		LocalVector<int> results;
+		WorkerThreadPool::TaskID task = WorkerThreadPool::INVALID_TASK_ID;
+	};
+
+	mutable ReadWindow read_windows[2];
+	mutable uint32_t read_last_fetched = 0;
+	uint32_t read_ahead_blocks = 0;
+
+	static void _decompress_window_block(void *p_userdata, uint32_t p_index);
+	void _wait_window(ReadWindow &p_window) const;
+	void _start_window(ReadWindow &p_window, uint32_t p_first) const;
+	bool _fetch_block(uint32_t p_block) const;
+
+	Vector<uint8_t> dictionary;
+	// Digested once per file, writing digests it when compressing the first time.
+	mutable ZSTD_CDict_s *zstd_cdict = nullptr;
+	ZSTD_DDict_s *zstd_ddict = nullptr;
+	void _free_dictionaries();
+
 	mutable Vector<uint8_t> comp_buffer;
-	uint8_t *read_ptr = nullptr;
+	mutable uint8_t *read_ptr = nullptr;
 	mutable uint32_t read_block = 0;
 	uint32_t read_block_count = 0;
 	mutable uint32_t read_block_size = 0;
@@ -61,14 +90,23 @@ class FileAccessCompressed : public FileAccess {
 
 	String magic = "GCMP";
 	mutable Vector<uint8_t> buffer;
-	Ref<FileAccess> f;
+	mutable Ref<FileAccess> f;
 
 	void _close();
 
 public:
-	void configure(const String &p_magic, Compression::Mode p_mode = Compression::MODE_ZSTD, uint32_t p_block_size = 4096);
+	static const uint32_t MIN_BLOCK_SIZE = 4096;
+	static uint32_t default_block_size;
+	static uint32_t read_ahead_size;
+
+	// A block size of 0 uses default_block_size. Block sizes are at least MIN_BLOCK_SIZE.
+	void configure(const String &p_magic, Compression::Mode p_mode = Compression::MODE_ZSTD, uint32_t p_block_size = 0);
+	// Zstandard only, the same dictionary must be set to read the file back.
+	void set_dictionary(const Vector<uint8_t> &p_dictionary);
 
 	Error open_after_magic(Ref<FileAccess> p_base);
+	// Returns p_data in the compressed file format as configured, what closing a written file would store.
+	Vector<uint8_t> compress_buffer(const uint8_t *p_data, uint64_t p_size) const;
 
 	virtual Error _open(const String &p_path, int p_mode_flags); ///< open a file
 	virtual bool is_open() const; ///< true when file is open
@@ -30,7 +30,9 @@
 
 #include "file_access_pack.h"
 
+#include "core/io/file_access_compressed.h"
 #include "core/io/file_access_encrypted.h"
+#include "core/io/marshalls.h"
 #include "core/object/script_language.h"
 #include "core/os/os.h"
 #include "core/version.h"
@@ -38,6 +40,8 @@
 #include <stdio.h>
 
 Error PackedData::add_pack(const String &p_path, bool p_replace_files, uint64_t p_offset) {
+	current_priority = p_replace_files ? ++top_priority : --bottom_priority;
+
 	for (int i = 0; i < sources.size(); i++) {
 		if (sources[i]->try_open_pack(p_path, p_replace_files, p_offset)) {
 			return OK;
@@ -61,38 +65,186 @@ void PackedData::add_path(const String &p_pkg_path, const String &p_path, uint64
 		pf.md5[i] = p_md5[i];
 	}
 	pf.src = p_src;
+	pf.priority = current_priority;
 
 	if (!exists || p_replace_files) {
 		files[pmd5] = pf;
 	}
 
 	if (!exists) {
-		//search for dir
-		String p = p_path.replace_first("res://", "");
-		PackedDir *cd = root;
-
-		if (p.contains("/")) { //in a subdir
-
-			Vector<String> ds = p.get_base_dir().split("/");
-
-			for (int j = 0; j < ds.size(); j++) {
-				if (!cd->subdirs.has(ds[j])) {
-					PackedDir *pd = memnew(PackedDir);
-					pd->name = ds[j];
-					pd->parent = cd;
-					cd->subdirs[pd->name] = pd;
-					cd = pd;
-				} else {
-					cd = cd->subdirs[ds[j]];
-				}
+		_add_dir_path(p_path);
+	}
+}
+
+void PackedData::_add_dir_path(const String &p_path) {
+	//search for dir
+	String p = p_path.replace_first("res://", "");
+	PackedDir *cd = root;
+
+	if (p.contains("/")) { //in a subdir
+
+		Vector<String> ds = p.get_base_dir().split("/");
+
+		for (int j = 0; j < ds.size(); j++) {
+			if (!cd->subdirs.has(ds[j])) {
+				PackedDir *pd = memnew(PackedDir);
+				pd->name = ds[j];
+				pd->parent = cd;
+				cd->subdirs[pd->name] = pd;
+				cd = pd;
+			} else {
+				cd = cd->subdirs[ds[j]];
 			}
 		}
-		String filename = p_path.get_file();
-		// Don't add as a file if the path points to a directory
-		if (!filename.is_empty()) {
-			cd->files.insert(filename);
+	}
+	String filename = p_path.get_file();
+	// Don't add as a file if the path points to a directory
+	if (!filename.is_empty()) {
+		cd->files.insert(filename);
+	}
+}
+
+void PackedData::add_pack_index(PackIndex *p_index) {
+	p_index->priority = current_priority;
+
+	int pos = 0;
+	while (pos < indexes.size() && indexes[pos]->priority > p_index->priority) {
+		pos++;
+	}
+	indexes.insert(pos, p_index);
+}
+
+void PackedData::_add_index_dirs() {
+	// Only needed to list directories, so it's not done when the pack is added.
+	MutexLock lock(dirs_mutex);
+	for (int i = 0; i < indexes.size(); i++) {
+		PackIndex *index = indexes[i];
+		if (index->dirs_added) {
+			continue;
+		}
+		index->dirs_added = true;
+
+		for (uint32_t j = 0; j < index->count; j++) {
+			const uint8_t *entry = index->entries + (uint64_t)j * PACK_INDEX_ENTRY_SIZE;
+			uint32_t path_ofs = decode_uint32(&entry[52]);
+			uint32_t path_len = decode_uint32(&entry[56]);
+			ERR_CONTINUE(uint64_t(path_ofs) + path_len > index->strings_size);
+
+			String path;
+			path.parse_utf8((const char *)&index->strings[path_ofs], path_len);
+			_add_dir_path(path);
+		}
+	}
+}
+
+bool PackedData::_find_path(const String &p_path, PackedFile &r_file) {
+	PathMD5 pmd5(p_path.md5_buffer());
+	Map<PathMD5, PackedFile>::Element *E = files.find(pmd5);
+
+	for (int i = 0; i < indexes.size(); i++) {
+		const PackIndex *index = indexes[i];
+		if (E && E->get().priority > index->priority) {
+			break; // Indexes are sorted, none of the rest can override it.
+		}
+
+		uint32_t low = 0;
+		uint32_t high = index->count;
+		while (low < high) {
+			uint32_t middle = low + (high - low) / 2;
+			const uint8_t *entry = index->entries + (uint64_t)middle * PACK_INDEX_ENTRY_SIZE;
+			PathMD5 entry_md5(entry);
+			if (entry_md5 < pmd5) {
+				low = middle + 1;
+			} else if (pmd5 < entry_md5) {
+				high = middle;
+			} else {
+				uint32_t flags = decode_uint32(&entry[48]);
+				r_file.pack = index->pack;
+				r_file.offset = index->file_base + decode_uint64(&entry[16]);
+				r_file.size = decode_uint64(&entry[24]);
+				memcpy(r_file.md5, &entry[32], 16);
+				r_file.src = index->src;
+				r_file.encrypted = flags & PACK_FILE_ENCRYPTED;
+				r_file.compressed = flags & PACK_FILE_COMPRESSED;
+				r_file.priority = index->priority;
+				return true;
+			}
 		}
 	}
+
+	if (E) {
+		r_file = E->get();
+		return true;
+	}
+	return false;
+}
+
+Ref<FileAccess> PackedData::try_open_path(const String &p_path) {
+	PackedFile pf;
+	if (!_find_path(p_path, pf)) {
+		return nullptr; //not found
+	}
+	if (pf.offset == 0) {
+		return nullptr; //was erased
+	}
+
+	return pf.src->get_file(p_path, &pf);
+}
+
+bool PackedData::has_path(const String &p_path) {
+	PackedFile pf;
+	return _find_path(p_path, pf);
+}
+
+Vector<uint8_t> PackedData::build_pack_index(const Vector<IndexEntry> &p_entries) {
+	struct SortEntry {
+		PathMD5 md5;
+		int index = 0;
+		bool operator<(const SortEntry &p_other) const {
+			return md5 < p_other.md5;
+		}
+	};
+
+	// Sorted by path hash, so lookups can binary search it where it's stored.
+	Vector<SortEntry> sorted;
+	sorted.resize(p_entries.size());
+	Vector<CharString> paths;
+	paths.resize(p_entries.size());
+	uint64_t strings_size = 0;
+	for (int i = 0; i < p_entries.size(); i++) {
+		sorted.write[i].md5 = PathMD5(p_entries[i].path.md5_buffer());
+		sorted.write[i].index = i;
+		paths.write[i] = p_entries[i].path.utf8();
+		strings_size += paths[i].length();
+	}
+	sorted.sort();
+
+	uint64_t entries_size = (uint64_t)p_entries.size() * PACK_INDEX_ENTRY_SIZE;
+	Vector<uint8_t> data;
+	data.resize(entries_size + strings_size);
+	uint8_t *w = data.ptrw();
+
+	uint32_t path_ofs = 0;
+	for (int i = 0; i < sorted.size(); i++) {
+		const IndexEntry &e = p_entries[sorted[i].index];
+		const CharString &path = paths[sorted[i].index];
+		uint8_t *entry = &w[(uint64_t)i * PACK_INDEX_ENTRY_SIZE];
+
+		memcpy(&entry[0], &sorted[i].md5.a, 8);
+		memcpy(&entry[8], &sorted[i].md5.b, 8);
+		encode_uint64(e.offset, &entry[16]);
+		encode_uint64(e.size, &entry[24]);
+		memcpy(&entry[32], e.md5, 16);
+		encode_uint32(e.flags, &entry[48]);
+		encode_uint32(path_ofs, &entry[52]);
+		encode_uint32(path.length(), &entry[56]);
+		encode_uint32(0, &entry[60]); // Reserved.
+
+		memcpy(&w[entries_size + path_ofs], path.get_data(), path.length());
+		path_ofs += path.length();
+	}
+
+	return data;
 }
 
 void PackedData::add_pack_source(PackSource *p_source) {
@@ -118,6 +270,9 @@ void PackedData::_free_packed_dirs(PackedDir *p_dir) {
 }
 
 PackedData::~PackedData() {
+	for (int i = 0; i < indexes.size(); i++) {
+		memdelete(indexes[i]);
+	}
 	for (int i = 0; i < sources.size(); i++) {
 		memdelete(sources[i]);
 	}
@@ -195,17 +350,27 @@ bool PackedSourcePCK::try_open_pack(const String &p_path, bool p_replace_files,
 		return false;
 	}
 
+	Ref<FileMapping> mapping = f->get_mapping();
+
 	uint32_t version = f->get_32();
 	uint32_t ver_major = f->get_32();
 	uint32_t ver_minor = f->get_32();
 	f->get_32(); // patch number, not used for validation.
 
-	ERR_FAIL_COND_V_MSG(version != PACK_FORMAT_VERSION, false, "Pack version unsupported: " + itos(version) + ".");
+	// Version 2 packs store a directory that's parsed entry by entry, version 3 a sorted index that's used in place.
+	ERR_FAIL_COND_V_MSG(version != 2 && version != PACK_FORMAT_VERSION, false, "Pack version unsupported: " + itos(version) + ".");
 	ERR_FAIL_COND_V_MSG(ver_major > VERSION_MAJOR || (ver_major == VERSION_MAJOR && ver_minor > VERSION_MINOR), false, "Pack created with a newer version of the engine: " + itos(ver_major) + "." + itos(ver_minor) + ".");
 
 	uint32_t pack_flags = f->get_32();
 	uint64_t file_base = f->get_64();
 
+	uint64_t index_offset = 0;
+	uint64_t index_size = 0;
+	if (version == PACK_FORMAT_VERSION) {
+		index_offset = f->get_64();
+		index_size = f->get_64();
+	}
+
 	bool enc_directory = (pack_flags & PACK_DIR_ENCRYPTED);
 
 	for (int i = 0; i < 16; i++) {
@@ -215,6 +380,14 @@ bool PackedSourcePCK::try_open_pack(const String &p_path, bool p_replace_files,
 
 	int file_count = f->get_32();
 
+	if (version == PACK_FORMAT_VERSION) {
+		ERR_FAIL_COND_V_MSG(index_size < (uint64_t)file_count * PACK_INDEX_ENTRY_SIZE, false, "Pack directory index is corrupted.");
+		// Nothing is allocated for the index before knowing it's within the file.
+		uint64_t pack_length = f->get_length();
+		ERR_FAIL_COND_V_MSG(index_offset + p_offset > pack_length || index_size > pack_length - (index_offset + p_offset), false, "Pack directory index is out of bounds.");
+		f->seek(index_offset + p_offset);
+	}
+
 	if (enc_directory) {
 		Ref<FileAccessEncrypted> fae;
 		fae.instantiate();
@@ -231,30 +404,83 @@ bool PackedSourcePCK::try_open_pack(const String &p_path, bool p_replace_files,
 		f = fae;
 	}
 
-	for (int i = 0; i < file_count; i++) {
-		uint32_t sl = f->get_32();
-		CharString cs;
-		cs.resize(sl + 1);
-		f->get_buffer((uint8_t *)cs.ptr(), sl);
-		cs[sl] = 0;
+	if (version == PACK_FORMAT_VERSION) {
+		PackedData::PackIndex *index = memnew(PackedData::PackIndex);
+		index->pack = p_path;
+		index->file_base = file_base + p_offset;
+		index->count = file_count;
+		index->strings_size = index_size - (uint64_t)file_count * PACK_INDEX_ENTRY_SIZE;
+		index->src = this;
 
-		String path;
-		path.parse_utf8(cs.ptr());
+		uint64_t index_pos = index_offset + p_offset;
+		if (!enc_directory && mapping.is_valid() && index_pos + index_size <= mapping->get_size()) {
+			// Nothing to read nor parse, lookups search the mapped index.
+			index->mapping = mapping;
+			index->entries = mapping->ptr() + index_pos;
+		} else {
+			index->data.resize(index_size);
+			if (f->get_buffer(index->data.ptrw(), index_size) != index_size) {
+				memdelete(index);
+				ERR_FAIL_V_MSG(false, "Can't read pack directory index.");
+			}
+			index->entries = index->data.ptr();
+		}
+		index->strings = index->entries + (uint64_t)file_count * PACK_INDEX_ENTRY_SIZE;
 
-		uint64_t ofs = file_base + f->get_64();
-		uint64_t size = f->get_64();
-		uint8_t md5[16];
-		f->get_buffer(md5, 16);
-		uint32_t flags = f->get_32();
+		PackedData::get_singleton()->add_pack_index(index);
+	} else {
+		for (int i = 0; i < file_count; i++) {
+			uint32_t sl = f->get_32();
+			CharString cs;
+			cs.resize(sl + 1);
+			f->get_buffer((uint8_t *)cs.ptr(), sl);
+			cs[sl] = 0;
+
+			String path;
+			path.parse_utf8(cs.ptr());
+
+			uint64_t ofs = file_base + f->get_64();
+			uint64_t size = f->get_64();
+			uint8_t md5[16];
+			f->get_buffer(md5, 16);
+			uint32_t flags = f->get_32();
+
+			PackedData::get_singleton()->add_path(p_path, path, ofs + p_offset, size, md5, this, p_replace_files, (flags & PACK_FILE_ENCRYPTED));
+		}
+	}
 
-		PackedData::get_singleton()->add_path(p_path, path, ofs + p_offset, size, md5, this, p_replace_files, (flags & PACK_FILE_ENCRYPTED));
+	if (mapping.is_valid()) {
+		MutexLock lock(mappings_mutex);
+		mappings.set(p_path, mapping);
 	}
 
 	return true;
 }
 
 Ref<FileAccess> PackedSourcePCK::get_file(const String &p_path, PackedData::PackedFile *p_file) {
-	return memnew(FileAccessPack(p_path, *p_file));
+	Ref<FileMapping> mapping;
+	if (!p_file->encrypted) {
+		MutexLock lock(mappings_mutex);
+		const Ref<FileMapping> *pack_mapping = mappings.getptr(p_file->pack);
+		if (pack_mapping) {
+			mapping = *pack_mapping;
+		}
+	}
+	Ref<FileAccess> file = memnew(FileAccessPack(p_path, *p_file, mapping));
+
+	if (p_file->compressed) {
+		// Stored in the FileAccessCompressed format, so it stays seekable.
+		uint8_t magic[4];
+		file->get_buffer(magic, 4);
+
+		Ref<FileAccessCompressed> fac;
+		fac.instantiate();
+		Error err = fac->open_after_magic(file);
+		ERR_FAIL_COND_V_MSG(err != OK, Ref<FileAccess>(), "Can't open compressed pack-referenced file '" + p_path + "'.");
+		return fac;
+	}
+
+	return file;
 }
 
 //////////////////////////////////////////////////////////////////
@@ -265,7 +491,9 @@ Error FileAccessPack::_open(const String &p_path, int p_mode_flags) {
 }
 
 bool FileAccessPack::is_open() const {
-	if (f.is_valid()) {
+	if (mapping.is_valid()) {
+		return true;
+	} else if (f.is_valid()) {
 		return f->is_open();
 	} else {
 		return false;
@@ -273,7 +501,7 @@ bool FileAccessPack::is_open() const {
 }
 
 void FileAccessPack::seek(uint64_t p_position) {
-	ERR_FAIL_COND_MSG(f.is_null(), "File must be opened before use.");
+	ERR_FAIL_COND_MSG(f.is_null() && mapping.is_null(), "File must be opened before use.");
 
 	if (p_position > pf.size) {
 		eof = true;
@@ -281,7 +509,9 @@ void FileAccessPack::seek(uint64_t p_position) {
 		eof = false;
 	}
 
-	f->seek(off + p_position);
+	if (f.is_valid()) {
+		f->seek(off + p_position);
+	}
 	pos = p_position;
 }
 
@@ -302,18 +532,22 @@ bool FileAccessPack::eof_reached() const {
 }
 
 uint8_t FileAccessPack::get_8() const {
-	ERR_FAIL_COND_V_MSG(f.is_null(), 0, "File must be opened before use.");
+	ERR_FAIL_COND_V_MSG(f.is_null() && mapping.is_null(), 0, "File must be opened before use.");
 	if (pos >= pf.size) {
 		eof = true;
 		return 0;
 	}
 
+	if (mapping.is_valid()) {
+		return mapping->ptr()[off + pos++];
+	}
+
 	pos++;
 	return f->get_8();
 }
 
 uint64_t FileAccessPack::get_buffer(uint8_t *p_dst, uint64_t p_length) const {
-	ERR_FAIL_COND_V_MSG(f.is_null(), -1, "File must be opened before use.");
+	ERR_FAIL_COND_V_MSG(f.is_null() && mapping.is_null(), -1, "File must be opened before use.");
 	ERR_FAIL_COND_V(!p_dst && p_length > 0, -1);
 
 	if (eof) {
@@ -326,21 +560,39 @@ uint64_t FileAccessPack::get_buffer(uint8_t *p_dst, uint64_t p_length) const {
 		to_read = (int64_t)pf.size - (int64_t)pos;
 	}
 
+	uint64_t from = pos;
 	pos += p_length;
 
 	if (to_read <= 0) {
 		return 0;
 	}
-	f->get_buffer(p_dst, to_read);
+	if (mapping.is_valid()) {
+		memcpy(p_dst, mapping->ptr() + off + from, to_read);
+	} else {
+		f->get_buffer(p_dst, to_read);
+	}
 
 	return to_read;
 }
 
+const uint8_t *FileAccessPack::borrow_buffer(uint64_t p_length, Ref<FileMapping> &r_mapping) {
+	if (mapping.is_null() || eof || pos + p_length > pf.size) {
+		return nullptr;
+	}
+
+	const uint8_t *data = mapping->ptr() + off + pos;
+	pos += p_length;
+	r_mapping = mapping;
+	return data;
+}
+
 void FileAccessPack::set_big_endian(bool p_big_endian) {
-	ERR_FAIL_COND_MSG(f.is_null(), "File must be opened before use.");
+	ERR_FAIL_COND_MSG(f.is_null() && mapping.is_null(), "File must be opened before use.");
 
 	FileAccess::set_big_endian(p_big_endian);
-	f->set_big_endian(p_big_endian);
+	if (f.is_valid()) {
+		f->set_big_endian(p_big_endian);
+	}
 }
 
 Error FileAccessPack::get_error() const {
@@ -366,9 +618,19 @@ bool FileAccessPack::file_exists(const String &p_name) {
 	return false;
 }
 
-FileAccessPack::FileAccessPack(const String &p_path, const PackedData::PackedFile &p_file) :
-		pf(p_file),
-		f(FileAccess::open(pf.pack, FileAccess::READ)) {
+FileAccessPack::FileAccessPack(const String &p_path, const PackedData::PackedFile &p_file, const Ref<FileMapping> &p_mapping) :
+		pf(p_file) {
+	pos = 0;
+	eof = false;
+
+	if (p_mapping.is_valid() && !pf.encrypted && pf.offset + pf.size <= p_mapping->get_size()) {
+		// Reads come straight from the mapped pack, no need to open it again.
+		mapping = p_mapping;
+		off = pf.offset;
+		return;
+	}
+
+	f = FileAccess::open(pf.pack, FileAccess::READ);
 	ERR_FAIL_COND_MSG(f.is_null(), "Can't open pack-referenced file '" + String(pf.pack) + "'.");
 
 	f->seek(pf.offset);
@@ -390,8 +652,6 @@ FileAccessPack::FileAccessPack(const String &p_path, const PackedData::PackedFil
 		f = fae;
 		off = 0;
 	}
-	pos = 0;
-	eof = false;
 }
 
 //////////////////////////////////////////////////////////////////////////////////
@@ -563,5 +823,6 @@ String DirAccessPack::get_filesystem_type() const {
 }
 
 DirAccessPack::DirAccessPack() {
+	PackedData::get_singleton()->_add_index_dirs();
 	current = PackedData::get_singleton()->root;
 }
@@ -33,7 +33,9 @@
 
 #include "core/io/dir_access.h"
 #include "core/io/file_access.h"
+#include "core/os/mutex.h"
 #include "core/string/print_string.h"
+#include "core/templates/hash_map.h"
 #include "core/templates/list.h"
 #include "core/templates/map.h"
 #include "core/templates/set.h"
@@ -41,14 +43,17 @@
 // Godot's packed file magic header ("GDPC" in ASCII).
 #define PACK_HEADER_MAGIC 0x43504447
 // The current packed file format version number.
-#define PACK_FORMAT_VERSION 2
+#define PACK_FORMAT_VERSION 3
+// Size of each entry in the sorted directory index of version 3 packs.
+#define PACK_INDEX_ENTRY_SIZE 64
 
 enum PackFlags {
 	PACK_DIR_ENCRYPTED = 1 << 0
 };
 
 enum PackFileFlags {
-	PACK_FILE_ENCRYPTED = 1 << 0
+	PACK_FILE_ENCRYPTED = 1 << 0,
+	PACK_FILE_COMPRESSED = 1 << 1, // Stored in the FileAccessCompressed format.
 };
 
 class PackSource;
@@ -66,6 +71,33 @@ public:
 		uint8_t md5[16];
 		PackSource *src = nullptr;
 		bool encrypted;
+		bool compressed = false;
+		int64_t priority = 0;
+	};
+
+	// Sorted directory of an indexed pack, searched in place instead of being parsed into `files`.
+	// Entries point into the mapped pack, or into `data` when it couldn't be mapped.
+	struct PackIndex {
+		String pack;
+		uint64_t file_base = 0;
+		int64_t priority = 0;
+		uint32_t count = 0;
+		const uint8_t *entries = nullptr;
+		const uint8_t *strings = nullptr;
+		uint64_t strings_size = 0;
+		PackSource *src = nullptr;
+		bool dirs_added = false;
+
+		Vector<uint8_t> data;
+		Ref<FileMapping> mapping;
+	};
+
+	struct IndexEntry {
+		String path;
+		uint64_t offset = 0;
+		uint64_t size = 0;
+		uint8_t md5[16] = {};
+		uint32_t flags = 0;
 	};
 
 private:
@@ -97,10 +129,24 @@ private:
 			a = *((uint64_t *)&p_buf[0]);
 			b = *((uint64_t *)&p_buf[8]);
 		}
+
+		explicit PathMD5(const uint8_t *p_buf) {
+			memcpy(&a, p_buf, sizeof(a));
+			memcpy(&b, p_buf + sizeof(a), sizeof(b));
+		}
 	};
 
 	Map<PathMD5, PackedFile> files;
 
+	// Packs added with p_replace_files go above everything loaded so far, the others below.
+	// Lookups take the match with the highest priority, so patch packs override without merging.
+	Vector<PackIndex *> indexes; // Highest priority first.
+	int64_t top_priority = 0;
+	int64_t bottom_priority = 0;
+	int64_t current_priority = 0;
+
+	Mutex dirs_mutex;
+
 	Vector<PackSource *> sources;
 
 	PackedDir *root = nullptr;
@@ -109,10 +155,17 @@ private:
 	bool disabled = false;
 
 	void _free_packed_dirs(PackedDir *p_dir);
+	void _add_dir_path(const String &p_path);
+	void _add_index_dirs();
+	bool _find_path(const String &p_path, PackedFile &r_file);
 
 public:
 	void add_pack_source(PackSource *p_source);
 	void add_path(const String &p_pkg_path, const String &p_path, uint64_t p_ofs, uint64_t p_size, const uint8_t *p_md5, PackSource *p_src, bool p_replace_files, bool p_encrypted = false); // for PackSource
+	void add_pack_index(PackIndex *p_index); // for PackSource, takes ownership.
+
+	// Builds the sorted directory index stored in version 3 packs.
+	static Vector<uint8_t> build_pack_index(const Vector<IndexEntry> &p_entries);
 
 	void set_disabled(bool p_disabled) { disabled = p_disabled; }
 	_FORCE_INLINE_ bool is_disabled() const { return disabled; }
@@ -120,8 +173,8 @@ public:
 	static PackedData *get_singleton() { return singleton; }
 	Error add_pack(const String &p_path, bool p_replace_files, uint64_t p_offset);
 
-	_FORCE_INLINE_ Ref<FileAccess> try_open_path(const String &p_path);
-	_FORCE_INLINE_ bool has_path(const String &p_path);
+	Ref<FileAccess> try_open_path(const String &p_path);
+	bool has_path(const String &p_path);
 
 	_FORCE_INLINE_ Ref<DirAccess> try_open_directory(const String &p_path);
 	_FORCE_INLINE_ bool has_directory(const String &p_path);
@@ -138,6 +191,10 @@ public:
 };
 
 class PackedSourcePCK : public PackSource {
+	// Packs are mapped once when the backend supports it, files opened from them then read straight from memory.
+	Mutex mappings_mutex;
+	HashMap<String, Ref<FileMapping>> mappings;
+
 public:
 	virtual bool try_open_pack(const String &p_path, bool p_replace_files, uint64_t p_offset) override;
 	virtual Ref<FileAccess> get_file(const String &p_path, PackedData::PackedFile *p_file) override;
@@ -151,6 +208,7 @@ class FileAccessPack : public FileAccess {
 	uint64_t off;
 
 	Ref<FileAccess> f;
+	Ref<FileMapping> mapping; // Used instead of f when the pack is mapped.
 	virtual Error _open(const String &p_path, int p_mode_flags);
 	virtual uint64_t _get_modified_time(const String &p_file) { return 0; }
 	virtual uint32_t _get_unix_permissions(const String &p_file) { return 0; }
@@ -169,6 +227,7 @@ public:
 	virtual uint8_t get_8() const;
 
 	virtual uint64_t get_buffer(uint8_t *p_dst, uint64_t p_length) const;
+	virtual const uint8_t *borrow_buffer(uint64_t p_length, Ref<FileMapping> &r_mapping);
 
 	virtual void set_big_endian(bool p_big_endian);
 
@@ -181,26 +240,9 @@ public:
 
 	virtual bool file_exists(const String &p_name);
 
-	FileAccessPack(const String &p_path, const PackedData::PackedFile &p_file);
+	FileAccessPack(const String &p_path, const PackedData::PackedFile &p_file, const Ref<FileMapping> &p_mapping = Ref<FileMapping>());
 };
 
-Ref<FileAccess> PackedData::try_open_path(const String &p_path) {
-	PathMD5 pmd5(p_path.md5_buffer());
-	Map<PathMD5, PackedFile>::Element *E = files.find(pmd5);
-	if (!E) {
-		return nullptr; //not found
-	}
-	if (E->get().offset == 0) {
-		return nullptr; //was erased
-	}
-
-	return E->get().src->get_file(p_path, &E->get());
-}
-
-bool PackedData::has_path(const String &p_path) {
-	return files.has(PathMD5(p_path.md5_buffer()));
-}
-
 bool PackedData::has_directory(const String &p_path) {
 	Ref<DirAccess> da = try_open_directory(p_path);
 	if (da.is_valid()) {
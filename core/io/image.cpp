@@ -35,8 +35,10 @@
 #include "core/io/image_loader.h"
 #include "core/io/resource_loader.h"
 #include "core/math/math_funcs.h"
+#include "core/os/worker_thread_pool.h"
 #include "core/string/print_string.h"
 #include "core/templates/hash_map.h"
+#include "core/templates/local_vector.h"
 #include "core/variant/dictionary.h"
 
 #include <stdio.h>
@@ -426,15 +428,62 @@ int Image::get_mipmap_count() const {
 	}
 }
 
+// Images with at least this many pixels are processed in bands of rows on the worker pool.
+static const uint64_t PARALLEL_MIN_PIXELS = 256 * 256;
+
+typedef void (*ImageRowsFunc)(void *p_userdata, uint32_t p_from, uint32_t p_to);
+
+struct ImageRowBands {
+	ImageRowsFunc func = nullptr;
+	void *userdata = nullptr;
+	uint32_t rows = 0;
+	uint32_t rows_per_band = 0;
+};
+
+static void _process_row_band(void *p_userdata, uint32_t p_band) {
+	ImageRowBands *bands = (ImageRowBands *)p_userdata;
+	uint32_t from = p_band * bands->rows_per_band;
+	bands->func(bands->userdata, from, MIN(from + bands->rows_per_band, bands->rows));
+}
+
+// Calls p_func for row ranges covering [0, p_rows). Each range must only write its own rows.
+static void _process_rows(ImageRowsFunc p_func, void *p_userdata, uint32_t p_rows, uint64_t p_pixels) {
+	WorkerThreadPool *pool = WorkerThreadPool::get_singleton();
+	if (!pool || pool->get_thread_count() == 0 || p_pixels < PARALLEL_MIN_PIXELS || p_rows < 2) {
+		p_func(p_userdata, 0, p_rows);
+		return;
+	}
+
+	ImageRowBands bands;
+	bands.func = p_func;
+	bands.userdata = p_userdata;
+	bands.rows = p_rows;
+	// A few bands per thread, so threads that finish early can pick up more work.
+	uint32_t band_count = MIN(p_rows, uint32_t(pool->get_thread_count()) * 4);
+	bands.rows_per_band = (p_rows + band_count - 1) / band_count;
+	band_count = (p_rows + bands.rows_per_band - 1) / bands.rows_per_band;
+
+	WorkerThreadPool::TaskID task = pool->add_native_group_task(&_process_row_band, &bands, band_count);
+	pool->wait_for_group_task_completion(task);
+}
+
+struct ImageConvertJob {
+	int width = 0;
+	const uint8_t *src = nullptr;
+	uint8_t *dst = nullptr;
+};
+
 //using template generates perfectly optimized code due to constant expression reduction and unused variable removal present in all compilers
 template <uint32_t read_bytes, bool read_alpha, uint32_t write_bytes, bool write_alpha, bool read_gray, bool write_gray>
-static void _convert(int p_width, int p_height, const uint8_t *p_src, uint8_t *p_dst) {
+static void _convert_rows(void *p_userdata, uint32_t p_from, uint32_t p_to) {
+	const ImageConvertJob *job = (const ImageConvertJob *)p_userdata;
+	const int width = job->width;
 	uint32_t max_bytes = MAX(read_bytes, write_bytes);
 
-	for (int y = 0; y < p_height; y++) {
-		for (int x = 0; x < p_width; x++) {
-			const uint8_t *rofs = &p_src[((y * p_width) + x) * (read_bytes + (read_alpha ? 1 : 0))];
-			uint8_t *wofs = &p_dst[((y * p_width) + x) * (write_bytes + (write_alpha ? 1 : 0))];
+	for (int y = p_from; y < (int)p_to; y++) {
+		for (int x = 0; x < width; x++) {
+			const uint8_t *rofs = &job->src[((y * width) + x) * (read_bytes + (read_alpha ? 1 : 0))];
+			uint8_t *wofs = &job->dst[((y * width) + x) * (write_bytes + (write_alpha ? 1 : 0))];
 
 			uint8_t rgba[4] = { 0, 0, 0, 255 };
 
@@ -468,6 +517,31 @@ static void _convert(int p_width, int p_height, const uint8_t *p_src, uint8_t *p
 	}
 }
 
+template <uint32_t read_bytes, bool read_alpha, uint32_t write_bytes, bool write_alpha, bool read_gray, bool write_gray>
+static void _convert(int p_width, int p_height, const uint8_t *p_src, uint8_t *p_dst) {
+	ImageConvertJob job;
+	job.width = p_width;
+	job.src = p_src;
+	job.dst = p_dst;
+	_process_rows(_convert_rows<read_bytes, read_alpha, write_bytes, write_alpha, read_gray, write_gray>, &job, p_height, uint64_t(p_width) * p_height);
+}
+
+struct ImagePixelConvertJob {
+	const Image *src = nullptr;
+	Image *dst = nullptr;
+};
+
+static void _convert_pixels_rows(void *p_userdata, uint32_t p_from, uint32_t p_to) {
+	const ImagePixelConvertJob *job = (const ImagePixelConvertJob *)p_userdata;
+	int width = job->src->get_width();
+
+	for (int y = p_from; y < (int)p_to; y++) {
+		for (int x = 0; x < width; x++) {
+			job->dst->set_pixel(x, y, job->src->get_pixel(x, y));
+		}
+	}
+}
+
 void Image::convert(Format p_new_format) {
 	if (data.size() == 0) {
 		return;
@@ -484,11 +558,10 @@ void Image::convert(Format p_new_format) {
 		//use put/set pixel which is slower but works with non byte formats
 		Image new_img(width, height, false, p_new_format);
 
-		for (int i = 0; i < width; i++) {
-			for (int j = 0; j < height; j++) {
-				new_img.set_pixel(i, j, get_pixel(i, j));
-			}
-		}
+		ImagePixelConvertJob job;
+		job.src = this;
+		job.dst = &new_img;
+		_process_rows(_convert_pixels_rows, &job, height, uint64_t(width) * height);
 
 		if (has_mipmaps()) {
 			new_img.generate_mipmaps();
@@ -627,7 +700,7 @@ static double _bicubic_interp_kernel(double x) {
 }
 
 template <int CC, class T>
-static void _scale_cubic(const uint8_t *__restrict p_src, uint8_t *__restrict p_dst, uint32_t p_src_width, uint32_t p_src_height, uint32_t p_dst_width, uint32_t p_dst_height) {
+static void _scale_cubic(const uint8_t *__restrict p_src, uint8_t *__restrict p_dst, uint32_t p_src_width, uint32_t p_src_height, uint32_t p_dst_width, uint32_t p_dst_height, uint32_t p_row_from, uint32_t p_row_to) {
 	// get source image size
 	int width = p_src_width;
 	int height = p_src_height;
@@ -642,7 +715,7 @@ static void _scale_cubic(const uint8_t *__restrict p_src, uint8_t *__restrict p_
 	int xmax = width - 1;
 	// temporary pointer
 
-	for (uint32_t y = 0; y < p_dst_height; y++) {
+	for (uint32_t y = p_row_from; y < p_row_to; y++) {
 		// Y coordinates
 		oy = (double)y * yfac - 0.5f;
 		oy1 = (int)oy;
@@ -713,16 +786,47 @@ static void _scale_cubic(const uint8_t *__restrict p_src, uint8_t *__restrict p_
 	}
 }
 
+enum {
+	BILINEAR_FRAC_BITS = 8,
+};
+
+// The horizontal sample positions of bilinear scaling are the same for every row: the left and
+// right source columns and the weight of the right one, for each destination column.
+static void _bilinear_x_samples(LocalVector<uint32_t> &r_samples, uint32_t p_src_width, uint32_t p_dst_width) {
+	enum {
+		FRAC_BITS = BILINEAR_FRAC_BITS,
+		FRAC_LEN = (1 << FRAC_BITS),
+		FRAC_HALF = (FRAC_LEN >> 1),
+		FRAC_MASK = FRAC_LEN - 1
+	};
+
+	r_samples.resize(p_dst_width * 3);
+	for (uint32_t j = 0; j < p_dst_width; j++) {
+		uint32_t src_xofs_left_fp = (j + 0.5) * p_src_width * FRAC_LEN / p_dst_width;
+		uint32_t src_xofs_left = src_xofs_left_fp >= FRAC_HALF ? (src_xofs_left_fp - FRAC_HALF) >> FRAC_BITS : 0;
+		uint32_t src_xofs_right = (src_xofs_left_fp + FRAC_HALF) >> FRAC_BITS;
+		if (src_xofs_right >= p_src_width) {
+			src_xofs_right = p_src_width - 1;
+		}
+		uint32_t src_xofs_frac = src_xofs_left_fp & FRAC_MASK;
+		src_xofs_frac = src_xofs_frac >= FRAC_HALF ? src_xofs_frac - FRAC_HALF : src_xofs_frac + FRAC_HALF;
+
+		r_samples[j * 3 + 0] = src_xofs_left;
+		r_samples[j * 3 + 1] = src_xofs_right;
+		r_samples[j * 3 + 2] = src_xofs_frac;
+	}
+}
+
 template <int CC, class T>
-static void _scale_bilinear(const uint8_t *__restrict p_src, uint8_t *__restrict p_dst, uint32_t p_src_width, uint32_t p_src_height, uint32_t p_dst_width, uint32_t p_dst_height) {
+static void _scale_bilinear(const uint8_t *__restrict p_src, uint8_t *__restrict p_dst, uint32_t p_src_width, uint32_t p_src_height, uint32_t p_dst_width, uint32_t p_dst_height, const uint32_t *p_x_samples, uint32_t p_row_from, uint32_t p_row_to) {
 	enum {
-		FRAC_BITS = 8,
+		FRAC_BITS = BILINEAR_FRAC_BITS,
 		FRAC_LEN = (1 << FRAC_BITS),
 		FRAC_HALF = (FRAC_LEN >> 1),
 		FRAC_MASK = FRAC_LEN - 1
 	};
 
-	for (uint32_t i = 0; i < p_dst_height; i++) {
+	for (uint32_t i = p_row_from; i < p_row_to; i++) {
 		// Add 0.5 in order to interpolate based on pixel center
 		uint32_t src_yofs_up_fp = (i + 0.5) * p_src_height * FRAC_LEN / p_dst_height;
 		// Calculate nearest src pixel center above current, and truncate to get y index
@@ -739,17 +843,9 @@ static void _scale_bilinear(const uint8_t *__restrict p_src, uint8_t *__restrict
 		uint32_t y_ofs_down = src_yofs_down * p_src_width * CC;
 
 		for (uint32_t j = 0; j < p_dst_width; j++) {
-			uint32_t src_xofs_left_fp = (j + 0.5) * p_src_width * FRAC_LEN / p_dst_width;
-			uint32_t src_xofs_left = src_xofs_left_fp >= FRAC_HALF ? (src_xofs_left_fp - FRAC_HALF) >> FRAC_BITS : 0;
-			uint32_t src_xofs_right = (src_xofs_left_fp + FRAC_HALF) >> FRAC_BITS;
-			if (src_xofs_right >= p_src_width) {
-				src_xofs_right = p_src_width - 1;
-			}
-			uint32_t src_xofs_frac = src_xofs_left_fp & FRAC_MASK;
-			src_xofs_frac = src_xofs_frac >= FRAC_HALF ? src_xofs_frac - FRAC_HALF : src_xofs_frac + FRAC_HALF;
-
-			src_xofs_left *= CC;
-			src_xofs_right *= CC;
+			uint32_t src_xofs_left = p_x_samples[j * 3 + 0] * CC;
+			uint32_t src_xofs_right = p_x_samples[j * 3 + 1] * CC;
+			uint32_t src_xofs_frac = p_x_samples[j * 3 + 2];
 
 			for (uint32_t l = 0; l < CC; l++) {
 				if (sizeof(T) == 1) { //uint8
@@ -804,8 +900,8 @@ static void _scale_bilinear(const uint8_t *__restrict p_src, uint8_t *__restrict
 }
 
 template <int CC, class T>
-static void _scale_nearest(const uint8_t *__restrict p_src, uint8_t *__restrict p_dst, uint32_t p_src_width, uint32_t p_src_height, uint32_t p_dst_width, uint32_t p_dst_height) {
-	for (uint32_t i = 0; i < p_dst_height; i++) {
+static void _scale_nearest(const uint8_t *__restrict p_src, uint8_t *__restrict p_dst, uint32_t p_src_width, uint32_t p_src_height, uint32_t p_dst_width, uint32_t p_dst_height, uint32_t p_row_from, uint32_t p_row_to) {
+	for (uint32_t i = p_row_from; i < p_row_to; i++) {
 		uint32_t src_yofs = i * p_src_height / p_dst_height;
 		uint32_t y_ofs = src_yofs * p_src_width * CC;
 
@@ -945,6 +1041,68 @@ static void _scale_lanczos(const uint8_t *__restrict p_src, uint8_t *__restrict
 	memdelete_arr(buffer);
 }
 
+typedef void (*ImageScaleFunc)(const uint8_t *p_src, uint8_t *p_dst, uint32_t p_src_width, uint32_t p_src_height, uint32_t p_dst_width, uint32_t p_dst_height, uint32_t p_row_from, uint32_t p_row_to);
+
+struct ImageScaleJob {
+	ImageScaleFunc func = nullptr;
+	const uint8_t *src = nullptr;
+	uint8_t *dst = nullptr;
+	uint32_t src_width = 0;
+	uint32_t src_height = 0;
+	uint32_t dst_width = 0;
+	uint32_t dst_height = 0;
+};
+
+static void _scale_rows(void *p_userdata, uint32_t p_from, uint32_t p_to) {
+	const ImageScaleJob *job = (const ImageScaleJob *)p_userdata;
+	job->func(job->src, job->dst, job->src_width, job->src_height, job->dst_width, job->dst_height, p_from, p_to);
+}
+
+// Runs a scaling kernel over all destination rows, in parallel for large images.
+static void _scale(ImageScaleFunc p_func, const uint8_t *p_src, uint8_t *p_dst, uint32_t p_src_width, uint32_t p_src_height, uint32_t p_dst_width, uint32_t p_dst_height) {
+	ImageScaleJob job;
+	job.func = p_func;
+	job.src = p_src;
+	job.dst = p_dst;
+	job.src_width = p_src_width;
+	job.src_height = p_src_height;
+	job.dst_width = p_dst_width;
+	job.dst_height = p_dst_height;
+	_process_rows(_scale_rows, &job, p_dst_height, uint64_t(p_dst_width) * p_dst_height);
+}
+
+typedef void (*ImageBilinearScaleFunc)(const uint8_t *p_src, uint8_t *p_dst, uint32_t p_src_width, uint32_t p_src_height, uint32_t p_dst_width, uint32_t p_dst_height, const uint32_t *p_x_samples, uint32_t p_row_from, uint32_t p_row_to);
+
+struct ImageBilinearScaleJob {
+	ImageBilinearScaleFunc func = nullptr;
+	const uint8_t *src = nullptr;
+	uint8_t *dst = nullptr;
+	uint32_t src_width = 0;
+	uint32_t src_height = 0;
+	uint32_t dst_width = 0;
+	uint32_t dst_height = 0;
+	LocalVector<uint32_t> x_samples;
+};
+
+static void _scale_bilinear_rows(void *p_userdata, uint32_t p_from, uint32_t p_to) {
+	const ImageBilinearScaleJob *job = (const ImageBilinearScaleJob *)p_userdata;
+	job->func(job->src, job->dst, job->src_width, job->src_height, job->dst_width, job->dst_height, job->x_samples.ptr(), p_from, p_to);
+}
+
+// Same as _scale(), the column samples are computed once and shared by every band.
+static void _scale_bilinear_image(ImageBilinearScaleFunc p_func, const uint8_t *p_src, uint8_t *p_dst, uint32_t p_src_width, uint32_t p_src_height, uint32_t p_dst_width, uint32_t p_dst_height) {
+	ImageBilinearScaleJob job;
+	job.func = p_func;
+	job.src = p_src;
+	job.dst = p_dst;
+	job.src_width = p_src_width;
+	job.src_height = p_src_height;
+	job.dst_width = p_dst_width;
+	job.dst_height = p_dst_height;
+	_bilinear_x_samples(job.x_samples, p_src_width, p_dst_width);
+	_process_rows(_scale_bilinear_rows, &job, p_dst_height, uint64_t(p_dst_width) * p_dst_height);
+}
+
 static void _overlay(const uint8_t *__restrict p_src, uint8_t *__restrict p_dst, float p_alpha, uint32_t p_width, uint32_t p_height, uint32_t p_pixel_size) {
 	uint16_t alpha = MIN((uint16_t)(p_alpha * 256.0f), 256);
 
@@ -1031,47 +1189,47 @@ void Image::resize(int p_width, int p_height, Interpolation p_interpolation) {
 			if (format >= FORMAT_L8 && format <= FORMAT_RGBA8) {
 				switch (get_format_pixel_size(format)) {
 					case 1:
-						_scale_nearest<1, uint8_t>(r_ptr, w_ptr, width, height, p_width, p_height);
+						_scale(_scale_nearest<1, uint8_t>, r_ptr, w_ptr, width, height, p_width, p_height);
 						break;
 					case 2:
-						_scale_nearest<2, uint8_t>(r_ptr, w_ptr, width, height, p_width, p_height);
+						_scale(_scale_nearest<2, uint8_t>, r_ptr, w_ptr, width, height, p_width, p_height);
 						break;
 					case 3:
-						_scale_nearest<3, uint8_t>(r_ptr, w_ptr, width, height, p_width, p_height);
+						_scale(_scale_nearest<3, uint8_t>, r_ptr, w_ptr, width, height, p_width, p_height);
 						break;
 					case 4:
-						_scale_nearest<4, uint8_t>(r_ptr, w_ptr, width, height, p_width, p_height);
+						_scale(_scale_nearest<4, uint8_t>, r_ptr, w_ptr, width, height, p_width, p_height);
 						break;
 				}
 			} else if (format >= FORMAT_RF && format <= FORMAT_RGBAF) {
 				switch (get_format_pixel_size(format)) {
 					case 4:
-						_scale_nearest<1, float>(r_ptr, w_ptr, width, height, p_width, p_height);
+						_scale(_scale_nearest<1, float>, r_ptr, w_ptr, width, height, p_width, p_height);
 						break;
 					case 8:
-						_scale_nearest<2, float>(r_ptr, w_ptr, width, height, p_width, p_height);
+						_scale(_scale_nearest<2, float>, r_ptr, w_ptr, width, height, p_width, p_height);
 						break;
 					case 12:
-						_scale_nearest<3, float>(r_ptr, w_ptr, width, height, p_width, p_height);
+						_scale(_scale_nearest<3, float>, r_ptr, w_ptr, width, height, p_width, p_height);
 						break;
 					case 16:
-						_scale_nearest<4, float>(r_ptr, w_ptr, width, height, p_width, p_height);
+						_scale(_scale_nearest<4, float>, r_ptr, w_ptr, width, height, p_width, p_height);
 						break;
 				}
 
 			} else if (format >= FORMAT_RH && format <= FORMAT_RGBAH) {
 				switch (get_format_pixel_size(format)) {
 					case 2:
-						_scale_nearest<1, uint16_t>(r_ptr, w_ptr, width, height, p_width, p_height);
+						_scale(_scale_nearest<1, uint16_t>, r_ptr, w_ptr, width, height, p_width, p_height);
 						break;
 					case 4:
-						_scale_nearest<2, uint16_t>(r_ptr, w_ptr, width, height, p_width, p_height);
+						_scale(_scale_nearest<2, uint16_t>, r_ptr, w_ptr, width, height, p_width, p_height);
 						break;
 					case 6:
-						_scale_nearest<3, uint16_t>(r_ptr, w_ptr, width, height, p_width, p_height);
+						_scale(_scale_nearest<3, uint16_t>, r_ptr, w_ptr, width, height, p_width, p_height);
 						break;
 					case 8:
-						_scale_nearest<4, uint16_t>(r_ptr, w_ptr, width, height, p_width, p_height);
+						_scale(_scale_nearest<4, uint16_t>, r_ptr, w_ptr, width, height, p_width, p_height);
 						break;
 				}
 			}
@@ -1118,46 +1276,46 @@ void Image::resize(int p_width, int p_height, Interpolation p_interpolation) {
 				if (format >= FORMAT_L8 && format <= FORMAT_RGBA8) {
 					switch (get_format_pixel_size(format)) {
 						case 1:
-							_scale_bilinear<1, uint8_t>(src_ptr, w_ptr, src_width, src_height, p_width, p_height);
+							_scale_bilinear_image(_scale_bilinear<1, uint8_t>, src_ptr, w_ptr, src_width, src_height, p_width, p_height);
 							break;
 						case 2:
-							_scale_bilinear<2, uint8_t>(src_ptr, w_ptr, src_width, src_height, p_width, p_height);
+							_scale_bilinear_image(_scale_bilinear<2, uint8_t>, src_ptr, w_ptr, src_width, src_height, p_width, p_height);
 							break;
 						case 3:
-							_scale_bilinear<3, uint8_t>(src_ptr, w_ptr, src_width, src_height, p_width, p_height);
+							_scale_bilinear_image(_scale_bilinear<3, uint8_t>, src_ptr, w_ptr, src_width, src_height, p_width, p_height);
 							break;
 						case 4:
-							_scale_bilinear<4, uint8_t>(src_ptr, w_ptr, src_width, src_height, p_width, p_height);
+							_scale_bilinear_image(_scale_bilinear<4, uint8_t>, src_ptr, w_ptr, src_width, src_height, p_width, p_height);
 							break;
 					}
 				} else if (format >= FORMAT_RF && format <= FORMAT_RGBAF) {
 					switch (get_format_pixel_size(format)) {
 						case 4:
-							_scale_bilinear<1, float>(src_ptr, w_ptr, src_width, src_height, p_width, p_height);
+							_scale_bilinear_image(_scale_bilinear<1, float>, src_ptr, w_ptr, src_width, src_height, p_width, p_height);
 							break;
 						case 8:
-							_scale_bilinear<2, float>(src_ptr, w_ptr, src_width, src_height, p_width, p_height);
+							_scale_bilinear_image(_scale_bilinear<2, float>, src_ptr, w_ptr, src_width, src_height, p_width, p_height);
 							break;
 						case 12:
-							_scale_bilinear<3, float>(src_ptr, w_ptr, src_width, src_height, p_width, p_height);
+							_scale_bilinear_image(_scale_bilinear<3, float>, src_ptr, w_ptr, src_width, src_height, p_width, p_height);
 							break;
 						case 16:
-							_scale_bilinear<4, float>(src_ptr, w_ptr, src_width, src_height, p_width, p_height);
+							_scale_bilinear_image(_scale_bilinear<4, float>, src_ptr, w_ptr, src_width, src_height, p_width, p_height);
 							break;
 					}
 				} else if (format >= FORMAT_RH && format <= FORMAT_RGBAH) {
 					switch (get_format_pixel_size(format)) {
 						case 2:
-							_scale_bilinear<1, uint16_t>(src_ptr, w_ptr, src_width, src_height, p_width, p_height);
+							_scale_bilinear_image(_scale_bilinear<1, uint16_t>, src_ptr, w_ptr, src_width, src_height, p_width, p_height);
 							break;
 						case 4:
-							_scale_bilinear<2, uint16_t>(src_ptr, w_ptr, src_width, src_height, p_width, p_height);
+							_scale_bilinear_image(_scale_bilinear<2, uint16_t>, src_ptr, w_ptr, src_width, src_height, p_width, p_height);
 							break;
 						case 6:
-							_scale_bilinear<3, uint16_t>(src_ptr, w_ptr, src_width, src_height, p_width, p_height);
+							_scale_bilinear_image(_scale_bilinear<3, uint16_t>, src_ptr, w_ptr, src_width, src_height, p_width, p_height);
 							break;
 						case 8:
-							_scale_bilinear<4, uint16_t>(src_ptr, w_ptr, src_width, src_height, p_width, p_height);
+							_scale_bilinear_image(_scale_bilinear<4, uint16_t>, src_ptr, w_ptr, src_width, src_height, p_width, p_height);
 							break;
 					}
 				}
@@ -1174,46 +1332,46 @@ void Image::resize(int p_width, int p_height, Interpolation p_interpolation) {
 			if (format >= FORMAT_L8 && format <= FORMAT_RGBA8) {
 				switch (get_format_pixel_size(format)) {
 					case 1:
-						_scale_cubic<1, uint8_t>(r_ptr, w_ptr, width, height, p_width, p_height);
+						_scale(_scale_cubic<1, uint8_t>, r_ptr, w_ptr, width, height, p_width, p_height);
 						break;
 					case 2:
-						_scale_cubic<2, uint8_t>(r_ptr, w_ptr, width, height, p_width, p_height);
+						_scale(_scale_cubic<2, uint8_t>, r_ptr, w_ptr, width, height, p_width, p_height);
 						break;
 					case 3:
-						_scale_cubic<3, uint8_t>(r_ptr, w_ptr, width, height, p_width, p_height);
+						_scale(_scale_cubic<3, uint8_t>, r_ptr, w_ptr, width, height, p_width, p_height);
 						break;
 					case 4:
-						_scale_cubic<4, uint8_t>(r_ptr, w_ptr, width, height, p_width, p_height);
+						_scale(_scale_cubic<4, uint8_t>, r_ptr, w_ptr, width, height, p_width, p_height);
 						break;
 				}
 			} else if (format >= FORMAT_RF && format <= FORMAT_RGBAF) {
 				switch (get_format_pixel_size(format)) {
 					case 4:
-						_scale_cubic<1, float>(r_ptr, w_ptr, width, height, p_width, p_height);
+						_scale(_scale_cubic<1, float>, r_ptr, w_ptr, width, height, p_width, p_height);
 						break;
 					case 8:
-						_scale_cubic<2, float>(r_ptr, w_ptr, width, height, p_width, p_height);
+						_scale(_scale_cubic<2, float>, r_ptr, w_ptr, width, height, p_width, p_height);
 						break;
 					case 12:
-						_scale_cubic<3, float>(r_ptr, w_ptr, width, height, p_width, p_height);
+						_scale(_scale_cubic<3, float>, r_ptr, w_ptr, width, height, p_width, p_height);
 						break;
 					case 16:
-						_scale_cubic<4, float>(r_ptr, w_ptr, width, height, p_width, p_height);
+						_scale(_scale_cubic<4, float>, r_ptr, w_ptr, width, height, p_width, p_height);
 						break;
 				}
 			} else if (format >= FORMAT_RH && format <= FORMAT_RGBAH) {
 				switch (get_format_pixel_size(format)) {
 					case 2:
-						_scale_cubic<1, uint16_t>(r_ptr, w_ptr, width, height, p_width, p_height);
+						_scale(_scale_cubic<1, uint16_t>, r_ptr, w_ptr, width, height, p_width, p_height);
 						break;
 					case 4:
-						_scale_cubic<2, uint16_t>(r_ptr, w_ptr, width, height, p_width, p_height);
+						_scale(_scale_cubic<2, uint16_t>, r_ptr, w_ptr, width, height, p_width, p_height);
 						break;
 					case 6:
-						_scale_cubic<3, uint16_t>(r_ptr, w_ptr, width, height, p_width, p_height);
+						_scale(_scale_cubic<3, uint16_t>, r_ptr, w_ptr, width, height, p_width, p_height);
 						break;
 					case 8:
-						_scale_cubic<4, uint16_t>(r_ptr, w_ptr, width, height, p_width, p_height);
+						_scale(_scale_cubic<4, uint16_t>, r_ptr, w_ptr, width, height, p_width, p_height);
 						break;
 				}
 			}
@@ -1460,23 +1618,57 @@ bool Image::_can_modify(Format p_format) const {
 	return p_format <= FORMAT_RGBE9995;
 }
 
+template <class Component>
+struct ImageMipmapJob {
+	const Component *src = nullptr;
+	Component *dst = nullptr;
+	uint32_t width = 0;
+	uint32_t height = 0;
+};
+
 template <class Component, int CC, bool renormalize,
 		void (*average_func)(Component &, const Component &, const Component &, const Component &, const Component &),
 		void (*renormalize_func)(Component *)>
-static void _generate_po2_mipmap(const Component *p_src, Component *p_dst, uint32_t p_width, uint32_t p_height) {
+static void _generate_po2_mipmap_rows(void *p_userdata, uint32_t p_from, uint32_t p_to) {
+	const ImageMipmapJob<Component> *job = (const ImageMipmapJob<Component> *)p_userdata;
+	uint32_t width = job->width;
+	uint32_t height = job->height;
+
 	//fast power of 2 mipmap generation
-	uint32_t dst_w = MAX(p_width >> 1, 1u);
-	uint32_t dst_h = MAX(p_height >> 1, 1u);
+	uint32_t dst_w = MAX(width >> 1, 1u);
 
-	int right_step = (p_width == 1) ? 0 : CC;
-	int down_step = (p_height == 1) ? 0 : (p_width * CC);
+	int right_step = (width == 1) ? 0 : CC;
+	int down_step = (height == 1) ? 0 : (width * CC);
 
-	for (uint32_t i = 0; i < dst_h; i++) {
-		const Component *rup_ptr = &p_src[i * 2 * down_step];
+	for (uint32_t i = p_from; i < p_to; i++) {
+		const Component *rup_ptr = &job->src[i * 2 * down_step];
 		const Component *rdown_ptr = rup_ptr + down_step;
-		Component *dst_ptr = &p_dst[i * dst_w * CC];
+		Component *dst_ptr = &job->dst[i * dst_w * CC];
 		uint32_t count = dst_w;
 
+		if (sizeof(Component) == 1 && CC == 4 && !renormalize) {
+			// RGBA8: all four channels of a pixel are averaged at once, with the even and odd channels
+			// in separate 16-bit lanes of a 32-bit word. The rounding is the same as average_4_uint8().
+			while (count) {
+				count--;
+				uint32_t a, b, c, d;
+				memcpy(&a, rup_ptr, 4);
+				memcpy(&b, rup_ptr + right_step, 4);
+				memcpy(&c, rdown_ptr, 4);
+				memcpy(&d, rdown_ptr + right_step, 4);
+
+				uint32_t even = (a & 0x00ff00ff) + (b & 0x00ff00ff) + (c & 0x00ff00ff) + (d & 0x00ff00ff) + 0x00020002;
+				uint32_t odd = ((a >> 8) & 0x00ff00ff) + ((b >> 8) & 0x00ff00ff) + ((c >> 8) & 0x00ff00ff) + ((d >> 8) & 0x00ff00ff) + 0x00020002;
+				uint32_t result = ((even >> 2) & 0x00ff00ff) | (((odd >> 2) & 0x00ff00ff) << 8);
+				memcpy(dst_ptr, &result, 4);
+
+				dst_ptr += CC;
+				rup_ptr += right_step * 2;
+				rdown_ptr += right_step * 2;
+			}
+			continue;
+		}
+
 		while (count) {
 			count--;
 			for (int j = 0; j < CC; j++) {
@@ -1494,6 +1686,18 @@ static void _generate_po2_mipmap(const Component *p_src, Component *p_dst, uint3
 	}
 }
 
+template <class Component, int CC, bool renormalize,
+		void (*average_func)(Component &, const Component &, const Component &, const Component &, const Component &),
+		void (*renormalize_func)(Component *)>
+static void _generate_po2_mipmap(const Component *p_src, Component *p_dst, uint32_t p_width, uint32_t p_height) {
+	ImageMipmapJob<Component> job;
+	job.src = p_src;
+	job.dst = p_dst;
+	job.width = p_width;
+	job.height = p_height;
+	_process_rows(_generate_po2_mipmap_rows<Component, CC, renormalize, average_func, renormalize_func>, &job, MAX(p_height >> 1, 1u), uint64_t(p_width) * p_height);
+}
+
 void Image::shrink_x2() {
 	ERR_FAIL_COND(data.size() == 0);
 
@@ -32,6 +32,7 @@
 
 #include "core/crypto/crypto_core.h"
 #include "core/io/file_access.h"
+#include "core/io/file_access_compressed.h"
 #include "core/io/file_access_encrypted.h"
 #include "core/io/file_access_pack.h" // PACK_HEADER_MAGIC, PACK_FORMAT_VERSION
 #include "core/version.h"
@@ -48,7 +49,7 @@ static int _get_pad(int p_alignment, int p_n) {
 
 void PCKPacker::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("pck_start", "pck_name", "alignment", "key", "encrypt_directory"), &PCKPacker::pck_start, DEFVAL(32), DEFVAL("0000000000000000000000000000000000000000000000000000000000000000"), DEFVAL(false));
-	ClassDB::bind_method(D_METHOD("add_file", "pck_path", "source_path", "encrypt"), &PCKPacker::add_file, DEFVAL(false));
+	ClassDB::bind_method(D_METHOD("add_file", "pck_path", "source_path", "encrypt", "compress"), &PCKPacker::add_file, DEFVAL(false), DEFVAL(false));
 	ClassDB::bind_method(D_METHOD("flush", "verbose"), &PCKPacker::flush, DEFVAL(false));
 }
 
@@ -101,12 +102,12 @@ Error PCKPacker::pck_start(const String &p_file, int p_alignment, const String &
 	file->store_32(pack_flags); // flags
 
 	files.clear();
-	ofs = 0;
+	file_indices.clear();
 
 	return OK;
 }
 
-Error PCKPacker::add_file(const String &p_file, const String &p_src, bool p_encrypt) {
+Error PCKPacker::add_file(const String &p_file, const String &p_src, bool p_encrypt, bool p_compress) {
 	Ref<FileAccess> f = FileAccess::open(p_src, FileAccess::READ);
 	if (f.is_null()) {
 		return ERR_FILE_CANT_OPEN;
@@ -115,7 +116,6 @@ Error PCKPacker::add_file(const String &p_file, const String &p_src, bool p_encr
 	File pf;
 	pf.path = p_file;
 	pf.src_path = p_src;
-	pf.ofs = ofs;
 	pf.size = f->get_length();
 
 	Vector<uint8_t> data = FileAccess::get_file_as_array(p_src);
@@ -128,22 +128,16 @@ Error PCKPacker::add_file(const String &p_file, const String &p_src, bool p_encr
 		}
 	}
 	pf.encrypted = p_encrypt;
-
-	uint64_t _size = pf.size;
-	if (p_encrypt) { // Add encryption overhead.
-		if (_size % 16) { // Pad to encryption block size.
-			_size += 16 - (_size % 16);
-		}
-		_size += 16; // hash
-		_size += 8; // data size
-		_size += 16; // iv
+	pf.compressed = p_compress;
+
+	const int *existing = file_indices.getptr(p_file);
+	if (existing) {
+		files.write[*existing] = pf;
+	} else {
+		file_indices.set(p_file, files.size());
+		files.push_back(pf);
 	}
 
-	int pad = _get_pad(alignment, ofs + _size);
-	ofs = ofs + _size + pad;
-
-	files.push_back(pf);
-
 	return OK;
 }
 
@@ -152,70 +146,36 @@ Error PCKPacker::flush(bool p_verbose) {
 
 	int64_t file_base_ofs = file->get_position();
 	file->store_64(0); // files base
+	file->store_64(0); // index offset
+	file->store_64(0); // index size
 
 	for (int i = 0; i < 16; i++) {
 		file->store_32(0); // reserved
 	}
 
-	// write the index
 	file->store_32(files.size());
 
-	Ref<FileAccessEncrypted> fae;
-	Ref<FileAccess> fhead = file;
-
-	if (enc_dir) {
-		fae.instantiate();
-		ERR_FAIL_COND_V(fae.is_null(), ERR_CANT_CREATE);
-
-		Error err = fae->open_and_parse(file, key, FileAccessEncrypted::MODE_WRITE_AES256, false);
-		ERR_FAIL_COND_V(err != OK, ERR_CANT_CREATE);
-
-		fhead = fae;
-	}
-
-	for (int i = 0; i < files.size(); i++) {
-		int string_len = files[i].path.utf8().length();
-		int pad = _get_pad(4, string_len);
-
-		fhead->store_32(string_len + pad);
-		fhead->store_buffer((const uint8_t *)files[i].path.utf8().get_data(), string_len);
-		for (int j = 0; j < pad; j++) {
-			fhead->store_8(0);
-		}
-
-		fhead->store_64(files[i].ofs);
-		fhead->store_64(files[i].size); // pay attention here, this is where file is
-		fhead->store_buffer(files[i].md5.ptr(), 16); //also save md5 for file
-
-		uint32_t flags = 0;
-		if (files[i].encrypted) {
-			flags |= PACK_FILE_ENCRYPTED;
-		}
-		fhead->store_32(flags);
-	}
-
-	if (fae.is_valid()) {
-		fhead.unref();
-		fae.unref();
-	}
-
 	int header_padding = _get_pad(alignment, file->get_position());
 	for (int i = 0; i < header_padding; i++) {
 		file->store_8(Math::rand() % 256);
 	}
 
 	int64_t file_base = file->get_position();
-	file->seek(file_base_ofs);
-	file->store_64(file_base); // update files base
-	file->seek(file_base);
 
 	const uint32_t buf_max = 65536;
 	uint8_t *buf = memnew_arr(uint8_t, buf_max);
 
+	Ref<FileAccessEncrypted> fae;
+	Vector<PackedData::IndexEntry> entries;
+	entries.resize(files.size());
+
 	int count = 0;
 	for (int i = 0; i < files.size(); i++) {
-		Ref<FileAccess> src = FileAccess::open(files[i].src_path, FileAccess::READ);
-		uint64_t to_write = files[i].size;
+		PackedData::IndexEntry &entry = entries.write[i];
+		entry.path = files[i].path;
+		entry.offset = file->get_position() - file_base;
+		entry.size = files[i].size;
+		memcpy(entry.md5, files[i].md5.ptr(), 16);
 
 		Ref<FileAccess> ftmp = file;
 		if (files[i].encrypted) {
@@ -225,12 +185,28 @@ Error PCKPacker::flush(bool p_verbose) {
 			Error err = fae->open_and_parse(file, key, FileAccessEncrypted::MODE_WRITE_AES256, false);
 			ERR_FAIL_COND_V(err != OK, ERR_CANT_CREATE);
 			ftmp = fae;
+			entry.flags |= PACK_FILE_ENCRYPTED;
 		}
 
-		while (to_write > 0) {
-			uint64_t read = src->get_buffer(buf, MIN(to_write, buf_max));
-			ftmp->store_buffer(buf, read);
-			to_write -= read;
+		if (files[i].compressed) {
+			// Compressed in blocks, so the file can still be seeked without decompressing all of it.
+			Ref<FileAccessCompressed> fac;
+			fac.instantiate();
+			fac->configure("GCPF");
+			Vector<uint8_t> data = FileAccess::get_file_as_array(files[i].src_path);
+			Vector<uint8_t> compressed = fac->compress_buffer(data.ptr(), data.size());
+			ERR_FAIL_COND_V_MSG(compressed.is_empty(), ERR_CANT_CREATE, "Can't compress file: " + files[i].src_path + ".");
+			ftmp->store_buffer(compressed.ptr(), compressed.size());
+			entry.size = compressed.size();
+			entry.flags |= PACK_FILE_COMPRESSED;
+		} else {
+			Ref<FileAccess> src = FileAccess::open(files[i].src_path, FileAccess::READ);
+			uint64_t to_write = files[i].size;
+			while (to_write > 0) {
+				uint64_t read = src->get_buffer(buf, MIN(to_write, buf_max));
+				ftmp->store_buffer(buf, read);
+				to_write -= read;
+			}
 		}
 
 		if (fae.is_valid()) {
@@ -250,6 +226,34 @@ Error PCKPacker::flush(bool p_verbose) {
 		}
 	}
 
+	// The index goes after the files, their final sizes are only known once stored.
+	int64_t index_offset = file->get_position();
+	Vector<uint8_t> index = PackedData::build_pack_index(entries);
+
+	Ref<FileAccess> fhead = file;
+	if (enc_dir) {
+		fae.instantiate();
+		ERR_FAIL_COND_V(fae.is_null(), ERR_CANT_CREATE);
+
+		Error err = fae->open_and_parse(file, key, FileAccessEncrypted::MODE_WRITE_AES256, false);
+		ERR_FAIL_COND_V(err != OK, ERR_CANT_CREATE);
+
+		fhead = fae;
+	}
+
+	fhead->store_buffer(index.ptr(), index.size());
+
+	if (fae.is_valid()) {
+		fhead.unref();
+		fae.unref();
+	}
+
+	file->seek(file_base_ofs);
+	file->store_64(file_base); // update files base
+	file->store_64(index_offset);
+	file->store_64(index.size());
+	file->seek_end();
+
 	if (p_verbose) {
 		printf("\n");
 	}
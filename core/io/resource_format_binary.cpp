@@ -91,6 +91,9 @@ enum {
 	FORMAT_VERSION = 4,
 	FORMAT_VERSION_CAN_RENAME_DEPS = 1,
 	FORMAT_VERSION_NO_NODEPATH_PROPERTY = 3,
+	// Packed arrays at least this big are copied out of the file's mapping when it has one,
+	// so only the pages that hold them are ever read from disk.
+	PACKED_ARRAY_BORROW_MIN_SIZE = 65536,
 };
 
 void ResourceLoaderBinary::_advance_padding(uint32_t p_len) {
@@ -102,6 +105,20 @@ void ResourceLoaderBinary::_advance_padding(uint32_t p_len) {
 	}
 }
 
+Error ResourceLoaderBinary::_read_packed(uint8_t *p_dst, uint64_t p_size) {
+	if (p_size >= PACKED_ARRAY_BORROW_MIN_SIZE) {
+		Ref<FileMapping> mapping;
+		const uint8_t *src = f->borrow_buffer(p_size, mapping);
+		if (src) {
+			memcpy(p_dst, src, p_size);
+			return OK;
+		}
+	}
+
+	ERR_FAIL_COND_V(f->get_buffer(p_dst, p_size) != p_size, ERR_FILE_CORRUPT);
+	return OK;
+}
+
 static Error read_reals(real_t *dst, Ref<FileAccess> &f, size_t count) {
 	if (f->real_is_double) {
 		if (sizeof(real_t) == 8) {
@@ -366,6 +383,18 @@ Error ResourceLoaderBinary::parse_variant(Variant &r_v) {
 						path += res_path + "::" + itos(index);
 					}
 
+					// Internal resources are materialized the first time they are referenced.
+					const int *resource_index = internal_path_index.getptr(path);
+					if (resource_index && !internal_resources[*resource_index].materialized) {
+						uint64_t pos = f->get_position();
+						Ref<Resource> res;
+						Error err = _load_internal_resource(*resource_index, res);
+						if (err != OK) {
+							return err;
+						}
+						f->seek(pos);
+					}
+
 					//always use internal cache for loading internal resources
 					if (!internal_index_cache.has(path)) {
 						WARN_PRINT(String("Couldn't load resource (no cache): " + path).utf8().get_data());
@@ -405,6 +434,13 @@ Error ResourceLoaderBinary::parse_variant(Variant &r_v) {
 						WARN_PRINT("Broken external resource! (index out of size)");
 						r_v = Variant();
 					} else {
+						if (!external_resources[erindex].requested) {
+							Error err = _request_external_resource(erindex);
+							if (err != OK) {
+								return err;
+							}
+						}
+
 						if (external_resources[erindex].cache.is_null()) {
 							//cache not here yet, wait for it?
 							if (use_sub_threads) {
@@ -473,7 +509,8 @@ Error ResourceLoaderBinary::parse_variant(Variant &r_v) {
 			Vector<uint8_t> array;
 			array.resize(len);
 			uint8_t *w = array.ptrw();
-			f->get_buffer(w, len);
+			Error err = _read_packed(w, len);
+			ERR_FAIL_COND_V(err != OK, err);
 			_advance_padding(len);
 
 			r_v = array;
@@ -485,7 +522,8 @@ Error ResourceLoaderBinary::parse_variant(Variant &r_v) {
 			Vector<int32_t> array;
 			array.resize(len);
 			int32_t *w = array.ptrw();
-			f->get_buffer((uint8_t *)w, len * sizeof(int32_t));
+			Error err = _read_packed((uint8_t *)w, len * sizeof(int32_t));
+			ERR_FAIL_COND_V(err != OK, err);
 #ifdef BIG_ENDIAN_ENABLED
 			{
 				uint32_t *ptr = (uint32_t *)w.ptr();
@@ -504,7 +542,8 @@ Error ResourceLoaderBinary::parse_variant(Variant &r_v) {
 			Vector<int64_t> array;
 			array.resize(len);
 			int64_t *w = array.ptrw();
-			f->get_buffer((uint8_t *)w, len * sizeof(int64_t));
+			Error err = _read_packed((uint8_t *)w, len * sizeof(int64_t));
+			ERR_FAIL_COND_V(err != OK, err);
 #ifdef BIG_ENDIAN_ENABLED
 			{
 				uint64_t *ptr = (uint64_t *)w.ptr();
@@ -523,7 +562,8 @@ Error ResourceLoaderBinary::parse_variant(Variant &r_v) {
 			Vector<float> array;
 			array.resize(len);
 			float *w = array.ptrw();
-			f->get_buffer((uint8_t *)w, len * sizeof(float));
+			Error err = _read_packed((uint8_t *)w, len * sizeof(float));
+			ERR_FAIL_COND_V(err != OK, err);
 #ifdef BIG_ENDIAN_ENABLED
 			{
 				uint32_t *ptr = (uint32_t *)w.ptr();
@@ -542,7 +582,8 @@ Error ResourceLoaderBinary::parse_variant(Variant &r_v) {
 			Vector<double> array;
 			array.resize(len);
 			double *w = array.ptrw();
-			f->get_buffer((uint8_t *)w, len * sizeof(double));
+			Error err = _read_packed((uint8_t *)w, len * sizeof(double));
+			ERR_FAIL_COND_V(err != OK, err);
 #ifdef BIG_ENDIAN_ENABLED
 			{
 				uint64_t *ptr = (uint64_t *)w.ptr();
@@ -601,7 +642,8 @@ Error ResourceLoaderBinary::parse_variant(Variant &r_v) {
 			Color *w = array.ptrw();
 			// Colors always use `float` even with double-precision support enabled
 			static_assert(sizeof(Color) == 4 * sizeof(float));
-			f->get_buffer((uint8_t *)w, len * sizeof(float) * 4);
+			Error err = _read_packed((uint8_t *)w, len * sizeof(float) * 4);
+			ERR_FAIL_COND_V(err != OK, err);
 #ifdef BIG_ENDIAN_ENABLED
 			{
 				uint32_t *ptr = (uint32_t *)w.ptr();
@@ -630,205 +672,278 @@ Ref<Resource> ResourceLoaderBinary::get_resource() {
 	return resource;
 }
 
-Error ResourceLoaderBinary::load() {
-	if (error != OK) {
-		return error;
-	}
+Error ResourceLoaderBinary::_request_external_resource(int p_index) {
+	ExtResource &er = external_resources.write[p_index];
+	er.requested = true;
 
-	for (int i = 0; i < external_resources.size(); i++) {
-		String path = external_resources[i].path;
+	if (!use_sub_threads) {
+		er.cache = ResourceLoader::load(er.path, er.type);
 
-		if (remaps.has(path)) {
-			path = remaps[path];
+		if (er.cache.is_null()) {
+			if (!ResourceLoader::get_abort_on_missing_resources()) {
+				ResourceLoader::notify_dependency_error(local_path, er.path, er.type);
+			} else {
+				error = ERR_FILE_MISSING_DEPENDENCIES;
+				ERR_FAIL_V_MSG(error, "Can't load dependency: " + er.path + ".");
+			}
 		}
 
-		if (!path.contains("://") && path.is_relative_path()) {
-			// path is relative to file being loaded, so convert to a resource path
-			path = ProjectSettings::get_singleton()->localize_path(path.get_base_dir().plus_file(external_resources[i].path));
+	} else {
+		Error err = ResourceLoader::load_threaded_request(er.path, er.type, use_sub_threads, ResourceFormatLoader::CACHE_MODE_REUSE, local_path);
+		if (err != OK) {
+			if (!ResourceLoader::get_abort_on_missing_resources()) {
+				ResourceLoader::notify_dependency_error(local_path, er.path, er.type);
+			} else {
+				error = ERR_FILE_MISSING_DEPENDENCIES;
+				ERR_FAIL_V_MSG(error, "Can't load dependency: " + er.path + ".");
+			}
 		}
+	}
 
-		external_resources.write[i].path = path; //remap happens here, not on load because on load it can actually be used for filesystem dock resource remap
-
-		if (!use_sub_threads) {
-			external_resources.write[i].cache = ResourceLoader::load(path, external_resources[i].type);
-
-			if (external_resources[i].cache.is_null()) {
-				if (!ResourceLoader::get_abort_on_missing_resources()) {
-					ResourceLoader::notify_dependency_error(local_path, path, external_resources[i].type);
-				} else {
-					error = ERR_FILE_MISSING_DEPENDENCIES;
-					ERR_FAIL_V_MSG(error, "Can't load dependency: " + path + ".");
-				}
-			}
+	return OK;
+}
 
-		} else {
-			Error err = ResourceLoader::load_threaded_request(path, external_resources[i].type, use_sub_threads, ResourceFormatLoader::CACHE_MODE_REUSE, local_path);
-			if (err != OK) {
-				if (!ResourceLoader::get_abort_on_missing_resources()) {
-					ResourceLoader::notify_dependency_error(local_path, path, external_resources[i].type);
-				} else {
-					error = ERR_FILE_MISSING_DEPENDENCIES;
-					ERR_FAIL_V_MSG(error, "Can't load dependency: " + path + ".");
-				}
+Error ResourceLoaderBinary::_load_internal_resource(int p_index, Ref<Resource> &r_res) {
+	bool main = p_index == (internal_resources.size() - 1);
+	internal_resources.write[p_index].materialized = true;
+
+	//maybe it is loaded already
+	String path;
+	String id;
+
+	if (!main) {
+		path = internal_resources[p_index].path;
+		id = internal_resources[p_index].id;
+
+		if (cache_mode == ResourceFormatLoader::CACHE_MODE_REUSE && ResourceCache::has(path)) {
+			Ref<Resource> cached = ResourceCache::get(path);
+			if (cached.is_valid()) {
+				//already loaded, don't do anything
+				error = OK;
+				internal_index_cache[path] = cached;
+				r_res = cached;
+				return OK;
 			}
 		}
+	} else {
+		if (cache_mode != ResourceFormatLoader::CACHE_MODE_IGNORE && !ResourceCache::has(res_path)) {
+			path = res_path;
+		}
 	}
 
-	for (int i = 0; i < internal_resources.size(); i++) {
-		bool main = i == (internal_resources.size() - 1);
+	uint64_t offset = internal_resources[p_index].offset;
 
-		//maybe it is loaded already
-		String path;
-		String id;
+	f->seek(offset);
 
-		if (!main) {
-			path = internal_resources[i].path;
+	String t = get_unicode_string();
 
-			if (path.begins_with("local://")) {
-				path = path.replace_first("local://", "");
-				id = path;
-				path = res_path + "::" + path;
+	Ref<Resource> res;
 
-				internal_resources.write[i].path = path; // Update path.
-			}
+	if (cache_mode == ResourceFormatLoader::CACHE_MODE_REPLACE && ResourceCache::has(path)) {
+		//use the existing one
+		Resource *r = ResourceCache::get(path);
+		if (r->get_class() == t) {
+			r->reset_state();
+			res = Ref<Resource>(r);
+		}
+	}
 
-			if (cache_mode == ResourceFormatLoader::CACHE_MODE_REUSE && ResourceCache::has(path)) {
-				Ref<Resource> cached = ResourceCache::get(path);
-				if (cached.is_valid()) {
-					//already loaded, don't do anything
-					error = OK;
-					internal_index_cache[path] = cached;
-					continue;
-				}
-			}
-		} else {
-			if (cache_mode != ResourceFormatLoader::CACHE_MODE_IGNORE && !ResourceCache::has(res_path)) {
-				path = res_path;
+	MissingResource *missing_resource = nullptr;
+
+	if (res.is_null()) {
+		//did not replace
+
+		Object *obj = ClassDB::instantiate(t);
+		if (!obj) {
+			if (ResourceLoader::is_creating_missing_resources_if_class_unavailable_enabled()) {
+				//create a missing resource
+				missing_resource = memnew(MissingResource);
+				missing_resource->set_original_class(t);
+				missing_resource->set_recording_properties(true);
+				obj = missing_resource;
+			} else {
+				error = ERR_FILE_CORRUPT;
+				ERR_FAIL_V_MSG(ERR_FILE_CORRUPT, local_path + ":Resource of unrecognized type in file: " + t + ".");
 			}
 		}
 
-		uint64_t offset = internal_resources[i].offset;
+		Resource *r = Object::cast_to<Resource>(obj);
+		if (!r) {
+			String obj_class = obj->get_class();
+			error = ERR_FILE_CORRUPT;
+			memdelete(obj); //bye
+			ERR_FAIL_V_MSG(ERR_FILE_CORRUPT, local_path + ":Resource type in resource field not a resource, type is: " + obj_class + ".");
+		}
 
-		f->seek(offset);
+		res = Ref<Resource>(r);
+		if (!path.is_empty() && cache_mode != ResourceFormatLoader::CACHE_MODE_IGNORE) {
+			r->set_path(path, cache_mode == ResourceFormatLoader::CACHE_MODE_REPLACE); //if got here because the resource with same path has different type, replace it
+		}
+		r->set_scene_unique_id(id);
+	}
 
-		String t = get_unicode_string();
+	if (!main) {
+		internal_index_cache[path] = res;
+	}
 
-		Ref<Resource> res;
+	int pc = f->get_32();
 
-		if (cache_mode == ResourceFormatLoader::CACHE_MODE_REPLACE && ResourceCache::has(path)) {
-			//use the existing one
-			Resource *r = ResourceCache::get(path);
-			if (r->get_class() == t) {
-				r->reset_state();
-				res = Ref<Resource>(r);
-			}
-		}
+	//set properties
 
-		MissingResource *missing_resource = nullptr;
+	Dictionary missing_resource_properties;
 
-		if (res.is_null()) {
-			//did not replace
+	for (int j = 0; j < pc; j++) {
+		StringName name = _get_string();
 
-			Object *obj = ClassDB::instantiate(t);
-			if (!obj) {
-				if (ResourceLoader::is_creating_missing_resources_if_class_unavailable_enabled()) {
-					//create a missing resource
-					missing_resource = memnew(MissingResource);
-					missing_resource->set_original_class(t);
-					missing_resource->set_recording_properties(true);
-					obj = missing_resource;
-				} else {
-					error = ERR_FILE_CORRUPT;
-					ERR_FAIL_V_MSG(ERR_FILE_CORRUPT, local_path + ":Resource of unrecognized type in file: " + t + ".");
-				}
-			}
+		if (name == StringName()) {
+			error = ERR_FILE_CORRUPT;
+			ERR_FAIL_V(ERR_FILE_CORRUPT);
+		}
 
-			Resource *r = Object::cast_to<Resource>(obj);
-			if (!r) {
-				String obj_class = obj->get_class();
-				error = ERR_FILE_CORRUPT;
-				memdelete(obj); //bye
-				ERR_FAIL_V_MSG(ERR_FILE_CORRUPT, local_path + ":Resource type in resource field not a resource, type is: " + obj_class + ".");
-			}
+		Variant value;
 
-			res = Ref<Resource>(r);
-			if (!path.is_empty() && cache_mode != ResourceFormatLoader::CACHE_MODE_IGNORE) {
-				r->set_path(path, cache_mode == ResourceFormatLoader::CACHE_MODE_REPLACE); //if got here because the resource with same path has different type, replace it
+		error = parse_variant(value);
+		if (error) {
+			return error;
+		}
+
+		bool set_valid = true;
+		if (value.get_type() == Variant::OBJECT && missing_resource != nullptr) {
+			// If the property being set is a missing resource (and the parent is not),
+			// then setting it will most likely not work.
+			// Instead, save it as metadata.
+
+			Ref<MissingResource> mr = value;
+			if (mr.is_valid()) {
+				missing_resource_properties[name] = mr;
+				set_valid = false;
 			}
-			r->set_scene_unique_id(id);
 		}
 
-		if (!main) {
-			internal_index_cache[path] = res;
+		if (set_valid) {
+			res->set(name, value);
 		}
+	}
 
-		int pc = f->get_32();
+	if (missing_resource) {
+		missing_resource->set_recording_properties(false);
+	}
 
-		//set properties
+	if (!missing_resource_properties.is_empty()) {
+		res->set_meta(META_MISSING_RESOURCES, missing_resource_properties);
+	}
 
-		Dictionary missing_resource_properties;
+#ifdef TOOLS_ENABLED
+	res->set_edited(false);
+#endif
 
-		for (int j = 0; j < pc; j++) {
-			StringName name = _get_string();
+	materialized_count++;
+	if (progress) {
+		*progress = main ? 1.0 : materialized_count / float(internal_resources.size());
+	}
 
-			if (name == StringName()) {
-				error = ERR_FILE_CORRUPT;
-				ERR_FAIL_V(ERR_FILE_CORRUPT);
-			}
+	resource_cache.push_back(res);
+	r_res = res;
 
-			Variant value;
+	return OK;
+}
 
-			error = parse_variant(value);
-			if (error) {
-				return error;
-			}
+Error ResourceLoaderBinary::load() {
+	if (error != OK) {
+		return error;
+	}
 
-			bool set_valid = true;
-			if (value.get_type() == Variant::OBJECT && missing_resource != nullptr) {
-				// If the property being set is a missing resource (and the parent is not),
-				// then setting it will most likely not work.
-				// Instead, save it as metadata.
+	for (int i = 0; i < external_resources.size(); i++) {
+		String path = external_resources[i].path;
 
-				Ref<MissingResource> mr = value;
-				if (mr.is_valid()) {
-					missing_resource_properties[name] = mr;
-					set_valid = false;
-				}
-			}
+		if (remaps.has(path)) {
+			path = remaps[path];
+		}
 
-			if (set_valid) {
-				res->set(name, value);
+		if (!path.contains("://") && path.is_relative_path()) {
+			// path is relative to file being loaded, so convert to a resource path
+			path = ProjectSettings::get_singleton()->localize_path(path.get_base_dir().plus_file(external_resources[i].path));
+		}
+
+		external_resources.write[i].path = path; //remap happens here, not on load because on load it can actually be used for filesystem dock resource remap
+
+		// When a single sub-resource is requested, dependencies are only loaded once it references them.
+		if (sub_resource_id.is_empty()) {
+			error = _request_external_resource(i);
+			if (error != OK) {
+				return error;
 			}
 		}
+	}
+
+	if (internal_resources.is_empty()) {
+		return ERR_FILE_EOF;
+	}
+
+	int main_index = internal_resources.size() - 1;
+	int sub_resource_index = -1;
 
-		if (missing_resource) {
-			missing_resource->set_recording_properties(false);
+	for (int i = 0; i < main_index; i++) {
+		String path = internal_resources[i].path;
+
+		if (path.begins_with("local://")) {
+			path = path.replace_first("local://", "");
+			internal_resources.write[i].id = path;
+			path = res_path + "::" + path;
+
+			internal_resources.write[i].path = path; // Update path.
 		}
 
-		if (!missing_resource_properties.is_empty()) {
-			res->set_meta(META_MISSING_RESOURCES, missing_resource_properties);
+		internal_path_index[path] = i;
+		if (!sub_resource_id.is_empty() && internal_resources[i].id == sub_resource_id) {
+			sub_resource_index = i;
 		}
+	}
 
-#ifdef TOOLS_ENABLED
-		res->set_edited(false);
-#endif
+	// Internal resources are materialized from the index as parse_variant() reaches them.
+	// Loading a single sub-resource, or loading without the cache, only reads what is referenced.
+	Ref<Resource> res;
 
-		if (progress) {
-			*progress = (i + 1) / float(internal_resources.size());
+	if (!sub_resource_id.is_empty()) {
+		if (sub_resource_index == -1) {
+			error = ERR_DOES_NOT_EXIST;
+			ERR_FAIL_V_MSG(error, local_path + ": No sub-resource with ID: " + sub_resource_id + ".");
 		}
 
-		resource_cache.push_back(res);
+		error = _load_internal_resource(sub_resource_index, res);
+		if (error != OK) {
+			return error;
+		}
 
-		if (main) {
-			f.unref();
-			resource = res;
-			resource->set_as_translation_remapped(translation_remapped);
-			error = OK;
-			return OK;
+		f.unref();
+		resource = res;
+		return OK;
+	}
+
+	if (cache_mode != ResourceFormatLoader::CACHE_MODE_IGNORE) {
+		// Resources nothing references are still registered in the cache as "path::id",
+		// so they stay reachable by path like when the whole file is loaded in order.
+		for (int i = 0; i < main_index; i++) {
+			if (internal_resources[i].materialized) {
+				continue;
+			}
+
+			error = _load_internal_resource(i, res);
+			if (error != OK) {
+				return error;
+			}
 		}
 	}
 
-	return ERR_FILE_EOF;
+	error = _load_internal_resource(main_index, res);
+	if (error != OK) {
+		return error;
+	}
+
+	f.unref();
+	resource = res;
+	resource->set_as_translation_remapped(translation_remapped);
+	return OK;
 }
 
 void ResourceLoaderBinary::set_translation_remapped(bool p_remapped) {
@@ -1088,6 +1203,36 @@ Ref<Resource> ResourceFormatLoaderBinary::load(const String &p_path, const Strin
 	return loader.resource;
 }
 
+Ref<Resource> ResourceFormatLoaderBinary::load_sub_resource(const String &p_path, const String &p_original_path, const String &p_id, Error *r_error, CacheMode p_cache_mode) {
+	if (r_error) {
+		*r_error = ERR_FILE_CANT_OPEN;
+	}
+
+	Error err;
+	Ref<FileAccess> f = FileAccess::open(p_path, FileAccess::READ, &err);
+
+	ERR_FAIL_COND_V_MSG(err != OK, Ref<Resource>(), "Cannot open file '" + p_path + "'.");
+
+	ResourceLoaderBinary loader;
+	loader.cache_mode = p_cache_mode;
+	loader.sub_resource_id = p_id;
+	String path = !p_original_path.is_empty() ? p_original_path : p_path;
+	loader.local_path = ProjectSettings::get_singleton()->localize_path(path);
+	loader.res_path = loader.local_path;
+	loader.open(f);
+
+	err = loader.load();
+
+	if (r_error) {
+		*r_error = err;
+	}
+
+	if (err) {
+		return Ref<Resource>();
+	}
+	return loader.resource;
+}
+
 void ResourceFormatLoaderBinary::get_recognized_extensions_for_type(const String &p_type, List<String> *p_extensions) const {
 	if (p_type.is_empty()) {
 		get_recognized_extensions(p_extensions);
@@ -61,6 +61,7 @@ class ResourceLoaderBinary {
 		String type;
 		ResourceUID::ID uid = ResourceUID::INVALID_ID;
 		Ref<Resource> cache;
+		bool requested = false;
 	};
 
 	bool using_named_scene_ids = false;
@@ -71,14 +72,20 @@ class ResourceLoaderBinary {
 
 	struct IntResource {
 		String path;
+		String id;
 		uint64_t offset;
+		bool materialized = false;
 	};
 
 	Vector<IntResource> internal_resources;
 	Map<String, Ref<Resource>> internal_index_cache;
+	HashMap<String, int> internal_path_index;
+	String sub_resource_id;
+	int materialized_count = 0;
 
 	String get_unicode_string();
 	void _advance_padding(uint32_t p_len);
+	Error _read_packed(uint8_t *p_dst, uint64_t p_size);
 
 	Map<String, String> remaps;
 	Error error = OK;
@@ -89,6 +96,9 @@ class ResourceLoaderBinary {
 
 	Error parse_variant(Variant &r_v);
 
+	Error _request_external_resource(int p_index);
+	Error _load_internal_resource(int p_index, Ref<Resource> &r_res);
+
 	Map<String, Ref<Resource>> dependency_cache;
 
 public:
@@ -115,6 +125,7 @@ public:
 	virtual ResourceUID::ID get_resource_uid(const String &p_path) const;
 	virtual void get_dependencies(const String &p_path, List<String> *p_dependencies, bool p_add_types = false);
 	virtual Error rename_dependencies(const String &p_path, const Map<String, String> &p_map);
+	virtual Ref<Resource> load_sub_resource(const String &p_path, const String &p_original_path, const String &p_id, Error *r_error = nullptr, CacheMode p_cache_mode = CACHE_MODE_REUSE);
 };
 
 class ResourceFormatSaverBinaryInstance {
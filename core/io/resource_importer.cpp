@@ -138,6 +138,21 @@ Ref<Resource> ResourceFormatImporter::load(const String &p_path, const String &p
 	return res;
 }
 
+Ref<Resource> ResourceFormatImporter::load_sub_resource(const String &p_path, const String &p_original_path, const String &p_id, Error *r_error, CacheMode p_cache_mode) {
+	PathAndType pat;
+	Error err = _get_path_and_type(p_path, pat);
+
+	if (err != OK) {
+		if (r_error) {
+			*r_error = err;
+		}
+
+		return Ref<Resource>();
+	}
+
+	return ResourceLoader::_load_sub_resource(pat.path, p_path, p_id, p_cache_mode, r_error);
+}
+
 void ResourceFormatImporter::get_recognized_extensions(List<String> *p_extensions) const {
 	Set<String> found;
 
@@ -168,6 +168,14 @@ Error ResourceFormatLoader::rename_dependencies(const String &p_path, const Map<
 	return OK;
 }
 
+Ref<Resource> ResourceFormatLoader::load_sub_resource(const String &p_path, const String &p_original_path, const String &p_id, Error *r_error, CacheMode p_cache_mode) {
+	// Formats that can't read a single sub-resource leave it to the next loader.
+	if (r_error) {
+		*r_error = ERR_UNAVAILABLE;
+	}
+	return Ref<Resource>();
+}
+
 void ResourceFormatLoader::_bind_methods() {
 	BIND_ENUM_CONSTANT(CACHE_MODE_IGNORE);
 	BIND_ENUM_CONSTANT(CACHE_MODE_REUSE);
@@ -213,16 +221,76 @@ Ref<Resource> ResourceLoader::_load(const String &p_path, const String &p_origin
 	ERR_FAIL_V_MSG(Ref<Resource>(), "No loader found for resource: " + p_path + ".");
 }
 
+Ref<Resource> ResourceLoader::_load_sub_resource(const String &p_path, const String &p_original_path, const String &p_id, ResourceFormatLoader::CacheMode p_cache_mode, Error *r_error) {
+	Error err = ERR_UNAVAILABLE;
+
+	for (int i = 0; i < loader_count; i++) {
+		if (!loader[i]->recognize_path(p_path)) {
+			continue;
+		}
+		Ref<Resource> res = loader[i]->load_sub_resource(p_path, p_original_path, p_id, &err, p_cache_mode);
+		if (err == ERR_UNAVAILABLE) {
+			continue;
+		}
+
+		if (r_error) {
+			*r_error = err;
+		}
+		return res;
+	}
+
+	if (r_error) {
+		*r_error = err;
+	}
+	ERR_FAIL_V_MSG(Ref<Resource>(), "No loader can load sub-resources from: " + p_path + ".");
+}
+
+void ResourceLoader::_prefetch_dependencies(ThreadLoadTask &p_load_task) {
+	// Request the dependencies before the loader gets to them, so the whole tree starts loading
+	// right away on the worker pool, also for loaders that would load them one after another.
+	// They use the cache as the resource requiring them does, the loader takes over these requests.
+	List<String> dependencies;
+	get_dependencies(p_load_task.local_path, &dependencies, true);
+
+	for (const String &E : dependencies) {
+		String path = E.get_slice("::", 0);
+		String type = E.get_slice("::", 1);
+		if (path.is_relative_path()) {
+			continue; // Relative paths are resolved by the loader.
+		}
+		_load_threaded_request(path, type, true, p_load_task.cache_mode, p_load_task.local_path, true);
+	}
+}
+
+void ResourceLoader::_load_task_finished(void *p_userdata) {
+	// Nothing to do, only waited on for the load task it depends on.
+}
+
 void ResourceLoader::_thread_load_function(void *p_userdata) {
 	ThreadLoadTask &load_task = *(ThreadLoadTask *)p_userdata;
 	load_task.loader_id = Thread::get_caller_id();
 
-	if (load_task.semaphore) {
-		//this is an actual thread, so wait for Ok from semaphore
-		thread_load_semaphore->wait(); //wait until its ok to start loading
+	print_lt("START: " + load_task.local_path);
+
+	if (load_task.use_sub_threads) {
+		_prefetch_dependencies(load_task);
 	}
+
 	load_task.resource = _load(load_task.remapped_path, load_task.remapped_path != load_task.local_path ? load_task.local_path : String(), load_task.type_hint, load_task.cache_mode, &load_task.error, load_task.use_sub_threads, &load_task.progress);
 
+	// Release the prefetched dependencies the loader didn't ask for.
+	thread_load_mutex->lock();
+	Vector<String> unclaimed;
+	for (Set<String>::Element *E = load_task.prefetched_tasks.front(); E; E = E->next()) {
+		unclaimed.push_back(E->get());
+	}
+	load_task.prefetched_tasks.clear();
+	thread_load_mutex->unlock();
+
+	for (int i = 0; i < unclaimed.size(); i++) {
+		load_threaded_get(unclaimed[i]);
+	}
+
 	load_task.progress = 1.0; //it was fully loaded at this point, so force progress to 1.0
 
 	thread_load_mutex->lock();
@@ -231,26 +299,13 @@ void ResourceLoader::_thread_load_function(void *p_userdata) {
 	} else {
 		load_task.status = THREAD_LOAD_LOADED;
 	}
-	if (load_task.semaphore) {
-		if (load_task.start_next && thread_waiting_count > 0) {
-			thread_waiting_count--;
-			//thread loading count remains constant, this ends but another one begins
-			thread_load_semaphore->post();
-		} else {
-			thread_loading_count--; //no threads waiting, just reduce loading count
-		}
-
-		print_lt("END: load count: " + itos(thread_loading_count) + " / wait count: " + itos(thread_waiting_count) + " / suspended count: " + itos(thread_suspended_count) + " / active: " + itos(thread_loading_count - thread_suspended_count));
 
-		for (int i = 0; i < load_task.poll_requests; i++) {
-			load_task.semaphore->post();
-		}
-		memdelete(load_task.semaphore);
-		load_task.semaphore = nullptr;
-	}
+	print_lt("END: " + load_task.local_path);
 
 	if (load_task.resource.is_valid()) {
-		load_task.resource->set_path(load_task.local_path);
+		if (load_task.cache_mode != ResourceFormatLoader::CACHE_MODE_IGNORE) {
+			load_task.resource->set_path(load_task.local_path, load_task.cache_mode == ResourceFormatLoader::CACHE_MODE_REPLACE);
+		}
 
 		if (load_task.xl_remapped) {
 			load_task.resource->set_as_translation_remapped(true);
@@ -271,6 +326,7 @@ void ResourceLoader::_thread_load_function(void *p_userdata) {
 		}
 	}
 
+	thread_load_condition->notify_all();
 	thread_load_mutex->unlock();
 }
 
@@ -285,6 +341,10 @@ static String _validate_local_path(const String &p_path) {
 	}
 }
 Error ResourceLoader::load_threaded_request(const String &p_path, const String &p_type_hint, bool p_use_sub_threads, ResourceFormatLoader::CacheMode p_cache_mode, const String &p_source_resource) {
+	return _load_threaded_request(p_path, p_type_hint, p_use_sub_threads, p_cache_mode, p_source_resource, false);
+}
+
+Error ResourceLoader::_load_threaded_request(const String &p_path, const String &p_type_hint, bool p_use_sub_threads, ResourceFormatLoader::CacheMode p_cache_mode, const String &p_source_resource, bool p_prefetch) {
 	String local_path = _validate_local_path(p_path);
 
 	thread_load_mutex->lock();
@@ -301,6 +361,20 @@ Error ResourceLoader::load_threaded_request(const String &p_path, const String &
 			ERR_FAIL_V_MSG(ERR_INVALID_PARAMETER, "Threading loading resource'" + local_path + " failed: Source specified: '" + p_source_resource + "' but was not called by it.");
 		}
 
+		ThreadLoadTask &source_task = thread_load_tasks[p_source_resource];
+		if (p_prefetch) {
+			// Something already loading it is enough, also avoids prefetching through dependency cycles.
+			if (thread_load_tasks.has(local_path) || source_task.sub_tasks.has(local_path) || source_task.prefetched_tasks.has(local_path)) {
+				thread_load_mutex->unlock();
+				return OK;
+			}
+		} else if (source_task.prefetched_tasks.erase(local_path)) {
+			// Already requested for this source ahead of time, the loader takes over that request.
+			source_task.sub_tasks.insert(local_path);
+			thread_load_mutex->unlock();
+			return OK;
+		}
+
 		//must not be already added as s sub tasks
 		if (thread_load_tasks[p_source_resource].sub_tasks.has(local_path)) {
 			thread_load_mutex->unlock();
@@ -311,7 +385,11 @@ Error ResourceLoader::load_threaded_request(const String &p_path, const String &
 	if (thread_load_tasks.has(local_path)) {
 		thread_load_tasks[local_path].requests++;
 		if (!p_source_resource.is_empty()) {
-			thread_load_tasks[p_source_resource].sub_tasks.insert(local_path);
+			if (p_prefetch) {
+				thread_load_tasks[p_source_resource].prefetched_tasks.insert(local_path);
+			} else {
+				thread_load_tasks[p_source_resource].sub_tasks.insert(local_path);
+			}
 		}
 		thread_load_mutex->unlock();
 		return OK;
@@ -329,7 +407,7 @@ Error ResourceLoader::load_threaded_request(const String &p_path, const String &
 		load_task.cache_mode = p_cache_mode;
 		load_task.use_sub_threads = p_use_sub_threads;
 
-		{ //must check if resource is already loaded before attempting to load it in a thread
+		if (p_cache_mode != ResourceFormatLoader::CACHE_MODE_IGNORE) { //must check if resource is already loaded before attempting to load it in a thread
 
 			if (load_task.loader_id == Thread::get_caller_id()) {
 				thread_load_mutex->unlock();
@@ -355,7 +433,11 @@ Error ResourceLoader::load_threaded_request(const String &p_path, const String &
 		}
 
 		if (!p_source_resource.is_empty()) {
-			thread_load_tasks[p_source_resource].sub_tasks.insert(local_path);
+			if (p_prefetch) {
+				thread_load_tasks[p_source_resource].prefetched_tasks.insert(local_path);
+			} else {
+				thread_load_tasks[p_source_resource].sub_tasks.insert(local_path);
+			}
 		}
 
 		thread_load_tasks[local_path] = load_task;
@@ -365,19 +447,10 @@ Error ResourceLoader::load_threaded_request(const String &p_path, const String &
 
 	if (load_task.resource.is_null()) { //needs to be loaded in thread
 
-		load_task.semaphore = memnew(Semaphore);
-		if (thread_loading_count < thread_load_max) {
-			thread_loading_count++;
-			thread_load_semaphore->post(); //we have free threads, so allow one
-		} else {
-			thread_waiting_count++;
-		}
+		print_lt("REQUEST: " + local_path);
 
-		print_lt("REQUEST: load count: " + itos(thread_loading_count) + " / wait count: " + itos(thread_waiting_count) + " / suspended count: " + itos(thread_suspended_count) + " / active: " + itos(thread_loading_count - thread_suspended_count));
-
-		load_task.thread = memnew(Thread);
-		load_task.thread->start(_thread_load_function, &thread_load_tasks[local_path]);
-		load_task.loader_id = load_task.thread->get_id();
+		// Tasks live in the map until their last request is gotten, so the pointer stays valid.
+		load_task.task_id = WorkerThreadPool::get_singleton()->add_native_task(_thread_load_function, &thread_load_tasks[local_path]);
 	}
 
 	thread_load_mutex->unlock();
@@ -385,25 +458,26 @@ Error ResourceLoader::load_threaded_request(const String &p_path, const String &
 	return OK;
 }
 
-float ResourceLoader::_dependency_get_progress(const String &p_path) {
-	if (thread_load_tasks.has(p_path)) {
-		ThreadLoadTask &load_task = thread_load_tasks[p_path];
-		int dep_count = load_task.sub_tasks.size();
-		if (dep_count > 0) {
-			float dep_progress = 0;
-			for (Set<String>::Element *E = load_task.sub_tasks.front(); E; E = E->next()) {
-				dep_progress += _dependency_get_progress(E->get());
-			}
-			dep_progress /= float(dep_count);
-			dep_progress *= 0.5;
-			dep_progress += load_task.progress * 0.5;
-			return dep_progress;
-		} else {
-			return load_task.progress;
-		}
+void ResourceLoader::_dependency_get_progress(const String &p_path, Set<String> &r_visited, float &r_progress, int &r_count) {
+	// Every resource in the tree weighs the same, and shared dependencies are only counted once.
+	if (r_visited.has(p_path)) {
+		return;
+	}
+	r_visited.insert(p_path);
+	r_count++;
 
-	} else {
-		return 1.0; //assume finished loading it so it no longer exists
+	const ThreadLoadTask *load_task = thread_load_tasks.getptr(p_path);
+	if (!load_task) {
+		r_progress += 1.0; //assume finished loading it so it no longer exists
+		return;
+	}
+
+	r_progress += load_task->progress;
+	for (const Set<String>::Element *E = load_task->sub_tasks.front(); E; E = E->next()) {
+		_dependency_get_progress(E->get(), r_visited, r_progress, r_count);
+	}
+	for (const Set<String>::Element *E = load_task->prefetched_tasks.front(); E; E = E->next()) {
+		_dependency_get_progress(E->get(), r_visited, r_progress, r_count);
 	}
 }
 
@@ -419,7 +493,13 @@ ResourceLoader::ThreadLoadStatus ResourceLoader::load_threaded_get_status(const
 	ThreadLoadStatus status;
 	status = load_task.status;
 	if (r_progress) {
-		*r_progress = _dependency_get_progress(local_path);
+		Set<String> visited;
+		float progress = 0.0;
+		int count = 0;
+		_dependency_get_progress(local_path, visited, progress, count);
+		// Dependencies are discovered while loading, don't let that make the progress go back.
+		load_task.reported_progress = MAX(load_task.reported_progress, progress / count);
+		*r_progress = load_task.reported_progress;
 	}
 
 	thread_load_mutex->unlock();
@@ -441,40 +521,18 @@ Ref<Resource> ResourceLoader::load_threaded_get(const String &p_path, Error *r_e
 
 	ThreadLoadTask &load_task = thread_load_tasks[local_path];
 
-	//semaphore still exists, meaning it's still loading, request poll
-	Semaphore *semaphore = load_task.semaphore;
-	if (semaphore) {
-		load_task.poll_requests++;
-
-		{
-			// As we got a semaphore, this means we are going to have to wait
-			// until the sub-resource is done loading
-			//
-			// As this thread will become 'blocked' we should "exchange" its
-			// active status with a waiting one, to ensure load continues.
-			//
-			// This ensures loading is never blocked and that is also within
-			// the maximum number of active threads.
-
-			if (thread_waiting_count > 0) {
-				thread_waiting_count--;
-				thread_loading_count++;
-				thread_load_semaphore->post();
-
-				load_task.start_next = false; //do not start next since we are doing it here
-			}
-
-			thread_suspended_count++;
+	if (load_task.task_id != WorkerThreadPool::INVALID_TASK_ID && !load_task.awaited) {
+		// The first caller waits on the pool task, which keeps running other loads
+		// meanwhile if this is called from a pool thread.
+		load_task.awaited = true;
+		WorkerThreadPool::TaskID task_id = load_task.task_id;
 
-			print_lt("GET: load count: " + itos(thread_loading_count) + " / wait count: " + itos(thread_waiting_count) + " / suspended count: " + itos(thread_suspended_count) + " / active: " + itos(thread_loading_count - thread_suspended_count));
-		}
+		print_lt("GET: " + local_path);
 
 		thread_load_mutex->unlock();
-		semaphore->wait();
+		WorkerThreadPool::get_singleton()->wait_for_task_completion(task_id);
 		thread_load_mutex->lock();
 
-		thread_suspended_count--;
-
 		if (!thread_load_tasks.has(local_path)) { //may have been erased during unlock and this was always an invalid call
 			thread_load_mutex->unlock();
 			if (r_error) {
@@ -482,6 +540,23 @@ Ref<Resource> ResourceLoader::load_threaded_get(const String &p_path, Error *r_e
 			}
 			return Ref<Resource>();
 		}
+	} else {
+		if (load_task.task_id != WorkerThreadPool::INVALID_TASK_ID && load_task.status == THREAD_LOAD_IN_PROGRESS) {
+			// Someone else is waiting on the pool task already. Wait on a task depending on it
+			// instead, so pool threads keep running other jobs (maybe the very dependency the
+			// load is waiting for) rather than sleeping.
+			Vector<WorkerThreadPool::TaskID> dependencies;
+			dependencies.push_back(load_task.task_id);
+			WorkerThreadPool::TaskID wait_id = WorkerThreadPool::get_singleton()->add_native_task(_load_task_finished, nullptr, dependencies);
+
+			thread_load_mutex->unlock();
+			WorkerThreadPool::get_singleton()->wait_for_task_completion(wait_id);
+			thread_load_mutex->lock();
+		}
+		// Loads run on the thread requesting them report back through the condition.
+		while (load_task.status == THREAD_LOAD_IN_PROGRESS) {
+			thread_load_condition->wait(*thread_load_mutex);
+		}
 	}
 
 	Ref<Resource> resource = load_task.resource;
@@ -492,10 +567,6 @@ Ref<Resource> ResourceLoader::load_threaded_get(const String &p_path, Error *r_e
 	load_task.requests--;
 
 	if (load_task.requests == 0) {
-		if (load_task.thread) { //thread may not have been used
-			load_task.thread->wait_to_finish();
-			memdelete(load_task.thread);
-		}
 		thread_load_tasks.erase(local_path);
 	}
 
@@ -605,6 +676,29 @@ Ref<Resource> ResourceLoader::load(const String &p_path, const String &p_type_hi
 	}
 }
 
+Ref<Resource> ResourceLoader::load_sub_resource(const String &p_path, const String &p_id, ResourceFormatLoader::CacheMode p_cache_mode, Error *r_error) {
+	if (r_error) {
+		*r_error = ERR_CANT_OPEN;
+	}
+
+	String local_path = _validate_local_path(p_path);
+
+	if (p_cache_mode == ResourceFormatLoader::CACHE_MODE_REUSE) {
+		Ref<Resource> cached = ResourceCache::get(local_path + "::" + p_id);
+		if (cached.is_valid()) {
+			if (r_error) {
+				*r_error = OK;
+			}
+			return cached;
+		}
+	}
+
+	String path = _path_remap(local_path);
+	ERR_FAIL_COND_V_MSG(path.is_empty(), Ref<Resource>(), "Remapping '" + local_path + "' failed.");
+
+	return _load_sub_resource(path, local_path, p_id, p_cache_mode, r_error);
+}
+
 bool ResourceLoader::exists(const String &p_path, const String &p_type_hint) {
 	String local_path = _validate_local_path(p_path);
 
@@ -1016,16 +1110,12 @@ void ResourceLoader::remove_custom_loaders() {
 
 void ResourceLoader::initialize() {
 	thread_load_mutex = memnew(Mutex);
-	thread_load_max = OS::get_singleton()->get_processor_count();
-	thread_loading_count = 0;
-	thread_waiting_count = 0;
-	thread_suspended_count = 0;
-	thread_load_semaphore = memnew(Semaphore);
+	thread_load_condition = memnew(ConditionVariable);
 }
 
 void ResourceLoader::finalize() {
 	memdelete(thread_load_mutex);
-	memdelete(thread_load_semaphore);
+	memdelete(thread_load_condition);
 }
 
 ResourceLoadErrorNotify ResourceLoader::err_notify = nullptr;
@@ -1039,13 +1129,8 @@ bool ResourceLoader::abort_on_missing_resource = true;
 bool ResourceLoader::timestamp_on_load = false;
 
 Mutex *ResourceLoader::thread_load_mutex = nullptr;
+ConditionVariable *ResourceLoader::thread_load_condition = nullptr;
 HashMap<String, ResourceLoader::ThreadLoadTask> ResourceLoader::thread_load_tasks;
-Semaphore *ResourceLoader::thread_load_semaphore = nullptr;
-
-int ResourceLoader::thread_loading_count = 0;
-int ResourceLoader::thread_waiting_count = 0;
-int ResourceLoader::thread_suspended_count = 0;
-int ResourceLoader::thread_load_max = 0;
 
 SelfList<Resource>::List ResourceLoader::remapped_list;
 HashMap<String, Vector<String>> ResourceLoader::translation_remaps;
@@ -34,8 +34,9 @@
 #include "core/io/resource.h"
 #include "core/object/gdvirtual.gen.inc"
 #include "core/object/script_language.h"
-#include "core/os/semaphore.h"
+#include "core/os/condition_variable.h"
 #include "core/os/thread.h"
+#include "core/os/worker_thread_pool.h"
 
 class ResourceFormatLoader : public RefCounted {
 	GDCLASS(ResourceFormatLoader, RefCounted);
@@ -71,6 +72,7 @@ public:
 	virtual ResourceUID::ID get_resource_uid(const String &p_path) const;
 	virtual void get_dependencies(const String &p_path, List<String> *p_dependencies, bool p_add_types = false);
 	virtual Error rename_dependencies(const String &p_path, const Map<String, String> &p_map);
+	virtual Ref<Resource> load_sub_resource(const String &p_path, const String &p_original_path, const String &p_id, Error *r_error = nullptr, CacheMode p_cache_mode = CACHE_MODE_REUSE);
 	virtual bool is_import_valid(const String &p_path) const { return true; }
 	virtual bool is_imported(const String &p_path) const { return false; }
 	virtual int get_import_order(const String &p_path) const { return 0; }
@@ -123,15 +125,16 @@ private:
 	friend class ResourceInteractiveLoader;
 	// Internal load function.
 	static Ref<Resource> _load(const String &p_path, const String &p_original_path, const String &p_type_hint, ResourceFormatLoader::CacheMode p_cache_mode, Error *r_error, bool p_use_sub_threads, float *r_progress);
+	static Ref<Resource> _load_sub_resource(const String &p_path, const String &p_original_path, const String &p_id, ResourceFormatLoader::CacheMode p_cache_mode, Error *r_error);
 
 	static ResourceLoadedCallback _loaded_callback;
 
 	static Ref<ResourceFormatLoader> _find_custom_resource_format_loader(String path);
 
 	struct ThreadLoadTask {
-		Thread *thread = nullptr;
+		WorkerThreadPool::TaskID task_id = WorkerThreadPool::INVALID_TASK_ID; // Invalid if it was already loaded.
+		bool awaited = false; // The pool task is waited on once, other callers wait for the status to change.
 		Thread::ID loader_id = 0;
-		Semaphore *semaphore = nullptr;
 		String local_path;
 		String remapped_path;
 		String type_hint;
@@ -142,22 +145,21 @@ private:
 		Ref<Resource> resource;
 		bool xl_remapped = false;
 		bool use_sub_threads = false;
-		bool start_next = true;
 		int requests = 0;
-		int poll_requests = 0;
+		float reported_progress = 0.0;
 		Set<String> sub_tasks;
+		Set<String> prefetched_tasks; // Requested ahead of the loader, handed over to it when it requests them too.
 	};
 
 	static void _thread_load_function(void *p_userdata);
+	static void _load_task_finished(void *p_userdata);
+	static void _prefetch_dependencies(ThreadLoadTask &p_load_task);
+	static Error _load_threaded_request(const String &p_path, const String &p_type_hint, bool p_use_sub_threads, ResourceFormatLoader::CacheMode p_cache_mode, const String &p_source_resource, bool p_prefetch);
 	static Mutex *thread_load_mutex;
+	static ConditionVariable *thread_load_condition;
 	static HashMap<String, ThreadLoadTask> thread_load_tasks;
-	static Semaphore *thread_load_semaphore;
-	static int thread_waiting_count;
-	static int thread_loading_count;
-	static int thread_suspended_count;
-	static int thread_load_max;
 
-	static float _dependency_get_progress(const String &p_path);
+	static void _dependency_get_progress(const String &p_path, Set<String> &r_visited, float &r_progress, int &r_count);
 
 public:
 	static Error load_threaded_request(const String &p_path, const String &p_type_hint = "", bool p_use_sub_threads = false, ResourceFormatLoader::CacheMode p_cache_mode = ResourceFormatLoader::CACHE_MODE_REUSE, const String &p_source_resource = String());
@@ -165,6 +167,7 @@ public:
 	static Ref<Resource> load_threaded_get(const String &p_path, Error *r_error = nullptr);
 
 	static Ref<Resource> load(const String &p_path, const String &p_type_hint = "", ResourceFormatLoader::CacheMode p_cache_mode = ResourceFormatLoader::CACHE_MODE_REUSE, Error *r_error = nullptr);
+	static Ref<Resource> load_sub_resource(const String &p_path, const String &p_id, ResourceFormatLoader::CacheMode p_cache_mode = ResourceFormatLoader::CACHE_MODE_REUSE, Error *r_error = nullptr);
 	static bool exists(const String &p_path, const String &p_type_hint = "");
 
 	static void get_recognized_extensions_for_type(const String &p_type, List<String> *p_extensions);
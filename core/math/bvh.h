@@ -53,6 +53,7 @@
 
 #include "bvh_tree.h"
 #include "core/os/mutex.h"
+#include "core/os/worker_thread_pool.h"
 
 #define BVHTREE_CLASS BVH_Tree<T, NUM_TREES, 2, MAX_ITEMS, USER_PAIR_TEST_FUNCTION, USER_CULL_TEST_FUNCTION, USE_PAIRS, BOUNDS, POINT>
 #define BVH_LOCKED_FUNCTION BVHLockedFunction(&_mutex, BVH_THREAD_SAFE &&_thread_safe);
@@ -381,6 +382,28 @@ public:
 		return params.result_count_overall;
 	}
 
+	// Same as cull_segment(), but registers hits in the caller's buffer and takes no lock,
+	// so several can run at once from different threads. The caller must make sure the
+	// BVH is not modified meanwhile.
+	int cull_segment_concurrent(const POINT &p_from, const POINT &p_to, T **p_result_array, int p_result_max, LocalVector<uint32_t, uint32_t, true> &r_hits, const T *p_tester, uint32_t p_tree_collision_mask = 0xFFFFFFFF, int *p_subindex_array = nullptr) {
+		typename BVHTREE_CLASS::CullParams params;
+
+		params.result_count_overall = 0;
+		params.result_max = p_result_max;
+		params.result_array = p_result_array;
+		params.subindex_array = p_subindex_array;
+		params.tester = p_tester;
+		params.tree_collision_mask = p_tree_collision_mask;
+		params.hits = &r_hits;
+
+		params.segment.from = p_from;
+		params.segment.to = p_to;
+
+		tree.cull_segment(params);
+
+		return params.result_count_overall;
+	}
+
 	int cull_point(const POINT &p_point, T **p_result_array, int p_result_max, const T *p_tester, uint32_t p_tree_collision_mask = 0xFFFFFFFF, int *p_subindex_array = nullptr) {
 		BVH_LOCKED_FUNCTION
 		typename BVHTREE_CLASS::CullParams params;
@@ -435,7 +458,32 @@ private:
 			return;
 		}
 
-		BOUNDS bb;
+		// Finding the candidates of each changed item only reads the tree, so with
+		// many changed items this is spread across threads, each item culling into
+		// its own hit list. Pair / unpair callbacks are then sent from this thread
+		// in the changed items order, exactly as the serial path does.
+		WorkerThreadPool *thread_pool = WorkerThreadPool::get_singleton();
+		if (changed_items.size() >= PARALLEL_PAIRING_MIN_ITEMS && thread_pool && thread_pool->get_thread_count() > 1) {
+			if (_pairing_hits.size() < changed_items.size()) {
+				_pairing_hits.resize(changed_items.size());
+			}
+
+			WorkerThreadPool::TaskID group = thread_pool->add_template_group_task(this, &BVH_Manager::_find_pairing_hits, nullptr, changed_items.size());
+			thread_pool->wait_for_group_task_completion(group);
+
+			for (unsigned int n = 0; n < changed_items.size(); n++) {
+				const BVHHandle &h = changed_items[n];
+
+				BVHABB_CLASS abb;
+				abb.from(tree._pairs[h.id()].expanded_aabb);
+				_find_leavers(h, abb, p_full_check);
+
+				_collide_hits(h, _pairing_hits[n]);
+			}
+
+			_reset();
+			return;
+		}
 
 		typename BVHTREE_CLASS::CullParams params;
 
@@ -458,30 +506,50 @@ private:
 			// paired, and send callbacks
 			_find_leavers(h, abb, p_full_check);
 
-			uint32_t changed_item_ref_id = h.id();
-
 			params.abb = abb;
 
 			params.result_count_overall = 0; // might not be needed
 			tree.cull_aabb(params, false);
 
-			for (unsigned int i = 0; i < tree._cull_hits.size(); i++) {
-				uint32_t ref_id = tree._cull_hits[i];
+			_collide_hits(h, tree._cull_hits);
+		}
+		_reset();
+	}
 
-				// don't collide against ourself
-				if (ref_id == changed_item_ref_id) {
-					continue;
-				}
+	// Runs on worker threads, must not modify anything but its own hit list.
+	void _find_pairing_hits(uint32_t p_index, void *p_userdata) {
+		const BVHHandle &h = changed_items[p_index];
 
-				// checkmasks is already done in the cull routine.
-				BVHHandle h_collidee;
-				h_collidee.set_id(ref_id);
+		typename BVHTREE_CLASS::CullParams params;
+		params.result_count_overall = 0;
+		params.result_max = INT_MAX;
+		params.result_array = nullptr;
+		params.subindex_array = nullptr;
+		params.hits = &_pairing_hits[p_index];
+
+		tree.item_fill_cullparams(h, params);
+		params.abb.from(tree._pairs[h.id()].expanded_aabb);
+		tree.cull_aabb(params, false);
+	}
 
-				// find NEW enterers, and send callbacks for them only
-				_collide(h, h_collidee);
+	void _collide_hits(const BVHHandle &p_handle, const LocalVector<uint32_t, uint32_t, true> &p_hits) {
+		uint32_t changed_item_ref_id = p_handle.id();
+
+		for (unsigned int i = 0; i < p_hits.size(); i++) {
+			uint32_t ref_id = p_hits[i];
+
+			// don't collide against ourself
+			if (ref_id == changed_item_ref_id) {
+				continue;
 			}
+
+			// checkmasks is already done in the cull routine.
+			BVHHandle h_collidee;
+			h_collidee.set_id(ref_id);
+
+			// find NEW enterers, and send callbacks for them only
+			_collide(p_handle, h_collidee);
 		}
-		_reset();
 	}
 
 public:
@@ -775,6 +843,14 @@ private:
 	// for collision pairing,
 	// maintain a list of all items moved etc on each frame / tick
 	LocalVector<BVHHandle, uint32_t, true> changed_items;
+
+	// Below this many changed items, pairing is not worth dispatching to threads.
+	enum {
+		PARALLEL_PAIRING_MIN_ITEMS = 256,
+	};
+
+	// Per changed item cull results, kept around to avoid reallocating each tick.
+	LocalVector<LocalVector<uint32_t, uint32_t, true>> _pairing_hits;
 	uint32_t _tick = 1; // Start from 1 so items with 0 indicate never updated.
 
 	class BVHLockedFunction {
@@ -195,10 +195,8 @@ uint64_t ClassDB::get_api_hash(APIType p_api) {
 
 			List<StringName> snames;
 
-			k = nullptr;
-
-			while ((k = t->method_map.next(k))) {
-				String name = k->operator String();
+			for (OAHashMap<StringName, MethodBind *>::Iterator it = t->method_map.iter(); it.valid; it = t->method_map.next_iter(it)) {
+				String name = it.key->operator String();
 
 				ERR_CONTINUE(name.is_empty());
 
@@ -206,13 +204,13 @@ uint64_t ClassDB::get_api_hash(APIType p_api) {
 					continue; // Ignore non-virtual methods that start with an underscore
 				}
 
-				snames.push_back(*k);
+				snames.push_back(*it.key);
 			}
 
 			snames.sort_custom<StringName::AlphCompare>();
 
 			for (const StringName &F : snames) {
-				MethodBind *mb = t->method_map[F];
+				MethodBind *mb = *t->method_map.lookup_ptr(F);
 				hash = hash_djb2_one_64(mb->get_name().hash(), hash);
 				hash = hash_djb2_one_64(mb->get_argument_count(), hash);
 				hash = hash_djb2_one_64(mb->get_argument_type(-1), hash); //return
@@ -466,7 +464,7 @@ void ClassDB::get_method_list(const StringName &p_class, List<MethodInfo> *p_met
 				continue;
 			}
 
-			MethodBind *method = type->method_map.get(E);
+			MethodBind *method = *type->method_map.lookup_ptr(E);
 			MethodInfo minfo = info_from_bind(method);
 
 			p_methods->push_back(minfo);
@@ -474,10 +472,8 @@ void ClassDB::get_method_list(const StringName &p_class, List<MethodInfo> *p_met
 
 #else
 
-		const StringName *K = nullptr;
-
-		while ((K = type->method_map.next(K))) {
-			MethodBind *m = type->method_map[*K];
+		for (OAHashMap<StringName, MethodBind *>::Iterator it = type->method_map.iter(); it.valid; it = type->method_map.next_iter(it)) {
+			MethodBind *m = *it.value;
 			MethodInfo minfo = info_from_bind(m);
 			p_methods->push_back(minfo);
 		}
@@ -508,7 +504,7 @@ bool ClassDB::get_method_info(const StringName &p_class, const StringName &p_met
 		}
 
 #ifdef DEBUG_METHODS_ENABLED
-		MethodBind **method = type->method_map.getptr(p_method);
+		MethodBind **method = type->method_map.lookup_ptr(p_method);
 		if (method && *method) {
 			if (r_info != nullptr) {
 				MethodInfo minfo = info_from_bind(*method);
@@ -522,9 +518,10 @@ bool ClassDB::get_method_info(const StringName &p_class, const StringName &p_met
 			return true;
 		}
 #else
-		if (type->method_map.has(p_method)) {
+		MethodBind **method = type->method_map.lookup_ptr(p_method);
+		if (method) {
 			if (r_info) {
-				MethodBind *m = type->method_map[p_method];
+				MethodBind *m = *method;
 				MethodInfo minfo = info_from_bind(m);
 				*r_info = minfo;
 			}
@@ -548,7 +545,7 @@ MethodBind *ClassDB::get_method(const StringName &p_class, const StringName &p_n
 	ClassInfo *type = classes.getptr(p_class);
 
 	while (type) {
-		MethodBind **method = type->method_map.getptr(p_name);
+		MethodBind **method = type->method_map.lookup_ptr(p_name);
 		if (method && *method) {
 			return *method;
 		}
@@ -1209,8 +1206,9 @@ void ClassDB::set_method_flags(const StringName &p_class, const StringName &p_me
 	ClassInfo *type = classes.getptr(p_class);
 	ClassInfo *check = type;
 	ERR_FAIL_COND(!check);
-	ERR_FAIL_COND(!check->method_map.has(p_method));
-	check->method_map[p_method]->set_hint_flags(p_flags);
+	MethodBind **method = check->method_map.lookup_ptr(p_method);
+	ERR_FAIL_COND(!method);
+	(*method)->set_hint_flags(p_flags);
 }
 
 bool ClassDB::has_method(const StringName &p_class, const StringName &p_method, bool p_no_inheritance) {
@@ -1244,7 +1242,7 @@ void ClassDB::bind_method_custom(const StringName &p_class, MethodBind *p_method
 	type->method_order.push_back(p_method->get_name());
 #endif
 
-	type->method_map[p_method->get_name()] = p_method;
+	type->method_map.insert(p_method->get_name(), p_method);
 }
 
 #ifdef DEBUG_METHODS_ENABLED
@@ -1290,7 +1288,7 @@ MethodBind *ClassDB::bind_methodfi(uint32_t p_flags, MethodBind *p_bind, const c
 	type->method_order.push_back(mdname);
 #endif
 
-	type->method_map[mdname] = p_bind;
+	type->method_map.insert(mdname, p_bind);
 
 	Vector<Variant> defvals;
 
@@ -1561,9 +1559,8 @@ void ClassDB::cleanup() {
 	while ((k = classes.next(k))) {
 		ClassInfo &ti = classes[*k];
 
-		const StringName *m = nullptr;
-		while ((m = ti.method_map.next(m))) {
-			memdelete(ti.method_map[*m]);
+		for (OAHashMap<StringName, MethodBind *>::Iterator it = ti.method_map.iter(); it.valid; it = ti.method_map.next_iter(it)) {
+			memdelete(*it.value);
 		}
 	}
 	classes.clear();
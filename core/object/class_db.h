@@ -101,7 +101,7 @@ public:
 
 		ObjectNativeExtension *native_extension = nullptr;
 
-		HashMap<StringName, MethodBind *> method_map;
+		OAHashMap<StringName, MethodBind *> method_map;
 		HashMap<StringName, int> constant_map;
 		HashMap<StringName, List<StringName>> enum_map;
 		HashMap<StringName, MethodInfo> signal_map;
@@ -280,7 +280,7 @@ public:
 			// Overloading not supported
 			ERR_FAIL_V_MSG(nullptr, "Method already bound: " + instance_type + "::" + p_name + ".");
 		}
-		type->method_map[p_name] = bind;
+		type->method_map.insert(p_name, bind);
 #ifdef DEBUG_METHODS_ENABLED
 		// FIXME: <reduz> set_return_type is no longer in MethodBind, so I guess it should be moved to vararg method bind
 		//bind->set_return_type("Variant");
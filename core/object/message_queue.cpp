@@ -30,72 +30,156 @@
 
 #include "message_queue.h"
 
-#include "core/config/project_settings.h"
 #include "core/core_string_names.h"
 #include "core/object/class_db.h"
 #include "core/object/script_language.h"
 
+#include "core/os/os.h"
+
 MessageQueue *MessageQueue::singleton = nullptr;
+thread_local MessageQueue::ProducerHandle MessageQueue::thread_producer;
+SafeNumeric<uint64_t> MessageQueue::last_queue_id;
 
 MessageQueue *MessageQueue::get_singleton() {
 	return singleton;
 }
 
-Error MessageQueue::push_callp(ObjectID p_id, const StringName &p_method, const Variant **p_args, int p_argcount, bool p_show_error) {
-	return push_callablep(Callable(p_id, p_method), p_args, p_argcount, p_show_error);
+MessageQueue::ProducerHandle::~ProducerHandle() {
+	if (producer) {
+		producer->orphaned.set();
+		_unref_producer(producer);
+	}
 }
 
-Error MessageQueue::push_set(ObjectID p_id, const StringName &p_prop, const Variant &p_value) {
-	_THREAD_SAFE_METHOD_
+MessageQueue::Segment *MessageQueue::_alloc_segment(uint32_t p_min_size) {
+	uint32_t size = MAX((uint32_t)SEGMENT_SIZE, p_min_size);
+	Segment *segment = (Segment *)memalloc(DATA_OFFSET + size);
+	memnew_placement(segment, Segment);
+	segment->next.store(nullptr, std::memory_order_relaxed);
+	segment->write_pos.store(0, std::memory_order_relaxed);
+	segment->size = size;
+	return segment;
+}
 
-	uint8_t room_needed = sizeof(Message) + sizeof(Variant);
+uint32_t MessageQueue::_get_message_size(const Message *p_message) {
+	uint32_t size = sizeof(Message);
+	if ((p_message->type & FLAG_MASK) != TYPE_NOTIFICATION) {
+		size += sizeof(Variant) * p_message->args;
+	}
+	return size;
+}
+
+void MessageQueue::_destroy_message(Message *p_message) {
+	if ((p_message->type & FLAG_MASK) != TYPE_NOTIFICATION) {
+		Variant *args = (Variant *)(p_message + 1);
+		for (int i = 0; i < p_message->args; i++) {
+			args[i].~Variant();
+		}
+	}
+	p_message->~Message();
+}
 
-	if ((buffer_end + room_needed) >= buffer_size) {
-		String type;
-		if (ObjectDB::get_instance(p_id)) {
-			type = ObjectDB::get_instance(p_id)->get_class();
+void MessageQueue::_free_producer_messages(Producer *p_producer) {
+	Segment *segment = p_producer->head;
+	while (segment) {
+		uint32_t end = segment->write_pos.load(std::memory_order_acquire);
+		while (segment->read_pos < end) {
+			Message *message = (Message *)&segment->get_data()[segment->read_pos];
+			segment->read_pos += _get_message_size(message);
+			_destroy_message(message);
 		}
-		print_line("Failed set: " + type + ":" + p_prop + " target ID: " + itos(p_id));
-		statistics();
-		ERR_FAIL_V_MSG(ERR_OUT_OF_MEMORY, "Message queue out of memory. Try increasing 'memory/limits/message_queue/max_size_kb' in project settings.");
+		Segment *next = segment->next.load(std::memory_order_acquire);
+		memfree(segment);
+		segment = next;
+	}
+	p_producer->head = nullptr;
+	p_producer->tail = nullptr;
+}
+
+void MessageQueue::_unref_producer(Producer *p_producer) {
+	if (p_producer->refcount.unref()) {
+		_free_producer_messages(p_producer);
+		memdelete(p_producer);
+	}
+}
+
+MessageQueue::Producer *MessageQueue::_get_producer() {
+	Producer *producer = thread_producer.producer;
+	if (likely(producer && producer->queue_id == queue_id)) {
+		return producer;
+	}
+	if (producer) {
+		// Left over from a previous MessageQueue.
+		_unref_producer(producer);
+	}
+
+	producer = memnew(Producer);
+	producer->refcount.init(2); // This thread and the queue.
+	producer->queue_id = queue_id;
+	producer->head = _alloc_segment(0);
+	producer->tail = producer->head;
+
+	producers_mutex.lock();
+	producers.push_back(producer);
+	producers_mutex.unlock();
+
+	thread_producer.producer = producer;
+	return producer;
+}
+
+MessageQueue::Message *MessageQueue::_reserve_message(Producer *p_producer, uint32_t p_size) {
+	Segment *segment = p_producer->tail;
+	uint32_t pos = segment->write_pos.load(std::memory_order_relaxed);
+	if (unlikely(pos + p_size > segment->size)) {
+		Segment *next = _alloc_segment(p_size);
+		// Nothing is written to the old segment after this, the consumer may free it once drained.
+		segment->next.store(next, std::memory_order_release);
+		p_producer->tail = next;
+		segment = next;
+		pos = 0;
 	}
+	return (Message *)&segment->get_data()[pos];
+}
 
-	Message *msg = memnew_placement(&buffer[buffer_end], Message);
+Error MessageQueue::push_callp(ObjectID p_id, const StringName &p_method, const Variant **p_args, int p_argcount, bool p_show_error) {
+	return push_callablep(Callable(p_id, p_method), p_args, p_argcount, p_show_error);
+}
+
+Error MessageQueue::push_set(ObjectID p_id, const StringName &p_prop, const Variant &p_value) {
+	Producer *producer = _get_producer();
+	uint32_t room_needed = sizeof(Message) + sizeof(Variant);
+
+	Message *msg = memnew_placement(_reserve_message(producer, room_needed), Message);
 	msg->args = 1;
 	msg->callable = Callable(p_id, p_prop);
 	msg->type = TYPE_SET;
+#ifdef DEBUG_ENABLED
+	msg->enqueue_usec = OS::get_singleton()->get_ticks_usec();
+#endif
 
-	buffer_end += sizeof(Message);
-
-	Variant *v = memnew_placement(&buffer[buffer_end], Variant);
-	buffer_end += sizeof(Variant);
-	*v = p_value;
+	memnew_placement(msg + 1, Variant(p_value));
 
+	_commit_message(producer, room_needed);
 	return OK;
 }
 
 Error MessageQueue::push_notification(ObjectID p_id, int p_notification) {
-	_THREAD_SAFE_METHOD_
-
 	ERR_FAIL_COND_V(p_notification < 0, ERR_INVALID_PARAMETER);
 
-	uint8_t room_needed = sizeof(Message);
-
-	if ((buffer_end + room_needed) >= buffer_size) {
-		print_line("Failed notification: " + itos(p_notification) + " target ID: " + itos(p_id));
-		statistics();
-		ERR_FAIL_V_MSG(ERR_OUT_OF_MEMORY, "Message queue out of memory. Try increasing 'memory/limits/message_queue/max_size_kb' in project settings.");
-	}
+	Producer *producer = _get_producer();
+	uint32_t room_needed = sizeof(Message);
 
-	Message *msg = memnew_placement(&buffer[buffer_end], Message);
+	Message *msg = memnew_placement(_reserve_message(producer, room_needed), Message);
 
 	msg->type = TYPE_NOTIFICATION;
 	msg->callable = Callable(p_id, CoreStringNames::get_singleton()->notification); //name is meaningless but callable needs it
 	//msg->target;
 	msg->notification = p_notification;
+#ifdef DEBUG_ENABLED
+	msg->enqueue_usec = OS::get_singleton()->get_ticks_usec();
+#endif
 
-	buffer_end += sizeof(Message);
-
+	_commit_message(producer, room_needed);
 	return OK;
 }
 
@@ -112,32 +196,28 @@ Error MessageQueue::push_set(Object *p_object, const StringName &p_prop, const V
 }
 
 Error MessageQueue::push_callablep(const Callable &p_callable, const Variant **p_args, int p_argcount, bool p_show_error) {
-	_THREAD_SAFE_METHOD_
-
-	int room_needed = sizeof(Message) + sizeof(Variant) * p_argcount;
+	ERR_FAIL_COND_V(p_argcount < 0 || p_argcount > INT16_MAX, ERR_INVALID_PARAMETER);
 
-	if ((buffer_end + room_needed) >= buffer_size) {
-		print_line("Failed method: " + p_callable);
-		statistics();
-		ERR_FAIL_V_MSG(ERR_OUT_OF_MEMORY, "Message queue out of memory. Try increasing 'memory/limits/message_queue/max_size_kb' in project settings.");
-	}
+	Producer *producer = _get_producer();
+	uint32_t room_needed = sizeof(Message) + sizeof(Variant) * p_argcount;
 
-	Message *msg = memnew_placement(&buffer[buffer_end], Message);
+	Message *msg = memnew_placement(_reserve_message(producer, room_needed), Message);
 	msg->args = p_argcount;
 	msg->callable = p_callable;
 	msg->type = TYPE_CALL;
 	if (p_show_error) {
 		msg->type |= FLAG_SHOW_ERROR;
 	}
+#ifdef DEBUG_ENABLED
+	msg->enqueue_usec = OS::get_singleton()->get_ticks_usec();
+#endif
 
-	buffer_end += sizeof(Message);
-
+	Variant *args = (Variant *)(msg + 1);
 	for (int i = 0; i < p_argcount; i++) {
-		Variant *v = memnew_placement(&buffer[buffer_end], Variant);
-		buffer_end += sizeof(Variant);
-		*v = *p_args[i];
+		memnew_placement(&args[i], Variant(*p_args[i]));
 	}
 
+	_commit_message(producer, room_needed);
 	return OK;
 }
 
@@ -146,57 +226,72 @@ void MessageQueue::statistics() {
 	Map<int, int> notify_count;
 	Map<Callable, int> call_count;
 	int null_count = 0;
+	uint64_t total_bytes = 0;
 
-	uint32_t read_pos = 0;
-	while (read_pos < buffer_end) {
-		Message *message = (Message *)&buffer[read_pos];
+	producers_mutex.lock();
+	for (uint32_t i = 0; i < producers.size(); i++) {
+		for (Segment *segment = producers[i]->head; segment; segment = segment->next.load(std::memory_order_acquire)) {
+			uint32_t read_pos = segment->read_pos;
+			uint32_t end = segment->write_pos.load(std::memory_order_acquire);
+			total_bytes += end - read_pos;
 
-		Object *target = message->callable.get_object();
+			while (read_pos < end) {
+				Message *message = (Message *)&segment->get_data()[read_pos];
 
-		if (target != nullptr) {
-			switch (message->type & FLAG_MASK) {
-				case TYPE_CALL: {
-					if (!call_count.has(message->callable)) {
-						call_count[message->callable] = 0;
-					}
+				Object *target = message->callable.get_object();
 
-					call_count[message->callable]++;
+				if (target != nullptr) {
+					switch (message->type & FLAG_MASK) {
+						case TYPE_CALL: {
+							if (!call_count.has(message->callable)) {
+								call_count[message->callable] = 0;
+							}
 
-				} break;
-				case TYPE_NOTIFICATION: {
-					if (!notify_count.has(message->notification)) {
-						notify_count[message->notification] = 0;
-					}
+							call_count[message->callable]++;
 
-					notify_count[message->notification]++;
+						} break;
+						case TYPE_NOTIFICATION: {
+							if (!notify_count.has(message->notification)) {
+								notify_count[message->notification] = 0;
+							}
 
-				} break;
-				case TYPE_SET: {
-					StringName t = message->callable.get_method();
-					if (!set_count.has(t)) {
-						set_count[t] = 0;
-					}
+							notify_count[message->notification]++;
 
-					set_count[t]++;
+						} break;
+						case TYPE_SET: {
+							StringName t = message->callable.get_method();
+							if (!set_count.has(t)) {
+								set_count[t] = 0;
+							}
 
-				} break;
-			}
+							set_count[t]++;
 
-		} else {
-			//object was deleted
-			print_line("Object was deleted while awaiting a callback");
+						} break;
+					}
 
-			null_count++;
-		}
+				} else {
+					//object was deleted
+					print_line("Object was deleted while awaiting a callback");
 
-		read_pos += sizeof(Message);
-		if ((message->type & FLAG_MASK) != TYPE_NOTIFICATION) {
-			read_pos += sizeof(Variant) * message->args;
+					null_count++;
+				}
+
+				read_pos += _get_message_size(message);
+			}
 		}
 	}
+	producers_mutex.unlock();
+
+	Stats stats = get_stats();
 
-	print_line("TOTAL BYTES: " + itos(buffer_end));
+	print_line("TOTAL BYTES: " + itos(total_bytes));
 	print_line("NULL count: " + itos(null_count));
+	print_line("PRODUCERS: " + itos(stats.producers));
+	print_line("LAST FLUSH: " + itos(stats.last_flush_messages) + " messages, " + itos(stats.last_flush_bytes) + " bytes");
+	print_line("MAX FLUSH: " + itos(stats.max_flush_messages) + " messages, " + itos(stats.max_flush_bytes) + " bytes");
+#ifdef DEBUG_ENABLED
+	print_line("LAST FLUSH LATENCY: max " + itos(stats.last_flush_max_latency_usec) + " usec, avg " + itos(stats.last_flush_avg_latency_usec) + " usec");
+#endif
 
 	for (const KeyValue<StringName, int> &E : set_count) {
 		print_line("SET " + E.key + ": " + itos(E.value));
@@ -211,8 +306,23 @@ void MessageQueue::statistics() {
 	}
 }
 
+MessageQueue::Stats MessageQueue::get_stats() {
+	Stats stats;
+	producers_mutex.lock();
+	stats.producers = producers.size();
+	producers_mutex.unlock();
+
+	stats.last_flush_messages = last_flush_messages;
+	stats.max_flush_messages = max_flush_messages;
+	stats.last_flush_bytes = last_flush_bytes;
+	stats.max_flush_bytes = max_flush_bytes;
+	stats.last_flush_max_latency_usec = last_flush_max_latency;
+	stats.last_flush_avg_latency_usec = last_flush_messages ? last_flush_total_latency / last_flush_messages : 0;
+	return stats;
+}
+
 int MessageQueue::get_max_buffer_usage() const {
-	return buffer_max_used;
+	return max_flush_bytes;
 }
 
 void MessageQueue::_call_function(const Callable &p_callable, const Variant *p_args, int p_argcount, bool p_show_error) {
@@ -232,36 +342,40 @@ void MessageQueue::_call_function(const Callable &p_callable, const Variant *p_a
 	}
 }
 
-void MessageQueue::flush() {
-	if (buffer_end > buffer_max_used) {
-		buffer_max_used = buffer_end;
-	}
-
-	uint32_t read_pos = 0;
-
-	//using reverse locking strategy
-	_THREAD_SAFE_LOCK_
-
-	if (flushing) {
-		_THREAD_SAFE_UNLOCK_
-		ERR_FAIL_COND(flushing); //already flushing, you did something odd
-	}
-	flushing = true;
+bool MessageQueue::_flush_producer(Producer *p_producer) {
+	bool flushed = false;
+	Segment *segment = p_producer->head;
 
-	while (read_pos < buffer_end) {
-		//lock on each iteration, so a call can re-add itself to the message queue
-
-		Message *message = (Message *)&buffer[read_pos];
-
-		uint32_t advance = sizeof(Message);
-		if ((message->type & FLAG_MASK) != TYPE_NOTIFICATION) {
-			advance += sizeof(Variant) * message->args;
+	while (true) {
+		uint32_t end = segment->write_pos.load(std::memory_order_acquire);
+		if (segment->read_pos == end) {
+			Segment *next = segment->next.load(std::memory_order_acquire);
+			if (!next) {
+				break;
+			}
+			if (segment->read_pos != segment->write_pos.load(std::memory_order_acquire)) {
+				continue; // Last messages were committed right before moving on.
+			}
+			memfree(segment);
+			segment = next;
+			p_producer->head = segment;
+			continue;
 		}
 
-		//pre-advance so this function is reentrant
-		read_pos += advance;
+		Message *message = (Message *)&segment->get_data()[segment->read_pos];
+		uint32_t size = _get_message_size(message);
+
+		// Pre-advance, so calls can add new messages (to this or any stream) while running.
+		segment->read_pos += size;
+		flushed = true;
 
-		_THREAD_SAFE_UNLOCK_
+		last_flush_messages++;
+		last_flush_bytes += size;
+#ifdef DEBUG_ENABLED
+		uint64_t latency = OS::get_singleton()->get_ticks_usec() - message->enqueue_usec;
+		last_flush_max_latency = MAX(last_flush_max_latency, latency);
+		last_flush_total_latency += latency;
+#endif
 
 		Object *target = message->callable.get_object();
 
@@ -289,57 +403,80 @@ void MessageQueue::flush() {
 			}
 		}
 
-		if ((message->type & FLAG_MASK) != TYPE_NOTIFICATION) {
-			Variant *args = (Variant *)(message + 1);
-			for (int i = 0; i < message->args; i++) {
-				args[i].~Variant();
-			}
+		_destroy_message(message);
+	}
+
+	return flushed;
+}
+
+void MessageQueue::flush() {
+	ERR_FAIL_COND_MSG(flushing.is_set(), "Already flushing the message queue, you did something odd.");
+	flushing.set();
+
+	last_flush_messages = 0;
+	last_flush_bytes = 0;
+	last_flush_max_latency = 0;
+	last_flush_total_latency = 0;
+
+	// Keep going until no stream had anything left, messages may push more messages.
+	bool flushed = true;
+	while (flushed) {
+		flushed = false;
+
+		producers_mutex.lock();
+		flush_producers.resize(producers.size());
+		for (uint32_t i = 0; i < producers.size(); i++) {
+			flush_producers[i] = producers[i];
 		}
+		producers_mutex.unlock();
 
-		message->~Message();
+		for (uint32_t i = 0; i < flush_producers.size(); i++) {
+			flushed |= _flush_producer(flush_producers[i]);
+		}
+	}
+
+	// Release the streams of threads that exited. They may have pushed right before exiting, so drain them one last time.
+	flush_producers.clear();
+	producers_mutex.lock();
+	for (uint32_t i = 0; i < producers.size(); i++) {
+		if (producers[i]->orphaned.is_set()) {
+			flush_producers.push_back(producers[i]);
+			producers.remove_at_unordered(i);
+			i--;
+		}
+	}
+	producers_mutex.unlock();
 
-		_THREAD_SAFE_LOCK_
+	for (uint32_t i = 0; i < flush_producers.size(); i++) {
+		_flush_producer(flush_producers[i]);
+		_unref_producer(flush_producers[i]);
 	}
 
-	buffer_end = 0; // reset buffer
-	flushing = false;
-	_THREAD_SAFE_UNLOCK_
+	max_flush_messages = MAX(max_flush_messages, last_flush_messages);
+	max_flush_bytes = MAX(max_flush_bytes, last_flush_bytes);
+
+	flushing.clear();
 }
 
 bool MessageQueue::is_flushing() const {
-	return flushing;
+	return flushing.is_set();
 }
 
 MessageQueue::MessageQueue() {
 	ERR_FAIL_COND_MSG(singleton != nullptr, "A MessageQueue singleton already exists.");
 	singleton = this;
 
-	buffer_size = GLOBAL_DEF_RST("memory/limits/message_queue/max_size_kb", DEFAULT_QUEUE_SIZE_KB);
-	ProjectSettings::get_singleton()->set_custom_property_info("memory/limits/message_queue/max_size_kb", PropertyInfo(Variant::INT, "memory/limits/message_queue/max_size_kb", PROPERTY_HINT_RANGE, "1024,4096,1,or_greater"));
-	buffer_size *= 1024;
-	buffer = memnew_arr(uint8_t, buffer_size);
+	queue_id = last_queue_id.increment();
 }
 
 MessageQueue::~MessageQueue() {
-	uint32_t read_pos = 0;
-
-	while (read_pos < buffer_end) {
-		Message *message = (Message *)&buffer[read_pos];
-		Variant *args = (Variant *)(message + 1);
-		int argc = message->args;
-		if ((message->type & FLAG_MASK) != TYPE_NOTIFICATION) {
-			for (int i = 0; i < argc; i++) {
-				args[i].~Variant();
-			}
-		}
-		message->~Message();
-
-		read_pos += sizeof(Message);
-		if ((message->type & FLAG_MASK) != TYPE_NOTIFICATION) {
-			read_pos += sizeof(Variant) * message->args;
-		}
+	producers_mutex.lock();
+	for (uint32_t i = 0; i < producers.size(); i++) {
+		_free_producer_messages(producers[i]);
+		_unref_producer(producers[i]);
 	}
+	producers.clear();
+	producers_mutex.unlock();
 
 	singleton = nullptr;
-	memdelete_arr(buffer);
 }
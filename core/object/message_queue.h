@@ -32,16 +32,24 @@
 #define MESSAGE_QUEUE_H
 
 #include "core/object/object_id.h"
-#include "core/os/thread_safe.h"
+#include "core/os/mutex.h"
+#include "core/templates/local_vector.h"
+#include "core/templates/safe_refcount.h"
 #include "core/variant/variant.h"
 
+#include <atomic>
+
 class Object;
 
+// Deferred calls, notifications and property sets, executed on flush().
+//
+// Every thread that pushes messages gets its own stream of growable segments,
+// which it appends to without locking. flush() drains the streams one after
+// the other, so messages from one thread always run in the order they were
+// pushed; there is no ordering between threads. There is no capacity limit.
 class MessageQueue {
-	_THREAD_SAFE_CLASS_
-
 	enum {
-		DEFAULT_QUEUE_SIZE_KB = 4096
+		SEGMENT_SIZE = 64 * 1024
 	};
 
 	enum {
@@ -60,19 +68,77 @@ class MessageQueue {
 			int16_t notification;
 			int16_t args;
 		};
+#ifdef DEBUG_ENABLED
+		uint64_t enqueue_usec;
+#endif
+	};
+
+	// Only the producer writes messages and publishes them through write_pos and
+	// next; only the consumer reads them and frees the segment.
+	struct Segment {
+		std::atomic<Segment *> next;
+		std::atomic<uint32_t> write_pos;
+		uint32_t read_pos = 0;
+		uint32_t size = 0;
+
+		_FORCE_INLINE_ uint8_t *get_data() { return (uint8_t *)this + DATA_OFFSET; }
 	};
 
-	uint8_t *buffer = nullptr;
-	uint32_t buffer_end = 0;
-	uint32_t buffer_max_used = 0;
-	uint32_t buffer_size = 0;
+	static const uint32_t DATA_OFFSET = (sizeof(Segment) + 15) & ~15;
+
+	// Message stream of one thread. Referenced by the queue and by the thread,
+	// whichever lets go last frees it.
+	struct Producer {
+		Segment *head = nullptr; // Consumer side.
+		Segment *tail = nullptr; // Producer side.
+		uint64_t queue_id = 0;
+		SafeRefCount refcount;
+		SafeFlag orphaned; // The thread has exited.
+	};
+
+	struct ProducerHandle {
+		Producer *producer = nullptr;
+		~ProducerHandle();
+	};
+
+	static thread_local ProducerHandle thread_producer;
+	static SafeNumeric<uint64_t> last_queue_id;
+
+	uint64_t queue_id = 0;
+
+	Mutex producers_mutex;
+	LocalVector<Producer *> producers; // Guarded by producers_mutex.
+	LocalVector<Producer *> flush_producers; // Snapshot used by flush().
+
+	SafeFlag flushing;
+
+	// Statistics, written by the consumer only.
+	uint32_t last_flush_messages = 0;
+	uint32_t max_flush_messages = 0;
+	uint32_t last_flush_bytes = 0;
+	uint32_t max_flush_bytes = 0;
+	uint64_t last_flush_max_latency = 0;
+	uint64_t last_flush_total_latency = 0;
+
+	static Segment *_alloc_segment(uint32_t p_min_size);
+	static void _free_producer_messages(Producer *p_producer);
+	static void _unref_producer(Producer *p_producer);
+
+	Producer *_get_producer();
+	Message *_reserve_message(Producer *p_producer, uint32_t p_size);
+	_FORCE_INLINE_ void _commit_message(Producer *p_producer, uint32_t p_size) {
+		Segment *segment = p_producer->tail;
+		segment->write_pos.store(segment->write_pos.load(std::memory_order_relaxed) + p_size, std::memory_order_release);
+	}
+
+	static uint32_t _get_message_size(const Message *p_message);
+	static void _destroy_message(Message *p_message);
+	bool _flush_producer(Producer *p_producer);
 
 	void _call_function(const Callable &p_callable, const Variant *p_args, int p_argcount, bool p_show_error);
 
 	static MessageQueue *singleton;
 
-	bool flushing = false;
-
 public:
 	static MessageQueue *get_singleton();
 
@@ -120,6 +186,18 @@ public:
 
 	bool is_flushing() const;
 
+	struct Stats {
+		uint32_t producers = 0; // Threads with a message stream.
+		uint32_t last_flush_messages = 0;
+		uint32_t max_flush_messages = 0;
+		uint32_t last_flush_bytes = 0;
+		uint32_t max_flush_bytes = 0;
+		// Time from push to execution, debug builds only.
+		uint64_t last_flush_max_latency_usec = 0;
+		uint64_t last_flush_avg_latency_usec = 0;
+	};
+
+	Stats get_stats();
 	int get_max_buffer_usage() const;
 
 	MessageQueue();
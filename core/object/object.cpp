@@ -843,6 +843,11 @@ Variant Object::callp(const StringName &p_method, const Variant **p_args, int p_
 	return ret;
 }
 
+Variant Object::callp_method_bind(MethodBind *p_method, const Variant **p_args, int p_argcount, Callable::CallError &r_error) {
+	OBJ_DEBUG_LOCK
+	return p_method->call(this, p_args, p_argcount, r_error);
+}
+
 void Object::notification(int p_notification, bool p_reversed) {
 	_notificationv(p_notification, p_reversed);
 
@@ -1012,14 +1017,15 @@ void Object::add_user_signal(const MethodInfo &p_signal) {
 	ERR_FAIL_COND_MSG(signal_map.has(p_signal.name), "Trying to add already existing signal '" + p_signal.name + "'.");
 	SignalData s;
 	s.user = p_signal;
-	signal_map[p_signal.name] = s;
+	signal_map.insert(p_signal.name, s);
 }
 
 bool Object::_has_user_signal(const StringName &p_name) const {
-	if (!signal_map.has(p_name)) {
+	const SignalData *s = signal_map.lookup_ptr(p_name);
+	if (!s) {
 		return false;
 	}
-	return signal_map[p_name].user.name.length() > 0;
+	return s->user.name.length() > 0;
 }
 
 struct _ObjectSignalDisconnectData {
@@ -1057,7 +1063,7 @@ Error Object::emit_signalp(const StringName &p_name, const Variant **p_args, int
 		return ERR_CANT_ACQUIRE_RESOURCE; //no emit, signals blocked
 	}
 
-	SignalData *s = signal_map.getptr(p_name);
+	SignalData *s = signal_map.lookup_ptr(p_name);
 	if (!s) {
 #ifdef DEBUG_ENABLED
 		bool signal_is_valid = ClassDB::has_signal(get_class_name(), p_name);
@@ -1250,21 +1256,17 @@ void Object::get_signal_list(List<MethodInfo> *p_signals) const {
 
 	ClassDB::get_signal_list(get_class_name(), p_signals);
 	//find maybe usersignals?
-	const StringName *S = nullptr;
-
-	while ((S = signal_map.next(S))) {
-		if (!signal_map[*S].user.name.is_empty()) {
+	for (OAHashMap<StringName, SignalData>::Iterator it = signal_map.iter(); it.valid; it = signal_map.next_iter(it)) {
+		if (!it.value->user.name.is_empty()) {
 			//user signal
-			p_signals->push_back(signal_map[*S].user);
+			p_signals->push_back(it.value->user);
 		}
 	}
 }
 
 void Object::get_all_signal_connections(List<Connection> *p_connections) const {
-	const StringName *S = nullptr;
-
-	while ((S = signal_map.next(S))) {
-		const SignalData *s = &signal_map[*S];
+	for (OAHashMap<StringName, SignalData>::Iterator it = signal_map.iter(); it.valid; it = signal_map.next_iter(it)) {
+		const SignalData *s = it.value;
 
 		for (int i = 0; i < s->slot_map.size(); i++) {
 			p_connections->push_back(s->slot_map.getv(i).conn);
@@ -1273,7 +1275,7 @@ void Object::get_all_signal_connections(List<Connection> *p_connections) const {
 }
 
 void Object::get_signal_connection_list(const StringName &p_signal, List<Connection> *p_connections) const {
-	const SignalData *s = signal_map.getptr(p_signal);
+	const SignalData *s = signal_map.lookup_ptr(p_signal);
 	if (!s) {
 		return; //nothing
 	}
@@ -1285,10 +1287,8 @@ void Object::get_signal_connection_list(const StringName &p_signal, List<Connect
 
 int Object::get_persistent_signal_connection_count() const {
 	int count = 0;
-	const StringName *S = nullptr;
-
-	while ((S = signal_map.next(S))) {
-		const SignalData *s = &signal_map[*S];
+	for (OAHashMap<StringName, SignalData>::Iterator it = signal_map.iter(); it.valid; it = signal_map.next_iter(it)) {
+		const SignalData *s = it.value;
 
 		for (int i = 0; i < s->slot_map.size(); i++) {
 			if (s->slot_map.getv(i).conn.flags & CONNECT_PERSIST) {
@@ -1312,7 +1312,7 @@ Error Object::connect(const StringName &p_signal, const Callable &p_callable, co
 	Object *target_object = p_callable.get_object();
 	ERR_FAIL_COND_V_MSG(!target_object, ERR_INVALID_PARAMETER, "Cannot connect to '" + p_signal + "' to callable '" + p_callable + "': the callable object is null.");
 
-	SignalData *s = signal_map.getptr(p_signal);
+	SignalData *s = signal_map.lookup_ptr(p_signal);
 	if (!s) {
 		bool signal_is_valid = ClassDB::has_signal(get_class_name(), p_signal);
 		//check in script
@@ -1332,8 +1332,8 @@ Error Object::connect(const StringName &p_signal, const Callable &p_callable, co
 
 		ERR_FAIL_COND_V_MSG(!signal_is_valid, ERR_INVALID_PARAMETER, "In Object of type '" + String(get_class()) + "': Attempt to connect nonexistent signal '" + p_signal + "' to callable '" + p_callable + "'.");
 
-		signal_map[p_signal] = SignalData();
-		s = &signal_map[p_signal];
+		signal_map.insert(p_signal, SignalData());
+		s = signal_map.lookup_ptr(p_signal);
 	}
 
 	Callable target = p_callable;
@@ -1369,7 +1369,7 @@ Error Object::connect(const StringName &p_signal, const Callable &p_callable, co
 
 bool Object::is_connected(const StringName &p_signal, const Callable &p_callable) const {
 	ERR_FAIL_COND_V_MSG(p_callable.is_null(), false, "Cannot determine if connected to '" + p_signal + "': the provided callable is null.");
-	const SignalData *s = signal_map.getptr(p_signal);
+	const SignalData *s = signal_map.lookup_ptr(p_signal);
 	if (!s) {
 		bool signal_is_valid = ClassDB::has_signal(get_class_name(), p_signal);
 		if (signal_is_valid) {
@@ -1400,7 +1400,7 @@ void Object::_disconnect(const StringName &p_signal, const Callable &p_callable,
 	Object *target_object = p_callable.get_object();
 	ERR_FAIL_COND_MSG(!target_object, "Cannot disconnect '" + p_signal + "' from callable '" + p_callable + "': the callable object is null.");
 
-	SignalData *s = signal_map.getptr(p_signal);
+	SignalData *s = signal_map.lookup_ptr(p_signal);
 	if (!s) {
 		bool signal_is_valid = ClassDB::has_signal(get_class_name(), p_signal) ||
 				(!script.is_null() && Ref<Script>(script)->has_script_signal(p_signal));
@@ -1424,7 +1424,7 @@ void Object::_disconnect(const StringName &p_signal, const Callable &p_callable,
 
 	if (s->slot_map.is_empty() && ClassDB::has_signal(get_class_name(), p_signal)) {
 		//not user signal, delete
-		signal_map.erase(p_signal);
+		signal_map.remove(p_signal);
 	}
 }
 
@@ -1866,15 +1866,14 @@ Object::~Object() {
 		_extension_instance = nullptr;
 	}
 
-	const StringName *S = nullptr;
-
 	if (_emitting) {
 		//@todo this may need to actually reach the debugger prioritarily somehow because it may crash before
 		ERR_PRINT("Object " + to_string() + " was freed or unreferenced while a signal is being emitted from it. Try connecting to the signal using 'CONNECT_DEFERRED' flag, or use queue_free() to free the object (if this object is a Node) to avoid this error and potential crashes.");
 	}
 
-	while ((S = signal_map.next(nullptr))) {
-		SignalData *s = &signal_map[*S];
+	// Removing invalidates iterators, so always restart from the first signal.
+	for (OAHashMap<StringName, SignalData>::Iterator it = signal_map.iter(); it.valid; it = signal_map.iter()) {
+		SignalData *s = it.value;
 
 		//brute force disconnect for performance
 		int slot_count = s->slot_map.size();
@@ -1884,7 +1883,7 @@ Object::~Object() {
 			slot_list[i].value.conn.callable.get_object()->connections.erase(slot_list[i].value.cE);
 		}
 
-		signal_map.erase(*S);
+		signal_map.remove(StringName(*it.key));
 	}
 
 	//signals from nodes that connect to this node
@@ -0,0 +1,74 @@
+/*************************************************************************/
+/*  condition_variable.h                                                 */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2022 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2022 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef CONDITION_VARIABLE_H
+#define CONDITION_VARIABLE_H
+
+#include "core/os/mutex.h"
+
+#if !defined(NO_THREADS)
+
+#include <condition_variable>
+
+// Wraps std::condition_variable_any so it can be used together with the
+// engine mutex types. The mutex passed to wait() must be locked by the caller
+// (typically through a MutexLock).
+
+class ConditionVariable {
+	mutable std::condition_variable_any condition;
+
+public:
+	template <class MutexT>
+	_ALWAYS_INLINE_ void wait(const MutexT &p_mutex) const {
+		condition.wait(p_mutex);
+	}
+
+	_ALWAYS_INLINE_ void notify_one() const {
+		condition.notify_one();
+	}
+
+	_ALWAYS_INLINE_ void notify_all() const {
+		condition.notify_all();
+	}
+};
+
+#else
+
+class ConditionVariable {
+public:
+	template <class MutexT>
+	_ALWAYS_INLINE_ void wait(const MutexT &p_mutex) const {}
+	_ALWAYS_INLINE_ void notify_one() const {}
+	_ALWAYS_INLINE_ void notify_all() const {}
+};
+
+#endif
+
+#endif // CONDITION_VARIABLE_H
@@ -61,9 +61,13 @@ void operator delete(void *p_mem, void *p_pointer, size_t check, const char *p_d
 #ifdef DEBUG_ENABLED
 SafeNumeric<uint64_t> Memory::mem_usage;
 SafeNumeric<uint64_t> Memory::max_usage;
+
+SafeNumeric<uint64_t> Memory::tag_alloc_count[TAG_MAX];
+SafeNumeric<uint64_t> Memory::tag_alloc_bytes[TAG_MAX];
 #endif
 
 SafeNumeric<uint64_t> Memory::alloc_count;
+thread_local Memory::Tag Memory::current_tag = Memory::TAG_DEFAULT;
 
 void *Memory::alloc_static(size_t p_bytes, bool p_pad_align) {
 #ifdef DEBUG_ENABLED
@@ -78,6 +82,11 @@ void *Memory::alloc_static(size_t p_bytes, bool p_pad_align) {
 
 	alloc_count.increment();
 
+#ifdef DEBUG_ENABLED
+	tag_alloc_count[current_tag].increment();
+	tag_alloc_bytes[current_tag].add(p_bytes);
+#endif
+
 	if (prepad) {
 		uint64_t *s = (uint64_t *)mem;
 		*s = p_bytes;
@@ -102,6 +111,9 @@ void *Memory::realloc_static(void *p_memory, size_t p_bytes, bool p_pad_align) {
 	uint8_t *mem = (uint8_t *)p_memory;
 
 #ifdef DEBUG_ENABLED
+	tag_alloc_count[current_tag].increment();
+	tag_alloc_bytes[current_tag].add(p_bytes);
+
 	bool prepad = true;
 #else
 	bool prepad = p_pad_align;
@@ -191,6 +203,37 @@ uint64_t Memory::get_mem_max_usage() {
 #endif
 }
 
+uint64_t Memory::get_tag_alloc_count(Tag p_tag) {
+	ERR_FAIL_INDEX_V(p_tag, TAG_MAX, 0);
+#ifdef DEBUG_ENABLED
+	return tag_alloc_count[p_tag].get();
+#else
+	return 0;
+#endif
+}
+
+uint64_t Memory::get_tag_alloc_bytes(Tag p_tag) {
+	ERR_FAIL_INDEX_V(p_tag, TAG_MAX, 0);
+#ifdef DEBUG_ENABLED
+	return tag_alloc_bytes[p_tag].get();
+#else
+	return 0;
+#endif
+}
+
+const char *Memory::get_tag_name(Tag p_tag) {
+	static const char *names[TAG_MAX] = {
+		"Default",
+		"Scene",
+		"Physics",
+		"Rendering",
+		"Audio",
+		"Script",
+	};
+	ERR_FAIL_INDEX_V(p_tag, TAG_MAX, "");
+	return names[p_tag];
+}
+
 _GlobalNil::_GlobalNil() {
 	left = this;
 	right = this;
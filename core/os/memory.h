@@ -42,12 +42,31 @@
 #endif
 
 class Memory {
+public:
+	// Subsystems that allocation traffic can be attributed to, see MemoryTagScope.
+	enum Tag {
+		TAG_DEFAULT,
+		TAG_SCENE,
+		TAG_PHYSICS,
+		TAG_RENDERING,
+		TAG_AUDIO,
+		TAG_SCRIPT,
+		TAG_MAX
+	};
+
+private:
+	friend class MemoryTagScope;
+
 #ifdef DEBUG_ENABLED
 	static SafeNumeric<uint64_t> mem_usage;
 	static SafeNumeric<uint64_t> max_usage;
+
+	static SafeNumeric<uint64_t> tag_alloc_count[TAG_MAX];
+	static SafeNumeric<uint64_t> tag_alloc_bytes[TAG_MAX];
 #endif
 
 	static SafeNumeric<uint64_t> alloc_count;
+	static thread_local Tag current_tag;
 
 public:
 	static void *alloc_static(size_t p_bytes, bool p_pad_align = false);
@@ -57,6 +76,27 @@ public:
 	static uint64_t get_mem_available();
 	static uint64_t get_mem_usage();
 	static uint64_t get_mem_max_usage();
+
+	// Cumulative number of calls (and bytes requested) to alloc_static()/realloc_static()
+	// made while the given tag was active. Only tracked in debug builds.
+	static uint64_t get_tag_alloc_count(Tag p_tag);
+	static uint64_t get_tag_alloc_bytes(Tag p_tag);
+	static const char *get_tag_name(Tag p_tag);
+};
+
+// Attributes all allocations made by the current thread to a subsystem until the scope ends.
+// Scopes nest; the innermost one wins.
+class MemoryTagScope {
+	Memory::Tag prev_tag;
+
+public:
+	_FORCE_INLINE_ MemoryTagScope(Memory::Tag p_tag) {
+		prev_tag = Memory::current_tag;
+		Memory::current_tag = p_tag;
+	}
+	_FORCE_INLINE_ ~MemoryTagScope() {
+		Memory::current_tag = prev_tag;
+	}
 };
 
 class DefaultAllocator {
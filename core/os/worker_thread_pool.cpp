@@ -0,0 +1,493 @@
+/*************************************************************************/
+/*  worker_thread_pool.cpp                                               */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2022 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2022 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#include "worker_thread_pool.h"
+
+#include "core/os/os.h"
+
+WorkerThreadPool *WorkerThreadPool::singleton = nullptr;
+thread_local int WorkerThreadPool::current_worker = -1;
+
+void WorkerThreadPool::JobQueue::push(Task *p_task, uint32_t p_count) {
+	lock.lock();
+	if (count + p_count > buffer.size()) {
+		uint32_t old_capacity = buffer.size();
+		uint32_t new_capacity = MAX(old_capacity, 16u);
+		while (new_capacity < count + p_count) {
+			new_capacity <<= 1;
+		}
+		LocalVector<Task *> new_buffer;
+		new_buffer.resize(new_capacity);
+		for (uint32_t i = 0; i < count; i++) {
+			new_buffer[i] = buffer[(head + i) & (old_capacity - 1)];
+		}
+		buffer = new_buffer;
+		head = 0;
+	}
+	uint32_t mask = buffer.size() - 1;
+	for (uint32_t i = 0; i < p_count; i++) {
+		buffer[(head + count + i) & mask] = p_task;
+	}
+	count += p_count;
+	lock.unlock();
+}
+
+WorkerThreadPool::Task *WorkerThreadPool::JobQueue::pop_back() {
+	lock.lock();
+	Task *task = nullptr;
+	if (count > 0) {
+		count--;
+		task = buffer[(head + count) & (buffer.size() - 1)];
+	}
+	lock.unlock();
+	return task;
+}
+
+WorkerThreadPool::Task *WorkerThreadPool::JobQueue::pop_front() {
+	lock.lock();
+	Task *task = nullptr;
+	if (count > 0) {
+		task = buffer[head];
+		head = (head + 1) & (buffer.size() - 1);
+		count--;
+	}
+	lock.unlock();
+	return task;
+}
+
+void WorkerThreadPool::_thread_function(void *p_user) {
+	ThreadData *thread = static_cast<ThreadData *>(p_user);
+	WorkerThreadPool *pool = thread->pool;
+	current_worker = thread->index;
+
+	while (true) {
+		Task *job = pool->_pop_job();
+		if (job) {
+			pool->_process_job(job);
+			continue;
+		}
+
+		MutexLock lock(pool->task_mutex);
+		if (pool->exit_threads.load()) {
+			break;
+		}
+		if (pool->queued_jobs.load() > 0) {
+			continue; // Something was pushed meanwhile.
+		}
+		pool->idle_workers++;
+		pool->work_available.wait(pool->task_mutex);
+		pool->idle_workers--;
+	}
+
+	current_worker = -1;
+}
+
+WorkerThreadPool::Task *WorkerThreadPool::_alloc_task() {
+	return task_allocator.alloc();
+}
+
+void WorkerThreadPool::_free_task(Task *p_task) {
+	if (p_task->template_userdata) {
+		if ((void *)p_task->template_userdata == (void *)p_task->inline_userdata) {
+			p_task->template_userdata->~BaseTemplateUserdata();
+		} else {
+			memdelete(p_task->template_userdata);
+		}
+		p_task->template_userdata = nullptr;
+	}
+	task_allocator.free(p_task);
+}
+
+void WorkerThreadPool::_setup_group(Task *p_task, uint32_t p_elements, int p_tasks) {
+	p_task->group = true;
+	p_task->max_elements = p_elements;
+	uint32_t runners = p_tasks < 0 ? MAX(thread_count, 1u) : MAX(p_tasks, 1);
+	p_task->runners = MIN(runners, p_elements);
+}
+
+WorkerThreadPool::TaskID WorkerThreadPool::_add_task(Task *p_task, const Vector<TaskID> &p_dependencies) {
+	MutexLock lock(task_mutex);
+
+	TaskID id = last_task++;
+	p_task->self = id;
+	tasks.set(id, p_task);
+
+	for (int i = 0; i < p_dependencies.size(); i++) {
+		Task **dependency = tasks.getptr(p_dependencies[i]);
+		// IDs already waited on (hence released) count as completed.
+		if (dependency && !(*dependency)->completed.is_set()) {
+			(*dependency)->dependents.push_back(p_task);
+			p_task->pending_dependencies++;
+		}
+	}
+
+	if (p_task->pending_dependencies == 0) {
+		_schedule(p_task);
+	}
+
+	return id;
+}
+
+void WorkerThreadPool::_schedule(Task *p_task) {
+	if (!p_task->group) {
+		p_task->runners = 1;
+		_push_jobs(p_task, 1);
+	} else if (p_task->max_elements == 0) {
+		_complete_task(p_task);
+	} else {
+		_push_jobs(p_task, p_task->runners);
+	}
+}
+
+void WorkerThreadPool::_push_jobs(Task *p_task, uint32_t p_count) {
+	// Tasks added from a worker go to its own deque, so nested work stays
+	// local unless other workers are starving and come to steal it.
+	int worker = current_worker;
+	JobQueue &queue = queues[worker >= 0 ? uint32_t(worker) : thread_count];
+	queue.push(p_task, p_count);
+	queued_jobs += p_count;
+
+	if (idle_workers.load() > 0) {
+		if (p_count == 1) {
+			work_available.notify_one();
+		} else {
+			work_available.notify_all();
+		}
+	} else if (blocked_waiters.load() > 0) {
+		// Everyone is busy, let the waiting threads help.
+		task_completed.notify_all();
+	}
+}
+
+void WorkerThreadPool::_complete_task(Task *p_task) {
+	p_task->completed.set();
+
+	for (uint32_t i = 0; i < p_task->dependents.size(); i++) {
+		Task *dependent = p_task->dependents[i];
+		dependent->pending_dependencies--;
+		if (dependent->pending_dependencies == 0) {
+			_schedule(dependent);
+		}
+	}
+	p_task->dependents.clear();
+
+	if (blocked_waiters.load() > 0) {
+		task_completed.notify_all();
+	}
+}
+
+WorkerThreadPool::Task *WorkerThreadPool::_pop_job() {
+	if (queued_jobs.load(std::memory_order_acquire) == 0) {
+		return nullptr;
+	}
+
+	int worker = current_worker;
+	Task *task = nullptr;
+
+	if (worker >= 0) {
+		task = queues[worker].pop_back();
+	}
+	if (!task) {
+		task = queues[thread_count].pop_front();
+	}
+	if (!task) {
+		// Steal the oldest job of another worker, starting from our neighbor
+		// so thieves spread across the victims.
+		uint32_t start = worker >= 0 ? uint32_t(worker) + 1 : 0;
+		for (uint32_t i = 0; i < thread_count && !task; i++) {
+			uint32_t victim = (start + i) % thread_count;
+			if (int(victim) != worker) {
+				task = queues[victim].pop_front();
+			}
+		}
+	}
+
+	if (task) {
+		queued_jobs--;
+	}
+	return task;
+}
+
+uint32_t WorkerThreadPool::_process_group_elements(Task *p_task) {
+	uint32_t processed = 0;
+	while (true) {
+		uint32_t index = p_task->index.postincrement();
+		if (index >= p_task->max_elements) {
+			break;
+		}
+		if (p_task->template_userdata) {
+			p_task->template_userdata->callback_indexed(index);
+		} else {
+			p_task->native_group_func(p_task->native_func_userdata, index);
+		}
+		processed++;
+	}
+	return processed;
+}
+
+void WorkerThreadPool::_process_job(Task *p_task) {
+	if (p_task->group) {
+		uint32_t processed = _process_group_elements(p_task);
+
+		MutexLock lock(task_mutex);
+		if (processed > 0 && p_task->finished.add(processed) == p_task->max_elements) {
+			_complete_task(p_task);
+		}
+		p_task->runners--;
+		if (p_task->runners == 0 && p_task->waited) {
+			_free_task(p_task);
+		}
+	} else {
+		// May have been run already by the thread waiting on it.
+		bool claimed = p_task->started.postincrement() == 0;
+		if (claimed) {
+			_run_task(p_task);
+		}
+
+		MutexLock lock(task_mutex);
+		if (claimed) {
+			_complete_task(p_task);
+		}
+		p_task->runners--;
+		if (p_task->runners == 0 && p_task->waited) {
+			_free_task(p_task);
+		}
+	}
+}
+
+void WorkerThreadPool::_run_task(Task *p_task) {
+	if (p_task->template_userdata) {
+		p_task->template_userdata->callback();
+	} else {
+		p_task->native_func(p_task->native_func_userdata);
+	}
+}
+
+void WorkerThreadPool::_wait_for(TaskID p_task, bool p_group) {
+	Task *task = nullptr;
+	{
+		MutexLock lock(task_mutex);
+		Task **t = tasks.getptr(p_task);
+		ERR_FAIL_COND_MSG(!t, "Invalid Task ID.");
+		ERR_FAIL_COND_MSG((*t)->group != p_group, p_group ? "Task ID is not a group task." : "Task ID is a group task.");
+		task = *t;
+	}
+
+	bool helped = false;
+	// Only workers run unrelated jobs while waiting. Other threads may hold locks
+	// those jobs need, or be the main thread, which must not stall on them.
+	// Without workers there is no one else to run them, though.
+	bool help_others = current_worker >= 0 || thread_count == 0;
+
+	while (!task->completed.is_set()) {
+		if (!helped) {
+			bool ready = false;
+			{
+				MutexLock lock(task_mutex);
+				ready = task->pending_dependencies == 0;
+			}
+			if (ready) {
+				// Work on the awaited task directly before anything else.
+				helped = true;
+				if (p_group) {
+					uint32_t processed = _process_group_elements(task);
+					if (processed > 0) {
+						MutexLock lock(task_mutex);
+						if (task->finished.add(processed) == task->max_elements) {
+							_complete_task(task);
+						}
+					}
+				} else if (task->started.postincrement() == 0) {
+					// Its queued job is released by whoever pops it.
+					_run_task(task);
+					MutexLock lock(task_mutex);
+					_complete_task(task);
+				}
+				continue;
+			}
+		}
+
+		if (help_others) {
+			Task *job = _pop_job();
+			if (job) {
+				_process_job(job);
+				continue;
+			}
+		}
+
+		MutexLock lock(task_mutex);
+		if (task->completed.is_set()) {
+			break;
+		}
+		if (help_others && queued_jobs.load() > 0) {
+			continue;
+		}
+		blocked_waiters++;
+		task_completed.wait(task_mutex);
+		blocked_waiters--;
+	}
+
+	MutexLock lock(task_mutex);
+	tasks.erase(p_task);
+	task->waited = true;
+	if (task->runners == 0) {
+		_free_task(task);
+	}
+}
+
+WorkerThreadPool::TaskID WorkerThreadPool::add_native_task(void (*p_func)(void *), void *p_userdata, const Vector<TaskID> &p_dependencies) {
+	Task *task = _alloc_task();
+	task->native_func = p_func;
+	task->native_func_userdata = p_userdata;
+	return _add_task(task, p_dependencies);
+}
+
+bool WorkerThreadPool::is_task_completed(TaskID p_task) const {
+	MutexLock lock(task_mutex);
+	Task *const *task = tasks.getptr(p_task);
+	ERR_FAIL_COND_V_MSG(!task, false, "Invalid Task ID.");
+	return (*task)->completed.is_set();
+}
+
+void WorkerThreadPool::wait_for_task_completion(TaskID p_task) {
+	_wait_for(p_task, false);
+}
+
+WorkerThreadPool::TaskID WorkerThreadPool::add_native_group_task(void (*p_func)(void *, uint32_t), void *p_userdata, uint32_t p_elements, int p_tasks, const Vector<TaskID> &p_dependencies) {
+	Task *task = _alloc_task();
+	task->native_group_func = p_func;
+	task->native_func_userdata = p_userdata;
+	_setup_group(task, p_elements, p_tasks);
+	return _add_task(task, p_dependencies);
+}
+
+uint32_t WorkerThreadPool::get_group_processed_element_count(TaskID p_group) const {
+	MutexLock lock(task_mutex);
+	Task *const *task = tasks.getptr(p_group);
+	ERR_FAIL_COND_V_MSG(!task, 0, "Invalid Group ID.");
+	return (*task)->finished.get();
+}
+
+uint32_t WorkerThreadPool::get_group_dispatched_element_count(TaskID p_group) const {
+	MutexLock lock(task_mutex);
+	Task *const *task = tasks.getptr(p_group);
+	ERR_FAIL_COND_V_MSG(!task, 0, "Invalid Group ID.");
+	// Runners overshoot the index once before noticing there's nothing left.
+	return MIN((*task)->index.get(), (*task)->max_elements);
+}
+
+bool WorkerThreadPool::is_group_task_completed(TaskID p_group) const {
+	MutexLock lock(task_mutex);
+	Task *const *task = tasks.getptr(p_group);
+	ERR_FAIL_COND_V_MSG(!task, false, "Invalid Group ID.");
+	return (*task)->completed.is_set();
+}
+
+void WorkerThreadPool::wait_for_group_task_completion(TaskID p_group) {
+	_wait_for(p_group, true);
+}
+
+void WorkerThreadPool::init(int p_thread_count) {
+	ERR_FAIL_COND(queues != nullptr);
+	if (p_thread_count < 0) {
+		p_thread_count = OS::get_singleton()->get_default_thread_pool_size();
+	}
+
+#ifdef NO_THREADS
+	// Jobs are run by whoever waits on them.
+	p_thread_count = 0;
+#endif
+
+	thread_count = p_thread_count;
+	queues = memnew_arr(JobQueue, thread_count + 1);
+	exit_threads.store(false);
+
+	if (thread_count > 0) {
+		threads = memnew_arr(ThreadData, thread_count);
+		for (uint32_t i = 0; i < thread_count; i++) {
+			threads[i].pool = this;
+			threads[i].index = i;
+			threads[i].thread.start(&WorkerThreadPool::_thread_function, &threads[i]);
+		}
+	}
+}
+
+void WorkerThreadPool::finish() {
+	if (queues == nullptr) {
+		return;
+	}
+
+	{
+		MutexLock lock(task_mutex);
+		exit_threads.store(true);
+		work_available.notify_all();
+	}
+
+	for (uint32_t i = 0; i < thread_count; i++) {
+		threads[i].thread.wait_to_finish();
+	}
+	if (threads) {
+		memdelete_arr(threads);
+		threads = nullptr;
+	}
+
+	// Run whatever was left queued, so every task reaches completion.
+	Task *job = _pop_job();
+	while (job) {
+		_process_job(job);
+		job = _pop_job();
+	}
+
+	if (tasks.size()) {
+		ERR_PRINT(itos(tasks.size()) + " task(s) were never waited on.");
+	}
+	const TaskID *key = nullptr;
+	while ((key = tasks.next(key))) {
+		_free_task(tasks[*key]);
+	}
+	tasks.clear();
+
+	memdelete_arr(queues);
+	queues = nullptr;
+	thread_count = 0;
+}
+
+WorkerThreadPool::WorkerThreadPool() {
+	singleton = this;
+	queued_jobs.store(0);
+	idle_workers.store(0);
+	blocked_waiters.store(0);
+	exit_threads.store(false);
+}
+
+WorkerThreadPool::~WorkerThreadPool() {
+	finish();
+	singleton = nullptr;
+}
@@ -0,0 +1,238 @@
+/*************************************************************************/
+/*  worker_thread_pool.h                                                 */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2022 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2022 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef WORKER_THREAD_POOL_H
+#define WORKER_THREAD_POOL_H
+
+#include "core/os/condition_variable.h"
+#include "core/os/memory.h"
+#include "core/os/mutex.h"
+#include "core/os/spin_lock.h"
+#include "core/os/thread.h"
+#include "core/templates/hash_map.h"
+#include "core/templates/local_vector.h"
+#include "core/templates/paged_allocator.h"
+#include "core/templates/safe_refcount.h"
+#include "core/templates/vector.h"
+
+#include <atomic>
+
+// Engine-wide task scheduler. A fixed set of worker threads is shared by every
+// subsystem; each worker owns a deque of pending jobs (LIFO for the owner,
+// FIFO for thieves) and steals from the others when it runs dry. Tasks added
+// from outside the pool go to a shared injection queue.
+//
+// Tasks may add more tasks (they go to the local deque of the worker running
+// them), may depend on other tasks or groups, and may wait on them. Workers
+// never wait idle: they run pending jobs until the awaited task is done, so
+// nested waits from inside workers can not starve the pool. Other threads
+// (e.g. the main thread, maybe holding locks) only run the task or group they
+// wait on, and otherwise block until it completes.
+//
+// Every task or group added must be waited on exactly once, this releases its
+// ID.
+
+class WorkerThreadPool {
+public:
+	typedef int64_t TaskID;
+
+	enum {
+		INVALID_TASK_ID = -1
+	};
+
+private:
+	struct BaseTemplateUserdata {
+		virtual void callback() {}
+		virtual void callback_indexed(uint32_t p_index) {}
+		virtual ~BaseTemplateUserdata() {}
+	};
+
+	template <class C, class M, class U>
+	struct TaskUserData : public BaseTemplateUserdata {
+		C *instance;
+		M method;
+		U userdata;
+		virtual void callback() override {
+			(instance->*method)(userdata);
+		}
+	};
+
+	template <class C, class M, class U>
+	struct GroupUserData : public BaseTemplateUserdata {
+		C *instance;
+		M method;
+		U userdata;
+		virtual void callback_indexed(uint32_t p_index) override {
+			(instance->*method)(p_index, userdata);
+		}
+	};
+
+	// Template userdata small enough is constructed inside the task itself,
+	// so adding a task does not hit the allocator.
+	static const uint32_t INLINE_USERDATA_SIZE = 64;
+
+	struct Task {
+		TaskID self = INVALID_TASK_ID;
+
+		BaseTemplateUserdata *template_userdata = nullptr;
+		void (*native_func)(void *) = nullptr;
+		void (*native_group_func)(void *, uint32_t) = nullptr;
+		void *native_func_userdata = nullptr;
+		alignas(16) uint8_t inline_userdata[INLINE_USERDATA_SIZE];
+
+		bool group = false;
+		uint32_t max_elements = 0;
+		SafeNumeric<uint32_t> index; // Next element to dispatch.
+		SafeNumeric<uint32_t> finished; // Elements processed.
+		SafeNumeric<uint32_t> started; // Single tasks run once, by whoever claims them first.
+		uint32_t runners = 0; // Queued or running entries of this task. Guarded by task_mutex.
+		uint32_t pending_dependencies = 0; // Guarded by task_mutex.
+		LocalVector<Task *> dependents; // Guarded by task_mutex.
+		SafeFlag completed;
+		bool waited = false; // Guarded by task_mutex.
+	};
+
+	struct JobQueue {
+		SpinLock lock;
+		LocalVector<Task *> buffer; // Ring buffer, capacity is a power of two.
+		uint32_t head = 0;
+		uint32_t count = 0;
+
+		void push(Task *p_task, uint32_t p_count);
+		Task *pop_back();
+		Task *pop_front();
+	};
+
+	struct ThreadData {
+		WorkerThreadPool *pool = nullptr;
+		uint32_t index = 0;
+		Thread thread;
+	};
+
+	PagedAllocator<Task, true> task_allocator;
+	HashMap<TaskID, Task *> tasks;
+	TaskID last_task = 1;
+
+	BinaryMutex task_mutex;
+	ConditionVariable work_available;
+	ConditionVariable task_completed;
+
+	ThreadData *threads = nullptr;
+	uint32_t thread_count = 0;
+	JobQueue *queues = nullptr; // One per worker, plus the injection queue at index thread_count.
+
+	std::atomic<uint32_t> queued_jobs;
+	std::atomic<uint32_t> idle_workers;
+	std::atomic<uint32_t> blocked_waiters;
+	std::atomic<bool> exit_threads;
+
+	static thread_local int current_worker; // Index of the worker owning the calling thread, or -1.
+	static WorkerThreadPool *singleton;
+
+	static void _thread_function(void *p_user);
+
+	Task *_alloc_task();
+	void _free_task(Task *p_task);
+	void _setup_group(Task *p_task, uint32_t p_elements, int p_tasks);
+	TaskID _add_task(Task *p_task, const Vector<TaskID> &p_dependencies);
+
+	// These expect task_mutex to be locked.
+	void _schedule(Task *p_task);
+	void _push_jobs(Task *p_task, uint32_t p_count);
+	void _complete_task(Task *p_task);
+
+	Task *_pop_job();
+	void _process_job(Task *p_task);
+	void _run_task(Task *p_task);
+	uint32_t _process_group_elements(Task *p_task);
+	void _wait_for(TaskID p_task, bool p_group);
+
+	template <class T>
+	_FORCE_INLINE_ BaseTemplateUserdata *_make_userdata(Task *p_task) {
+		if (sizeof(T) <= INLINE_USERDATA_SIZE) {
+			return memnew_placement(p_task->inline_userdata, T);
+		}
+		return memnew(T);
+	}
+
+public:
+	// Single tasks.
+	TaskID add_native_task(void (*p_func)(void *), void *p_userdata, const Vector<TaskID> &p_dependencies = Vector<TaskID>());
+
+	template <class C, class M, class U>
+	TaskID add_template_task(C *p_instance, M p_method, U p_userdata, const Vector<TaskID> &p_dependencies = Vector<TaskID>()) {
+		Task *task = _alloc_task();
+		TaskUserData<C, M, U> *ud = static_cast<TaskUserData<C, M, U> *>(_make_userdata<TaskUserData<C, M, U>>(task));
+		ud->instance = p_instance;
+		ud->method = p_method;
+		ud->userdata = p_userdata;
+		task->template_userdata = ud;
+		return _add_task(task, p_dependencies);
+	}
+
+	bool is_task_completed(TaskID p_task) const;
+	void wait_for_task_completion(TaskID p_task);
+
+	// Group tasks call the function once per element, spread across at most
+	// p_tasks workers (-1 uses all of them).
+	TaskID add_native_group_task(void (*p_func)(void *, uint32_t), void *p_userdata, uint32_t p_elements, int p_tasks = -1, const Vector<TaskID> &p_dependencies = Vector<TaskID>());
+
+	template <class C, class M, class U>
+	TaskID add_template_group_task(C *p_instance, M p_method, U p_userdata, uint32_t p_elements, int p_tasks = -1, const Vector<TaskID> &p_dependencies = Vector<TaskID>()) {
+		Task *task = _alloc_task();
+		GroupUserData<C, M, U> *ud = static_cast<GroupUserData<C, M, U> *>(_make_userdata<GroupUserData<C, M, U>>(task));
+		ud->instance = p_instance;
+		ud->method = p_method;
+		ud->userdata = p_userdata;
+		task->template_userdata = ud;
+		_setup_group(task, p_elements, p_tasks);
+		return _add_task(task, p_dependencies);
+	}
+
+	uint32_t get_group_processed_element_count(TaskID p_group) const;
+	// Elements handed out to a runner so far, processed or not.
+	uint32_t get_group_dispatched_element_count(TaskID p_group) const;
+	bool is_group_task_completed(TaskID p_group) const;
+	void wait_for_group_task_completion(TaskID p_group);
+
+	_FORCE_INLINE_ int get_thread_count() const { return thread_count; }
+	// Returns the worker index of the calling thread, or -1 if it is not a worker.
+	_FORCE_INLINE_ static int get_current_worker_index() { return current_worker; }
+
+	static WorkerThreadPool *get_singleton() { return singleton; }
+
+	void init(int p_thread_count = -1);
+	void finish();
+
+	WorkerThreadPool();
+	~WorkerThreadPool();
+};
+
+#endif // WORKER_THREAD_POOL_H
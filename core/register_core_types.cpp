@@ -76,6 +76,7 @@
 #include "core/object/undo_redo.h"
 #include "core/os/main_loop.h"
 #include "core/os/time.h"
+#include "core/os/worker_thread_pool.h"
 #include "core/string/optimized_translation.h"
 #include "core/string/translation.h"
 
@@ -110,6 +111,8 @@ extern void unregister_global_constants();
 
 static ResourceUID *resource_uid = nullptr;
 
+static WorkerThreadPool *worker_thread_pool = nullptr;
+
 static bool _is_core_extensions_registered = false;
 
 void register_core_types() {
@@ -119,6 +122,10 @@ void register_core_types() {
 	ObjectDB::setup();
 
 	StringName::setup();
+
+	worker_thread_pool = memnew(WorkerThreadPool);
+	worker_thread_pool->init();
+
 	ResourceLoader::initialize();
 
 	register_global_constants();
@@ -336,6 +343,8 @@ void unregister_core_extensions() {
 }
 
 void unregister_core_types() {
+	memdelete(worker_thread_pool);
+
 	memdelete(native_extension_manager);
 
 	memdelete(resource_uid);
@@ -48,7 +48,10 @@ class StringName {
 	enum {
 		STRING_TABLE_BITS = 16,
 		STRING_TABLE_LEN = 1 << STRING_TABLE_BITS,
-		STRING_TABLE_MASK = STRING_TABLE_LEN - 1
+		STRING_TABLE_MASK = STRING_TABLE_LEN - 1,
+		STRING_TABLE_SHARD_BITS = 6,
+		STRING_TABLE_SHARDS = 1 << STRING_TABLE_SHARD_BITS,
+		STRING_TABLE_SHARD_MASK = STRING_TABLE_SHARDS - 1
 	};
 
 	struct _Data {
@@ -80,7 +83,20 @@ class StringName {
 	friend void register_core_types();
 	friend void unregister_core_types();
 	friend class Main;
-	static Mutex mutex;
+
+	// The table is split in shards, each one guarding the buckets whose index
+	// shares its low bits, so threads interning different names rarely contend.
+	// Shards are cache line aligned to avoid false sharing between their locks.
+	struct alignas(64) _TableShard {
+		Mutex mutex;
+	};
+
+	static _TableShard _shards[STRING_TABLE_SHARDS];
+
+	_FORCE_INLINE_ static Mutex &_get_table_mutex(uint32_t p_idx) {
+		return _shards[p_idx & STRING_TABLE_SHARD_MASK].mutex;
+	}
+
 	static void setup();
 	static void cleanup();
 	static bool configured;
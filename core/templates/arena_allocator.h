@@ -0,0 +1,202 @@
+/*************************************************************************/
+/*  arena_allocator.h                                                    */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2022 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2022 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef ARENA_ALLOCATOR_H
+#define ARENA_ALLOCATOR_H
+
+#include "core/os/memory.h"
+#include "core/typedefs.h"
+
+#include <type_traits>
+
+// Bump allocator for short-lived scratch memory. Allocations are never freed
+// individually; instead, the arena is rewound to a previously taken mark or
+// reset as a whole. Blocks are recycled rather than returned to the system,
+// so once the arena has grown to its working size it does not touch malloc.
+//
+// Only trivially destructible data may be placed in an arena.
+// Not thread safe; use get_thread_arena() to obtain one per thread.
+class ArenaAllocator {
+	struct Block {
+		Block *prev = nullptr;
+		uint32_t size = 0;
+		uint32_t used = 0;
+	};
+
+	static constexpr uint32_t HEADER_SIZE = (sizeof(Block) + 15) & ~uint32_t(15);
+
+	Block *current = nullptr;
+	Block *spare = nullptr; // Recycled blocks, linked through prev.
+	uint32_t block_size = 0;
+
+	_FORCE_INLINE_ static uint8_t *_block_data(Block *p_block) {
+		return (uint8_t *)p_block + HEADER_SIZE;
+	}
+
+	Block *_take_block(uint32_t p_min_size) {
+		Block **prev_link = &spare;
+		for (Block *b = spare; b; b = b->prev) {
+			if (b->size >= p_min_size) {
+				*prev_link = b->prev;
+				return b;
+			}
+			prev_link = &b->prev;
+		}
+
+		uint32_t size = MAX(block_size, p_min_size);
+		if (current) {
+			size = MAX(size, current->size * 2);
+		}
+		Block *b = (Block *)memalloc(HEADER_SIZE + size);
+		ERR_FAIL_COND_V(!b, nullptr);
+		b->size = size;
+		return b;
+	}
+
+	void _release_chain(Block *p_block) {
+		while (p_block) {
+			Block *prev = p_block->prev;
+			memfree(p_block);
+			p_block = prev;
+		}
+	}
+
+public:
+	struct Mark {
+		Block *block = nullptr;
+		uint32_t used = 0;
+	};
+
+	void *alloc(size_t p_bytes, uint32_t p_align = 16) {
+		DEV_ASSERT(p_align > 0 && (p_align & (p_align - 1)) == 0 && p_align <= 16);
+		if (current) {
+			uint32_t offset = (current->used + p_align - 1) & ~(p_align - 1);
+			if (offset + p_bytes <= current->size) {
+				current->used = offset + p_bytes;
+				return _block_data(current) + offset;
+			}
+		}
+
+		ERR_FAIL_COND_V(p_bytes > UINT32_MAX - HEADER_SIZE, nullptr);
+		Block *b = _take_block(p_bytes);
+		ERR_FAIL_COND_V(!b, nullptr);
+		b->prev = current;
+		b->used = p_bytes;
+		current = b;
+		return _block_data(b);
+	}
+
+	template <class T>
+	T *alloc_array(uint32_t p_count) {
+		static_assert(std::is_trivially_destructible<T>::value, "Arena memory is never destructed.");
+		static_assert(alignof(T) <= 16, "Arena allocations are aligned to at most 16 bytes.");
+		return (T *)alloc(sizeof(T) * p_count, alignof(T));
+	}
+
+	_FORCE_INLINE_ Mark get_mark() const {
+		Mark mark;
+		mark.block = current;
+		mark.used = current ? current->used : 0;
+		return mark;
+	}
+
+	// Releases everything allocated after p_mark was taken.
+	void rewind(const Mark &p_mark) {
+		while (current != p_mark.block) {
+			ERR_FAIL_COND_MSG(!current, "Arena mark does not belong to this arena, or was already rewound past.");
+			Block *prev = current->prev;
+			current->prev = spare;
+			spare = current;
+			current = prev;
+		}
+		if (current) {
+			current->used = p_mark.used;
+		}
+	}
+
+	// Releases everything. If the previous cycle needed more than one block,
+	// they are merged into one so the next cycle fits in a single block.
+	void reset() {
+		rewind(Mark());
+		if (spare && spare->prev) {
+			uint64_t total = 0;
+			for (Block *b = spare; b; b = b->prev) {
+				total += b->size;
+			}
+			_release_chain(spare);
+			spare = nullptr;
+			block_size = MAX(block_size, (uint32_t)MIN(total, (uint64_t)(UINT32_MAX - HEADER_SIZE)));
+		}
+	}
+
+	uint64_t get_capacity() const {
+		uint64_t total = 0;
+		for (Block *b = current; b; b = b->prev) {
+			total += b->size;
+		}
+		for (Block *b = spare; b; b = b->prev) {
+			total += b->size;
+		}
+		return total;
+	}
+
+	// The calling thread's scratch arena. The main thread's arena is reset once
+	// per frame by Main::iteration(); other threads must use Scope (or reset it
+	// themselves) so memory does not accumulate.
+	static ArenaAllocator &get_thread_arena() {
+		static thread_local ArenaAllocator arena;
+		return arena;
+	}
+
+	// Rewinds the calling thread's arena to where it was when the scope began.
+	class Scope {
+		ArenaAllocator &arena;
+		Mark mark;
+
+	public:
+		_FORCE_INLINE_ ArenaAllocator &get_arena() { return arena; }
+
+		Scope() :
+				arena(get_thread_arena()),
+				mark(arena.get_mark()) {}
+		~Scope() { arena.rewind(mark); }
+	};
+
+	ArenaAllocator(uint32_t p_block_size = 64 * 1024) {
+		block_size = p_block_size;
+	}
+
+	~ArenaAllocator() {
+		_release_chain(current);
+		_release_chain(spare);
+	}
+};
+
+#endif // ARENA_ALLOCATOR_H
@@ -43,11 +43,21 @@
  * improve the performance and to avoid infinite loops in rare cases.
  *
  * The entries are stored inplace, so huge keys or values might fill cache lines
- * a lot faster.
+ * a lot faster. The full hash of every entry is kept in its own array, so
+ * probing only touches keys whose hash matches.
+ *
+ * The capacity is always a power of 2 and hashes are spread over it with a
+ * multiplicative (Fibonacci) step, so weak hashes such as the identity hash
+ * of integers don't cluster. No memory is allocated until the first insertion,
+ * which keeps empty maps (e.g. per-object tables) cheap.
  *
  * Only used keys and values are constructed. For free positions there's space
  * in the arrays for each, but that memory is kept uninitialized.
  *
+ * Pointers returned by lookup_ptr() and iterators are invalidated by any
+ * insertion or removal, as entries move around when probing or resizing.
+ * To remove entries while iterating, restart from iter() after each removal.
+ *
  * The assignment operator copy the pairs from one map to the other.
  */
 template <class TKey, class TValue,
@@ -60,10 +70,12 @@ private:
 	uint32_t *hashes = nullptr;
 
 	uint32_t capacity = 0;
+	uint32_t capacity_shift = 0;
 
 	uint32_t num_elements = 0;
 
 	static const uint32_t EMPTY_HASH = 0;
+	static const uint32_t MIN_CAPACITY_SHIFT = 3;
 
 	_FORCE_INLINE_ uint32_t _hash(const TKey &p_key) const {
 		uint32_t hash = Hasher::hash(p_key);
@@ -75,9 +87,13 @@ private:
 		return hash;
 	}
 
+	_FORCE_INLINE_ uint32_t _get_position(uint32_t p_hash) const {
+		return (p_hash * 0x9E3779B9u) >> (32 - capacity_shift);
+	}
+
 	_FORCE_INLINE_ uint32_t _get_probe_length(uint32_t p_pos, uint32_t p_hash) const {
-		uint32_t original_pos = p_hash % capacity;
-		return (p_pos - original_pos + capacity) % capacity;
+		uint32_t original_pos = _get_position(p_hash);
+		return (p_pos - original_pos) & (capacity - 1);
 	}
 
 	_FORCE_INLINE_ void _construct(uint32_t p_pos, uint32_t p_hash, const TKey &p_key, const TValue &p_value) {
@@ -89,8 +105,12 @@ private:
 	}
 
 	bool _lookup_pos(const TKey &p_key, uint32_t &r_pos) const {
+		if (num_elements == 0) {
+			return false;
+		}
+
 		uint32_t hash = _hash(p_key);
-		uint32_t pos = hash % capacity;
+		uint32_t pos = _get_position(hash);
 		uint32_t distance = 0;
 
 		while (true) {
@@ -107,7 +127,7 @@ private:
 				return true;
 			}
 
-			pos = (pos + 1) % capacity;
+			pos = (pos + 1) & (capacity - 1);
 			distance++;
 		}
 	}
@@ -115,7 +135,7 @@ private:
 	void _insert_with_hash(uint32_t p_hash, const TKey &p_key, const TValue &p_value) {
 		uint32_t hash = p_hash;
 		uint32_t distance = 0;
-		uint32_t pos = hash % capacity;
+		uint32_t pos = _get_position(hash);
 
 		TKey key = p_key;
 		TValue value = p_value;
@@ -136,7 +156,7 @@ private:
 				distance = existing_probe_len;
 			}
 
-			pos = (pos + 1) % capacity;
+			pos = (pos + 1) & (capacity - 1);
 			distance++;
 		}
 	}
@@ -144,8 +164,12 @@ private:
 	void _resize_and_rehash(uint32_t p_new_capacity) {
 		uint32_t old_capacity = capacity;
 
-		// Capacity can't be 0.
-		capacity = MAX(1u, p_new_capacity);
+		// Capacity is a power of 2, and never smaller than the minimum once allocated.
+		capacity_shift = nearest_shift(MAX(1u, p_new_capacity) - 1);
+		if (capacity_shift < MIN_CAPACITY_SHIFT) {
+			capacity_shift = MIN_CAPACITY_SHIFT;
+		}
+		capacity = 1 << capacity_shift;
 
 		TKey *old_keys = keys;
 		TValue *old_values = values;
@@ -157,7 +181,7 @@ private:
 		hashes = static_cast<uint32_t *>(Memory::alloc_static(sizeof(uint32_t) * capacity));
 
 		for (uint32_t i = 0; i < capacity; i++) {
-			hashes[i] = 0;
+			hashes[i] = EMPTY_HASH;
 		}
 
 		if (old_capacity == 0) {
@@ -185,6 +209,24 @@ private:
 		_resize_and_rehash(capacity * 2);
 	}
 
+	void _free() {
+		if (capacity == 0) {
+			return;
+		}
+
+		clear();
+
+		Memory::free_static(keys);
+		Memory::free_static(values);
+		Memory::free_static(hashes);
+
+		keys = nullptr;
+		values = nullptr;
+		hashes = nullptr;
+		capacity = 0;
+		capacity_shift = 0;
+	}
+
 public:
 	_FORCE_INLINE_ uint32_t get_capacity() const { return capacity; }
 	_FORCE_INLINE_ uint32_t get_num_elements() const { return num_elements; }
@@ -208,7 +250,8 @@ public:
 	}
 
 	void insert(const TKey &p_key, const TValue &p_value) {
-		if (num_elements + 1 > 0.9 * capacity) {
+		// Keep the load factor under 90%.
+		if (capacity == 0 || (num_elements + 1) * 10 > capacity * 9) {
 			_resize_and_rehash();
 		}
 
@@ -279,14 +322,14 @@ public:
 			return;
 		}
 
-		uint32_t next_pos = (pos + 1) % capacity;
+		uint32_t next_pos = (pos + 1) & (capacity - 1);
 		while (hashes[next_pos] != EMPTY_HASH &&
 				_get_probe_length(next_pos, hashes[next_pos]) != 0) {
 			SWAP(hashes[next_pos], hashes[pos]);
 			SWAP(keys[next_pos], keys[pos]);
 			SWAP(values[next_pos], values[pos]);
 			pos = next_pos;
-			next_pos = (pos + 1) % capacity;
+			next_pos = (pos + 1) & (capacity - 1);
 		}
 
 		hashes[pos] = EMPTY_HASH;
@@ -358,43 +401,31 @@ public:
 	}
 
 	void operator=(const OAHashMap &p_other) {
-		if (capacity != 0) {
-			clear();
+		if (this == &p_other) {
+			return;
+		}
+
+		_free();
+
+		if (p_other.num_elements == 0) {
+			return;
 		}
 
 		_resize_and_rehash(p_other.capacity);
 
 		for (Iterator it = p_other.iter(); it.valid; it = p_other.next_iter(it)) {
-			set(*it.key, *it.value);
+			_insert_with_hash(p_other.hashes[it.pos - 1], *it.key, *it.value);
 		}
 	}
 
-	OAHashMap(uint32_t p_initial_capacity = 64) {
-		// Capacity can't be 0.
-		capacity = MAX(1u, p_initial_capacity);
-
-		keys = static_cast<TKey *>(Memory::alloc_static(sizeof(TKey) * capacity));
-		values = static_cast<TValue *>(Memory::alloc_static(sizeof(TValue) * capacity));
-		hashes = static_cast<uint32_t *>(Memory::alloc_static(sizeof(uint32_t) * capacity));
-
-		for (uint32_t i = 0; i < capacity; i++) {
-			hashes[i] = EMPTY_HASH;
+	OAHashMap(uint32_t p_initial_capacity = 0) {
+		if (p_initial_capacity > 0) {
+			_resize_and_rehash(p_initial_capacity);
 		}
 	}
 
 	~OAHashMap() {
-		for (uint32_t i = 0; i < capacity; i++) {
-			if (hashes[i] == EMPTY_HASH) {
-				continue;
-			}
-
-			values[i].~TValue();
-			keys[i].~TKey();
-		}
-
-		Memory::free_static(keys);
-		Memory::free_static(values);
-		Memory::free_static(hashes);
+		_free();
 	}
 };
 
@@ -131,4 +131,36 @@ public:
 	}
 };
 
+// Allocator policy (usable as the `A` parameter of List, Map, Set, etc.) serving
+// every allocation from a shared, thread safe PagedAllocator of fixed size slots.
+// Pick the size class from the container's node size; requests larger than
+// SIZE are a programming error. Pools live for the whole program and are never
+// returned to the system, which makes them safe to use from static containers.
+template <uint32_t SIZE>
+class PagedSizeClassAllocator {
+	static_assert(SIZE > 0 && SIZE % 8 == 0, "Size class must be a multiple of 8 bytes.");
+
+	struct Slot {
+		uint64_t data[SIZE / 8];
+		Slot() {} // Don't zero the slot on every allocation.
+	};
+
+	typedef PagedAllocator<Slot, true> Pool;
+
+	static Pool &_get_pool() {
+		// Intentionally leaked, see above.
+		static Pool *pool = memnew(Pool(MAX(4096u / SIZE, 64u)));
+		return *pool;
+	}
+
+public:
+	_FORCE_INLINE_ static void *alloc(size_t p_bytes) {
+		CRASH_COND_MSG(p_bytes > SIZE, "Allocation does not fit the size class of this PagedSizeClassAllocator.");
+		return _get_pool().alloc();
+	}
+	_FORCE_INLINE_ static void free(void *p_ptr) {
+		_get_pool().free((Slot *)p_ptr);
+	}
+};
+
 #endif // PAGED_ALLOCATOR_H
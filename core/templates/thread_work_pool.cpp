@@ -30,50 +30,30 @@
 
 #include "thread_work_pool.h"
 
-#include "core/os/os.h"
-
-void ThreadWorkPool::_thread_function(void *p_user) {
-	ThreadData *thread = static_cast<ThreadData *>(p_user);
-	while (true) {
-		thread->start.wait();
-		if (thread->exit.load()) {
-			break;
-		}
-		thread->work->work();
-		thread->completed.post();
-	}
-}
-
 void ThreadWorkPool::init(int p_thread_count) {
-	ERR_FAIL_COND(threads != nullptr);
-	if (p_thread_count < 0) {
-		p_thread_count = OS::get_singleton()->get_default_thread_pool_size();
-	}
+	ERR_FAIL_COND(initialized);
+	ERR_FAIL_COND(!WorkerThreadPool::get_singleton());
 
-	thread_count = p_thread_count;
-	threads = memnew_arr(ThreadData, thread_count);
-
-	for (uint32_t i = 0; i < thread_count; i++) {
-		threads[i].exit.store(false);
-		threads[i].thread.start(&ThreadWorkPool::_thread_function, &threads[i]);
+	int pool_threads = WorkerThreadPool::get_singleton()->get_thread_count();
+	if (p_thread_count < 0 || p_thread_count > pool_threads) {
+		p_thread_count = pool_threads;
 	}
+
+	// The pool may have no threads at all, in which case the waiting thread
+	// does the whole work itself.
+	thread_count = MAX(p_thread_count, 1);
+	initialized = true;
 }
 
 void ThreadWorkPool::finish() {
-	if (threads == nullptr) {
+	if (!initialized) {
 		return;
 	}
 
-	for (uint32_t i = 0; i < thread_count; i++) {
-		threads[i].exit.store(true);
-		threads[i].start.post();
+	if (current_work != WorkerThreadPool::INVALID_TASK_ID) {
+		end_work();
 	}
-	for (uint32_t i = 0; i < thread_count; i++) {
-		threads[i].thread.wait_to_finish();
-	}
-
-	memdelete_arr(threads);
-	threads = nullptr;
+	initialized = false;
 }
 
 ThreadWorkPool::~ThreadWorkPool() {
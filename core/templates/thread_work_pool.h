@@ -31,103 +31,47 @@
 #ifndef THREAD_WORK_POOL_H
 #define THREAD_WORK_POOL_H
 
-#include "core/os/memory.h"
-#include "core/os/semaphore.h"
-#include "core/os/thread.h"
+#include "core/os/worker_thread_pool.h"
 
-#include <atomic>
+// Compatibility wrapper running one parallel loop at a time on the shared
+// WorkerThreadPool. It no longer owns threads; init() only sets how many
+// workers a loop may occupy at most. New code should use WorkerThreadPool
+// directly, which allows several loops in flight, nesting and dependencies.
 
 class ThreadWorkPool {
-	std::atomic<uint32_t> index;
-
-	struct BaseWork {
-		std::atomic<uint32_t> *index = nullptr;
-		uint32_t max_elements = 0;
-		virtual void work() = 0;
-		virtual ~BaseWork() = default;
-	};
-
-	template <class C, class M, class U>
-	struct Work : public BaseWork {
-		C *instance;
-		M method;
-		U userdata;
-		virtual void work() override {
-			while (true) {
-				uint32_t work_index = index->fetch_add(1, std::memory_order_relaxed);
-				if (work_index >= max_elements) {
-					break;
-				}
-				(instance->*method)(work_index, userdata);
-			}
-		}
-	};
-
-	struct ThreadData {
-		Thread thread;
-		Semaphore start;
-		Semaphore completed;
-		std::atomic<bool> exit;
-		BaseWork *work = nullptr;
-	};
-
-	ThreadData *threads = nullptr;
+	WorkerThreadPool::TaskID current_work = WorkerThreadPool::INVALID_TASK_ID;
+	uint32_t max_elements = 0;
 	uint32_t thread_count = 0;
-	uint32_t threads_working = 0;
-	BaseWork *current_work = nullptr;
-
-	static void _thread_function(void *p_user);
+	bool initialized = false;
 
 public:
 	template <class C, class M, class U>
 	void begin_work(uint32_t p_elements, C *p_instance, M p_method, U p_userdata) {
-		ERR_FAIL_COND(!threads); //never initialized
-		ERR_FAIL_COND(current_work != nullptr);
+		ERR_FAIL_COND(!initialized); //never initialized
+		ERR_FAIL_COND(current_work != WorkerThreadPool::INVALID_TASK_ID);
 
-		index.store(0, std::memory_order_release);
-
-		Work<C, M, U> *w = memnew((Work<C, M, U>));
-		w->instance = p_instance;
-		w->userdata = p_userdata;
-		w->method = p_method;
-		w->index = &index;
-		w->max_elements = p_elements;
-
-		current_work = w;
-
-		threads_working = MIN(p_elements, thread_count);
-
-		for (uint32_t i = 0; i < threads_working; i++) {
-			threads[i].work = w;
-			threads[i].start.post();
-		}
+		max_elements = p_elements;
+		current_work = WorkerThreadPool::get_singleton()->add_template_group_task(p_instance, p_method, p_userdata, p_elements, MIN(p_elements, thread_count));
 	}
 
 	bool is_working() const {
-		return current_work != nullptr;
+		return current_work != WorkerThreadPool::INVALID_TASK_ID;
 	}
 
 	bool is_done_dispatching() const {
-		ERR_FAIL_COND_V(current_work == nullptr, true);
-		return index.load(std::memory_order_acquire) >= current_work->max_elements;
+		ERR_FAIL_COND_V(current_work == WorkerThreadPool::INVALID_TASK_ID, true);
+		return WorkerThreadPool::get_singleton()->get_group_dispatched_element_count(current_work) >= max_elements;
 	}
 
 	uint32_t get_work_index() const {
-		ERR_FAIL_COND_V(current_work == nullptr, 0);
-		uint32_t idx = index.load(std::memory_order_acquire);
-		return MIN(idx, current_work->max_elements);
+		ERR_FAIL_COND_V(current_work == WorkerThreadPool::INVALID_TASK_ID, 0);
+		return WorkerThreadPool::get_singleton()->get_group_dispatched_element_count(current_work);
 	}
 
 	void end_work() {
-		ERR_FAIL_COND(current_work == nullptr);
-		for (uint32_t i = 0; i < threads_working; i++) {
-			threads[i].completed.wait();
-			threads[i].work = nullptr;
-		}
-
-		threads_working = 0;
-		memdelete(current_work);
-		current_work = nullptr;
+		ERR_FAIL_COND(current_work == WorkerThreadPool::INVALID_TASK_ID);
+		WorkerThreadPool::get_singleton()->wait_for_group_task_completion(current_work);
+		current_work = WorkerThreadPool::INVALID_TASK_ID;
 	}
 
 	template <class C, class M, class U>
@@ -154,4 +98,4 @@ public:
 	~ThreadWorkPool();
 };
 
-#endif // THREAD_POOL_H
+#endif // THREAD_WORK_POOL_H
@@ -194,7 +194,18 @@ bool Array::_assign(const Array &p_array) {
 			_p->array = p_array._p->array; //then just copy, which is cheap anyway
 
 		} else {
-			//for non objects, we need to check if there is a valid conversion, which needs to happen one by one, so this is the worst case.
+			//for non objects, elements that already have the right type need no conversion, so if all of them do the storage can just be shared.
+			const Vector<Variant> &src_array = p_array._p->array;
+			int matching = 0;
+			while (matching < src_array.size() && src_array[matching].get_type() == _p->typed.type) {
+				matching++;
+			}
+			if (matching == src_array.size()) {
+				_p->array = src_array;
+				return true;
+			}
+
+			//otherwise we need to check if there is a valid conversion, which needs to happen one by one, so this is the worst case.
 			Vector<Variant> new_array;
 			new_array.resize(p_array._p->array.size());
 			for (int i = 0; i < p_array._p->array.size(); i++) {
@@ -233,7 +244,11 @@ void Array::push_back(const Variant &p_value) {
 }
 
 void Array::append_array(const Array &p_array) {
-	ERR_FAIL_COND(!_p->typed.validate(p_array, "append_array"));
+	if (_p->typed.type != Variant::NIL && !_p->typed.can_reference(p_array._p->typed)) {
+		for (int i = 0; i < p_array._p->array.size(); i++) {
+			ERR_FAIL_COND(!_p->typed.validate(p_array._p->array[i], "append_array"));
+		}
+	}
 	_p->array.append_array(p_array._p->array);
 }
 
@@ -615,6 +630,10 @@ const void *Array::id() const {
 	return _p;
 }
 
+bool Array::is_shared() const {
+	return _p->refcount.get() > 1;
+}
+
 Array::Array(const Array &p_from, uint32_t p_type, const StringName &p_class_name, const Variant &p_script) {
 	_p = memnew(ArrayPrivate);
 	_p->refcount.init();
@@ -353,6 +353,10 @@ const void *Dictionary::id() const {
 	return _p;
 }
 
+bool Dictionary::is_shared() const {
+	return _p->refcount.get() > 1;
+}
+
 Dictionary::Dictionary(const Dictionary &p_from) {
 	_p = nullptr;
 	_ref(p_from);
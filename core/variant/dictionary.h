@@ -85,6 +85,7 @@ public:
 	Dictionary recursive_duplicate(bool p_deep, int recursion_count) const;
 
 	const void *id() const;
+	bool is_shared() const;
 
 	Dictionary(const Dictionary &p_from);
 	Dictionary();
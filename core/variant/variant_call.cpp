@@ -877,6 +877,239 @@ struct _VariantCall {
 		return len;
 	}
 
+	// Bulk math on packed arrays. These run as plain loops over the packed storage,
+	// simple enough for the compiler to vectorize, instead of one Variant call per element.
+
+	static void func_PackedFloat32Array_add_scalar(PackedFloat32Array *p_instance, double p_value) {
+		float *w = p_instance->ptrw();
+		const int size = p_instance->size();
+		const float value = p_value;
+		for (int i = 0; i < size; i++) {
+			w[i] += value;
+		}
+	}
+
+	static void func_PackedFloat32Array_multiply_scalar(PackedFloat32Array *p_instance, double p_value) {
+		float *w = p_instance->ptrw();
+		const int size = p_instance->size();
+		const float value = p_value;
+		for (int i = 0; i < size; i++) {
+			w[i] *= value;
+		}
+	}
+
+	static void func_PackedFloat32Array_add_array(PackedFloat32Array *p_instance, const PackedFloat32Array &p_array) {
+		ERR_FAIL_COND_MSG(p_array.size() != p_instance->size(), "Both arrays must have the same size.");
+		const float *r = p_array.ptr();
+		float *w = p_instance->ptrw();
+		const int size = p_instance->size();
+		for (int i = 0; i < size; i++) {
+			w[i] += r[i];
+		}
+	}
+
+	static void func_PackedFloat32Array_multiply_array(PackedFloat32Array *p_instance, const PackedFloat32Array &p_array) {
+		ERR_FAIL_COND_MSG(p_array.size() != p_instance->size(), "Both arrays must have the same size.");
+		const float *r = p_array.ptr();
+		float *w = p_instance->ptrw();
+		const int size = p_instance->size();
+		for (int i = 0; i < size; i++) {
+			w[i] *= r[i];
+		}
+	}
+
+	static void func_PackedFloat32Array_lerp_array(PackedFloat32Array *p_instance, const PackedFloat32Array &p_to, double p_weight) {
+		ERR_FAIL_COND_MSG(p_to.size() != p_instance->size(), "Both arrays must have the same size.");
+		const float *r = p_to.ptr();
+		float *w = p_instance->ptrw();
+		const int size = p_instance->size();
+		const float weight = p_weight;
+		for (int i = 0; i < size; i++) {
+			w[i] += (r[i] - w[i]) * weight;
+		}
+	}
+
+	static double func_PackedFloat32Array_dot(PackedFloat32Array *p_instance, const PackedFloat32Array &p_array) {
+		ERR_FAIL_COND_V_MSG(p_array.size() != p_instance->size(), 0.0, "Both arrays must have the same size.");
+		const float *a = p_instance->ptr();
+		const float *b = p_array.ptr();
+		const int size = p_instance->size();
+		// Independent partial sums, so consecutive iterations don't wait on each other.
+		double partial[4] = { 0.0, 0.0, 0.0, 0.0 };
+		int i = 0;
+		for (; i + 4 <= size; i += 4) {
+			partial[0] += double(a[i + 0]) * b[i + 0];
+			partial[1] += double(a[i + 1]) * b[i + 1];
+			partial[2] += double(a[i + 2]) * b[i + 2];
+			partial[3] += double(a[i + 3]) * b[i + 3];
+		}
+		for (; i < size; i++) {
+			partial[0] += double(a[i]) * b[i];
+		}
+		return (partial[0] + partial[1]) + (partial[2] + partial[3]);
+	}
+
+	static double func_PackedFloat32Array_sum(PackedFloat32Array *p_instance) {
+		const float *r = p_instance->ptr();
+		const int size = p_instance->size();
+		double partial[4] = { 0.0, 0.0, 0.0, 0.0 };
+		int i = 0;
+		for (; i + 4 <= size; i += 4) {
+			partial[0] += r[i + 0];
+			partial[1] += r[i + 1];
+			partial[2] += r[i + 2];
+			partial[3] += r[i + 3];
+		}
+		for (; i < size; i++) {
+			partial[0] += r[i];
+		}
+		return (partial[0] + partial[1]) + (partial[2] + partial[3]);
+	}
+
+	static double func_PackedFloat32Array_min(PackedFloat32Array *p_instance) {
+		const int size = p_instance->size();
+		if (size == 0) {
+			return 0.0;
+		}
+		const float *r = p_instance->ptr();
+		float ret = r[0];
+		for (int i = 1; i < size; i++) {
+			ret = MIN(ret, r[i]);
+		}
+		return ret;
+	}
+
+	static double func_PackedFloat32Array_max(PackedFloat32Array *p_instance) {
+		const int size = p_instance->size();
+		if (size == 0) {
+			return 0.0;
+		}
+		const float *r = p_instance->ptr();
+		float ret = r[0];
+		for (int i = 1; i < size; i++) {
+			ret = MAX(ret, r[i]);
+		}
+		return ret;
+	}
+
+	static void func_PackedVector3Array_transform(PackedVector3Array *p_instance, const Transform3D &p_transform) {
+		Vector3 *w = p_instance->ptrw();
+		const int size = p_instance->size();
+		for (int i = 0; i < size; i++) {
+			w[i] = p_transform.xform(w[i]);
+		}
+	}
+
+	static void func_PackedVector3Array_translate(PackedVector3Array *p_instance, const Vector3 &p_offset) {
+		Vector3 *w = p_instance->ptrw();
+		const int size = p_instance->size();
+		for (int i = 0; i < size; i++) {
+			w[i] += p_offset;
+		}
+	}
+
+	static void func_PackedVector3Array_multiply_scalar(PackedVector3Array *p_instance, double p_value) {
+		Vector3 *w = p_instance->ptrw();
+		const int size = p_instance->size();
+		const real_t value = p_value;
+		for (int i = 0; i < size; i++) {
+			w[i] *= value;
+		}
+	}
+
+	static void func_PackedVector3Array_add_array(PackedVector3Array *p_instance, const PackedVector3Array &p_array) {
+		ERR_FAIL_COND_MSG(p_array.size() != p_instance->size(), "Both arrays must have the same size.");
+		const Vector3 *r = p_array.ptr();
+		Vector3 *w = p_instance->ptrw();
+		const int size = p_instance->size();
+		for (int i = 0; i < size; i++) {
+			w[i] += r[i];
+		}
+	}
+
+	static void func_PackedVector3Array_multiply_array(PackedVector3Array *p_instance, const PackedVector3Array &p_array) {
+		ERR_FAIL_COND_MSG(p_array.size() != p_instance->size(), "Both arrays must have the same size.");
+		const Vector3 *r = p_array.ptr();
+		Vector3 *w = p_instance->ptrw();
+		const int size = p_instance->size();
+		for (int i = 0; i < size; i++) {
+			w[i] *= r[i];
+		}
+	}
+
+	static void func_PackedVector3Array_normalize(PackedVector3Array *p_instance) {
+		Vector3 *w = p_instance->ptrw();
+		const int size = p_instance->size();
+		for (int i = 0; i < size; i++) {
+			w[i].normalize();
+		}
+	}
+
+	static void func_PackedVector3Array_lerp_array(PackedVector3Array *p_instance, const PackedVector3Array &p_to, double p_weight) {
+		ERR_FAIL_COND_MSG(p_to.size() != p_instance->size(), "Both arrays must have the same size.");
+		const Vector3 *r = p_to.ptr();
+		Vector3 *w = p_instance->ptrw();
+		const int size = p_instance->size();
+		const real_t weight = p_weight;
+		for (int i = 0; i < size; i++) {
+			w[i] += (r[i] - w[i]) * weight;
+		}
+	}
+
+	static PackedFloat32Array func_PackedVector3Array_dot(PackedVector3Array *p_instance, const PackedVector3Array &p_array) {
+		PackedFloat32Array dest;
+		ERR_FAIL_COND_V_MSG(p_array.size() != p_instance->size(), dest, "Both arrays must have the same size.");
+		const Vector3 *a = p_instance->ptr();
+		const Vector3 *b = p_array.ptr();
+		const int size = p_instance->size();
+		dest.resize(size);
+		float *w = dest.ptrw();
+		for (int i = 0; i < size; i++) {
+			w[i] = a[i].dot(b[i]);
+		}
+		return dest;
+	}
+
+	static Vector3 func_PackedVector3Array_sum(PackedVector3Array *p_instance) {
+		const Vector3 *r = p_instance->ptr();
+		const int size = p_instance->size();
+		Vector3 ret;
+		for (int i = 0; i < size; i++) {
+			ret += r[i];
+		}
+		return ret;
+	}
+
+	static Vector3 func_PackedVector3Array_min(PackedVector3Array *p_instance) {
+		const int size = p_instance->size();
+		if (size == 0) {
+			return Vector3();
+		}
+		const Vector3 *r = p_instance->ptr();
+		Vector3 ret = r[0];
+		for (int i = 1; i < size; i++) {
+			ret.x = MIN(ret.x, r[i].x);
+			ret.y = MIN(ret.y, r[i].y);
+			ret.z = MIN(ret.z, r[i].z);
+		}
+		return ret;
+	}
+
+	static Vector3 func_PackedVector3Array_max(PackedVector3Array *p_instance) {
+		const int size = p_instance->size();
+		if (size == 0) {
+			return Vector3();
+		}
+		const Vector3 *r = p_instance->ptr();
+		Vector3 ret = r[0];
+		for (int i = 1; i < size; i++) {
+			ret.x = MAX(ret.x, r[i].x);
+			ret.y = MAX(ret.y, r[i].y);
+			ret.z = MAX(ret.z, r[i].z);
+		}
+		return ret;
+	}
+
 	static void func_Callable_call(Variant *v, const Variant **p_args, int p_argcount, Variant &r_ret, Callable::CallError &r_error) {
 		Callable *callable = VariantGetInternalPtr<Callable>::get_ptr(v);
 		callable->call(p_args, p_argcount, r_ret, r_error);
@@ -1987,6 +2220,15 @@ static void _register_variant_builtin_methods() {
 	bind_method(PackedFloat32Array, find, sarray("value", "from"), varray(0));
 	bind_method(PackedFloat32Array, rfind, sarray("value", "from"), varray(-1));
 	bind_method(PackedFloat32Array, count, sarray("value"), varray());
+	bind_functionnc(PackedFloat32Array, add_scalar, _VariantCall::func_PackedFloat32Array_add_scalar, sarray("value"), varray());
+	bind_functionnc(PackedFloat32Array, multiply_scalar, _VariantCall::func_PackedFloat32Array_multiply_scalar, sarray("value"), varray());
+	bind_functionnc(PackedFloat32Array, add_array, _VariantCall::func_PackedFloat32Array_add_array, sarray("array"), varray());
+	bind_functionnc(PackedFloat32Array, multiply_array, _VariantCall::func_PackedFloat32Array_multiply_array, sarray("array"), varray());
+	bind_functionnc(PackedFloat32Array, lerp_array, _VariantCall::func_PackedFloat32Array_lerp_array, sarray("to", "weight"), varray());
+	bind_function(PackedFloat32Array, dot, _VariantCall::func_PackedFloat32Array_dot, sarray("array"), varray());
+	bind_function(PackedFloat32Array, sum, _VariantCall::func_PackedFloat32Array_sum, sarray(), varray());
+	bind_function(PackedFloat32Array, min, _VariantCall::func_PackedFloat32Array_min, sarray(), varray());
+	bind_function(PackedFloat32Array, max, _VariantCall::func_PackedFloat32Array_max, sarray(), varray());
 
 	/* Float64 Array */
 
@@ -2079,6 +2321,17 @@ static void _register_variant_builtin_methods() {
 	bind_method(PackedVector3Array, find, sarray("value", "from"), varray(0));
 	bind_method(PackedVector3Array, rfind, sarray("value", "from"), varray(-1));
 	bind_method(PackedVector3Array, count, sarray("value"), varray());
+	bind_functionnc(PackedVector3Array, transform, _VariantCall::func_PackedVector3Array_transform, sarray("transform"), varray());
+	bind_functionnc(PackedVector3Array, translate, _VariantCall::func_PackedVector3Array_translate, sarray("offset"), varray());
+	bind_functionnc(PackedVector3Array, multiply_scalar, _VariantCall::func_PackedVector3Array_multiply_scalar, sarray("value"), varray());
+	bind_functionnc(PackedVector3Array, add_array, _VariantCall::func_PackedVector3Array_add_array, sarray("array"), varray());
+	bind_functionnc(PackedVector3Array, multiply_array, _VariantCall::func_PackedVector3Array_multiply_array, sarray("array"), varray());
+	bind_functionnc(PackedVector3Array, normalize, _VariantCall::func_PackedVector3Array_normalize, sarray(), varray());
+	bind_functionnc(PackedVector3Array, lerp_array, _VariantCall::func_PackedVector3Array_lerp_array, sarray("to", "weight"), varray());
+	bind_function(PackedVector3Array, dot, _VariantCall::func_PackedVector3Array_dot, sarray("array"), varray());
+	bind_function(PackedVector3Array, sum, _VariantCall::func_PackedVector3Array_sum, sarray(), varray());
+	bind_function(PackedVector3Array, min, _VariantCall::func_PackedVector3Array_min, sarray(), varray());
+	bind_function(PackedVector3Array, max, _VariantCall::func_PackedVector3Array_max, sarray(), varray());
 
 	/* Color Array */
 
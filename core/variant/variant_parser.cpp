@@ -34,40 +34,59 @@
 #include "core/io/resource_loader.h"
 #include "core/os/keyboard.h"
 #include "core/string/string_buffer.h"
+#include "core/templates/local_vector.h"
+
+char32_t VariantParser::Stream::_refill() {
+	readahead_pointer = 0;
+	readahead_filled = _read_buffer(readahead_buffer, readahead_enabled ? READAHEAD_SIZE : 1);
+	if (readahead_filled == 0) {
+		// You need to try to read again when you have reached the end for EOF to be reported.
+		eof = true;
+		return 0;
+	}
 
-char32_t VariantParser::StreamFile::get_char() {
-	return f->get_8();
+	eof = false;
+	return readahead_buffer[readahead_pointer++];
 }
 
-bool VariantParser::StreamFile::is_utf8() const {
-	return true;
+uint32_t VariantParser::StreamFile::_read_buffer(char32_t *p_buffer, uint32_t p_num_chars) {
+	// Bytes are passed through as is, strings are decoded from UTF-8 once they are complete.
+	uint8_t bytes[512];
+	uint32_t total = 0;
+
+	while (total < p_num_chars) {
+		uint32_t chunk = MIN(p_num_chars - total, (uint32_t)sizeof(bytes));
+		uint32_t read = f->get_buffer(bytes, chunk);
+		for (uint32_t i = 0; i < read; i++) {
+			p_buffer[total + i] = bytes[i];
+		}
+		total += read;
+		if (read < chunk) {
+			break;
+		}
+	}
+
+	return total;
 }
 
-bool VariantParser::StreamFile::is_eof() const {
-	return f->eof_reached();
+bool VariantParser::StreamFile::is_utf8() const {
+	return true;
 }
 
-char32_t VariantParser::StreamString::get_char() {
-	if (pos > s.length()) {
-		return 0;
-	} else if (pos == s.length()) {
-		// You need to try to read again when you have reached the end for EOF to be reported,
-		// so this works the same as files (like StreamFile does)
-		pos++;
-		return 0;
-	} else {
-		return s[pos++];
+uint32_t VariantParser::StreamString::_read_buffer(char32_t *p_buffer, uint32_t p_num_chars) {
+	int available = MAX(s.length() - pos, 0);
+	uint32_t count = MIN(p_num_chars, (uint32_t)available);
+	if (count > 0) {
+		memcpy(p_buffer, s.ptr() + pos, count * sizeof(char32_t));
+		pos += count;
 	}
+	return count;
 }
 
 bool VariantParser::StreamString::is_utf8() const {
 	return false;
 }
 
-bool VariantParser::StreamString::is_eof() const {
-	return pos > s.length();
-}
-
 /////////////////////////////////////////////////////////////////////////////////////////////////
 
 const char *VariantParser::tk_name[TK_MAX] = {
@@ -101,6 +120,151 @@ static double stor_fix(const String &p_str) {
 	return -1;
 }
 
+// Characters of a string token. UTF-8 streams hand over raw bytes, which are
+// collected as such and decoded once the token is complete. Short strings don't allocate.
+class TokenString {
+	bool utf8 = false;
+	StringBuffer<> chars;
+	char short_bytes[256];
+	LocalVector<char> bytes;
+	uint32_t length = 0;
+
+	_FORCE_INLINE_ void _append_byte(uint8_t p_byte) {
+		if (length < sizeof(short_bytes)) {
+			short_bytes[length++] = p_byte;
+			return;
+		}
+		if (bytes.is_empty()) {
+			bytes.resize(length);
+			memcpy(bytes.ptr(), short_bytes, length);
+		}
+		bytes.push_back(p_byte);
+		length++;
+	}
+
+public:
+	// A byte from the stream when it's UTF-8, otherwise a full character.
+	_FORCE_INLINE_ void append_raw(char32_t p_char) {
+		if (utf8) {
+			_append_byte(p_char);
+		} else {
+			chars += p_char;
+		}
+	}
+
+	// A character produced by an escape sequence.
+	void append_char(char32_t p_char) {
+		if (!utf8) {
+			chars += p_char;
+		} else if (p_char < 0x80) {
+			_append_byte(p_char);
+		} else if (p_char < 0x800) {
+			_append_byte(0xc0 | (p_char >> 6));
+			_append_byte(0x80 | (p_char & 0x3f));
+		} else if (p_char < 0x10000) {
+			_append_byte(0xe0 | (p_char >> 12));
+			_append_byte(0x80 | ((p_char >> 6) & 0x3f));
+			_append_byte(0x80 | (p_char & 0x3f));
+		} else {
+			_append_byte(0xf0 | (p_char >> 18));
+			_append_byte(0x80 | ((p_char >> 12) & 0x3f));
+			_append_byte(0x80 | ((p_char >> 6) & 0x3f));
+			_append_byte(0x80 | (p_char & 0x3f));
+		}
+	}
+
+	String as_string() {
+		if (!utf8) {
+			return chars.as_string();
+		}
+		String str;
+		if (length > 0) {
+			str.parse_utf8(length > sizeof(short_bytes) ? bytes.ptr() : short_bytes, length);
+		}
+		return str;
+	}
+
+	TokenString(bool p_utf8) {
+		utf8 = p_utf8;
+	}
+};
+
+// Reads a number starting with p_char, which is '-' or a digit, and returns whether it's a float.
+// The characters are collected in StringBuffer's fixed buffer, so no String is built.
+static bool _read_number(VariantParser::Stream *p_stream, char32_t p_char, double &r_float, int64_t &r_int) {
+	StringBuffer<> num;
+#define READING_SIGN 0
+#define READING_INT 1
+#define READING_DEC 2
+#define READING_EXP 3
+#define READING_DONE 4
+	int reading = READING_INT;
+
+	char32_t c = p_char;
+	if (c == '-') {
+		num += '-';
+		c = p_stream->get_char();
+	}
+
+	bool exp_sign = false;
+	bool exp_beg = false;
+	bool is_float = false;
+
+	while (true) {
+		switch (reading) {
+			case READING_INT: {
+				if (is_digit(c)) {
+					//pass
+				} else if (c == '.') {
+					reading = READING_DEC;
+					is_float = true;
+				} else if (c == 'e') {
+					reading = READING_EXP;
+					is_float = true;
+				} else {
+					reading = READING_DONE;
+				}
+
+			} break;
+			case READING_DEC: {
+				if (is_digit(c)) {
+				} else if (c == 'e') {
+					reading = READING_EXP;
+				} else {
+					reading = READING_DONE;
+				}
+
+			} break;
+			case READING_EXP: {
+				if (is_digit(c)) {
+					exp_beg = true;
+
+				} else if ((c == '-' || c == '+') && !exp_sign && !exp_beg) {
+					exp_sign = true;
+
+				} else {
+					reading = READING_DONE;
+				}
+			} break;
+		}
+
+		if (reading == READING_DONE) {
+			break;
+		}
+		num += c;
+		c = p_stream->get_char();
+	}
+
+	p_stream->saved = c;
+
+	if (is_float) {
+		r_float = num.as_double();
+	} else {
+		r_int = num.as_int();
+	}
+	return is_float;
+}
+
 Error VariantParser::get_token(Stream *p_stream, Token &r_token, int &line, String &r_err_str) {
 	bool string_name = false;
 
@@ -217,7 +381,7 @@ Error VariantParser::get_token(Stream *p_stream, Token &r_token, int &line, Stri
 				[[fallthrough]];
 			}
 			case '"': {
-				String str;
+				TokenString str(p_stream->is_utf8());
 				char32_t prev = 0;
 				while (true) {
 					char32_t ch = p_stream->get_char();
@@ -320,7 +484,7 @@ Error VariantParser::get_token(Stream *p_stream, Token &r_token, int &line, Stri
 							r_token.type = TK_ERROR;
 							return ERR_PARSE_ERROR;
 						}
-						str += res;
+						str.append_char(res);
 					} else {
 						if (prev != 0) {
 							r_err_str = "Invalid UTF-16 sequence in string, unpaired lead surrogate";
@@ -330,7 +494,7 @@ Error VariantParser::get_token(Stream *p_stream, Token &r_token, int &line, Stri
 						if (ch == '\n') {
 							line++;
 						}
-						str += ch;
+						str.append_raw(ch);
 					}
 				}
 				if (prev != 0) {
@@ -339,15 +503,12 @@ Error VariantParser::get_token(Stream *p_stream, Token &r_token, int &line, Stri
 					return ERR_PARSE_ERROR;
 				}
 
-				if (p_stream->is_utf8()) {
-					str.parse_utf8(str.ascii(true).get_data());
-				}
 				if (string_name) {
 					r_token.type = TK_STRING_NAME;
-					r_token.value = StringName(str);
+					r_token.value = StringName(str.as_string());
 				} else {
 					r_token.type = TK_STRING;
-					r_token.value = str;
+					r_token.value = str.as_string();
 				}
 				return OK;
 
@@ -359,78 +520,15 @@ Error VariantParser::get_token(Stream *p_stream, Token &r_token, int &line, Stri
 
 				if (cchar == '-' || (cchar >= '0' && cchar <= '9')) {
 					//a number
-
-					StringBuffer<> num;
-#define READING_SIGN 0
-#define READING_INT 1
-#define READING_DEC 2
-#define READING_EXP 3
-#define READING_DONE 4
-					int reading = READING_INT;
-
-					if (cchar == '-') {
-						num += '-';
-						cchar = p_stream->get_char();
-					}
-
-					char32_t c = cchar;
-					bool exp_sign = false;
-					bool exp_beg = false;
-					bool is_float = false;
-
-					while (true) {
-						switch (reading) {
-							case READING_INT: {
-								if (is_digit(c)) {
-									//pass
-								} else if (c == '.') {
-									reading = READING_DEC;
-									is_float = true;
-								} else if (c == 'e') {
-									reading = READING_EXP;
-									is_float = true;
-								} else {
-									reading = READING_DONE;
-								}
-
-							} break;
-							case READING_DEC: {
-								if (is_digit(c)) {
-								} else if (c == 'e') {
-									reading = READING_EXP;
-								} else {
-									reading = READING_DONE;
-								}
-
-							} break;
-							case READING_EXP: {
-								if (is_digit(c)) {
-									exp_beg = true;
-
-								} else if ((c == '-' || c == '+') && !exp_sign && !exp_beg) {
-									exp_sign = true;
-
-								} else {
-									reading = READING_DONE;
-								}
-							} break;
-						}
-
-						if (reading == READING_DONE) {
-							break;
-						}
-						num += c;
-						c = p_stream->get_char();
-					}
-
-					p_stream->saved = c;
+					double float_value = 0;
+					int64_t int_value = 0;
 
 					r_token.type = TK_NUMBER;
 
-					if (is_float) {
-						r_token.value = num.as_double();
+					if (_read_number(p_stream, cchar, float_value, int_value)) {
+						r_token.value = float_value;
 					} else {
-						r_token.value = num.as_int();
+						r_token.value = int_value;
 					}
 					return OK;
 				} else if (is_ascii_char(cchar) || is_underscore(cchar)) {
@@ -500,6 +598,11 @@ Error VariantParser::_parse_construct(Stream *p_stream, Vector<T> &r_construct,
 		return ERR_PARSE_ERROR;
 	}
 
+	// Numbers are read straight from the stream into the array, which grows geometrically
+	// and is trimmed at the end. Anything else goes through get_token().
+	int count = r_construct.size();
+	T *w = r_construct.ptrw();
+
 	bool first = true;
 	while (true) {
 		if (!first) {
@@ -513,30 +616,62 @@ Error VariantParser::_parse_construct(Stream *p_stream, Vector<T> &r_construct,
 				return ERR_PARSE_ERROR;
 			}
 		}
-		get_token(p_stream, token, line, r_err_str);
 
-		if (first && token.type == TK_PARENTHESIS_CLOSE) {
-			break;
-		} else if (token.type != TK_NUMBER) {
-			bool valid = false;
-			if (token.type == TK_IDENTIFIER) {
-				double real = stor_fix(token.value);
-				if (real != -1) {
-					token.type = TK_NUMBER;
-					token.value = real;
-					valid = true;
-				}
+		char32_t c = p_stream->saved;
+		p_stream->saved = 0;
+		if (!c) {
+			c = p_stream->get_char();
+		}
+		while (c > 0 && c <= 32) {
+			if (c == '\n') {
+				line++;
 			}
-			if (!valid) {
-				r_err_str = "Expected float in constructor";
-				return ERR_PARSE_ERROR;
+			c = p_stream->get_char();
+		}
+
+		T element;
+		if (c == '-' || is_digit(c)) {
+			double float_value = 0;
+			int64_t int_value = 0;
+			if (_read_number(p_stream, c, float_value, int_value)) {
+				element = T(float_value);
+			} else {
+				element = T(int_value);
+			}
+		} else {
+			p_stream->saved = c;
+			get_token(p_stream, token, line, r_err_str);
+
+			if (first && token.type == TK_PARENTHESIS_CLOSE) {
+				break;
+			} else if (token.type != TK_NUMBER) {
+				bool valid = false;
+				if (token.type == TK_IDENTIFIER) {
+					double real = stor_fix(token.value);
+					if (real != -1) {
+						token.type = TK_NUMBER;
+						token.value = real;
+						valid = true;
+					}
+				}
+				if (!valid) {
+					r_err_str = "Expected float in constructor";
+					return ERR_PARSE_ERROR;
+				}
 			}
+			element = token.value;
 		}
 
-		r_construct.push_back(token.value);
+		if (count == r_construct.size()) {
+			r_construct.resize(MAX(count * 2, 16));
+			w = r_construct.ptrw();
+		}
+		w[count++] = element;
 		first = false;
 	}
 
+	r_construct.resize(count);
+
 	return OK;
 }
 
@@ -940,17 +1075,7 @@ Error VariantParser::parse_value(Token &token, Variant &value, Stream *p_stream,
 				return err;
 			}
 
-			Vector<uint8_t> arr;
-			{
-				int len = args.size();
-				arr.resize(len);
-				uint8_t *w = arr.ptrw();
-				for (int i = 0; i < len; i++) {
-					w[i] = args[i];
-				}
-			}
-
-			value = arr;
+			value = args;
 		} else if (id == "PackedInt32Array" || id == "PackedIntArray" || id == "PoolIntArray" || id == "IntArray") {
 			Vector<int32_t> args;
 			Error err = _parse_construct<int32_t>(p_stream, args, line, r_err_str);
@@ -958,17 +1083,7 @@ Error VariantParser::parse_value(Token &token, Variant &value, Stream *p_stream,
 				return err;
 			}
 
-			Vector<int32_t> arr;
-			{
-				int32_t len = args.size();
-				arr.resize(len);
-				int32_t *w = arr.ptrw();
-				for (int32_t i = 0; i < len; i++) {
-					w[i] = int32_t(args[i]);
-				}
-			}
-
-			value = arr;
+			value = args;
 		} else if (id == "PackedInt64Array") {
 			Vector<int64_t> args;
 			Error err = _parse_construct<int64_t>(p_stream, args, line, r_err_str);
@@ -976,17 +1091,7 @@ Error VariantParser::parse_value(Token &token, Variant &value, Stream *p_stream,
 				return err;
 			}
 
-			Vector<int64_t> arr;
-			{
-				int64_t len = args.size();
-				arr.resize(len);
-				int64_t *w = arr.ptrw();
-				for (int64_t i = 0; i < len; i++) {
-					w[i] = int64_t(args[i]);
-				}
-			}
-
-			value = arr;
+			value = args;
 		} else if (id == "PackedFloat32Array" || id == "PackedRealArray" || id == "PoolRealArray" || id == "FloatArray") {
 			Vector<float> args;
 			Error err = _parse_construct<float>(p_stream, args, line, r_err_str);
@@ -994,17 +1099,7 @@ Error VariantParser::parse_value(Token &token, Variant &value, Stream *p_stream,
 				return err;
 			}
 
-			Vector<float> arr;
-			{
-				int len = args.size();
-				arr.resize(len);
-				float *w = arr.ptrw();
-				for (int i = 0; i < len; i++) {
-					w[i] = args[i];
-				}
-			}
-
-			value = arr;
+			value = args;
 		} else if (id == "PackedFloat64Array") {
 			Vector<double> args;
 			Error err = _parse_construct<double>(p_stream, args, line, r_err_str);
@@ -1012,17 +1107,7 @@ Error VariantParser::parse_value(Token &token, Variant &value, Stream *p_stream,
 				return err;
 			}
 
-			Vector<double> arr;
-			{
-				int len = args.size();
-				arr.resize(len);
-				double *w = arr.ptrw();
-				for (int i = 0; i < len; i++) {
-					w[i] = args[i];
-				}
-			}
-
-			value = arr;
+			value = args;
 		} else if (id == "PackedStringArray" || id == "PoolStringArray" || id == "StringArray") {
 			get_token(p_stream, token, line, r_err_str);
 			if (token.type != TK_PARENTHESIS_OPEN) {
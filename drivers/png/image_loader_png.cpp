@@ -38,6 +38,14 @@
 
 Error ImageLoaderPNG::load_image(Ref<Image> p_image, Ref<FileAccess> f, bool p_force_linear, float p_scale) {
 	const uint64_t buffer_size = f->get_length();
+
+	// Decode straight from memory when the file (or the pack it's in) is mapped.
+	Ref<FileMapping> mapping;
+	const uint8_t *mapped = f->borrow_buffer(buffer_size, mapping);
+	if (mapped) {
+		return PNGDriverCommon::png_to_image(mapped, buffer_size, p_force_linear, p_image);
+	}
+
 	Vector<uint8_t> file_buffer;
 	Error err = file_buffer.resize(buffer_size);
 	if (err) {
@@ -41,6 +41,7 @@
 #include <errno.h>
 
 #if defined(UNIX_ENABLED)
+#include <sys/mman.h>
 #include <unistd.h>
 #endif
 
@@ -62,6 +63,20 @@
 #include <sys/ioctl.h>
 #endif
 
+#if defined(UNIX_ENABLED)
+class FileMappingUnix : public FileMapping {
+public:
+	FileMappingUnix(const uint8_t *p_data, uint64_t p_size) {
+		data = p_data;
+		size = p_size;
+	}
+
+	~FileMappingUnix() {
+		munmap((void *)data, size);
+	}
+};
+#endif
+
 void FileAccessUnix::check_errors() const {
 	ERR_FAIL_COND_MSG(!f, "File must be opened before use.");
 
@@ -152,6 +167,7 @@ void FileAccessUnix::_close() {
 
 	fclose(f);
 	f = nullptr;
+	mapping = Ref<FileMapping>();
 
 	if (close_notification_func) {
 		close_notification_func(path, flags);
@@ -245,6 +261,27 @@ uint64_t FileAccessUnix::get_buffer(uint8_t *p_dst, uint64_t p_length) const {
 	return read;
 }
 
+Ref<FileMapping> FileAccessUnix::get_mapping() {
+	ERR_FAIL_COND_V_MSG(!f, Ref<FileMapping>(), "File must be opened before use.");
+
+#if defined(UNIX_ENABLED)
+	// Only files opened for reading are mapped, so the mapping never sees writes made through this file.
+	// Note that the file must not be truncated by someone else while it's mapped.
+	if (mapping.is_null() && flags == READ) {
+		uint64_t length = get_length();
+		if (length == 0 || length > SIZE_MAX) {
+			return Ref<FileMapping>();
+		}
+		void *data = mmap(nullptr, length, PROT_READ, MAP_SHARED, fileno(f), 0);
+		if (data == MAP_FAILED) {
+			return Ref<FileMapping>();
+		}
+		mapping = Ref<FileMapping>(memnew(FileMappingUnix((const uint8_t *)data, length)));
+	}
+#endif
+	return mapping;
+}
+
 Error FileAccessUnix::get_error() const {
 	return last_error;
 }
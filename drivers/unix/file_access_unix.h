@@ -48,6 +48,7 @@ class FileAccessUnix : public FileAccess {
 	String save_path;
 	String path;
 	String path_src;
+	Ref<FileMapping> mapping;
 
 	static Ref<FileAccess> create_libc();
 	void _close();
@@ -70,6 +71,7 @@ public:
 
 	virtual uint8_t get_8() const; ///< get a byte
 	virtual uint64_t get_buffer(uint8_t *p_dst, uint64_t p_length) const;
+	virtual Ref<FileMapping> get_mapping();
 
 	virtual Error get_error() const; ///< get last error
 
@@ -36,6 +36,7 @@
 #include "core/io/config_file.h"
 #include "core/io/dir_access.h"
 #include "core/io/file_access.h"
+#include "core/io/file_access_compressed.h"
 #include "core/io/file_access_encrypted.h"
 #include "core/io/file_access_pack.h" // PACK_HEADER_MAGIC, PACK_FORMAT_VERSION
 #include "core/io/resource_loader.h"
@@ -327,6 +328,21 @@ Error EditorExportPlatform::_save_pack_file(void *p_userdata, const String &p_pa
 		}
 	}
 
+	// Store compressed when it's worth it, data that's already compressed is kept as is.
+	Vector<uint8_t> compressed;
+	{
+		Ref<FileAccessCompressed> fac;
+		fac.instantiate();
+		fac->configure("GCPF");
+		compressed = fac->compress_buffer(p_data.ptr(), p_data.size());
+		if ((uint64_t)compressed.size() * 10 > (uint64_t)p_data.size() * 9) {
+			compressed.clear();
+		}
+	}
+	const Vector<uint8_t> &stored = compressed.is_empty() ? p_data : compressed;
+	sd.compressed = !compressed.is_empty();
+	sd.size = stored.size();
+
 	Ref<FileAccessEncrypted> fae;
 	Ref<FileAccess> ftmp = pd->f;
 
@@ -340,7 +356,7 @@ Error EditorExportPlatform::_save_pack_file(void *p_userdata, const String &p_pa
 	}
 
 	// Store file content.
-	ftmp->store_buffer(p_data.ptr(), p_data.size());
+	ftmp->store_buffer(stored.ptr(), stored.size());
 
 	if (fae.is_valid()) {
 		ftmp.unref();
@@ -1153,8 +1169,6 @@ Error EditorExportPlatform::save_pack(const Ref<EditorExportPreset> &p_preset, b
 		return err;
 	}
 
-	pd.file_ofs.sort(); //do sort, so we can do binary search later
-
 	Ref<FileAccess> f;
 	int64_t embed_pos = 0;
 	if (!p_embed) {
@@ -1204,6 +1218,8 @@ Error EditorExportPlatform::save_pack(const Ref<EditorExportPreset> &p_preset, b
 
 	uint64_t file_base_ofs = f->get_position();
 	f->store_64(0); // files base
+	f->store_64(0); // index offset
+	f->store_64(0); // index size
 
 	for (int i = 0; i < 16; i++) {
 		//reserved
@@ -1212,6 +1228,51 @@ Error EditorExportPlatform::save_pack(const Ref<EditorExportPreset> &p_preset, b
 
 	f->store_32(pd.file_ofs.size()); //amount of files
 
+	int header_padding = _get_pad(PCK_PADDING, f->get_position());
+	for (int i = 0; i < header_padding; i++) {
+		f->store_8(Math::rand() % 256);
+	}
+
+	uint64_t file_base = f->get_position();
+
+	// Save the rest of the data.
+
+	ftmp = FileAccess::open(tmppath, FileAccess::READ);
+	if (ftmp.is_null()) {
+		DirAccess::remove_file_or_error(tmppath);
+		ERR_FAIL_V_MSG(ERR_CANT_CREATE, "Can't open file to read from path '" + String(tmppath) + "'.");
+	}
+
+	const int bufsize = 16384;
+	uint8_t buf[bufsize];
+
+	while (true) {
+		uint64_t got = ftmp->get_buffer(buf, bufsize);
+		if (got == 0) {
+			break;
+		}
+		f->store_buffer(buf, got);
+	}
+
+	// Sorted directory index after the files, it's used in place when the pack is loaded.
+	Vector<PackedData::IndexEntry> entries;
+	entries.resize(pd.file_ofs.size());
+	for (int i = 0; i < pd.file_ofs.size(); i++) {
+		PackedData::IndexEntry &entry = entries.write[i];
+		entry.path.parse_utf8(pd.file_ofs[i].path_utf8.get_data());
+		entry.offset = pd.file_ofs[i].ofs;
+		entry.size = pd.file_ofs[i].size;
+		memcpy(entry.md5, pd.file_ofs[i].md5.ptr(), 16);
+		if (pd.file_ofs[i].encrypted) {
+			entry.flags |= PACK_FILE_ENCRYPTED;
+		}
+		if (pd.file_ofs[i].compressed) {
+			entry.flags |= PACK_FILE_COMPRESSED;
+		}
+	}
+	Vector<uint8_t> index = PackedData::build_pack_index(entries);
+	uint64_t index_offset = f->get_position();
+
 	Ref<FileAccessEncrypted> fae;
 	Ref<FileAccess> fhead = f;
 
@@ -1253,59 +1314,18 @@ Error EditorExportPlatform::save_pack(const Ref<EditorExportPreset> &p_preset, b
 		fhead = fae;
 	}
 
-	for (int i = 0; i < pd.file_ofs.size(); i++) {
-		uint32_t string_len = pd.file_ofs[i].path_utf8.length();
-		uint32_t pad = _get_pad(4, string_len);
-
-		fhead->store_32(string_len + pad);
-		fhead->store_buffer((const uint8_t *)pd.file_ofs[i].path_utf8.get_data(), string_len);
-		for (uint32_t j = 0; j < pad; j++) {
-			fhead->store_8(0);
-		}
-
-		fhead->store_64(pd.file_ofs[i].ofs);
-		fhead->store_64(pd.file_ofs[i].size); // pay attention here, this is where file is
-		fhead->store_buffer(pd.file_ofs[i].md5.ptr(), 16); //also save md5 for file
-		uint32_t flags = 0;
-		if (pd.file_ofs[i].encrypted) {
-			flags |= PACK_FILE_ENCRYPTED;
-		}
-		fhead->store_32(flags);
-	}
+	fhead->store_buffer(index.ptr(), index.size());
 
 	if (fae.is_valid()) {
 		fhead.unref();
 		fae.unref();
 	}
 
-	int header_padding = _get_pad(PCK_PADDING, f->get_position());
-	for (int i = 0; i < header_padding; i++) {
-		f->store_8(Math::rand() % 256);
-	}
-
-	uint64_t file_base = f->get_position();
 	f->seek(file_base_ofs);
 	f->store_64(file_base); // update files base
-	f->seek(file_base);
-
-	// Save the rest of the data.
-
-	ftmp = FileAccess::open(tmppath, FileAccess::READ);
-	if (ftmp.is_null()) {
-		DirAccess::remove_file_or_error(tmppath);
-		ERR_FAIL_V_MSG(ERR_CANT_CREATE, "Can't open file to read from path '" + String(tmppath) + "'.");
-	}
-
-	const int bufsize = 16384;
-	uint8_t buf[bufsize];
-
-	while (true) {
-		uint64_t got = ftmp->get_buffer(buf, bufsize);
-		if (got == 0) {
-			break;
-		}
-		f->store_buffer(buf, got);
-	}
+	f->store_64(index_offset);
+	f->store_64(index.size());
+	f->seek_end();
 
 	ftmp.unref(); // Close temp file.
 
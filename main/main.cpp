@@ -50,6 +50,7 @@
 #include "core/os/time.h"
 #include "core/register_core_types.h"
 #include "core/string/translation.h"
+#include "core/templates/arena_allocator.h"
 #include "core/version.h"
 #include "drivers/register_driver_types.h"
 #include "main/app_icon.gen.h"
@@ -2660,6 +2661,9 @@ bool Main::iteration() {
 
 	iterating++;
 
+	// Nothing allocated from the main thread's scratch arena may outlive a frame.
+	ArenaAllocator::get_thread_arena().reset();
+
 	const uint64_t ticks = OS::get_singleton()->get_ticks_usec();
 	Engine::get_singleton()->_frame_ticks = ticks;
 	main_timer_sync.set_cpu_ticks_usec(ticks);
@@ -2848,6 +2852,16 @@ void Main::cleanup(bool p_force) {
 	ResourceLoader::remove_custom_loaders();
 	ResourceSaver::remove_custom_savers();
 
+#ifdef DEBUG_ENABLED
+	if (OS::get_singleton()->is_stdout_verbose()) {
+		print_line("Allocations per subsystem:");
+		for (int i = 0; i < Memory::TAG_MAX; i++) {
+			Memory::Tag tag = Memory::Tag(i);
+			print_line(vformat("\t%s: %d allocations, %s", Memory::get_tag_name(tag), Memory::get_tag_alloc_count(tag), String::humanize_size(Memory::get_tag_alloc_bytes(tag))));
+		}
+	}
+#endif
+
 	// Flush before uninitializing the scene, but delete the MessageQueue as late as possible.
 	message_queue->flush();
 
@@ -40,10 +40,13 @@
 #include "core/io/file_access_encrypted.h"
 #include "core/os/os.h"
 #include "gdscript_analyzer.h"
+#include "gdscript_bytecode_format.h"
 #include "gdscript_cache.h"
 #include "gdscript_compiler.h"
+#include "gdscript_numeric_tier.h"
 #include "gdscript_parser.h"
 #include "gdscript_rpc_callable.h"
+#include "gdscript_sampling_profiler.h"
 #include "gdscript_warning.h"
 
 #ifdef TESTS_ENABLED
@@ -858,31 +861,46 @@ Error GDScript::reload(bool p_keep_state) {
 	}
 
 	valid = false;
-	GDScriptParser parser;
-	Error err = parser.parse(source, path, false);
-	if (err) {
-		if (EngineDebugger::is_active()) {
-			GDScriptLanguage::get_singleton()->debug_break_parse(_get_debug_path(), parser.get_errors().front()->get().line, "Parser Error: " + parser.get_errors().front()->get().message);
-		}
-		// TODO: Show all error messages.
-		_err_print_error("GDScript::reload", path.is_empty() ? "built-in" : (const char *)path.utf8().get_data(), parser.get_errors().front()->get().line, ("Parse Error: " + parser.get_errors().front()->get().message).utf8().get_data(), false, ERR_HANDLER_SCRIPT);
-		ERR_FAIL_V(ERR_PARSE_ERROR);
+	compiled_parser_id = ObjectID();
+
+	// When the cache already analyzed this very source, compile from its parser.
+	Ref<GDScriptParserRef> parser_ref;
+	if (path.is_resource_file()) {
+		parser_ref = GDScriptCache::get_analyzed_parser(path, source);
 	}
 
-	GDScriptAnalyzer analyzer(&parser);
-	err = analyzer.analyze();
+	GDScriptParser local_parser;
+	GDScriptAnalyzer analyzer(&local_parser);
+	GDScriptParser &parser = parser_ref.is_valid() ? *parser_ref->get_parser() : local_parser;
+	Error err = OK;
+	if (parser_ref.is_null()) {
+		err = parser.parse(source, path, false);
+		if (err) {
+			if (EngineDebugger::is_active()) {
+				GDScriptLanguage::get_singleton()->debug_break_parse(_get_debug_path(), parser.get_errors().front()->get().line, "Parser Error: " + parser.get_errors().front()->get().message);
+			}
+			// TODO: Show all error messages.
+			_err_print_error("GDScript::reload", path.is_empty() ? "built-in" : (const char *)path.utf8().get_data(), parser.get_errors().front()->get().line, ("Parse Error: " + parser.get_errors().front()->get().message).utf8().get_data(), false, ERR_HANDLER_SCRIPT);
+			ERR_FAIL_V(ERR_PARSE_ERROR);
+		}
 
-	if (err) {
-		if (EngineDebugger::is_active()) {
-			GDScriptLanguage::get_singleton()->debug_break_parse(_get_debug_path(), parser.get_errors().front()->get().line, "Parser Error: " + parser.get_errors().front()->get().message);
+		if (path.is_resource_file()) {
+			GDScriptCache::parse_dependencies(path, &parser);
 		}
+		err = analyzer.analyze();
 
-		const List<GDScriptParser::ParserError>::Element *e = parser.get_errors().front();
-		while (e != nullptr) {
-			_err_print_error("GDScript::reload", path.is_empty() ? "built-in" : (const char *)path.utf8().get_data(), e->get().line, ("Parse Error: " + e->get().message).utf8().get_data(), false, ERR_HANDLER_SCRIPT);
-			e = e->next();
+		if (err) {
+			if (EngineDebugger::is_active()) {
+				GDScriptLanguage::get_singleton()->debug_break_parse(_get_debug_path(), parser.get_errors().front()->get().line, "Parser Error: " + parser.get_errors().front()->get().message);
+			}
+
+			const List<GDScriptParser::ParserError>::Element *e = parser.get_errors().front();
+			while (e != nullptr) {
+				_err_print_error("GDScript::reload", path.is_empty() ? "built-in" : (const char *)path.utf8().get_data(), e->get().line, ("Parse Error: " + e->get().message).utf8().get_data(), false, ERR_HANDLER_SCRIPT);
+				e = e->next();
+			}
+			ERR_FAIL_V(ERR_PARSE_ERROR);
 		}
-		ERR_FAIL_V(ERR_PARSE_ERROR);
 	}
 
 	bool can_run = ScriptServer::is_scripting_enabled() || parser.is_tool();
@@ -915,6 +933,9 @@ Error GDScript::reload(bool p_keep_state) {
 #endif
 
 	valid = true;
+	if (parser_ref.is_valid()) {
+		compiled_parser_id = parser_ref->get_instance_id();
+	}
 
 	for (KeyValue<StringName, Ref<GDScript>> &E : subclasses) {
 		_set_subclass_path(E.value, path);
@@ -1019,15 +1040,57 @@ void GDScript::_bind_methods() {
 }
 
 Vector<uint8_t> GDScript::get_as_byte_code() const {
-	return Vector<uint8_t>();
-};
+	Vector<uint8_t> bytecode;
+	if (GDScriptBytecodeFormat::serialize(this, bytecode) != OK) {
+		return Vector<uint8_t>();
+	}
+	return bytecode;
+}
 
-// TODO: Fully remove this. There's not this kind of "bytecode" anymore.
 Error GDScript::load_byte_code(const String &p_path) {
-	return ERR_COMPILATION_FAILED;
+	Error err;
+	Vector<uint8_t> bytecode = FileAccess::get_file_as_array(p_path, &err);
+	ERR_FAIL_COND_V_MSG(err, err, "Cannot open compiled script '" + p_path + "'.");
+
+	// Keep the embedded source so the script can still be compiled if the bytecode is rejected.
+	err = GDScriptBytecodeFormat::get_source(bytecode, source);
+	ERR_FAIL_COND_V_MSG(err, err, "Compiled script '" + p_path + "' is corrupt.");
+#ifdef TOOLS_ENABLED
+	source_changed_cache = true;
+#endif
+
+	valid = false;
+	err = GDScriptBytecodeFormat::deserialize(bytecode, this);
+	if (err) {
+		return err;
+	}
+	valid = true;
+
+	for (KeyValue<StringName, Ref<GDScript>> &E : subclasses) {
+		_set_subclass_path(E.value, path);
+	}
+
+	_init_rpc_methods_properties();
+
+	return GDScriptCache::finish_compiling(path);
 }
 
 Error GDScript::load_source_code(const String &p_path) {
+	String bytecode_path = GDScriptBytecodeFormat::get_bytecode_path(p_path);
+	if (!bytecode_path.is_empty()) {
+		// Exported as bytecode, which embeds the source.
+		Error err;
+		Vector<uint8_t> bytecode = FileAccess::get_file_as_array(bytecode_path, &err);
+		ERR_FAIL_COND_V_MSG(err, err, "Cannot open compiled script '" + bytecode_path + "'.");
+		err = GDScriptBytecodeFormat::get_source(bytecode, source);
+		ERR_FAIL_COND_V_MSG(err, err, "Compiled script '" + bytecode_path + "' is corrupt.");
+#ifdef TOOLS_ENABLED
+		source_changed_cache = true;
+#endif
+		path = p_path;
+		return OK;
+	}
+
 	Vector<uint8_t> sourcef;
 	Error err;
 	Ref<FileAccess> f = FileAccess::open(p_path, FileAccess::READ, &err);
@@ -1716,6 +1779,10 @@ void GDScriptLanguage::init() {
 		_add_global(E.name, E.ptr);
 	}
 
+	if (GLOBAL_GET("debug/settings/gdscript/sampling_profiler/enabled")) {
+		sampling_profiler->start(GLOBAL_GET("debug/settings/gdscript/sampling_profiler/interval_usec"));
+	}
+
 #ifdef TESTS_ENABLED
 	GDScriptTests::GDScriptTestRunner::handle_cmdline();
 #endif
@@ -1735,6 +1802,15 @@ Error GDScriptLanguage::execute_file(const String &p_path) {
 }
 
 void GDScriptLanguage::finish() {
+	if (sampling_profiler->is_running()) {
+		sampling_profiler->stop();
+		String path = GLOBAL_GET("debug/settings/gdscript/sampling_profiler/output_path");
+		// Chrome traces are JSON, anything else gets the collapsed stacks used by flamegraph tools.
+		GDScriptSamplingProfiler::Format format = path.get_extension().to_lower() == "json" ? GDScriptSamplingProfiler::FORMAT_CHROME_TRACE : GDScriptSamplingProfiler::FORMAT_COLLAPSED_STACKS;
+		if (sampling_profiler->save(path, format) == OK) {
+			print_verbose("GDScript: Saved " + itos(sampling_profiler->get_sample_count()) + " profiler samples to: " + path);
+		}
+	}
 }
 
 void GDScriptLanguage::profiling_start() {
@@ -1856,9 +1932,16 @@ void GDScriptLanguage::reload_all_scripts() {
 
 	scripts.sort_custom<GDScriptDepSort>(); //update in inheritance dependency order
 
+	GDScriptCache::check_for_changes();
+
 	for (Ref<GDScript> &script : scripts) {
-		print_verbose("GDScript: Reloading: " + script->get_path());
 		script->load_source_code(script->get_path());
+		// Neither its source nor the scripts it depends on changed since it was compiled.
+		if (script->valid && GDScriptCache::is_parser_current(script->get_path(), script->compiled_parser_id)) {
+			print_verbose("GDScript: Unchanged: " + script->get_path());
+			continue;
+		}
+		print_verbose("GDScript: Reloading: " + script->get_path());
 		script->reload(true);
 	}
 #endif
@@ -1866,6 +1949,7 @@ void GDScriptLanguage::reload_all_scripts() {
 
 void GDScriptLanguage::reload_tool_script(const Ref<Script> &p_script, bool p_soft_reload) {
 #ifdef DEBUG_ENABLED
+	GDScriptCache::check_for_changes();
 
 	List<Ref<GDScript>> scripts;
 	{
@@ -2227,6 +2311,14 @@ GDScriptLanguage::GDScriptLanguage() {
 		_call_stack = nullptr;
 	}
 
+	GDScriptNumericTier::set_enabled(GLOBAL_DEF("debug/settings/gdscript/numeric_tier", true));
+
+	sampling_profiler = memnew(GDScriptSamplingProfiler);
+	GLOBAL_DEF("debug/settings/gdscript/sampling_profiler/enabled", false);
+	GLOBAL_DEF("debug/settings/gdscript/sampling_profiler/output_path", "user://gdscript_profile.folded");
+	GLOBAL_DEF("debug/settings/gdscript/sampling_profiler/interval_usec", 1000);
+	ProjectSettings::get_singleton()->set_custom_property_info("debug/settings/gdscript/sampling_profiler/interval_usec", PropertyInfo(Variant::INT, "debug/settings/gdscript/sampling_profiler/interval_usec", PROPERTY_HINT_RANGE, "100,100000,1,or_greater"));
+
 #ifdef DEBUG_ENABLED
 	GLOBAL_DEF("debug/gdscript/warnings/enable", true);
 	GLOBAL_DEF("debug/gdscript/warnings/treat_warnings_as_errors", false);
@@ -2243,6 +2335,7 @@ GDScriptLanguage::~GDScriptLanguage() {
 	if (_call_stack) {
 		memdelete_arr(_call_stack);
 	}
+	memdelete(sampling_profiler);
 
 	// Clear dependencies between scripts, to ensure cyclic references are broken (to avoid leaks at exit).
 	SelfList<GDScript> *s = script_list.first();
@@ -2297,10 +2390,13 @@ Ref<Resource> ResourceFormatLoaderGDScript::load(const String &p_path, const Str
 		*r_error = ERR_FILE_CANT_OPEN;
 	}
 
+	// Compiled scripts are cached under the path of the source they were exported from.
+	String path = p_path.get_extension().to_lower() == "gdc" ? p_original_path : p_path;
+
 	Error err;
-	Ref<GDScript> script = GDScriptCache::get_full_script(p_path, err);
+	Ref<GDScript> script = GDScriptCache::get_full_script(path, err);
 
-	// TODO: Reintroduce binary and encrypted scripts.
+	// TODO: Reintroduce encrypted scripts.
 
 	if (script.is_null()) {
 		// Don't fail loading because of parsing error.
@@ -2316,8 +2412,8 @@ Ref<Resource> ResourceFormatLoaderGDScript::load(const String &p_path, const Str
 
 void ResourceFormatLoaderGDScript::get_recognized_extensions(List<String> *p_extensions) const {
 	p_extensions->push_back("gd");
-	// TODO: Reintroduce binary and encrypted scripts.
-	// p_extensions->push_back("gdc");
+	p_extensions->push_back("gdc");
+	// TODO: Reintroduce encrypted scripts.
 	// p_extensions->push_back("gde");
 }
 
@@ -2327,8 +2423,8 @@ bool ResourceFormatLoaderGDScript::handles_type(const String &p_type) const {
 
 String ResourceFormatLoaderGDScript::get_resource_type(const String &p_path) const {
 	String el = p_path.get_extension().to_lower();
-	// TODO: Reintroduce binary and encrypted scripts.
-	if (el == "gd" /*|| el == "gdc" || el == "gde"*/) {
+	// TODO: Reintroduce encrypted scripts.
+	if (el == "gd" || el == "gdc" /*|| el == "gde"*/) {
 		return "GDScript";
 	}
 	return "";
@@ -2338,7 +2434,15 @@ void ResourceFormatLoaderGDScript::get_dependencies(const String &p_path, List<S
 	Ref<FileAccess> file = FileAccess::open(p_path, FileAccess::READ);
 	ERR_FAIL_COND_MSG(file.is_null(), "Cannot open file '" + p_path + "'.");
 
-	String source = file->get_as_utf8_string();
+	String source;
+	if (p_path.get_extension().to_lower() == "gdc") {
+		Vector<uint8_t> bytecode;
+		bytecode.resize(file->get_length());
+		file->get_buffer(bytecode.ptrw(), bytecode.size());
+		GDScriptBytecodeFormat::get_source(bytecode, source);
+	} else {
+		source = file->get_as_utf8_string();
+	}
 	if (source.is_empty()) {
 		return;
 	}
@@ -2371,6 +2475,8 @@ Error ResourceFormatSaverGDScript::save(const String &p_path, const Ref<Resource
 		}
 	}
 
+	GDScriptCache::check_for_changes();
+
 	if (ScriptServer::is_reload_scripts_on_save_enabled()) {
 		GDScriptLanguage::get_singleton()->reload_tool_script(p_resource, false);
 	}
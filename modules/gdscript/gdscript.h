@@ -39,6 +39,8 @@
 #include "core/object/script_language.h"
 #include "gdscript_function.h"
 
+class GDScriptSamplingProfiler;
+
 class GDScriptNativeClass : public RefCounted {
 	GDCLASS(GDScriptNativeClass, RefCounted);
 
@@ -60,6 +62,7 @@ class GDScript : public Script {
 	GDCLASS(GDScript, Script);
 	bool tool = false;
 	bool valid = false;
+	ObjectID compiled_parser_id; // Cached parser this script was compiled from, if any.
 
 	struct MemberInfo {
 		int index = 0;
@@ -70,6 +73,7 @@ class GDScript : public Script {
 
 	friend class GDScriptInstance;
 	friend class GDScriptFunction;
+	friend class GDScriptBytecodeFormat;
 	friend class GDScriptAnalyzer;
 	friend class GDScriptCompiler;
 	friend class GDScriptLanguage;
@@ -333,6 +337,8 @@ class GDScriptLanguage : public ScriptLanguage {
 	int _debug_max_call_stack;
 	CallLevel *_call_stack = nullptr;
 
+	GDScriptSamplingProfiler *sampling_profiler = nullptr;
+
 	void _add_global(const StringName &p_name, const Variant &p_value);
 
 	friend class GDScriptInstance;
@@ -431,6 +437,7 @@ public:
 	_FORCE_INLINE_ const Map<StringName, Variant> &get_named_globals_map() const { return named_globals; }
 
 	_FORCE_INLINE_ static GDScriptLanguage *get_singleton() { return singleton; }
+	_FORCE_INLINE_ GDScriptSamplingProfiler *get_sampling_profiler() const { return sampling_profiler; }
 
 	virtual String get_name() const override;
 
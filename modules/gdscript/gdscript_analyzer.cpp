@@ -4218,6 +4218,14 @@ Error GDScriptAnalyzer::resolve_program() {
 	resolve_class_interface(parser->head);
 	resolve_class_body(parser->head);
 
+	Error err = resolve_dependencies();
+	if (err) {
+		return err;
+	}
+	return parser->errors.is_empty() ? OK : ERR_PARSE_ERROR;
+}
+
+Error GDScriptAnalyzer::resolve_dependencies() {
 	List<String> parser_keys;
 	depended_parsers.get_key_list(&parser_keys);
 	for (const String &E : parser_keys) {
@@ -4226,7 +4234,7 @@ Error GDScriptAnalyzer::resolve_program() {
 		}
 		depended_parsers[E]->raise_status(GDScriptParserRef::FULLY_SOLVED);
 	}
-	return parser->errors.is_empty() ? OK : ERR_PARSE_ERROR;
+	return OK;
 }
 
 Error GDScriptAnalyzer::analyze() {
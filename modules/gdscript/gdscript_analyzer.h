@@ -126,8 +126,11 @@ public:
 	Error resolve_inheritance();
 	Error resolve_interface();
 	Error resolve_body();
+	Error resolve_dependencies();
 	Error analyze();
 
+	const HashMap<String, Ref<GDScriptParserRef>> &get_depended_parsers() const { return depended_parsers; }
+
 	GDScriptAnalyzer(GDScriptParser *p_parser);
 };
 
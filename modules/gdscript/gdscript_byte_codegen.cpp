@@ -393,6 +393,8 @@ GDScriptFunction *GDScriptByteCodeGenerator::write_end() {
 		function->_lambdas_count = 0;
 	}
 
+	function->_set_inline_cache_count(inline_cache_count);
+
 	if (debug_stack) {
 		function->stack_debug = stack_debug;
 	}
@@ -536,20 +538,26 @@ void GDScriptByteCodeGenerator::write_unary_operator(const Address &p_target, Va
 		// Gather specific operator.
 		Variant::ValidatedOperatorEvaluator op_func = Variant::get_validated_operator_evaluator(p_operator, p_left_operand.type.builtin_type, Variant::NIL);
 
+		last_operator_pos = opcodes.size();
 		append(GDScriptFunction::OPCODE_OPERATOR_VALIDATED, 3);
 		append(p_left_operand);
 		append(Address());
 		append(p_target);
 		append(op_func);
+		last_operator_end = opcodes.size();
+		last_operator_target = p_target;
 		return;
 	}
 
 	// No specific types, perform variant evaluation.
+	last_operator_pos = opcodes.size();
 	append(GDScriptFunction::OPCODE_OPERATOR, 3);
 	append(p_left_operand);
 	append(Address());
 	append(p_target);
 	append(p_operator);
+	last_operator_end = opcodes.size();
+	last_operator_target = p_target;
 }
 
 void GDScriptByteCodeGenerator::write_binary_operator(const Address &p_target, Variant::Operator p_operator, const Address &p_left_operand, const Address &p_right_operand) {
@@ -565,20 +573,41 @@ void GDScriptByteCodeGenerator::write_binary_operator(const Address &p_target, V
 		// Gather specific operator.
 		Variant::ValidatedOperatorEvaluator op_func = Variant::get_validated_operator_evaluator(p_operator, p_left_operand.type.builtin_type, p_right_operand.type.builtin_type);
 
+		last_operator_pos = opcodes.size();
 		append(GDScriptFunction::OPCODE_OPERATOR_VALIDATED, 3);
 		append(p_left_operand);
 		append(p_right_operand);
 		append(p_target);
 		append(op_func);
+		last_operator_end = opcodes.size();
+		last_operator_target = p_target;
 		return;
 	}
 
 	// No specific types, perform variant evaluation.
+	last_operator_pos = opcodes.size();
 	append(GDScriptFunction::OPCODE_OPERATOR, 3);
 	append(p_left_operand);
 	append(p_right_operand);
 	append(p_target);
 	append(p_operator);
+	last_operator_end = opcodes.size();
+	last_operator_target = p_target;
+}
+
+void GDScriptByteCodeGenerator::write_jump_if_not(const Address &p_condition) {
+	// When the condition was just computed by an operator, fuse the test into it
+	// so comparisons in `if` and `while` dispatch once. The caller appends the target.
+	if (last_operator_end == opcodes.size() && last_operator_target.mode == p_condition.mode && last_operator_target.address == p_condition.address) {
+		int opcode = opcodes[last_operator_pos] & GDScriptFunction::INSTR_MASK;
+		GDScriptFunction::Opcode fused = opcode == GDScriptFunction::OPCODE_OPERATOR_VALIDATED ? GDScriptFunction::OPCODE_OPERATOR_VALIDATED_JUMP_IF_NOT : GDScriptFunction::OPCODE_OPERATOR_JUMP_IF_NOT;
+		opcodes.write[last_operator_pos] = (fused & GDScriptFunction::INSTR_MASK) | (3 << GDScriptFunction::INSTR_BITS);
+		last_operator_end = -1;
+		return;
+	}
+
+	append(GDScriptFunction::OPCODE_JUMP_IF_NOT, 1);
+	append(p_condition);
 }
 
 void GDScriptByteCodeGenerator::write_type_test(const Address &p_target, const Address &p_source, const Address &p_type) {
@@ -596,15 +625,13 @@ void GDScriptByteCodeGenerator::write_type_test_builtin(const Address &p_target,
 }
 
 void GDScriptByteCodeGenerator::write_and_left_operand(const Address &p_left_operand) {
-	append(GDScriptFunction::OPCODE_JUMP_IF_NOT, 1);
-	append(p_left_operand);
+	write_jump_if_not(p_left_operand);
 	logic_op_jump_pos1.push_back(opcodes.size());
 	append(0); // Jump target, will be patched.
 }
 
 void GDScriptByteCodeGenerator::write_and_right_operand(const Address &p_right_operand) {
-	append(GDScriptFunction::OPCODE_JUMP_IF_NOT, 1);
-	append(p_right_operand);
+	write_jump_if_not(p_right_operand);
 	logic_op_jump_pos2.push_back(opcodes.size());
 	append(0); // Jump target, will be patched.
 }
@@ -660,8 +687,7 @@ void GDScriptByteCodeGenerator::write_start_ternary(const Address &p_target) {
 }
 
 void GDScriptByteCodeGenerator::write_ternary_condition(const Address &p_condition) {
-	append(GDScriptFunction::OPCODE_JUMP_IF_NOT, 1);
-	append(p_condition);
+	write_jump_if_not(p_condition);
 	ternary_jump_fail_pos.push_back(opcodes.size());
 	append(0); // Jump target, will be patched.
 }
@@ -693,8 +719,9 @@ void GDScriptByteCodeGenerator::write_end_ternary() {
 
 void GDScriptByteCodeGenerator::write_set(const Address &p_target, const Address &p_index, const Address &p_source) {
 	if (HAS_BUILTIN_TYPE(p_target)) {
+		// Arrays validate the element themselves (they may be typed), so they can take any source.
 		if (IS_BUILTIN_TYPE(p_index, Variant::INT) && Variant::get_member_validated_indexed_setter(p_target.type.builtin_type) &&
-				IS_BUILTIN_TYPE(p_source, Variant::get_indexed_element_type(p_target.type.builtin_type))) {
+				(p_target.type.builtin_type == Variant::ARRAY || IS_BUILTIN_TYPE(p_source, Variant::get_indexed_element_type(p_target.type.builtin_type)))) {
 			// Use indexed setter instead.
 			Variant::ValidatedIndexedSetter setter = Variant::get_member_validated_indexed_setter(p_target.type.builtin_type);
 			append(GDScriptFunction::OPCODE_SET_INDEXED_VALIDATED, 3);
@@ -761,6 +788,7 @@ void GDScriptByteCodeGenerator::write_set_named(const Address &p_target, const S
 	append(p_target);
 	append(p_source);
 	append(p_name);
+	append(add_inline_cache());
 }
 
 void GDScriptByteCodeGenerator::write_get_named(const Address &p_target, const StringName &p_name, const Address &p_source) {
@@ -776,18 +804,30 @@ void GDScriptByteCodeGenerator::write_get_named(const Address &p_target, const S
 	append(p_source);
 	append(p_target);
 	append(p_name);
+	append(add_inline_cache());
 }
 
 void GDScriptByteCodeGenerator::write_set_member(const Address &p_value, const StringName &p_name) {
 	append(GDScriptFunction::OPCODE_SET_MEMBER, 1);
 	append(p_value);
 	append(p_name);
+	append(add_inline_cache());
 }
 
 void GDScriptByteCodeGenerator::write_get_member(const Address &p_target, const StringName &p_name) {
 	append(GDScriptFunction::OPCODE_GET_MEMBER, 1);
 	append(p_target);
 	append(p_name);
+	append(add_inline_cache());
+}
+
+void GDScriptByteCodeGenerator::write_set_member_operator(const StringName &p_name, Variant::Operator p_operator, const Address &p_value) {
+	append(GDScriptFunction::OPCODE_SET_MEMBER_OPERATOR, 1);
+	append(p_value);
+	append(p_name);
+	append(p_operator);
+	append(add_inline_cache()); // Getter.
+	append(add_inline_cache()); // Setter.
 }
 
 void GDScriptByteCodeGenerator::write_assign_with_conversion(const Address &p_target, const Address &p_source) {
@@ -870,6 +910,7 @@ void GDScriptByteCodeGenerator::write_assign_default_parameter(const Address &p_
 void GDScriptByteCodeGenerator::write_store_global(const Address &p_dst, int p_global_index) {
 	append(GDScriptFunction::OPCODE_STORE_GLOBAL, 1);
 	append(p_dst);
+	function->global_index_positions.push_back(opcodes.size());
 	append(p_global_index);
 }
 
@@ -919,6 +960,7 @@ void GDScriptByteCodeGenerator::write_call(const Address &p_target, const Addres
 	append(p_target);
 	append(p_arguments.size());
 	append(p_function_name);
+	append(add_inline_cache());
 }
 
 void GDScriptByteCodeGenerator::write_super_call(const Address &p_target, const StringName &p_function_name, const Vector<Address> &p_arguments) {
@@ -940,6 +982,7 @@ void GDScriptByteCodeGenerator::write_call_async(const Address &p_target, const
 	append(p_target);
 	append(p_arguments.size());
 	append(p_function_name);
+	append(add_inline_cache());
 }
 
 void GDScriptByteCodeGenerator::write_call_gdscript_utility(const Address &p_target, GDScriptUtilityFunctions::FunctionPtr p_function, const Vector<Address> &p_arguments) {
@@ -1187,6 +1230,7 @@ void GDScriptByteCodeGenerator::write_call_self(const Address &p_target, const S
 	append(p_target);
 	append(p_arguments.size());
 	append(p_function_name);
+	append(-1); // No inline cache, self always has a script instance.
 }
 
 void GDScriptByteCodeGenerator::write_call_self_async(const Address &p_target, const StringName &p_function_name, const Vector<Address> &p_arguments) {
@@ -1198,6 +1242,7 @@ void GDScriptByteCodeGenerator::write_call_self_async(const Address &p_target, c
 	append(p_target);
 	append(p_arguments.size());
 	append(p_function_name);
+	append(-1);
 }
 
 void GDScriptByteCodeGenerator::write_call_script_function(const Address &p_target, const Address &p_base, const StringName &p_function_name, const Vector<Address> &p_arguments) {
@@ -1209,6 +1254,7 @@ void GDScriptByteCodeGenerator::write_call_script_function(const Address &p_targ
 	append(p_target);
 	append(p_arguments.size());
 	append(p_function_name);
+	append(-1);
 }
 
 void GDScriptByteCodeGenerator::write_lambda(const Address &p_target, GDScriptFunction *p_function, const Vector<Address> &p_captures, bool p_use_self) {
@@ -1317,8 +1363,7 @@ void GDScriptByteCodeGenerator::write_await(const Address &p_target, const Addre
 }
 
 void GDScriptByteCodeGenerator::write_if(const Address &p_condition) {
-	append(GDScriptFunction::OPCODE_JUMP_IF_NOT, 1);
-	append(p_condition);
+	write_jump_if_not(p_condition);
 	if_jmp_addrs.push_back(opcodes.size());
 	append(0); // Jump destination, will be patched.
 }
@@ -1355,6 +1400,11 @@ void GDScriptByteCodeGenerator::write_for_assignment(const Address &p_variable,
 	append(container);
 	append(p_list);
 
+	// A container built just for the loop (e.g. an array literal) is dropped once the loop is done,
+	// so the temporary it came from holds the only reference and can be refilled the next time.
+	bool release = p_list.mode == Address::TEMPORARY && p_list.type.has_type && p_list.type.kind == GDScriptDataType::BUILTIN && (p_list.type.builtin_type == Variant::ARRAY || p_list.type.builtin_type == Variant::DICTIONARY);
+	for_release_containers.push_back(release);
+
 	for_iterator_variables.push_back(p_variable);
 }
 
@@ -1491,7 +1541,14 @@ void GDScriptByteCodeGenerator::write_endfor() {
 	}
 	current_breaks_to_patch.pop_back();
 
+	if (for_release_containers.back()->get()) {
+		append(GDScriptFunction::OPCODE_ASSIGN, 2);
+		append(for_container_variables.back()->get());
+		append(Address());
+	}
+
 	// Pop state.
+	for_release_containers.pop_back();
 	for_iterator_variables.pop_back();
 	for_counter_variables.pop_back();
 	for_container_variables.pop_back();
@@ -1504,8 +1561,7 @@ void GDScriptByteCodeGenerator::start_while_condition() {
 
 void GDScriptByteCodeGenerator::write_while(const Address &p_condition) {
 	// Condition check.
-	append(GDScriptFunction::OPCODE_JUMP_IF_NOT, 1);
-	append(p_condition);
+	write_jump_if_not(p_condition);
 	while_jmp_addrs.push_back(opcodes.size());
 	append(0); // End of loop address, will be patched.
 }
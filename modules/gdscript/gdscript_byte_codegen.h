@@ -71,6 +71,12 @@ class GDScriptByteCodeGenerator : public GDScriptCodeGenerator {
 	int current_line = 0;
 	int instr_args_max = 0;
 	int ptrcall_max = 0;
+	int inline_cache_count = 0;
+
+	// End of the last binary operator, so a conditional jump right after it can be fused into it.
+	int last_operator_pos = -1;
+	int last_operator_end = -1;
+	Address last_operator_target;
 
 #ifdef DEBUG_ENABLED
 	List<int> temp_stack;
@@ -101,6 +107,7 @@ class GDScriptByteCodeGenerator : public GDScriptCodeGenerator {
 	List<Address> for_iterator_variables;
 	List<Address> for_counter_variables;
 	List<Address> for_container_variables;
+	List<bool> for_release_containers;
 	List<int> while_jmp_addrs;
 	List<int> continue_addrs;
 
@@ -303,6 +310,12 @@ class GDScriptByteCodeGenerator : public GDScriptCodeGenerator {
 		return pos;
 	}
 
+	int add_inline_cache() {
+		return inline_cache_count++;
+	}
+
+	void write_jump_if_not(const Address &p_condition);
+
 	void alloc_ptrcall(int p_params) {
 		if (p_params >= ptrcall_max) {
 			ptrcall_max = p_params;
@@ -402,6 +415,7 @@ class GDScriptByteCodeGenerator : public GDScriptCodeGenerator {
 
 	void patch_jump(int p_address) {
 		opcodes.write[p_address] = opcodes.size();
+		last_operator_end = -1; // Something jumps past the operator now, it can't be fused.
 	}
 
 public:
@@ -449,6 +463,7 @@ public:
 	virtual void write_get_named(const Address &p_target, const StringName &p_name, const Address &p_source) override;
 	virtual void write_set_member(const Address &p_value, const StringName &p_name) override;
 	virtual void write_get_member(const Address &p_target, const StringName &p_name) override;
+	virtual void write_set_member_operator(const StringName &p_name, Variant::Operator p_operator, const Address &p_value) override;
 	virtual void write_assign(const Address &p_target, const Address &p_source) override;
 	virtual void write_assign_with_conversion(const Address &p_target, const Address &p_source) override;
 	virtual void write_assign_true(const Address &p_target) override;
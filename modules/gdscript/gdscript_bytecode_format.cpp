@@ -0,0 +1,1393 @@
+/*************************************************************************/
+/*  gdscript_bytecode_format.cpp                                         */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2022 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2022 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#include "gdscript_bytecode_format.h"
+
+#include "core/io/file_access.h"
+#include "core/io/marshalls.h"
+#include "core/io/resource_loader.h"
+#include "core/version.h"
+#include "gdscript.h"
+#include "gdscript_cache.h"
+
+static const char *GDSC_MAGIC = "GDSC";
+
+enum ScriptRefKind {
+	SCRIPT_REF_GDSCRIPT,
+	SCRIPT_REF_RESOURCE,
+};
+
+enum ConstantKind {
+	CONSTANT_VARIANT,
+	CONSTANT_TYPED_ARRAY,
+	CONSTANT_NULL_OBJECT,
+	CONSTANT_NATIVE_CLASS,
+	CONSTANT_SCRIPT,
+	CONSTANT_RESOURCE,
+};
+
+struct GDScriptBytecodeFormat::Writer {
+	Vector<uint8_t> &buffer;
+	const GDScript *main = nullptr;
+
+	void put_u8(uint8_t p_value) {
+		buffer.push_back(p_value);
+	}
+
+	void put_u32(uint32_t p_value) {
+		int ofs = buffer.size();
+		buffer.resize(ofs + 4);
+		encode_uint32(p_value, buffer.ptrw() + ofs);
+	}
+
+	void put_s32(int32_t p_value) {
+		put_u32(uint32_t(p_value));
+	}
+
+	void put_string(const String &p_value) {
+		CharString utf8 = p_value.utf8();
+		put_u32(utf8.length());
+		int ofs = buffer.size();
+		buffer.resize(ofs + utf8.length());
+		memcpy(buffer.ptrw() + ofs, utf8.get_data(), utf8.length());
+	}
+
+	Error put_variant(const Variant &p_value) {
+		int len = 0;
+		Error err = encode_variant(p_value, nullptr, len);
+		ERR_FAIL_COND_V(err, err);
+		put_u32(len);
+		int ofs = buffer.size();
+		buffer.resize(ofs + len);
+		return encode_variant(p_value, buffer.ptrw() + ofs, len);
+	}
+
+	Writer(Vector<uint8_t> &r_buffer, const GDScript *p_main) :
+			buffer(r_buffer),
+			main(p_main) {}
+};
+
+// Every read is bounds checked. Once anything goes out of bounds the reader
+// keeps returning empty values and `failed` stays set.
+struct GDScriptBytecodeFormat::Reader {
+	const uint8_t *data = nullptr;
+	int size = 0;
+	int pos = 0;
+	bool failed = false;
+
+	bool _has(int p_bytes) {
+		if (failed || p_bytes < 0 || p_bytes > size - pos) {
+			failed = true;
+			return false;
+		}
+		return true;
+	}
+
+	uint8_t get_u8() {
+		if (!_has(1)) {
+			return 0;
+		}
+		return data[pos++];
+	}
+
+	uint32_t get_u32() {
+		if (!_has(4)) {
+			return 0;
+		}
+		uint32_t value = decode_uint32(data + pos);
+		pos += 4;
+		return value;
+	}
+
+	int32_t get_s32() {
+		return int32_t(get_u32());
+	}
+
+	// Element count, every element takes at least one byte.
+	uint32_t get_count() {
+		uint32_t count = get_u32();
+		if (!failed && count > uint32_t(size - pos)) {
+			failed = true;
+			return 0;
+		}
+		return count;
+	}
+
+	String get_string() {
+		uint32_t len = get_count();
+		if (failed) {
+			return String();
+		}
+		String value = String::utf8((const char *)data + pos, len);
+		pos += len;
+		return value;
+	}
+
+	StringName get_name() {
+		return StringName(get_string());
+	}
+
+	Variant get_variant() {
+		uint32_t len = get_count();
+		if (failed) {
+			return Variant();
+		}
+		Variant value;
+		if (decode_variant(value, data + pos, len) != OK) {
+			failed = true;
+			return Variant();
+		}
+		pos += len;
+		return value;
+	}
+
+	Reader(const Vector<uint8_t> &p_buffer) :
+			data(p_buffer.ptr()),
+			size(p_buffer.size()) {}
+};
+
+// Validated function pointers are stored by the Variant API entry they were
+// looked up from, so they resolve to the same entry in any build.
+struct BytecodeReverseTables {
+	struct OperatorKey {
+		Variant::Operator op = Variant::OP_MAX;
+		Variant::Type type_a = Variant::NIL;
+		Variant::Type type_b = Variant::NIL;
+	};
+
+	struct MemberKey {
+		Variant::Type type = Variant::NIL;
+		StringName name;
+	};
+
+	struct ConstructorKey {
+		Variant::Type type = Variant::NIL;
+		int index = 0;
+	};
+
+	Map<Variant::ValidatedOperatorEvaluator, OperatorKey> operators;
+	Map<Variant::ValidatedSetter, MemberKey> setters;
+	Map<Variant::ValidatedGetter, MemberKey> getters;
+	Map<Variant::ValidatedKeyedSetter, Variant::Type> keyed_setters;
+	Map<Variant::ValidatedKeyedGetter, Variant::Type> keyed_getters;
+	Map<Variant::ValidatedIndexedSetter, Variant::Type> indexed_setters;
+	Map<Variant::ValidatedIndexedGetter, Variant::Type> indexed_getters;
+	Map<Variant::ValidatedBuiltInMethod, MemberKey> builtin_methods;
+	Map<Variant::ValidatedConstructor, ConstructorKey> constructors;
+	Map<Variant::ValidatedUtilityFunction, StringName> utilities;
+	Map<GDScriptUtilityFunctions::FunctionPtr, StringName> gds_utilities;
+
+	template <class K, class V>
+	static void _add(Map<K, V> &r_map, K p_key, const V &p_value) {
+		// Identical functions may be shared between entries, any of them resolves back to it.
+		if (p_key && !r_map.has(p_key)) {
+			r_map.insert(p_key, p_value);
+		}
+	}
+
+	BytecodeReverseTables() {
+		for (int i = 0; i < Variant::VARIANT_MAX; i++) {
+			Variant::Type type = Variant::Type(i);
+
+			for (int op = 0; op < Variant::OP_MAX; op++) {
+				for (int j = 0; j < Variant::VARIANT_MAX; j++) {
+					OperatorKey key;
+					key.op = Variant::Operator(op);
+					key.type_a = type;
+					key.type_b = Variant::Type(j);
+					_add(operators, Variant::get_validated_operator_evaluator(key.op, key.type_a, key.type_b), key);
+				}
+			}
+
+			List<StringName> members;
+			Variant::get_member_list(type, &members);
+			for (const StringName &E : members) {
+				MemberKey key;
+				key.type = type;
+				key.name = E;
+				_add(setters, Variant::get_member_validated_setter(type, E), key);
+				_add(getters, Variant::get_member_validated_getter(type, E), key);
+			}
+
+			if (Variant::is_keyed(type)) {
+				_add(keyed_setters, Variant::get_member_validated_keyed_setter(type), type);
+				_add(keyed_getters, Variant::get_member_validated_keyed_getter(type), type);
+			}
+			if (Variant::has_indexing(type)) {
+				_add(indexed_setters, Variant::get_member_validated_indexed_setter(type), type);
+				_add(indexed_getters, Variant::get_member_validated_indexed_getter(type), type);
+			}
+
+			List<StringName> methods;
+			Variant::get_builtin_method_list(type, &methods);
+			for (const StringName &E : methods) {
+				MemberKey key;
+				key.type = type;
+				key.name = E;
+				_add(builtin_methods, Variant::get_validated_builtin_method(type, E), key);
+			}
+
+			for (int j = 0; j < Variant::get_constructor_count(type); j++) {
+				ConstructorKey key;
+				key.type = type;
+				key.index = j;
+				_add(constructors, Variant::get_validated_constructor(type, j), key);
+			}
+		}
+
+		List<StringName> functions;
+		Variant::get_utility_function_list(&functions);
+		for (const StringName &E : functions) {
+			_add(utilities, Variant::get_validated_utility_function(E), E);
+		}
+
+		functions.clear();
+		GDScriptUtilityFunctions::get_function_list(&functions);
+		for (const StringName &E : functions) {
+			_add(gds_utilities, GDScriptUtilityFunctions::get_function(E), E);
+		}
+	}
+
+	static const BytecodeReverseTables &get() {
+		static BytecodeReverseTables tables;
+		return tables;
+	}
+};
+
+static bool _is_plain_variant(const Variant &p_value) {
+	switch (p_value.get_type()) {
+		case Variant::OBJECT:
+		case Variant::CALLABLE:
+		case Variant::SIGNAL:
+		case Variant::RID:
+			return false;
+		case Variant::ARRAY: {
+			Array array = p_value;
+			if (array.is_typed()) {
+				return false;
+			}
+			for (int i = 0; i < array.size(); i++) {
+				if (!_is_plain_variant(array[i])) {
+					return false;
+				}
+			}
+		} break;
+		case Variant::DICTIONARY: {
+			Dictionary dict = p_value;
+			List<Variant> keys;
+			dict.get_key_list(&keys);
+			for (const Variant &E : keys) {
+				if (!_is_plain_variant(E) || !_is_plain_variant(dict[E])) {
+					return false;
+				}
+			}
+		} break;
+		default:
+			break;
+	}
+	return true;
+}
+
+static Ref<GDScriptNativeClass> _get_native_class(const StringName &p_name) {
+	const Map<StringName, int> &global_map = GDScriptLanguage::get_singleton()->get_global_map();
+	const Map<StringName, int>::Element *E = global_map.find(p_name);
+	if (!E) {
+		return Ref<GDScriptNativeClass>();
+	}
+	return GDScriptLanguage::get_singleton()->get_global_array()[E->get()];
+}
+
+uint32_t GDScriptBytecodeFormat::get_abi_hash() {
+	uint32_t hash = hash_djb2(VERSION_FULL_CONFIG);
+	hash = hash_djb2_one_32(FORMAT_VERSION, hash);
+	hash = hash_djb2_one_32(GDScriptFunction::OPCODE_END, hash);
+	hash = hash_djb2_one_32(GDScriptFunction::ADDR_BITS, hash);
+	hash = hash_djb2_one_32(GDScriptFunction::INSTR_BITS, hash);
+	hash = hash_djb2_one_32(GDScriptFunction::ADDR_STACK_NIL, hash);
+	hash = hash_djb2_one_32(Variant::VARIANT_MAX, hash);
+	hash = hash_djb2_one_32(Variant::OP_MAX, hash);
+	return hash;
+}
+
+String GDScriptBytecodeFormat::get_bytecode_path(const String &p_path) {
+	if (p_path.is_empty() || FileAccess::exists(p_path)) {
+		// The source is always preferred when present.
+		return String();
+	}
+	String remapped = ResourceLoader::path_remap(p_path);
+	if (remapped != p_path && remapped.get_extension().to_lower() == "gdc") {
+		return remapped;
+	}
+	return String();
+}
+
+Error GDScriptBytecodeFormat::_read_header(Reader &p_reader, String &r_source, bool &r_compatible) {
+	ERR_FAIL_COND_V(p_reader.size < 12 || memcmp(p_reader.data, GDSC_MAGIC, 4) != 0, ERR_FILE_UNRECOGNIZED);
+	p_reader.pos = 4;
+	uint32_t version = p_reader.get_u32();
+	uint32_t abi_hash = p_reader.get_u32();
+	r_source = p_reader.get_string();
+	ERR_FAIL_COND_V(p_reader.failed, ERR_FILE_CORRUPT);
+
+	r_compatible = version == FORMAT_VERSION && abi_hash == get_abi_hash();
+	return OK;
+}
+
+Error GDScriptBytecodeFormat::get_source(const Vector<uint8_t> &p_buffer, String &r_source) {
+	Reader reader(p_buffer);
+	bool compatible = false;
+	return _read_header(reader, r_source, compatible);
+}
+
+/* Serialization */
+
+Error GDScriptBytecodeFormat::_write_script_ref(Writer &p_writer, const Script *p_script) {
+	const GDScript *script = Object::cast_to<GDScript>(p_script);
+	if (!script) {
+		ERR_FAIL_COND_V_MSG(!p_script->get_path().is_resource_file(), ERR_UNAVAILABLE, "Built-in scripts can't be referenced from bytecode.");
+		p_writer.put_u8(SCRIPT_REF_RESOURCE);
+		p_writer.put_string(p_script->get_path());
+		return OK;
+	}
+
+	// Inner classes are stored as their root script path plus the chain of class names.
+	Vector<StringName> names;
+	while (script->_owner) {
+		names.push_back(script->name);
+		script = script->_owner;
+	}
+	ERR_FAIL_COND_V_MSG(script != p_writer.main && !script->path.is_resource_file(), ERR_UNAVAILABLE, "Built-in scripts can't be referenced from bytecode.");
+
+	p_writer.put_u8(SCRIPT_REF_GDSCRIPT);
+	p_writer.put_string(script->path);
+	p_writer.put_u32(names.size());
+	for (int i = names.size() - 1; i >= 0; i--) {
+		p_writer.put_string(names[i]);
+	}
+	return OK;
+}
+
+Error GDScriptBytecodeFormat::_write_data_type(Writer &p_writer, const GDScriptDataType &p_type) {
+	p_writer.put_u8(p_type.has_type);
+	p_writer.put_u8(p_type.kind);
+	p_writer.put_u32(p_type.builtin_type);
+	p_writer.put_string(p_type.native_type);
+
+	p_writer.put_u8(p_type.script_type != nullptr);
+	if (p_type.script_type) {
+		Error err = _write_script_ref(p_writer, p_type.script_type);
+		if (err) {
+			return err;
+		}
+		p_writer.put_u8(p_type.script_type_ref.is_valid());
+	}
+
+	p_writer.put_u8(p_type.has_container_element_type());
+	if (p_type.has_container_element_type()) {
+		return _write_data_type(p_writer, p_type.get_container_element_type());
+	}
+	return OK;
+}
+
+Error GDScriptBytecodeFormat::_write_constant(Writer &p_writer, const Variant &p_value) {
+	if (p_value.get_type() == Variant::OBJECT) {
+		Object *obj = p_value.get_validated_object();
+		if (!obj) {
+			p_writer.put_u8(CONSTANT_NULL_OBJECT);
+			return OK;
+		}
+
+		GDScriptNativeClass *native_class = Object::cast_to<GDScriptNativeClass>(obj);
+		if (native_class) {
+			p_writer.put_u8(CONSTANT_NATIVE_CLASS);
+			p_writer.put_string(native_class->get_name());
+			return OK;
+		}
+
+		Script *script = Object::cast_to<Script>(obj);
+		if (script) {
+			p_writer.put_u8(CONSTANT_SCRIPT);
+			return _write_script_ref(p_writer, script);
+		}
+
+		Resource *resource = Object::cast_to<Resource>(obj);
+		ERR_FAIL_COND_V_MSG(!resource || !resource->get_path().is_resource_file(), ERR_UNAVAILABLE, "Constant of type '" + obj->get_class() + "' can't be stored in bytecode.");
+		p_writer.put_u8(CONSTANT_RESOURCE);
+		p_writer.put_string(resource->get_path());
+		return OK;
+	}
+
+	if (p_value.get_type() == Variant::ARRAY) {
+		Array array = p_value;
+		if (array.is_typed()) {
+			ERR_FAIL_COND_V_MSG(array.get_typed_script().get_type() != Variant::NIL, ERR_UNAVAILABLE, "Arrays typed with a script can't be stored in bytecode.");
+			Array untyped;
+			untyped.resize(array.size());
+			for (int i = 0; i < array.size(); i++) {
+				ERR_FAIL_COND_V_MSG(!_is_plain_variant(array[i]), ERR_UNAVAILABLE, "Constant array can't be stored in bytecode.");
+				untyped[i] = array[i];
+			}
+			p_writer.put_u8(CONSTANT_TYPED_ARRAY);
+			p_writer.put_u32(array.get_typed_builtin());
+			p_writer.put_string(array.get_typed_class_name());
+			return p_writer.put_variant(untyped);
+		}
+	}
+
+	ERR_FAIL_COND_V_MSG(!_is_plain_variant(p_value), ERR_UNAVAILABLE, "Constant of type '" + Variant::get_type_name(p_value.get_type()) + "' containing objects can't be stored in bytecode.");
+	p_writer.put_u8(CONSTANT_VARIANT);
+	return p_writer.put_variant(p_value);
+}
+
+Error GDScriptBytecodeFormat::_write_function(Writer &p_writer, const GDScriptFunction *p_function) {
+	const BytecodeReverseTables &tables = BytecodeReverseTables::get();
+	Error err = OK;
+
+	p_writer.put_string(p_function->name);
+	p_writer.put_string(p_function->source);
+	p_writer.put_s32(p_function->_initial_line);
+	p_writer.put_u8(p_function->_static);
+	p_writer.put_u32(p_function->rpc_config.rpc_mode);
+	p_writer.put_u8(p_function->rpc_config.call_local);
+	p_writer.put_u32(p_function->rpc_config.transfer_mode);
+	p_writer.put_s32(p_function->rpc_config.channel);
+	p_writer.put_s32(p_function->_argument_count);
+	p_writer.put_s32(p_function->_stack_size);
+	p_writer.put_s32(p_function->_instruction_args_size);
+	p_writer.put_s32(p_function->_ptrcall_args_size);
+	p_writer.put_s32(p_function->_inline_caches_count);
+
+	p_writer.put_u32(p_function->code.size());
+	for (int i = 0; i < p_function->code.size(); i++) {
+		p_writer.put_s32(p_function->code[i]);
+	}
+
+	// Global indices depend on registration order, store them by name.
+	p_writer.put_u32(p_function->global_index_positions.size());
+	if (p_function->global_index_positions.size()) {
+		Map<int, StringName> global_names;
+		for (const KeyValue<StringName, int> &E : GDScriptLanguage::get_singleton()->get_global_map()) {
+			global_names[E.value] = E.key;
+		}
+		for (int i = 0; i < p_function->global_index_positions.size(); i++) {
+			int pos = p_function->global_index_positions[i];
+			const Map<int, StringName>::Element *E = global_names.find(p_function->code[pos]);
+			ERR_FAIL_COND_V(!E, ERR_BUG);
+			p_writer.put_u32(pos);
+			p_writer.put_string(E->get());
+		}
+	}
+
+	p_writer.put_u32(p_function->constants.size());
+	for (int i = 0; i < p_function->constants.size(); i++) {
+		err = _write_constant(p_writer, p_function->constants[i]);
+		if (err) {
+			return err;
+		}
+	}
+
+	p_writer.put_u32(p_function->global_names.size());
+	for (int i = 0; i < p_function->global_names.size(); i++) {
+		p_writer.put_string(p_function->global_names[i]);
+	}
+
+	p_writer.put_u32(p_function->default_arguments.size());
+	for (int i = 0; i < p_function->default_arguments.size(); i++) {
+		p_writer.put_s32(p_function->default_arguments[i]);
+	}
+
+	p_writer.put_u32(p_function->operator_funcs.size());
+	for (int i = 0; i < p_function->operator_funcs.size(); i++) {
+		const Map<Variant::ValidatedOperatorEvaluator, BytecodeReverseTables::OperatorKey>::Element *E = tables.operators.find(p_function->operator_funcs[i]);
+		ERR_FAIL_COND_V(!E, ERR_BUG);
+		p_writer.put_u32(E->get().op);
+		p_writer.put_u32(E->get().type_a);
+		p_writer.put_u32(E->get().type_b);
+	}
+
+	p_writer.put_u32(p_function->setters.size());
+	for (int i = 0; i < p_function->setters.size(); i++) {
+		const Map<Variant::ValidatedSetter, BytecodeReverseTables::MemberKey>::Element *E = tables.setters.find(p_function->setters[i]);
+		ERR_FAIL_COND_V(!E, ERR_BUG);
+		p_writer.put_u32(E->get().type);
+		p_writer.put_string(E->get().name);
+	}
+
+	p_writer.put_u32(p_function->getters.size());
+	for (int i = 0; i < p_function->getters.size(); i++) {
+		const Map<Variant::ValidatedGetter, BytecodeReverseTables::MemberKey>::Element *E = tables.getters.find(p_function->getters[i]);
+		ERR_FAIL_COND_V(!E, ERR_BUG);
+		p_writer.put_u32(E->get().type);
+		p_writer.put_string(E->get().name);
+	}
+
+	p_writer.put_u32(p_function->keyed_setters.size());
+	for (int i = 0; i < p_function->keyed_setters.size(); i++) {
+		const Map<Variant::ValidatedKeyedSetter, Variant::Type>::Element *E = tables.keyed_setters.find(p_function->keyed_setters[i]);
+		ERR_FAIL_COND_V(!E, ERR_BUG);
+		p_writer.put_u32(E->get());
+	}
+
+	p_writer.put_u32(p_function->keyed_getters.size());
+	for (int i = 0; i < p_function->keyed_getters.size(); i++) {
+		const Map<Variant::ValidatedKeyedGetter, Variant::Type>::Element *E = tables.keyed_getters.find(p_function->keyed_getters[i]);
+		ERR_FAIL_COND_V(!E, ERR_BUG);
+		p_writer.put_u32(E->get());
+	}
+
+	p_writer.put_u32(p_function->indexed_setters.size());
+	for (int i = 0; i < p_function->indexed_setters.size(); i++) {
+		const Map<Variant::ValidatedIndexedSetter, Variant::Type>::Element *E = tables.indexed_setters.find(p_function->indexed_setters[i]);
+		ERR_FAIL_COND_V(!E, ERR_BUG);
+		p_writer.put_u32(E->get());
+	}
+
+	p_writer.put_u32(p_function->indexed_getters.size());
+	for (int i = 0; i < p_function->indexed_getters.size(); i++) {
+		const Map<Variant::ValidatedIndexedGetter, Variant::Type>::Element *E = tables.indexed_getters.find(p_function->indexed_getters[i]);
+		ERR_FAIL_COND_V(!E, ERR_BUG);
+		p_writer.put_u32(E->get());
+	}
+
+	p_writer.put_u32(p_function->builtin_methods.size());
+	for (int i = 0; i < p_function->builtin_methods.size(); i++) {
+		const Map<Variant::ValidatedBuiltInMethod, BytecodeReverseTables::MemberKey>::Element *E = tables.builtin_methods.find(p_function->builtin_methods[i]);
+		ERR_FAIL_COND_V(!E, ERR_BUG);
+		p_writer.put_u32(E->get().type);
+		p_writer.put_string(E->get().name);
+	}
+
+	p_writer.put_u32(p_function->constructors.size());
+	for (int i = 0; i < p_function->constructors.size(); i++) {
+		const Map<Variant::ValidatedConstructor, BytecodeReverseTables::ConstructorKey>::Element *E = tables.constructors.find(p_function->constructors[i]);
+		ERR_FAIL_COND_V(!E, ERR_BUG);
+		p_writer.put_u32(E->get().type);
+		p_writer.put_s32(E->get().index);
+	}
+
+	p_writer.put_u32(p_function->utilities.size());
+	for (int i = 0; i < p_function->utilities.size(); i++) {
+		const Map<Variant::ValidatedUtilityFunction, StringName>::Element *E = tables.utilities.find(p_function->utilities[i]);
+		ERR_FAIL_COND_V(!E, ERR_BUG);
+		p_writer.put_string(E->get());
+	}
+
+	p_writer.put_u32(p_function->gds_utilities.size());
+	for (int i = 0; i < p_function->gds_utilities.size(); i++) {
+		const Map<GDScriptUtilityFunctions::FunctionPtr, StringName>::Element *E = tables.gds_utilities.find(p_function->gds_utilities[i]);
+		ERR_FAIL_COND_V(!E, ERR_BUG);
+		p_writer.put_string(E->get());
+	}
+
+	p_writer.put_u32(p_function->methods.size());
+	for (int i = 0; i < p_function->methods.size(); i++) {
+		p_writer.put_string(p_function->methods[i]->get_instance_class());
+		p_writer.put_string(p_function->methods[i]->get_name());
+	}
+
+	p_writer.put_u32(p_function->lambdas.size());
+	for (int i = 0; i < p_function->lambdas.size(); i++) {
+		err = _write_function(p_writer, p_function->lambdas[i]);
+		if (err) {
+			return err;
+		}
+	}
+
+	p_writer.put_u32(p_function->argument_types.size());
+	for (int i = 0; i < p_function->argument_types.size(); i++) {
+		err = _write_data_type(p_writer, p_function->argument_types[i]);
+		if (err) {
+			return err;
+		}
+	}
+	err = _write_data_type(p_writer, p_function->return_type);
+	if (err) {
+		return err;
+	}
+
+	p_writer.put_u32(p_function->temporary_slots.size());
+	for (const KeyValue<int, Variant::Type> &E : p_function->temporary_slots) {
+		p_writer.put_s32(E.key);
+		p_writer.put_u32(E.value);
+	}
+
+#ifdef TOOLS_ENABLED
+	p_writer.put_u32(p_function->arg_names.size());
+	for (int i = 0; i < p_function->arg_names.size(); i++) {
+		p_writer.put_string(p_function->arg_names[i]);
+	}
+#else
+	p_writer.put_u32(0);
+#endif
+
+	p_writer.put_u32(p_function->stack_debug.size());
+	for (const GDScriptFunction::StackDebug &E : p_function->stack_debug) {
+		p_writer.put_s32(E.line);
+		p_writer.put_s32(E.pos);
+		p_writer.put_u8(E.added);
+		p_writer.put_string(E.identifier);
+	}
+
+#ifdef DEBUG_ENABLED
+	p_writer.put_string(p_function->profile.signature);
+#else
+	p_writer.put_string(String());
+#endif
+	return OK;
+}
+
+void GDScriptBytecodeFormat::_write_class_tree(Writer &p_writer, const GDScript *p_script) {
+	p_writer.put_u32(p_script->subclasses.size());
+	for (const KeyValue<StringName, Ref<GDScript>> &E : p_script->subclasses) {
+		p_writer.put_string(E.key);
+		_write_class_tree(p_writer, E.value.ptr());
+	}
+}
+
+Error GDScriptBytecodeFormat::_write_class(Writer &p_writer, const GDScript *p_script) {
+	Error err = OK;
+	ERR_FAIL_COND_V(p_script->native.is_null(), ERR_BUG);
+
+	p_writer.put_u8(p_script->tool);
+	p_writer.put_string(p_script->name);
+	p_writer.put_string(p_script->native->get_name());
+	p_writer.put_u8(p_script->base.is_valid());
+	if (p_script->base.is_valid()) {
+		err = _write_script_ref(p_writer, p_script->base.ptr());
+		if (err) {
+			return err;
+		}
+	}
+
+	p_writer.put_u32(p_script->members.size());
+	for (const Set<StringName>::Element *E = p_script->members.front(); E; E = E->next()) {
+		p_writer.put_string(E->get());
+	}
+
+	p_writer.put_u32(p_script->member_indices.size());
+	for (const KeyValue<StringName, GDScript::MemberInfo> &E : p_script->member_indices) {
+		p_writer.put_string(E.key);
+		p_writer.put_s32(E.value.index);
+		p_writer.put_string(E.value.setter);
+		p_writer.put_string(E.value.getter);
+		err = _write_data_type(p_writer, E.value.data_type);
+		if (err) {
+			return err;
+		}
+	}
+
+	p_writer.put_u32(p_script->member_info.size());
+	for (const KeyValue<StringName, PropertyInfo> &E : p_script->member_info) {
+		p_writer.put_string(E.key);
+		p_writer.put_u32(E.value.type);
+		p_writer.put_string(E.value.name);
+		p_writer.put_string(E.value.class_name);
+		p_writer.put_u32(E.value.hint);
+		p_writer.put_string(E.value.hint_string);
+		p_writer.put_u32(E.value.usage);
+	}
+
+	p_writer.put_u32(p_script->constants.size());
+	for (const KeyValue<StringName, Variant> &E : p_script->constants) {
+		p_writer.put_string(E.key);
+		err = _write_constant(p_writer, E.value);
+		if (err) {
+			return err;
+		}
+	}
+
+	p_writer.put_u32(p_script->_signals.size());
+	for (const KeyValue<StringName, Vector<StringName>> &E : p_script->_signals) {
+		p_writer.put_string(E.key);
+		p_writer.put_u32(E.value.size());
+		for (int i = 0; i < E.value.size(); i++) {
+			p_writer.put_string(E.value[i]);
+		}
+	}
+
+	StringName initializer;
+	StringName implicit_initializer;
+	p_writer.put_u32(p_script->member_functions.size());
+	for (const KeyValue<StringName, GDScriptFunction *> &E : p_script->member_functions) {
+		if (E.value == p_script->initializer) {
+			initializer = E.key;
+		}
+		if (E.value == p_script->implicit_initializer) {
+			implicit_initializer = E.key;
+		}
+		p_writer.put_string(E.key);
+		err = _write_function(p_writer, E.value);
+		if (err) {
+			return err;
+		}
+	}
+	p_writer.put_string(initializer);
+	p_writer.put_string(implicit_initializer);
+
+	for (const KeyValue<StringName, Ref<GDScript>> &E : p_script->subclasses) {
+		err = _write_class(p_writer, E.value.ptr());
+		if (err) {
+			return err;
+		}
+	}
+	return OK;
+}
+
+Error GDScriptBytecodeFormat::serialize(const GDScript *p_script, Vector<uint8_t> &r_buffer) {
+	ERR_FAIL_COND_V(!p_script->valid, ERR_INVALID_DATA);
+	ERR_FAIL_COND_V(p_script->_owner != nullptr, ERR_INVALID_PARAMETER);
+
+	r_buffer.clear();
+	Writer writer(r_buffer, p_script);
+	for (int i = 0; i < 4; i++) {
+		writer.put_u8(GDSC_MAGIC[i]);
+	}
+	writer.put_u32(FORMAT_VERSION);
+	writer.put_u32(get_abi_hash());
+	writer.put_string(p_script->source);
+
+	_write_class_tree(writer, p_script);
+	Error err = _write_class(writer, p_script);
+	if (err) {
+		r_buffer.clear();
+	}
+	return err;
+}
+
+/* Deserialization */
+
+Ref<Script> GDScriptBytecodeFormat::_read_script_ref(Reader &p_reader, GDScript *p_main, bool p_full) {
+	uint8_t kind = p_reader.get_u8();
+	String path = p_reader.get_string();
+	if (p_reader.failed) {
+		return Ref<Script>();
+	}
+
+	if (kind == SCRIPT_REF_RESOURCE) {
+		return ResourceLoader::load(path);
+	}
+	if (kind != SCRIPT_REF_GDSCRIPT) {
+		p_reader.failed = true;
+		return Ref<Script>();
+	}
+
+	uint32_t depth = p_reader.get_count();
+	Ref<GDScript> script;
+	if (path == p_main->path) {
+		script = Ref<GDScript>(p_main);
+	} else if (depth == 0 && !p_full) {
+		// Like the compiler, only hold a shallow reference to other scripts used as types
+		// or constants. They are completed by GDScriptCache::finish_compiling().
+		script = GDScriptCache::get_shallow_script(path, p_main->path);
+	} else {
+		Error err = OK;
+		script = GDScriptCache::get_full_script(path, err, p_main->path);
+		if (err || script.is_null() || !script->is_valid()) {
+			return Ref<Script>();
+		}
+	}
+
+	for (uint32_t i = 0; i < depth; i++) {
+		StringName name = p_reader.get_name();
+		if (script.is_null() || !script->subclasses.has(name)) {
+			return Ref<Script>();
+		}
+		script = script->subclasses[name];
+	}
+	return script;
+}
+
+bool GDScriptBytecodeFormat::_read_data_type(Reader &p_reader, GDScript *p_main, GDScriptDataType &r_type) {
+	r_type.has_type = p_reader.get_u8();
+	uint8_t kind = p_reader.get_u8();
+	uint32_t builtin_type = p_reader.get_u32();
+	r_type.native_type = p_reader.get_name();
+	if (kind > GDScriptDataType::GDSCRIPT || builtin_type >= Variant::VARIANT_MAX) {
+		return false;
+	}
+	r_type.kind = GDScriptDataType::Kind(kind);
+	r_type.builtin_type = Variant::Type(builtin_type);
+
+	if (p_reader.get_u8()) {
+		Ref<Script> script = _read_script_ref(p_reader, p_main, false);
+		bool hold_reference = p_reader.get_u8();
+		if (script.is_null()) {
+			return false;
+		}
+		if (!hold_reference) {
+			// Only scripts from the file being loaded are referenced weakly, anything
+			// else must be kept alive here.
+			const GDScript *root = Object::cast_to<GDScript>(script.ptr());
+			while (root && root->_owner) {
+				root = root->_owner;
+			}
+			hold_reference = root != p_main;
+		}
+		r_type.script_type = script.ptr();
+		if (hold_reference) {
+			r_type.script_type_ref = script;
+		}
+	}
+
+	if (p_reader.get_u8()) {
+		GDScriptDataType element_type;
+		if (!_read_data_type(p_reader, p_main, element_type)) {
+			return false;
+		}
+		r_type.set_container_element_type(element_type);
+	}
+	return !p_reader.failed;
+}
+
+bool GDScriptBytecodeFormat::_read_constant(Reader &p_reader, GDScript *p_main, Variant &r_value) {
+	switch (p_reader.get_u8()) {
+		case CONSTANT_VARIANT: {
+			r_value = p_reader.get_variant();
+		} break;
+		case CONSTANT_TYPED_ARRAY: {
+			uint32_t builtin_type = p_reader.get_u32();
+			StringName class_name = p_reader.get_name();
+			Array elements = p_reader.get_variant();
+			if (p_reader.failed || builtin_type >= Variant::VARIANT_MAX) {
+				return false;
+			}
+			Array array;
+			array.set_typed(builtin_type, class_name, Variant());
+			for (int i = 0; i < elements.size(); i++) {
+				array.push_back(elements[i]);
+			}
+			r_value = array;
+		} break;
+		case CONSTANT_NULL_OBJECT: {
+			r_value = Variant((Object *)nullptr);
+		} break;
+		case CONSTANT_NATIVE_CLASS: {
+			Ref<GDScriptNativeClass> native_class = _get_native_class(p_reader.get_name());
+			if (native_class.is_null()) {
+				return false;
+			}
+			r_value = native_class;
+		} break;
+		case CONSTANT_SCRIPT: {
+			Ref<Script> script = _read_script_ref(p_reader, p_main, false);
+			if (script.is_null()) {
+				return false;
+			}
+			r_value = script;
+		} break;
+		case CONSTANT_RESOURCE: {
+			String path = p_reader.get_string();
+			if (p_reader.failed) {
+				return false;
+			}
+			Ref<Resource> resource = ResourceLoader::load(path);
+			if (resource.is_null()) {
+				return false;
+			}
+			r_value = resource;
+		} break;
+		default: {
+			return false;
+		}
+	}
+	return !p_reader.failed;
+}
+
+GDScriptFunction *GDScriptBytecodeFormat::_read_function(Reader &p_reader, GDScript *p_main, GDScript *p_script) {
+	GDScriptFunction *function = memnew(GDScriptFunction);
+	bool valid = true;
+
+	function->_script = p_script;
+	function->name = p_reader.get_name();
+	function->source = p_reader.get_name();
+	function->_initial_line = p_reader.get_s32();
+	function->_static = p_reader.get_u8();
+	function->rpc_config.rpc_mode = Multiplayer::RPCMode(p_reader.get_u32());
+	function->rpc_config.call_local = p_reader.get_u8();
+	function->rpc_config.transfer_mode = Multiplayer::TransferMode(p_reader.get_u32());
+	function->rpc_config.channel = p_reader.get_s32();
+	function->_argument_count = p_reader.get_s32();
+	function->_stack_size = p_reader.get_s32();
+	function->_instruction_args_size = p_reader.get_s32();
+	function->_ptrcall_args_size = p_reader.get_s32();
+	int inline_cache_count = p_reader.get_s32();
+
+	uint32_t count = p_reader.get_count();
+	function->code.resize(count);
+	for (uint32_t i = 0; i < count; i++) {
+		function->code.write[i] = p_reader.get_s32();
+	}
+
+	// Every cache is referenced by at least one code word.
+	if (inline_cache_count < 0 || inline_cache_count > function->code.size()) {
+		valid = false;
+	} else {
+		function->_set_inline_cache_count(inline_cache_count);
+	}
+
+	count = p_reader.get_count();
+	for (uint32_t i = 0; i < count; i++) {
+		uint32_t pos = p_reader.get_u32();
+		StringName global = p_reader.get_name();
+		const Map<StringName, int>::Element *E = GDScriptLanguage::get_singleton()->get_global_map().find(global);
+		if (!E || pos >= uint32_t(function->code.size())) {
+			valid = false;
+			continue;
+		}
+		function->code.write[pos] = E->get();
+		function->global_index_positions.push_back(pos);
+	}
+
+	count = p_reader.get_count();
+	function->constants.resize(count);
+	for (uint32_t i = 0; i < count && valid; i++) {
+		valid = _read_constant(p_reader, p_main, function->constants.write[i]);
+	}
+
+	count = p_reader.get_count();
+	function->global_names.resize(count);
+	for (uint32_t i = 0; i < count; i++) {
+		function->global_names.write[i] = p_reader.get_name();
+	}
+
+	count = p_reader.get_count();
+	function->default_arguments.resize(count);
+	for (uint32_t i = 0; i < count; i++) {
+		function->default_arguments.write[i] = p_reader.get_s32();
+	}
+
+	count = p_reader.get_count();
+	function->operator_funcs.resize(count);
+	for (uint32_t i = 0; i < count; i++) {
+		uint32_t op = p_reader.get_u32();
+		uint32_t type_a = p_reader.get_u32();
+		uint32_t type_b = p_reader.get_u32();
+		if (op >= Variant::OP_MAX || type_a >= Variant::VARIANT_MAX || type_b >= Variant::VARIANT_MAX) {
+			valid = false;
+			continue;
+		}
+		function->operator_funcs.write[i] = Variant::get_validated_operator_evaluator(Variant::Operator(op), Variant::Type(type_a), Variant::Type(type_b));
+		valid = valid && function->operator_funcs[i] != nullptr;
+	}
+
+	count = p_reader.get_count();
+	function->setters.resize(count);
+	for (uint32_t i = 0; i < count; i++) {
+		uint32_t type = p_reader.get_u32();
+		StringName member = p_reader.get_name();
+		if (type >= Variant::VARIANT_MAX) {
+			valid = false;
+			continue;
+		}
+		function->setters.write[i] = Variant::get_member_validated_setter(Variant::Type(type), member);
+		valid = valid && function->setters[i] != nullptr;
+	}
+
+	count = p_reader.get_count();
+	function->getters.resize(count);
+	for (uint32_t i = 0; i < count; i++) {
+		uint32_t type = p_reader.get_u32();
+		StringName member = p_reader.get_name();
+		if (type >= Variant::VARIANT_MAX) {
+			valid = false;
+			continue;
+		}
+		function->getters.write[i] = Variant::get_member_validated_getter(Variant::Type(type), member);
+		valid = valid && function->getters[i] != nullptr;
+	}
+
+	count = p_reader.get_count();
+	function->keyed_setters.resize(count);
+	for (uint32_t i = 0; i < count; i++) {
+		uint32_t type = p_reader.get_u32();
+		if (type >= Variant::VARIANT_MAX || !Variant::is_keyed(Variant::Type(type))) {
+			valid = false;
+			continue;
+		}
+		function->keyed_setters.write[i] = Variant::get_member_validated_keyed_setter(Variant::Type(type));
+	}
+
+	count = p_reader.get_count();
+	function->keyed_getters.resize(count);
+	for (uint32_t i = 0; i < count; i++) {
+		uint32_t type = p_reader.get_u32();
+		if (type >= Variant::VARIANT_MAX || !Variant::is_keyed(Variant::Type(type))) {
+			valid = false;
+			continue;
+		}
+		function->keyed_getters.write[i] = Variant::get_member_validated_keyed_getter(Variant::Type(type));
+	}
+
+	count = p_reader.get_count();
+	function->indexed_setters.resize(count);
+	for (uint32_t i = 0; i < count; i++) {
+		uint32_t type = p_reader.get_u32();
+		if (type >= Variant::VARIANT_MAX || !Variant::has_indexing(Variant::Type(type))) {
+			valid = false;
+			continue;
+		}
+		function->indexed_setters.write[i] = Variant::get_member_validated_indexed_setter(Variant::Type(type));
+	}
+
+	count = p_reader.get_count();
+	function->indexed_getters.resize(count);
+	for (uint32_t i = 0; i < count; i++) {
+		uint32_t type = p_reader.get_u32();
+		if (type >= Variant::VARIANT_MAX || !Variant::has_indexing(Variant::Type(type))) {
+			valid = false;
+			continue;
+		}
+		function->indexed_getters.write[i] = Variant::get_member_validated_indexed_getter(Variant::Type(type));
+	}
+
+	count = p_reader.get_count();
+	function->builtin_methods.resize(count);
+	for (uint32_t i = 0; i < count; i++) {
+		uint32_t type = p_reader.get_u32();
+		StringName method = p_reader.get_name();
+		if (type >= Variant::VARIANT_MAX || !Variant::has_builtin_method(Variant::Type(type), method)) {
+			valid = false;
+			continue;
+		}
+		function->builtin_methods.write[i] = Variant::get_validated_builtin_method(Variant::Type(type), method);
+	}
+
+	count = p_reader.get_count();
+	function->constructors.resize(count);
+	for (uint32_t i = 0; i < count; i++) {
+		uint32_t type = p_reader.get_u32();
+		int index = p_reader.get_s32();
+		if (type >= Variant::VARIANT_MAX || index < 0 || index >= Variant::get_constructor_count(Variant::Type(type))) {
+			valid = false;
+			continue;
+		}
+		function->constructors.write[i] = Variant::get_validated_constructor(Variant::Type(type), index);
+	}
+
+	count = p_reader.get_count();
+	function->utilities.resize(count);
+	for (uint32_t i = 0; i < count; i++) {
+		StringName utility = p_reader.get_name();
+		if (!Variant::has_utility_function(utility)) {
+			valid = false;
+			continue;
+		}
+		function->utilities.write[i] = Variant::get_validated_utility_function(utility);
+	}
+
+	count = p_reader.get_count();
+	function->gds_utilities.resize(count);
+	for (uint32_t i = 0; i < count; i++) {
+		StringName utility = p_reader.get_name();
+		if (!GDScriptUtilityFunctions::function_exists(utility)) {
+			valid = false;
+			continue;
+		}
+		function->gds_utilities.write[i] = GDScriptUtilityFunctions::get_function(utility);
+	}
+
+	count = p_reader.get_count();
+	function->methods.resize(count);
+	for (uint32_t i = 0; i < count; i++) {
+		StringName class_name = p_reader.get_name();
+		StringName method = p_reader.get_name();
+		function->methods.write[i] = ClassDB::get_method(class_name, method);
+		valid = valid && function->methods[i] != nullptr;
+	}
+
+	count = p_reader.get_count();
+	for (uint32_t i = 0; i < count && valid; i++) {
+		GDScriptFunction *lambda = _read_function(p_reader, p_main, p_script);
+		if (!lambda) {
+			valid = false;
+			break;
+		}
+		function->lambdas.push_back(lambda);
+	}
+
+	count = p_reader.get_count();
+	function->argument_types.resize(count);
+	for (uint32_t i = 0; i < count && valid; i++) {
+		valid = _read_data_type(p_reader, p_main, function->argument_types.write[i]);
+	}
+	valid = valid && _read_data_type(p_reader, p_main, function->return_type);
+
+	count = p_reader.get_count();
+	for (uint32_t i = 0; i < count; i++) {
+		int slot = p_reader.get_s32();
+		uint32_t type = p_reader.get_u32();
+		if (type >= Variant::VARIANT_MAX) {
+			valid = false;
+			continue;
+		}
+		function->temporary_slots[slot] = Variant::Type(type);
+	}
+
+	count = p_reader.get_count();
+	for (uint32_t i = 0; i < count; i++) {
+		StringName arg_name = p_reader.get_name();
+#ifdef TOOLS_ENABLED
+		function->arg_names.push_back(arg_name);
+#endif
+	}
+
+	count = p_reader.get_count();
+	for (uint32_t i = 0; i < count; i++) {
+		GDScriptFunction::StackDebug stack_debug;
+		stack_debug.line = p_reader.get_s32();
+		stack_debug.pos = p_reader.get_s32();
+		stack_debug.added = p_reader.get_u8();
+		stack_debug.identifier = p_reader.get_name();
+		function->stack_debug.push_back(stack_debug);
+	}
+
+	String signature = p_reader.get_string();
+
+	if (!valid || p_reader.failed || function->code.is_empty()) {
+		memdelete(function);
+		return nullptr;
+	}
+
+#ifdef DEBUG_ENABLED
+	function->profile.signature = signature;
+	function->func_cname = (String(function->source) + " - " + String(function->name)).utf8();
+	function->_func_cname = function->func_cname.get_data();
+#endif
+
+	// Same setup as GDScriptByteCodeGenerator::write_end().
+	function->_code_ptr = function->code.ptr();
+	function->_code_size = function->code.size();
+	function->_constants_ptr = function->constants.is_empty() ? nullptr : function->constants.ptrw();
+	function->_constant_count = function->constants.size();
+	function->_global_names_ptr = function->global_names.is_empty() ? nullptr : function->global_names.ptr();
+	function->_global_names_count = function->global_names.size();
+	function->_default_arg_ptr = function->default_arguments.is_empty() ? nullptr : function->default_arguments.ptr();
+	function->_default_arg_count = function->default_arguments.is_empty() ? 0 : function->default_arguments.size() - 1;
+	function->_operator_funcs_ptr = function->operator_funcs.is_empty() ? nullptr : function->operator_funcs.ptr();
+	function->_operator_funcs_count = function->operator_funcs.size();
+	function->_setters_ptr = function->setters.is_empty() ? nullptr : function->setters.ptr();
+	function->_setters_count = function->setters.size();
+	function->_getters_ptr = function->getters.is_empty() ? nullptr : function->getters.ptr();
+	function->_getters_count = function->getters.size();
+	function->_keyed_setters_ptr = function->keyed_setters.is_empty() ? nullptr : function->keyed_setters.ptr();
+	function->_keyed_setters_count = function->keyed_setters.size();
+	function->_keyed_getters_ptr = function->keyed_getters.is_empty() ? nullptr : function->keyed_getters.ptr();
+	function->_keyed_getters_count = function->keyed_getters.size();
+	function->_indexed_setters_ptr = function->indexed_setters.is_empty() ? nullptr : function->indexed_setters.ptr();
+	function->_indexed_setters_count = function->indexed_setters.size();
+	function->_indexed_getters_ptr = function->indexed_getters.is_empty() ? nullptr : function->indexed_getters.ptr();
+	function->_indexed_getters_count = function->indexed_getters.size();
+	function->_builtin_methods_ptr = function->builtin_methods.is_empty() ? nullptr : function->builtin_methods.ptr();
+	function->_builtin_methods_count = function->builtin_methods.size();
+	function->_constructors_ptr = function->constructors.is_empty() ? nullptr : function->constructors.ptr();
+	function->_constructors_count = function->constructors.size();
+	function->_utilities_ptr = function->utilities.is_empty() ? nullptr : function->utilities.ptr();
+	function->_utilities_count = function->utilities.size();
+	function->_gds_utilities_ptr = function->gds_utilities.is_empty() ? nullptr : function->gds_utilities.ptr();
+	function->_gds_utilities_count = function->gds_utilities.size();
+	function->_methods_ptr = function->methods.is_empty() ? nullptr : function->methods.ptrw();
+	function->_methods_count = function->methods.size();
+	function->_lambdas_ptr = function->lambdas.is_empty() ? nullptr : function->lambdas.ptrw();
+	function->_lambdas_count = function->lambdas.size();
+
+	return function;
+}
+
+bool GDScriptBytecodeFormat::_read_class_tree(Reader &p_reader, GDScript *p_script) {
+	p_script->subclasses.clear();
+
+	uint32_t count = p_reader.get_count();
+	for (uint32_t i = 0; i < count; i++) {
+		StringName name = p_reader.get_name();
+		if (p_reader.failed) {
+			return false;
+		}
+
+		Ref<GDScript> subclass;
+		subclass.instantiate();
+		subclass->_owner = p_script;
+		subclass->fully_qualified_name = p_script->fully_qualified_name + "::" + name;
+		p_script->subclasses.insert(name, subclass);
+
+		if (!_read_class_tree(p_reader, subclass.ptr())) {
+			return false;
+		}
+	}
+	return true;
+}
+
+bool GDScriptBytecodeFormat::_read_class(Reader &p_reader, GDScript *p_main, GDScript *p_script) {
+	// Same reset as GDScriptCompiler::_parse_class_level().
+	p_script->native = Ref<GDScriptNativeClass>();
+	p_script->base = Ref<GDScript>();
+	p_script->_base = nullptr;
+	p_script->members.clear();
+	p_script->constants.clear();
+	for (const KeyValue<StringName, GDScriptFunction *> &E : p_script->member_functions) {
+		memdelete(E.value);
+	}
+	p_script->member_functions.clear();
+	p_script->member_indices.clear();
+	p_script->member_info.clear();
+	p_script->_signals.clear();
+	p_script->initializer = nullptr;
+	p_script->implicit_initializer = nullptr;
+
+	p_script->tool = p_reader.get_u8();
+	p_script->name = p_reader.get_string();
+	p_script->native = _get_native_class(p_reader.get_name());
+	if (p_script->native.is_null()) {
+		return false;
+	}
+
+	if (p_reader.get_u8()) {
+		Ref<GDScript> base = _read_script_ref(p_reader, p_main, true);
+		if (base.is_null()) {
+			return false;
+		}
+		p_script->base = base;
+		p_script->_base = base.ptr();
+	}
+
+	uint32_t count = p_reader.get_count();
+	for (uint32_t i = 0; i < count; i++) {
+		p_script->members.insert(p_reader.get_name());
+	}
+
+	count = p_reader.get_count();
+	for (uint32_t i = 0; i < count; i++) {
+		StringName name = p_reader.get_name();
+		GDScript::MemberInfo member;
+		member.index = p_reader.get_s32();
+		member.setter = p_reader.get_name();
+		member.getter = p_reader.get_name();
+		if (!_read_data_type(p_reader, p_main, member.data_type)) {
+			return false;
+		}
+		p_script->member_indices[name] = member;
+	}
+
+	count = p_reader.get_count();
+	for (uint32_t i = 0; i < count; i++) {
+		StringName name = p_reader.get_name();
+		PropertyInfo info;
+		info.type = Variant::Type(p_reader.get_u32());
+		info.name = p_reader.get_string();
+		info.class_name = p_reader.get_name();
+		info.hint = PropertyHint(p_reader.get_u32());
+		info.hint_string = p_reader.get_string();
+		info.usage = p_reader.get_u32();
+		if (info.type >= Variant::VARIANT_MAX) {
+			return false;
+		}
+		p_script->member_info[name] = info;
+	}
+
+	count = p_reader.get_count();
+	for (uint32_t i = 0; i < count; i++) {
+		StringName name = p_reader.get_name();
+		Variant value;
+		if (!_read_constant(p_reader, p_main, value)) {
+			return false;
+		}
+		p_script->constants.insert(name, value);
+	}
+
+	count = p_reader.get_count();
+	for (uint32_t i = 0; i < count; i++) {
+		StringName name = p_reader.get_name();
+		Vector<StringName> parameters;
+		uint32_t parameter_count = p_reader.get_count();
+		parameters.resize(parameter_count);
+		for (uint32_t j = 0; j < parameter_count; j++) {
+			parameters.write[j] = p_reader.get_name();
+		}
+		p_script->_signals[name] = parameters;
+	}
+
+	count = p_reader.get_count();
+	for (uint32_t i = 0; i < count; i++) {
+		StringName name = p_reader.get_name();
+		GDScriptFunction *function = _read_function(p_reader, p_main, p_script);
+		if (!function) {
+			return false;
+		}
+		p_script->member_functions[name] = function;
+	}
+
+	StringName initializer = p_reader.get_name();
+	StringName implicit_initializer = p_reader.get_name();
+	if (initializer != StringName()) {
+		if (!p_script->member_functions.has(initializer)) {
+			return false;
+		}
+		p_script->initializer = p_script->member_functions[initializer];
+	}
+	if (implicit_initializer != StringName()) {
+		if (!p_script->member_functions.has(implicit_initializer)) {
+			return false;
+		}
+		p_script->implicit_initializer = p_script->member_functions[implicit_initializer];
+	}
+
+	for (KeyValue<StringName, Ref<GDScript>> &E : p_script->subclasses) {
+		if (!_read_class(p_reader, p_main, E.value.ptr())) {
+			return false;
+		}
+	}
+
+	if (p_reader.failed) {
+		return false;
+	}
+	p_script->valid = true;
+	return true;
+}
+
+Error GDScriptBytecodeFormat::deserialize(const Vector<uint8_t> &p_buffer, GDScript *p_script) {
+	Reader reader(p_buffer);
+	String source;
+	bool compatible = false;
+	Error err = _read_header(reader, source, compatible);
+	if (err) {
+		return err;
+	}
+	if (!compatible) {
+		return ERR_FILE_UNRECOGNIZED;
+	}
+
+	p_script->_owner = nullptr;
+	p_script->fully_qualified_name = p_script->path;
+
+	if (!_read_class_tree(reader, p_script) || !_read_class(reader, p_script, p_script) || reader.pos != reader.size) {
+		p_script->valid = false;
+		return ERR_FILE_CORRUPT;
+	}
+	return OK;
+}
@@ -0,0 +1,88 @@
+/*************************************************************************/
+/*  gdscript_bytecode_format.h                                           */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2022 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2022 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef GDSCRIPT_BYTECODE_FORMAT_H
+#define GDSCRIPT_BYTECODE_FORMAT_H
+
+#include "core/object/script_language.h"
+#include "core/string/ustring.h"
+#include "core/templates/vector.h"
+
+class GDScript;
+class GDScriptDataType;
+class GDScriptFunction;
+
+// Compiled GDScript as written to `.gdc` files on export, so that exported
+// projects skip tokenizing, parsing, analysis and code generation on load.
+//
+// Layout: magic, format version, ABI hash, embedded source, class tree.
+// The first four fields never move, so the source can always be recovered
+// and compiled instead when the bytecode was written by an incompatible build.
+class GDScriptBytecodeFormat {
+public:
+	enum {
+		FORMAT_VERSION = 2,
+	};
+
+private:
+	struct Writer;
+	struct Reader;
+
+	static Error _read_header(Reader &p_reader, String &r_source, bool &r_compatible);
+
+	static Error _write_script_ref(Writer &p_writer, const Script *p_script);
+	static Error _write_data_type(Writer &p_writer, const GDScriptDataType &p_type);
+	static Error _write_constant(Writer &p_writer, const Variant &p_value);
+	static Error _write_function(Writer &p_writer, const GDScriptFunction *p_function);
+	static void _write_class_tree(Writer &p_writer, const GDScript *p_script);
+	static Error _write_class(Writer &p_writer, const GDScript *p_script);
+
+	static Ref<Script> _read_script_ref(Reader &p_reader, GDScript *p_main, bool p_full);
+	static bool _read_data_type(Reader &p_reader, GDScript *p_main, GDScriptDataType &r_type);
+	static bool _read_constant(Reader &p_reader, GDScript *p_main, Variant &r_value);
+	static GDScriptFunction *_read_function(Reader &p_reader, GDScript *p_main, GDScript *p_script);
+	static bool _read_class_tree(Reader &p_reader, GDScript *p_script);
+	static bool _read_class(Reader &p_reader, GDScript *p_main, GDScript *p_script);
+
+public:
+	// Hash of everything the encoded bytecode depends on besides what is
+	// resolved by name on load (opcode numbering, address layout, Variant
+	// type and operator enums).
+	static uint32_t get_abi_hash();
+
+	// Returns the `.gdc` file `p_path` is remapped to, or an empty string.
+	static String get_bytecode_path(const String &p_path);
+
+	static Error get_source(const Vector<uint8_t> &p_buffer, String &r_source);
+	static Error serialize(const GDScript *p_script, Vector<uint8_t> &r_buffer);
+	static Error deserialize(const Vector<uint8_t> &p_buffer, GDScript *p_script);
+};
+
+#endif // GDSCRIPT_BYTECODE_FORMAT_H
@@ -31,9 +31,11 @@
 #include "gdscript_cache.h"
 
 #include "core/io/file_access.h"
+#include "core/os/worker_thread_pool.h"
 #include "core/templates/vector.h"
 #include "gdscript.h"
 #include "gdscript_analyzer.h"
+#include "gdscript_bytecode_format.h"
 #include "gdscript_parser.h"
 
 bool GDScriptParserRef::is_valid() const {
@@ -48,6 +50,10 @@ GDScriptParser *GDScriptParserRef::get_parser() const {
 	return parser;
 }
 
+uint32_t GDScriptParserRef::get_source_hash() const {
+	return source_hash;
+}
+
 Error GDScriptParserRef::raise_status(Status p_new_status) {
 	ERR_FAIL_COND_V(parser == nullptr, ERR_INVALID_DATA);
 
@@ -57,10 +63,13 @@ Error GDScriptParserRef::raise_status(Status p_new_status) {
 
 	while (p_new_status > status) {
 		switch (status) {
-			case EMPTY:
+			case EMPTY: {
+				String source = GDScriptCache::get_source_code(path);
+				source_hash = source.hash();
+				result = parser->parse(source, path, false);
+				// Only once the AST is complete, anyone seeing this status may analyze it.
 				status = PARSED;
-				result = parser->parse(GDScriptCache::get_source_code(path), path, false);
-				break;
+			} break;
 			case PARSED: {
 				analyzer = memnew(GDScriptAnalyzer(parser));
 				status = INHERITANCE_SOLVED;
@@ -82,6 +91,11 @@ Error GDScriptParserRef::raise_status(Status p_new_status) {
 				if (result == OK) {
 					result = body_result;
 				}
+				// Same as a full analysis, so the script can be compiled from this parser.
+				Error dependencies_result = analyzer->resolve_dependencies();
+				if (result == OK) {
+					result = dependencies_result;
+				}
 			} break;
 			case FULLY_SOLVED: {
 				return result;
@@ -95,54 +109,313 @@ Error GDScriptParserRef::raise_status(Status p_new_status) {
 	return result;
 }
 
-GDScriptParserRef::~GDScriptParserRef() {
-	if (parser != nullptr) {
-		memdelete(parser);
-	}
+void GDScriptParserRef::clear() {
 	if (analyzer != nullptr) {
 		memdelete(analyzer);
+		analyzer = nullptr;
+	}
+	if (parser != nullptr) {
+		memdelete(parser);
+		parser = nullptr;
 	}
-	MutexLock lock(GDScriptCache::singleton->lock);
-	GDScriptCache::singleton->parser_map.erase(path);
+}
+
+GDScriptParserRef::~GDScriptParserRef() {
+	clear();
 }
 
 GDScriptCache *GDScriptCache::singleton = nullptr;
+thread_local int GDScriptCache::lock_depth = 0;
 
 void GDScriptCache::remove_script(const String &p_path) {
-	MutexLock lock(singleton->lock);
+	CacheLock lock;
 	singleton->shallow_gdscript_cache.erase(p_path);
 	singleton->full_gdscript_cache.erase(p_path);
 }
 
-Ref<GDScriptParserRef> GDScriptCache::get_parser(const String &p_path, GDScriptParserRef::Status p_status, Error &r_error, const String &p_owner) {
-	MutexLock lock(singleton->lock);
+Ref<GDScriptParserRef> GDScriptCache::_create_parser_ref(const String &p_path) {
 	Ref<GDScriptParserRef> ref;
-	if (!p_owner.is_empty()) {
-		singleton->dependencies[p_owner].insert(p_path);
+	if (!FileAccess::exists(p_path) && GDScriptBytecodeFormat::get_bytecode_path(p_path).is_empty()) {
+		return ref;
 	}
-	if (singleton->parser_map.has(p_path)) {
-		ref = Ref<GDScriptParserRef>(singleton->parser_map[p_path]);
-		if (ref.is_null()) {
-			r_error = ERR_INVALID_DATA;
-			return ref;
+	ref.instantiate();
+	ref->parser = memnew(GDScriptParser);
+	ref->path = p_path;
+	ref->checked_generation = generation;
+	parser_map[p_path] = ref;
+	return ref;
+}
+
+void GDScriptCache::_parse_group(uint32_t p_index, GDScriptParserRef **p_refs) {
+	// Only parsing, which doesn't touch the cache or other scripts.
+	p_refs[p_index]->raise_status(GDScriptParserRef::PARSED);
+
+	MutexLock parse_lock(parse_mutex);
+	p_refs[p_index]->parsing = false;
+	parse_condition.notify_all();
+}
+
+void GDScriptCache::_wait_for_parse(const Ref<GDScriptParserRef> &p_ref) {
+	// Parsing doesn't need the cache lock, so this can't deadlock with the thread that started it.
+	MutexLock parse_lock(parse_mutex);
+	while (p_ref->parsing) {
+		parse_condition.wait(parse_mutex);
+	}
+}
+
+void GDScriptCache::_parse_dependencies(const String &p_path, const GDScriptParser *p_parser) {
+	// Walk the dependency graph breadth-first, parsing each level on the worker threads,
+	// so the analyzer finds everything it's going to look into already parsed.
+	Set<String> visited;
+	visited.insert(p_path);
+	LocalVector<Ref<GDScriptParserRef>> parsed;
+	LocalVector<Ref<GDScriptParserRef>> to_parse;
+
+	List<String> paths = p_parser->get_dependencies();
+	String owner = p_path;
+	uint32_t next = 0;
+	while (true) {
+		for (const String &path : paths) {
+			if (visited.has(path) || path.get_extension() != "gd") {
+				continue;
+			}
+			visited.insert(path);
+			parser_dependencies[owner].insert(path);
+
+			Ref<GDScriptParserRef> ref;
+			if (parser_map.has(path) && !_check_outdated(path)) {
+				ref = parser_map[path];
+			} else {
+				ref = _create_parser_ref(path);
+			}
+			if (ref.is_null()) {
+				continue;
+			}
+			if (ref->status == GDScriptParserRef::EMPTY) {
+				to_parse.push_back(ref);
+			} else {
+				parsed.push_back(ref);
+			}
+		}
+
+		if (next == parsed.size() && !to_parse.is_empty()) {
+			// Waiting on the pool may run other jobs on this thread, which must not find the lock
+			// already taken. Callers further up the stack rely on it being held though, so nested
+			// calls parse here instead.
+			if (to_parse.size() == 1 || WorkerThreadPool::get_singleton() == nullptr || lock_depth > 1) {
+				for (uint32_t i = 0; i < to_parse.size(); i++) {
+					to_parse[i]->raise_status(GDScriptParserRef::PARSED);
+				}
+			} else {
+				LocalVector<GDScriptParserRef *> refs;
+				refs.resize(to_parse.size());
+				{
+					MutexLock parse_lock(parse_mutex);
+					for (uint32_t i = 0; i < to_parse.size(); i++) {
+						refs[i] = to_parse[i].ptr();
+						refs[i]->parsing = true;
+					}
+				}
+				WorkerThreadPool::TaskID task = WorkerThreadPool::get_singleton()->add_template_group_task(this, &GDScriptCache::_parse_group, refs.ptr(), refs.size());
+
+				// The parsers stay referenced from `to_parse`, so they aren't released meanwhile.
+				lock_depth--;
+				lock.unlock();
+				WorkerThreadPool::get_singleton()->wait_for_group_task_completion(task);
+				lock.lock();
+				lock_depth++;
+			}
+			for (uint32_t i = 0; i < to_parse.size(); i++) {
+				parsed.push_back(to_parse[i]);
+			}
+			to_parse.clear();
+		}
+
+		if (next == parsed.size()) {
+			break;
+		}
+		const Ref<GDScriptParserRef> &ref = parsed[next++];
+		owner = ref->path;
+		paths = ref->result == OK ? ref->parser->get_dependencies() : List<String>();
+	}
+}
+
+bool GDScriptCache::_check_outdated(const String &p_path) {
+	Ref<GDScriptParserRef> ref = parser_map[p_path];
+	_wait_for_parse(ref);
+	if (ref->checked_generation == generation) {
+		return false;
+	}
+	ref->checked_generation = generation;
+
+	bool outdated = false;
+	// Exported bytecode doesn't change while running.
+	if (ref->status != GDScriptParserRef::EMPTY && GDScriptBytecodeFormat::get_bytecode_path(p_path).is_empty()) {
+		outdated = !FileAccess::exists(p_path) || get_source_code(p_path).hash() != ref->source_hash;
+	}
+
+	if (!outdated && parser_dependencies.has(p_path)) {
+		// Copied, as invalidating a dependency erases the entries of its dependents.
+		const Set<String> depends = parser_dependencies[p_path];
+		for (const Set<String>::Element *E = depends.front(); E != nullptr; E = E->next()) {
+			if (parser_map.has(E->get()) && _check_outdated(E->get())) {
+				outdated = true;
+				break;
+			}
 		}
+	}
+
+	if (outdated) {
+		_invalidate(p_path);
+	}
+	return outdated;
+}
+
+void GDScriptCache::_invalidate(const String &p_path) {
+	parser_dependencies.erase(p_path);
+	if (!parser_map.has(p_path)) {
+		return;
+	}
+	outdated_parsers.push_back(parser_map[p_path]);
+	parser_map.erase(p_path);
+
+	// Whatever was analyzed against this script is outdated as well.
+	List<String> dependents;
+	List<String> keys;
+	parser_dependencies.get_key_list(&keys);
+	for (const String &E : keys) {
+		if (parser_dependencies[E].has(p_path)) {
+			dependents.push_back(E);
+		}
+	}
+	for (const String &E : dependents) {
+		_invalidate(E);
+	}
+}
+
+Ref<GDScriptParserRef> GDScriptCache::get_parser(const String &p_path, GDScriptParserRef::Status p_status, Error &r_error, const String &p_owner) {
+	CacheLock lock;
+	Ref<GDScriptParserRef> ref;
+	if (singleton->parser_map.has(p_path) && !singleton->_check_outdated(p_path)) {
+		ref = singleton->parser_map[p_path];
 	} else {
-		if (!FileAccess::exists(p_path)) {
+		ref = singleton->_create_parser_ref(p_path);
+		if (ref.is_null()) {
 			r_error = ERR_FILE_NOT_FOUND;
 			return ref;
 		}
-		GDScriptParser *parser = memnew(GDScriptParser);
-		ref.instantiate();
-		ref->parser = parser;
-		ref->path = p_path;
-		singleton->parser_map[p_path] = ref.ptr();
+	}
+	if (!p_owner.is_empty()) {
+		singleton->dependencies[p_owner].insert(p_path);
+		singleton->parser_dependencies[p_owner].insert(p_path);
+	}
+
+	if (ref->status == GDScriptParserRef::EMPTY && p_status > GDScriptParserRef::EMPTY) {
+		if (ref->raise_status(GDScriptParserRef::PARSED) == OK) {
+			singleton->_parse_dependencies(p_path, ref->parser);
+		}
 	}
 	r_error = ref->raise_status(p_status);
 
 	return ref;
 }
 
+Ref<GDScriptParserRef> GDScriptCache::get_analyzed_parser(const String &p_path, const String &p_source) {
+	// Parsed before taking the lock, so the dependencies can be parsed on the worker threads.
+	Error err;
+	Ref<GDScriptParserRef> ref = get_parser(p_path, GDScriptParserRef::PARSED, err);
+
+	// Analyzed under the lock, the parser is shared with every other thread asking for this script.
+	CacheLock lock;
+	if (err != OK || ref->source_hash != p_source.hash()) {
+		// Edited but not saved, or has errors the caller reports with its own parser.
+		return Ref<GDScriptParserRef>();
+	}
+	if (ref->raise_status(GDScriptParserRef::FULLY_SOLVED) != OK) {
+		return Ref<GDScriptParserRef>();
+	}
+	return ref;
+}
+
+bool GDScriptCache::is_parser_current(const String &p_path, ObjectID p_parser_id) {
+	CacheLock lock;
+	if (p_parser_id.is_null() || !singleton->parser_map.has(p_path) || singleton->_check_outdated(p_path)) {
+		return false;
+	}
+	return singleton->parser_map[p_path]->get_instance_id() == p_parser_id;
+}
+
+void GDScriptCache::parse_dependencies(const String &p_path, const GDScriptParser *p_parser) {
+	CacheLock lock;
+	singleton->_parse_dependencies(p_path, p_parser);
+}
+
+void GDScriptCache::check_for_changes() {
+	CacheLock lock;
+	singleton->generation++;
+	singleton->_clear_outdated_parsers();
+}
+
+void GDScriptCache::_clear_outdated_parsers() {
+	// Outdated parsers may reference each other, so they can't just be released. Count those references,
+	// anything holding more is still used elsewhere (e.g. a script compiling on another thread).
+	HashMap<const GDScriptParserRef *, int> internal_refs;
+	for (uint32_t i = 0; i < outdated_parsers.size(); i++) {
+		internal_refs[outdated_parsers[i].ptr()] = 1;
+	}
+	for (uint32_t i = 0; i < outdated_parsers.size(); i++) {
+		if (outdated_parsers[i]->analyzer == nullptr) {
+			continue;
+		}
+		const HashMap<String, Ref<GDScriptParserRef>> &depended = outdated_parsers[i]->analyzer->get_depended_parsers();
+		for (const String *K = depended.next(nullptr); K != nullptr; K = depended.next(K)) {
+			const Ref<GDScriptParserRef> &dependency = depended[*K];
+			if (dependency.is_valid() && internal_refs.has(dependency.ptr())) {
+				internal_refs[dependency.ptr()]++;
+			}
+		}
+	}
+
+	// Keep whatever is still used, along with the parsers it depends on.
+	LocalVector<Ref<GDScriptParserRef>> in_use;
+	Set<const GDScriptParserRef *> kept;
+	for (uint32_t i = 0; i < outdated_parsers.size(); i++) {
+		if (outdated_parsers[i]->reference_get_count() > internal_refs[outdated_parsers[i].ptr()]) {
+			in_use.push_back(outdated_parsers[i]);
+			kept.insert(outdated_parsers[i].ptr());
+		}
+	}
+	for (uint32_t i = 0; i < in_use.size(); i++) {
+		if (in_use[i]->analyzer == nullptr) {
+			continue;
+		}
+		const HashMap<String, Ref<GDScriptParserRef>> &depended = in_use[i]->analyzer->get_depended_parsers();
+		for (const String *K = depended.next(nullptr); K != nullptr; K = depended.next(K)) {
+			const Ref<GDScriptParserRef> &dependency = depended[*K];
+			if (dependency.is_valid() && internal_refs.has(dependency.ptr()) && !kept.has(dependency.ptr())) {
+				in_use.push_back(dependency);
+				kept.insert(dependency.ptr());
+			}
+		}
+	}
+
+	for (uint32_t i = 0; i < outdated_parsers.size(); i++) {
+		if (!kept.has(outdated_parsers[i].ptr())) {
+			outdated_parsers[i]->clear();
+		}
+	}
+	// Checked again on the next call.
+	outdated_parsers = in_use;
+}
+
 String GDScriptCache::get_source_code(const String &p_path) {
+	String bytecode_path = GDScriptBytecodeFormat::get_bytecode_path(p_path);
+	if (!bytecode_path.is_empty()) {
+		String source;
+		GDScriptBytecodeFormat::get_source(FileAccess::get_file_as_array(bytecode_path), source);
+		return source;
+	}
+
 	Vector<uint8_t> source_file;
 	Error err;
 	Ref<FileAccess> f = FileAccess::open(p_path, FileAccess::READ, &err);
@@ -164,7 +437,7 @@ String GDScriptCache::get_source_code(const String &p_path) {
 }
 
 Ref<GDScript> GDScriptCache::get_shallow_script(const String &p_path, const String &p_owner) {
-	MutexLock lock(singleton->lock);
+	CacheLock lock;
 	if (!p_owner.is_empty()) {
 		singleton->dependencies[p_owner].insert(p_path);
 	}
@@ -186,7 +459,7 @@ Ref<GDScript> GDScriptCache::get_shallow_script(const String &p_path, const Stri
 }
 
 Ref<GDScript> GDScriptCache::get_full_script(const String &p_path, Error &r_error, const String &p_owner) {
-	MutexLock lock(singleton->lock);
+	CacheLock lock;
 
 	if (!p_owner.is_empty()) {
 		singleton->dependencies[p_owner].insert(p_path);
@@ -200,13 +473,22 @@ Ref<GDScript> GDScriptCache::get_full_script(const String &p_path, Error &r_erro
 	Ref<GDScript> script = get_shallow_script(p_path);
 	ERR_FAIL_COND_V(script.is_null(), Ref<GDScript>());
 
-	r_error = script->load_source_code(p_path);
-
-	if (r_error) {
-		return script;
+	String bytecode_path = GDScriptBytecodeFormat::get_bytecode_path(p_path);
+	if (!bytecode_path.is_empty()) {
+		r_error = script->load_byte_code(bytecode_path);
+		if (r_error == ERR_FILE_UNRECOGNIZED || r_error == ERR_FILE_CORRUPT) {
+			// Written by an incompatible build, compile the embedded source instead.
+			print_verbose("GDScript: Compiling '" + p_path + "' from source, its bytecode can't be used by this build.");
+			r_error = script->reload();
+		}
+	} else {
+		r_error = script->load_source_code(p_path);
+		if (r_error) {
+			return script;
+		}
+		r_error = script->reload();
 	}
 
-	r_error = script->reload();
 	if (r_error) {
 		return script;
 	}
@@ -246,7 +528,18 @@ GDScriptCache::GDScriptCache() {
 }
 
 GDScriptCache::~GDScriptCache() {
+	// Break the references parsers hold to each other.
+	for (uint32_t i = 0; i < outdated_parsers.size(); i++) {
+		outdated_parsers[i]->clear();
+	}
+	outdated_parsers.clear();
+	List<String> keys;
+	parser_map.get_key_list(&keys);
+	for (const String &E : keys) {
+		parser_map[E]->clear();
+	}
 	parser_map.clear();
+	parser_dependencies.clear();
 	shallow_gdscript_cache.clear();
 	full_gdscript_cache.clear();
 	singleton = nullptr;
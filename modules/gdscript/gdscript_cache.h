@@ -32,8 +32,10 @@
 #define GDSCRIPT_CACHE_H
 
 #include "core/object/ref_counted.h"
+#include "core/os/condition_variable.h"
 #include "core/os/mutex.h"
 #include "core/templates/hash_map.h"
+#include "core/templates/local_vector.h"
 #include "core/templates/set.h"
 #include "gdscript.h"
 
@@ -56,6 +58,11 @@ private:
 	Status status = EMPTY;
 	Error result = OK;
 	String path;
+	uint32_t source_hash = 0;
+	uint32_t checked_generation = 0;
+	bool parsing = false; // Being parsed on the worker threads. Guarded by GDScriptCache::parse_mutex.
+
+	void clear();
 
 	friend class GDScriptCache;
 
@@ -63,6 +70,7 @@ public:
 	bool is_valid() const;
 	Status get_status() const;
 	GDScriptParser *get_parser() const;
+	uint32_t get_source_hash() const;
 	Error raise_status(Status p_new_status);
 
 	GDScriptParserRef() {}
@@ -71,7 +79,10 @@ public:
 
 class GDScriptCache {
 	// String key is full path.
-	HashMap<String, GDScriptParserRef *> parser_map;
+	// Parsers are kept with their analysis until their source or the source of
+	// a script they depend on changes, so unchanged scripts are not parsed again.
+	HashMap<String, Ref<GDScriptParserRef>> parser_map;
+	HashMap<String, Set<String>> parser_dependencies; // Scripts each parser looked into.
 	HashMap<String, GDScript *> shallow_gdscript_cache;
 	HashMap<String, GDScript *> full_gdscript_cache;
 	HashMap<String, Set<String>> dependencies;
@@ -82,10 +93,43 @@ class GDScriptCache {
 	static GDScriptCache *singleton;
 
 	Mutex lock;
+	// Times the calling thread holds `lock`, it's only released around waits by its outermost holder.
+	static thread_local int lock_depth;
+
+	struct CacheLock {
+		CacheLock() {
+			singleton->lock.lock();
+			lock_depth++;
+		}
+		~CacheLock() {
+			lock_depth--;
+			singleton->lock.unlock();
+		}
+	};
+
+	BinaryMutex parse_mutex;
+	ConditionVariable parse_condition;
+
+	uint32_t generation = 1; // Parsers are checked against their source once per generation.
+	LocalVector<Ref<GDScriptParserRef>> outdated_parsers; // Cleared when it's safe, they may reference each other.
+
 	static void remove_script(const String &p_path);
 
+	// These expect the lock to be held.
+	Ref<GDScriptParserRef> _create_parser_ref(const String &p_path);
+	void _parse_dependencies(const String &p_path, const GDScriptParser *p_parser);
+	void _parse_group(uint32_t p_index, GDScriptParserRef **p_refs);
+	void _wait_for_parse(const Ref<GDScriptParserRef> &p_ref);
+	bool _check_outdated(const String &p_path);
+	void _invalidate(const String &p_path);
+	void _clear_outdated_parsers();
+
 public:
 	static Ref<GDScriptParserRef> get_parser(const String &p_path, GDScriptParserRef::Status status, Error &r_error, const String &p_owner = String());
+	static Ref<GDScriptParserRef> get_analyzed_parser(const String &p_path, const String &p_source);
+	static bool is_parser_current(const String &p_path, ObjectID p_parser_id);
+	static void parse_dependencies(const String &p_path, const GDScriptParser *p_parser);
+	static void check_for_changes();
 	static String get_source_code(const String &p_path);
 	static Ref<GDScript> get_shallow_script(const String &p_path, const String &p_owner = String());
 	static Ref<GDScript> get_full_script(const String &p_path, Error &r_error, const String &p_owner = String());
@@ -214,6 +214,19 @@ static bool _have_exact_arguments(const MethodBind *p_method, const Vector<GDScr
 	return true;
 }
 
+bool GDScriptCompiler::_is_constant_array_literal(const GDScriptParser::ExpressionNode *p_expression) {
+	if (p_expression->type != GDScriptParser::Node::ARRAY || p_expression->get_datatype().has_container_element_type()) {
+		return false;
+	}
+	const GDScriptParser::ArrayNode *an = static_cast<const GDScriptParser::ArrayNode *>(p_expression);
+	for (int i = 0; i < an->elements.size(); i++) {
+		if (!an->elements[i]->is_constant) {
+			return false;
+		}
+	}
+	return true;
+}
+
 GDScriptCodeGenerator::Address GDScriptCompiler::_parse_expression(CodeGen &codegen, Error &r_error, const GDScriptParser::ExpressionNode *p_expression, bool p_root, bool p_initializer, const GDScriptCodeGenerator::Address &p_index_addr) {
 	if (p_expression->is_constant) {
 		return codegen.add_constant(p_expression->reduced_value);
@@ -1079,27 +1092,17 @@ GDScriptCodeGenerator::Address GDScriptCompiler::_parse_expression(CodeGen &code
 					return GDScriptCodeGenerator::Address();
 				}
 
-				GDScriptCodeGenerator::Address to_assign = assigned_value;
-				bool has_operation = assignment->operation != GDScriptParser::AssignmentNode::OP_NONE;
-
 				StringName name = static_cast<GDScriptParser::IdentifierNode *>(assignment->assignee)->name;
 
-				if (has_operation) {
-					GDScriptCodeGenerator::Address op_result = codegen.add_temporary(_gdtype_from_datatype(assignment->get_datatype()));
-					GDScriptCodeGenerator::Address member = codegen.add_temporary(_gdtype_from_datatype(assignment->assignee->get_datatype()));
-					gen->write_get_member(member, name);
-					gen->write_binary_operator(op_result, assignment->variant_op, member, assigned_value);
-					gen->pop_temporary(); // Pop member temp.
-					to_assign = op_result;
+				if (assignment->operation != GDScriptParser::AssignmentNode::OP_NONE) {
+					// Get, operate and set the member in a single instruction.
+					gen->write_set_member_operator(name, assignment->variant_op, assigned_value);
+				} else {
+					gen->write_set_member(assigned_value, name);
 				}
 
-				gen->write_set_member(to_assign, name);
-
-				if (to_assign.mode == GDScriptCodeGenerator::Address::TEMPORARY) {
-					gen->pop_temporary(); // Pop the assigned expression or the temp result if it has operation.
-				}
-				if (has_operation && assigned_value.mode == GDScriptCodeGenerator::Address::TEMPORARY) {
-					gen->pop_temporary(); // Pop the assigned expression if not done before.
+				if (assigned_value.mode == GDScriptCodeGenerator::Address::TEMPORARY) {
+					gen->pop_temporary(); // Pop the assigned expression.
 				}
 			} else {
 				// Regular assignment.
@@ -1748,9 +1751,22 @@ Error GDScriptCompiler::_parse_block(CodeGen &codegen, const GDScriptParser::Sui
 
 				gen->start_for(iterator.type, _gdtype_from_datatype(for_n->list->get_datatype()));
 
-				GDScriptCodeGenerator::Address list = _parse_expression(codegen, error, for_n->list);
-				if (error) {
-					return error;
+				GDScriptCodeGenerator::Address list;
+				if (_is_constant_array_literal(for_n->list)) {
+					// The literal is only visible to the loop, which never modifies it,
+					// so it can be built once instead of on every run.
+					const GDScriptParser::ArrayNode *an = static_cast<const GDScriptParser::ArrayNode *>(for_n->list);
+					Array array;
+					array.resize(an->elements.size());
+					for (int i = 0; i < an->elements.size(); i++) {
+						array[i] = an->elements[i]->reduced_value;
+					}
+					list = codegen.add_constant(array);
+				} else {
+					list = _parse_expression(codegen, error, for_n->list);
+					if (error) {
+						return error;
+					}
 				}
 
 				gen->write_for_assignment(iterator, list);
@@ -30,7 +30,11 @@
 
 #include "gdscript_function.h"
 
+#include "core/core_string_names.h"
+#include "core/object/class_db.h"
 #include "gdscript.h"
+#include "gdscript_numeric_tier.h"
+#include "gdscript_sampling_profiler.h"
 
 const int *GDScriptFunction::get_code() const {
 	return _code_ptr;
@@ -138,6 +142,123 @@ void GDScriptFunction::debug_get_stack_member_state(int p_line, List<Pair<String
 	}
 }
 
+void GDScriptFunction::InlineCache::insert(const Entry &p_entry) {
+	lock.lock();
+	uint32_t count = entry_count.get();
+	bool exists = false;
+	for (uint32_t i = 0; i < count; i++) {
+		if (entries[i].type == p_entry.type && entries[i].class_name == p_entry.class_name) {
+			exists = true; // Another thread got here first.
+			break;
+		}
+	}
+	if (!exists && count < MAX_ENTRIES) {
+		entries[count] = p_entry;
+		entry_count.set(count + 1);
+	}
+	lock.unlock();
+}
+
+static bool _is_inline_cacheable_class(const StringName &p_class) {
+	if (!ClassDB::class_exists(p_class)) {
+		return false;
+	}
+	// Extension method binds go away when the extension is unloaded.
+	ClassDB::APIType api = ClassDB::get_api_type(p_class);
+	return api != ClassDB::API_EXTENSION && api != ClassDB::API_EDITOR_EXTENSION;
+}
+
+MethodBind *GDScriptFunction::_inline_cache_method(InlineCache *p_cache, Object *p_object, const StringName &p_method) {
+	if (p_cache->is_full() || p_object->get_script_instance()) {
+		return nullptr;
+	}
+	const StringName &class_name = p_object->get_class_name();
+	MethodBind *method = nullptr;
+	// Object::callp() special-cases free(), and these override callp() to resolve names themselves.
+	bool cacheable = p_method != CoreStringNames::get_singleton()->_free && !Object::cast_to<Script>(p_object) && !Object::cast_to<GDScriptNativeClass>(p_object);
+	if (cacheable && _is_inline_cacheable_class(class_name)) {
+		method = ClassDB::get_method(class_name, p_method);
+	}
+
+	// Also recorded when not found, so the lookups above aren't repeated.
+	InlineCache::Entry entry;
+	entry.type = Variant::OBJECT;
+	entry.class_name = class_name;
+	entry.method = method;
+	p_cache->insert(entry);
+	return method;
+}
+
+MethodBind *GDScriptFunction::_inline_cache_property(InlineCache *p_cache, Object *p_object, const StringName &p_property, bool p_setter) {
+	if (p_cache->is_full()) {
+		return nullptr;
+	}
+
+	const StringName &class_name = p_object->get_class_name();
+	MethodBind *method = nullptr;
+	if (_is_inline_cacheable_class(class_name)) {
+		bool valid = false;
+		int index = ClassDB::get_property_index(class_name, p_property, &valid);
+		// Not a native property otherwise, or an indexed one which needs the index passed along.
+		if (valid && index < 0) {
+			StringName accessor = p_setter ? ClassDB::get_property_setter(class_name, p_property) : ClassDB::get_property_getter(class_name, p_property);
+			if (accessor != StringName()) {
+				method = ClassDB::get_method(class_name, accessor);
+			}
+		}
+	}
+
+	// Also recorded when not found, so the lookups above aren't repeated.
+	InlineCache::Entry entry;
+	entry.type = Variant::OBJECT;
+	entry.class_name = class_name;
+	entry.method = method;
+	p_cache->insert(entry);
+	return method;
+}
+
+const GDScriptFunction::InlineCache::Entry *GDScriptFunction::_inline_cache_builtin_member(InlineCache *p_cache, Variant::Type p_type, const StringName &p_member) {
+	if (p_cache->is_full()) {
+		return nullptr;
+	}
+
+	InlineCache::Entry entry;
+	entry.type = p_type;
+	entry.getter = Variant::get_member_validated_getter(p_type, p_member);
+	if (entry.getter) {
+		entry.setter = Variant::get_member_validated_setter(p_type, p_member);
+		entry.value_type = Variant::get_member_type(p_type, p_member);
+	}
+	// Also recorded without a getter, so the lookups above aren't repeated.
+	p_cache->insert(entry);
+	return p_cache->find(p_type);
+}
+
+void GDScriptFunction::_set_inline_cache_count(int p_count) {
+	if (_inline_caches_ptr) {
+		memdelete_arr(_inline_caches_ptr);
+		_inline_caches_ptr = nullptr;
+	}
+	_inline_caches_count = p_count;
+	if (p_count > 0) {
+		_inline_caches_ptr = memnew_arr(InlineCache, p_count);
+	}
+}
+
+GDScriptNumericTier *GDScriptFunction::_translate_numeric_tier() {
+	// Only the call reaching the threshold translates, so it happens once.
+	if (numeric_tier_calls.increment() != GDScriptNumericTier::HOT_CALL_COUNT) {
+		return nullptr;
+	}
+	GDScriptNumericTier *tier = GDScriptNumericTier::create(this);
+	if (tier) {
+		numeric_tier.store(tier, std::memory_order_release);
+	} else {
+		numeric_tier_unsupported.set();
+	}
+	return tier;
+}
+
 GDScriptFunction::GDScriptFunction() {
 	name = "<anonymous>";
 #ifdef DEBUG_ENABLED
@@ -153,6 +274,19 @@ GDScriptFunction::~GDScriptFunction() {
 		memdelete(lambdas[i]);
 	}
 
+	if (_inline_caches_ptr) {
+		memdelete_arr(_inline_caches_ptr);
+	}
+
+	GDScriptNumericTier *tier = numeric_tier.load();
+	if (tier) {
+		memdelete(tier);
+	}
+
+	if (GDScriptSamplingProfiler::is_sampling()) {
+		GDScriptSamplingProfiler::get_singleton()->forget_function(this);
+	}
+
 #ifdef DEBUG_ENABLED
 
 	MutexLock lock(GDScriptLanguage::get_singleton()->lock);
@@ -33,6 +33,7 @@
 
 #include "core/object/ref_counted.h"
 #include "core/object/script_language.h"
+#include "core/os/spin_lock.h"
 #include "core/os/thread.h"
 #include "core/string/string_name.h"
 #include "core/templates/pair.h"
@@ -41,6 +42,7 @@
 #include "gdscript_utility_functions.h"
 
 class GDScriptInstance;
+class GDScriptNumericTier;
 class GDScript;
 
 class GDScriptDataType {
@@ -233,6 +235,7 @@ public:
 		OPCODE_GET_NAMED_VALIDATED,
 		OPCODE_SET_MEMBER,
 		OPCODE_GET_MEMBER,
+		OPCODE_SET_MEMBER_OPERATOR,
 		OPCODE_ASSIGN,
 		OPCODE_ASSIGN_TRUE,
 		OPCODE_ASSIGN_FALSE,
@@ -303,6 +306,8 @@ public:
 		OPCODE_JUMP,
 		OPCODE_JUMP_IF,
 		OPCODE_JUMP_IF_NOT,
+		OPCODE_OPERATOR_JUMP_IF_NOT,
+		OPCODE_OPERATOR_VALIDATED_JUMP_IF_NOT,
 		OPCODE_JUMP_TO_DEF_ARGUMENT,
 		OPCODE_RETURN,
 		OPCODE_RETURN_TYPED_BUILTIN,
@@ -425,6 +430,60 @@ public:
 private:
 	friend class GDScriptCompiler;
 	friend class GDScriptByteCodeGenerator;
+	friend class GDScriptBytecodeFormat;
+	friend class GDScriptNumericTier;
+
+	// Per-callsite cache for untyped calls and property accesses. Entries are
+	// only appended, and published by bumping the count, so threads running
+	// the same function read them without locking. Sites that see more
+	// receiver types than there are entries keep using the generic path.
+	// Receivers that can't be cached get an entry without a method or
+	// getter, so later executions skip the lookups and go generic at once.
+	struct InlineCache {
+		enum {
+			MAX_ENTRIES = 2,
+		};
+
+		struct Entry {
+			Variant::Type type = Variant::NIL;
+			StringName class_name; // For objects.
+			MethodBind *method = nullptr; // Method, property getter or setter, for objects.
+			Variant::ValidatedGetter getter = nullptr; // For built-in types.
+			Variant::ValidatedSetter setter = nullptr; // For built-in types.
+			Variant::Type value_type = Variant::NIL; // Type the setter accepts, for built-in types.
+		};
+
+		Entry entries[MAX_ENTRIES];
+		SafeNumeric<uint32_t> entry_count;
+		SpinLock lock;
+
+		_FORCE_INLINE_ const Entry *find(const StringName &p_class) const {
+			uint32_t count = entry_count.get();
+			for (uint32_t i = 0; i < count; i++) {
+				if (entries[i].type == Variant::OBJECT && entries[i].class_name == p_class) {
+					return &entries[i];
+				}
+			}
+			return nullptr;
+		}
+
+		_FORCE_INLINE_ const Entry *find(Variant::Type p_type) const {
+			uint32_t count = entry_count.get();
+			for (uint32_t i = 0; i < count; i++) {
+				if (entries[i].type == p_type) {
+					return &entries[i];
+				}
+			}
+			return nullptr;
+		}
+
+		_FORCE_INLINE_ bool is_full() const { return entry_count.get() >= MAX_ENTRIES; }
+		void insert(const Entry &p_entry);
+	};
+
+	static MethodBind *_inline_cache_method(InlineCache *p_cache, Object *p_object, const StringName &p_method);
+	static MethodBind *_inline_cache_property(InlineCache *p_cache, Object *p_object, const StringName &p_property, bool p_setter);
+	static const InlineCache::Entry *_inline_cache_builtin_member(InlineCache *p_cache, Variant::Type p_type, const StringName &p_member);
 
 	StringName source;
 
@@ -461,6 +520,8 @@ private:
 	MethodBind **_methods_ptr = nullptr;
 	int _lambdas_count = 0;
 	GDScriptFunction **_lambdas_ptr = nullptr;
+	int _inline_caches_count = 0;
+	InlineCache *_inline_caches_ptr = nullptr;
 	const int *_code_ptr = nullptr;
 	int _code_size = 0;
 	int _argument_count = 0;
@@ -492,11 +553,17 @@ private:
 	Vector<MethodBind *> methods;
 	Vector<GDScriptFunction *> lambdas;
 	Vector<int> code;
+	Vector<int> global_index_positions; // Code positions holding GDScriptLanguage global indices.
 	Vector<GDScriptDataType> argument_types;
 	GDScriptDataType return_type;
 
 	Map<int, Variant::Type> temporary_slots;
 
+	// Numeric tier, translated once the function becomes hot.
+	SafeNumeric<uint32_t> numeric_tier_calls;
+	SafeFlag numeric_tier_unsupported;
+	std::atomic<GDScriptNumericTier *> numeric_tier = { nullptr };
+
 #ifdef TOOLS_ENABLED
 	Vector<StringName> arg_names;
 	Vector<Variant> default_arg_values;
@@ -505,8 +572,22 @@ private:
 	List<StackDebug> stack_debug;
 
 	Variant _get_default_variant_for_data_type(const GDScriptDataType &p_data_type);
+	void _set_inline_cache_count(int p_count);
+	GDScriptNumericTier *_translate_numeric_tier();
+
+	_FORCE_INLINE_ GDScriptNumericTier *_get_numeric_tier() {
+		GDScriptNumericTier *tier = numeric_tier.load(std::memory_order_acquire);
+		if (tier || numeric_tier_unsupported.is_set()) {
+			return tier;
+		}
+		return _translate_numeric_tier();
+	}
 
 	_FORCE_INLINE_ Variant *_get_variant(int p_address, GDScriptInstance *p_instance, Variant *p_stack, String &r_error) const;
+	_FORCE_INLINE_ static bool _set_named_cached(InlineCache *p_cache, Variant *p_base, const StringName &p_name, const Variant *p_value, bool &r_valid);
+	_FORCE_INLINE_ static bool _get_named_cached(InlineCache *p_cache, const Variant *p_base, const StringName &p_name, Variant *r_value);
+	_FORCE_INLINE_ static bool _call_cached(InlineCache *p_cache, Variant *p_base, const StringName &p_method, const Variant **p_args, int p_argcount, Variant &r_ret, Callable::CallError &r_error);
+	_FORCE_INLINE_ static MethodBind *_get_cached_property_accessor(InlineCache *p_cache, Object *p_object, const StringName &p_property, bool p_setter);
 	_FORCE_INLINE_ String _get_call_error(const Callable::CallError &p_err, const String &p_where, const Variant **argptrs) const;
 
 	friend class GDScriptLanguage;
@@ -0,0 +1,1238 @@
+/*************************************************************************/
+/*  gdscript_numeric_tier.cpp                                            */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2022 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2022 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#include "gdscript_numeric_tier.h"
+
+#include "core/math/math_funcs.h"
+#include "gdscript_function.h"
+// required in this order by VariantInternal, do not remove this comment.
+#include "core/object/class_db.h"
+#include "core/object/object.h"
+#include "core/variant/type_info.h"
+#include "core/variant/variant_internal.h"
+
+bool GDScriptNumericTier::enabled = true;
+
+enum {
+	NUMERIC_TIER_MAX_REGISTERS = 4096, // Registers live on the native stack.
+	NUMERIC_TIER_MAX_UTILITY_ARGS = 8,
+};
+
+static _FORCE_INLINE_ bool _is_numeric(Variant::Type p_type) {
+	return p_type == Variant::BOOL || p_type == Variant::INT || p_type == Variant::FLOAT;
+}
+
+// Turns the bytecode of a function into a register program. This happens in
+// four passes: decoding (rejecting anything the tier can't run), inferring a
+// single type for every stack slot, checking that no slot is read before it's
+// written, and emitting the typed instructions. Any failure rejects the whole
+// function, which then keeps running in the interpreter.
+struct GDScriptNumericTier::Translator {
+	enum Kind {
+		KIND_NOP,
+		KIND_OPERATOR,
+		KIND_ASSIGN,
+		KIND_CONVERT,
+		KIND_ADJUST,
+		KIND_JUMP,
+		KIND_JUMP_IF,
+		KIND_JUMP_IF_NOT,
+		KIND_RETURN,
+		KIND_ITERATE_BEGIN,
+		KIND_ITERATE,
+		KIND_UTILITY,
+		KIND_END,
+	};
+
+	struct Decoded {
+		Kind kind = KIND_NOP;
+		int ip = 0;
+		int size = 0;
+		Variant::Operator op = Variant::OP_MAX;
+		Variant::Type left_type = Variant::VARIANT_MAX; // Operand types of validated operators, or source type of constructors.
+		Variant::Type right_type = Variant::VARIANT_MAX;
+		Variant::Type type = Variant::VARIANT_MAX; // Converted, adjusted or returned type.
+		int dst = -1;
+		int args[2] = { -1, -1 }; // Operands; container and iterator for loops.
+		int target = -1; // Bytecode position.
+		int utility = -1;
+	};
+
+	const GDScriptFunction *function = nullptr;
+	GDScriptNumericTier *tier = nullptr;
+	int code_size = 0;
+
+	LocalVector<Decoded> decoded;
+	LocalVector<int> decoded_at; // Bytecode position to decoded instruction, -1 inside instructions.
+	LocalVector<int> constant_registers; // Function constant to register, -1 if not used.
+	LocalVector<Variant::Type> register_types; // Variant::VARIANT_MAX while unknown.
+	LocalVector<StringName> utility_names; // Parallel to `tier->utility_calls`.
+
+	int _add_constant(Variant::Type p_type, int64_t p_int, double p_float) {
+		Value value;
+		if (p_type == Variant::FLOAT) {
+			value.f = p_float;
+		} else {
+			value.i = p_int;
+		}
+		tier->constants.push_back(value);
+		register_types.push_back(p_type);
+		return tier->stack_size + tier->constants.size() - 1;
+	}
+
+	int _add_scratch(Variant::Type p_type) {
+		register_types.push_back(p_type);
+		return register_types.size() - 1;
+	}
+
+	// Returns -1 for the nil address when allowed, -2 if the address can't be used.
+	int _register(int p_address, bool p_allow_nil = false) {
+		int index = p_address & GDScriptFunction::ADDR_MASK;
+		switch ((p_address & GDScriptFunction::ADDR_TYPE_MASK) >> GDScriptFunction::ADDR_BITS) {
+			case GDScriptFunction::ADDR_TYPE_STACK: {
+				if (index == GDScriptFunction::ADDR_STACK_NIL && p_allow_nil) {
+					return -1;
+				}
+				if (index <= GDScriptFunction::ADDR_STACK_NIL || index >= tier->stack_size) {
+					return -2;
+				}
+				return index;
+			}
+			case GDScriptFunction::ADDR_TYPE_CONSTANT: {
+				if (index >= function->_constant_count) {
+					return -2;
+				}
+				if (constant_registers[index] < 0) {
+					const Variant &constant = function->_constants_ptr[index];
+					switch (constant.get_type()) {
+						case Variant::BOOL:
+							constant_registers[index] = _add_constant(Variant::BOOL, *VariantInternal::get_bool(&constant), 0);
+							break;
+						case Variant::INT:
+							constant_registers[index] = _add_constant(Variant::INT, *VariantInternal::get_int(&constant), 0);
+							break;
+						case Variant::FLOAT:
+							constant_registers[index] = _add_constant(Variant::FLOAT, 0, *VariantInternal::get_float(&constant));
+							break;
+						default:
+							return -2;
+					}
+				}
+				return constant_registers[index];
+			}
+			default: {
+				return -2; // Members need an instance.
+			}
+		}
+	}
+
+	bool _is_constant(int p_register) const {
+		return p_register >= tier->stack_size && p_register < tier->stack_size + (int)tier->constants.size();
+	}
+
+	const Value &_constant_value(int p_register) const {
+		return tier->constants[p_register - tier->stack_size];
+	}
+
+	static bool _find_operator(Variant::ValidatedOperatorEvaluator p_evaluator, Variant::Operator &r_op, Variant::Type &r_left, Variant::Type &r_right) {
+		static const Variant::Type types[] = { Variant::NIL, Variant::BOOL, Variant::INT, Variant::FLOAT };
+		int found = 0;
+		for (int op = 0; op < Variant::OP_MAX; op++) {
+			for (int i = 1; i < 4; i++) {
+				for (int j = 0; j < 4; j++) {
+					if (Variant::get_validated_operator_evaluator((Variant::Operator)op, types[i], types[j]) == p_evaluator) {
+						r_op = (Variant::Operator)op;
+						r_left = types[i];
+						r_right = types[j];
+						found++;
+					}
+				}
+			}
+		}
+		// Identical code folding may merge evaluators, don't guess which one it is.
+		return found == 1;
+	}
+
+	static bool _find_constructor(Variant::ValidatedConstructor p_constructor, Variant::Type &r_type, int &r_index) {
+		static const Variant::Type types[] = { Variant::BOOL, Variant::INT, Variant::FLOAT };
+		for (int i = 0; i < 3; i++) {
+			for (int j = 0; j < Variant::get_constructor_count(types[i]); j++) {
+				if (Variant::get_validated_constructor(types[i], j) == p_constructor) {
+					r_type = types[i];
+					r_index = j;
+					return true;
+				}
+			}
+		}
+		return false;
+	}
+
+	bool _decode_utility(Variant::ValidatedUtilityFunction p_function, const int *p_args, int p_argcount, Decoded &r_decoded) {
+		List<StringName> utilities;
+		Variant::get_utility_function_list(&utilities);
+		for (const StringName &name : utilities) {
+			if (Variant::get_validated_utility_function(name) != p_function) {
+				continue;
+			}
+			if (Variant::is_utility_function_vararg(name) || Variant::get_utility_function_argument_count(name) != p_argcount || p_argcount > NUMERIC_TIER_MAX_UTILITY_ARGS) {
+				return false;
+			}
+			UtilityCall call;
+			call.function = p_function;
+			call.return_type = Variant::get_utility_function_return_type(name);
+			if (!_is_numeric(call.return_type)) {
+				return false;
+			}
+			for (int i = 0; i < p_argcount; i++) {
+				Variant::Type type = Variant::get_utility_function_argument_type(name, i);
+				int reg = _register(p_args[i]);
+				if (!_is_numeric(type) || reg < 0) {
+					return false;
+				}
+				call.arguments.push_back(reg);
+				call.argument_types.push_back(type);
+			}
+			r_decoded.kind = KIND_UTILITY;
+			r_decoded.utility = tier->utility_calls.size();
+			tier->utility_calls.push_back(call);
+			utility_names.push_back(name);
+			return true;
+		}
+		return false;
+	}
+
+	bool decode() {
+		const int *code = function->_code_ptr;
+		decoded_at.resize(code_size + 1);
+		for (int i = 0; i <= code_size; i++) {
+			decoded_at[i] = -1;
+		}
+
+		int ip = 0;
+		while (ip < code_size) {
+			Decoded d;
+			d.ip = ip;
+			int opcode = code[ip] & GDScriptFunction::INSTR_MASK;
+			int instr_arg_count = (code[ip] & GDScriptFunction::INSTR_ARGS_MASK) >> GDScriptFunction::INSTR_BITS;
+
+#define NEEDS(m_size)                 \
+	if (ip + (m_size) > code_size) {  \
+		return false;                 \
+	}                                 \
+	d.size = m_size;
+
+			switch (opcode) {
+				case GDScriptFunction::OPCODE_OPERATOR:
+				case GDScriptFunction::OPCODE_OPERATOR_JUMP_IF_NOT:
+				case GDScriptFunction::OPCODE_OPERATOR_VALIDATED:
+				case GDScriptFunction::OPCODE_OPERATOR_VALIDATED_JUMP_IF_NOT: {
+					bool jump_if_not = opcode == GDScriptFunction::OPCODE_OPERATOR_JUMP_IF_NOT || opcode == GDScriptFunction::OPCODE_OPERATOR_VALIDATED_JUMP_IF_NOT;
+					NEEDS(jump_if_not ? 6 : 5);
+					d.kind = KIND_OPERATOR;
+					d.args[0] = _register(code[ip + 1]);
+					d.args[1] = _register(code[ip + 2], true);
+					d.dst = _register(code[ip + 3]);
+					if (d.args[0] < 0 || d.args[1] < -1 || d.dst < 0 || _is_constant(d.dst)) {
+						return false;
+					}
+					if (opcode == GDScriptFunction::OPCODE_OPERATOR || opcode == GDScriptFunction::OPCODE_OPERATOR_JUMP_IF_NOT) {
+						d.op = (Variant::Operator)code[ip + 4];
+						if (d.op < 0 || d.op >= Variant::OP_MAX) {
+							return false;
+						}
+					} else {
+						int index = code[ip + 4];
+						if (index < 0 || index >= function->_operator_funcs_count || !_find_operator(function->_operator_funcs_ptr[index], d.op, d.left_type, d.right_type)) {
+							return false;
+						}
+						if ((d.right_type == Variant::NIL) != (d.args[1] == -1)) {
+							return false;
+						}
+					}
+					if (jump_if_not) {
+						d.target = code[ip + 5];
+					}
+				} break;
+				case GDScriptFunction::OPCODE_ASSIGN: {
+					NEEDS(3);
+					d.kind = KIND_ASSIGN;
+					d.dst = _register(code[ip + 1]);
+					d.args[0] = _register(code[ip + 2]);
+				} break;
+				case GDScriptFunction::OPCODE_ASSIGN_TRUE:
+				case GDScriptFunction::OPCODE_ASSIGN_FALSE: {
+					NEEDS(2);
+					d.kind = KIND_ASSIGN;
+					d.dst = _register(code[ip + 1]);
+					d.args[0] = _add_constant(Variant::BOOL, opcode == GDScriptFunction::OPCODE_ASSIGN_TRUE ? 1 : 0, 0);
+				} break;
+				case GDScriptFunction::OPCODE_ASSIGN_TYPED_BUILTIN: {
+					NEEDS(4);
+					d.kind = KIND_CONVERT;
+					d.dst = _register(code[ip + 1]);
+					d.args[0] = _register(code[ip + 2]);
+					d.type = (Variant::Type)code[ip + 3];
+				} break;
+				case GDScriptFunction::OPCODE_TYPE_ADJUST_BOOL:
+				case GDScriptFunction::OPCODE_TYPE_ADJUST_INT:
+				case GDScriptFunction::OPCODE_TYPE_ADJUST_FLOAT: {
+					NEEDS(2);
+					d.kind = KIND_ADJUST;
+					d.dst = _register(code[ip + 1]);
+					d.type = opcode == GDScriptFunction::OPCODE_TYPE_ADJUST_BOOL ? Variant::BOOL : (opcode == GDScriptFunction::OPCODE_TYPE_ADJUST_INT ? Variant::INT : Variant::FLOAT);
+				} break;
+				case GDScriptFunction::OPCODE_CONSTRUCT_VALIDATED: {
+					NEEDS(instr_arg_count + 3);
+					int argc = code[ip + 1 + instr_arg_count];
+					int index = code[ip + 2 + instr_arg_count];
+					Variant::Type type;
+					int constructor;
+					if (argc < 0 || argc > 1 || argc + 1 != instr_arg_count || index < 0 || index >= function->_constructors_count || !_find_constructor(function->_constructors_ptr[index], type, constructor)) {
+						return false;
+					}
+					d.dst = _register(code[ip + 1 + argc]);
+					d.type = type;
+					if (argc == 0) {
+						// Default value.
+						d.kind = KIND_ASSIGN;
+						d.args[0] = _add_constant(type, 0, 0);
+					} else {
+						d.kind = KIND_CONVERT;
+						d.args[0] = _register(code[ip + 1]);
+						d.left_type = Variant::get_constructor_argument_type(type, constructor, 0);
+						if (!_is_numeric(d.left_type)) {
+							return false;
+						}
+					}
+				} break;
+				case GDScriptFunction::OPCODE_JUMP: {
+					NEEDS(2);
+					d.kind = KIND_JUMP;
+					d.target = code[ip + 1];
+				} break;
+				case GDScriptFunction::OPCODE_JUMP_IF:
+				case GDScriptFunction::OPCODE_JUMP_IF_NOT: {
+					NEEDS(3);
+					d.kind = opcode == GDScriptFunction::OPCODE_JUMP_IF ? KIND_JUMP_IF : KIND_JUMP_IF_NOT;
+					d.args[0] = _register(code[ip + 1]);
+					d.target = code[ip + 2];
+				} break;
+				case GDScriptFunction::OPCODE_RETURN: {
+					NEEDS(2);
+					d.kind = KIND_RETURN;
+					d.args[0] = _register(code[ip + 1]);
+				} break;
+				case GDScriptFunction::OPCODE_RETURN_TYPED_BUILTIN: {
+					NEEDS(3);
+					d.kind = KIND_RETURN;
+					d.args[0] = _register(code[ip + 1]);
+					d.type = (Variant::Type)code[ip + 2];
+				} break;
+				case GDScriptFunction::OPCODE_ITERATE_BEGIN_INT:
+				case GDScriptFunction::OPCODE_ITERATE_INT: {
+					NEEDS(5);
+					d.kind = opcode == GDScriptFunction::OPCODE_ITERATE_BEGIN_INT ? KIND_ITERATE_BEGIN : KIND_ITERATE;
+					d.dst = _register(code[ip + 1]); // Counter.
+					d.args[0] = _register(code[ip + 2]); // Container.
+					d.args[1] = _register(code[ip + 3]); // Iterator.
+					d.target = code[ip + 4];
+					if (d.args[1] < 0 || _is_constant(d.args[1])) {
+						return false;
+					}
+				} break;
+				case GDScriptFunction::OPCODE_CALL_UTILITY_VALIDATED: {
+					NEEDS(instr_arg_count + 3);
+					int argc = code[ip + 1 + instr_arg_count];
+					int index = code[ip + 2 + instr_arg_count];
+					if (argc < 0 || argc + 1 != instr_arg_count || index < 0 || index >= function->_utilities_count) {
+						return false;
+					}
+					d.dst = _register(code[ip + 1 + argc]);
+					if (!_decode_utility(function->_utilities_ptr[index], &code[ip + 1], argc, d)) {
+						return false;
+					}
+				} break;
+				case GDScriptFunction::OPCODE_LINE: {
+					NEEDS(2);
+				} break;
+				case GDScriptFunction::OPCODE_END: {
+					NEEDS(1);
+					d.kind = KIND_END;
+				} break;
+				default: {
+					return false;
+				}
+			}
+
+#undef NEEDS
+
+			if (d.dst < -1 || _is_constant(d.dst) || d.args[0] < -1 || d.args[1] < -1) {
+				return false;
+			}
+			if ((d.type != Variant::VARIANT_MAX && !_is_numeric(d.type)) || d.target < -1 || d.target > code_size) {
+				return false;
+			}
+
+			decoded_at[ip] = decoded.size();
+			decoded.push_back(d);
+			ip += d.size;
+		}
+
+		// Jumps must land on an instruction.
+		for (uint32_t i = 0; i < decoded.size(); i++) {
+			int target = decoded[i].target;
+			if (target >= 0 && target < code_size && decoded_at[target] < 0) {
+				return false;
+			}
+		}
+		return !decoded.is_empty();
+	}
+
+	bool _constrain(int p_register, Variant::Type p_type, bool &r_changed) {
+		if (!_is_numeric(p_type)) {
+			return false;
+		}
+		Variant::Type &current = register_types[p_register];
+		if (current == p_type) {
+			return true;
+		}
+		if (current != Variant::VARIANT_MAX) {
+			return false;
+		}
+		current = p_type;
+		r_changed = true;
+		return true;
+	}
+
+	bool _known(int p_register) const {
+		return register_types[p_register] != Variant::VARIANT_MAX;
+	}
+
+	// A slot keeps the same type in the whole function. Typed code satisfies
+	// this already, slots reused with different types reject the function.
+	bool infer_types() {
+		bool changed = true;
+		while (changed) {
+			changed = false;
+			for (uint32_t i = 0; i < decoded.size(); i++) {
+				const Decoded &d = decoded[i];
+				bool valid = true;
+				switch (d.kind) {
+					case KIND_OPERATOR: {
+						if (d.left_type != Variant::VARIANT_MAX) {
+							valid = _constrain(d.args[0], d.left_type, changed) && (d.args[1] < 0 || _constrain(d.args[1], d.right_type, changed));
+							valid = valid && _constrain(d.dst, Variant::get_operator_return_type(d.op, d.left_type, d.right_type), changed);
+						} else if (_known(d.args[0]) && (d.args[1] < 0 || _known(d.args[1]))) {
+							Variant::Type right_type = d.args[1] < 0 ? Variant::NIL : register_types[d.args[1]];
+							valid = _constrain(d.dst, Variant::get_operator_return_type(d.op, register_types[d.args[0]], right_type), changed);
+						}
+					} break;
+					case KIND_ASSIGN: {
+						if (_known(d.args[0])) {
+							valid = _constrain(d.dst, register_types[d.args[0]], changed);
+						}
+					} break;
+					case KIND_CONVERT: {
+						if (d.left_type != Variant::VARIANT_MAX) {
+							valid = _constrain(d.args[0], d.left_type, changed);
+						}
+						valid = valid && _constrain(d.dst, d.type, changed);
+					} break;
+					case KIND_ADJUST: {
+						valid = _constrain(d.dst, d.type, changed);
+					} break;
+					case KIND_ITERATE_BEGIN:
+					case KIND_ITERATE: {
+						valid = _constrain(d.dst, Variant::INT, changed) && _constrain(d.args[0], Variant::INT, changed) && _constrain(d.args[1], Variant::INT, changed);
+					} break;
+					case KIND_UTILITY: {
+						const UtilityCall &call = tier->utility_calls[d.utility];
+						for (uint32_t j = 0; valid && j < call.arguments.size(); j++) {
+							valid = _constrain(call.arguments[j], call.argument_types[j], changed);
+						}
+						valid = valid && _constrain(d.dst, call.return_type, changed);
+					} break;
+					default: {
+					} break;
+				}
+				if (!valid) {
+					return false;
+				}
+			}
+		}
+		return true;
+	}
+
+	void _get_uses(const Decoded &p_decoded, LocalVector<int> &r_uses) const {
+		r_uses.clear();
+		switch (p_decoded.kind) {
+			case KIND_OPERATOR:
+			case KIND_ITERATE_BEGIN: {
+				r_uses.push_back(p_decoded.args[0]);
+				if (p_decoded.kind == KIND_OPERATOR && p_decoded.args[1] >= 0) {
+					r_uses.push_back(p_decoded.args[1]);
+				}
+			} break;
+			case KIND_ITERATE: {
+				r_uses.push_back(p_decoded.dst);
+				r_uses.push_back(p_decoded.args[0]);
+			} break;
+			case KIND_ASSIGN:
+			case KIND_CONVERT:
+			case KIND_JUMP_IF:
+			case KIND_JUMP_IF_NOT:
+			case KIND_RETURN: {
+				r_uses.push_back(p_decoded.args[0]);
+			} break;
+			case KIND_UTILITY: {
+				const UtilityCall &call = tier->utility_calls[p_decoded.utility];
+				for (uint32_t i = 0; i < call.arguments.size(); i++) {
+					r_uses.push_back(call.arguments[i]);
+				}
+			} break;
+			default: {
+			} break;
+		}
+	}
+
+	int _get_successors(int p_index, int *r_successors) const {
+		const Decoded &d = decoded[p_index];
+		int count = 0;
+		if (d.kind != KIND_JUMP && d.kind != KIND_RETURN && d.kind != KIND_END && p_index + 1 < (int)decoded.size()) {
+			r_successors[count++] = p_index + 1;
+		}
+		if (d.target >= 0 && d.target < code_size) {
+			r_successors[count++] = decoded_at[d.target];
+		}
+		return count;
+	}
+
+	// Registers start zeroed instead of holding the defaults of their types,
+	// so a slot read before any write would differ from the interpreter.
+	// Reject that, except for arguments and typed temporaries which match.
+	bool check_definitions() {
+		int words = (tier->stack_size + 63) / 64;
+		int count = decoded.size();
+
+		LocalVector<uint64_t> defined;
+		defined.resize(count * words);
+		for (uint32_t i = 0; i < defined.size(); i++) {
+			defined[i] = ~uint64_t(0);
+		}
+		LocalVector<bool> reached;
+		reached.resize(count);
+		for (int i = 0; i < count; i++) {
+			reached[i] = false;
+		}
+
+		for (int i = 0; i < words; i++) {
+			defined[i] = 0;
+		}
+		for (int i = 0; i < tier->stack_size; i++) {
+			bool initialized = i < GDScriptFunction::ADDR_STACK_NIL + 1 + function->_argument_count || function->temporary_slots.has(i);
+			if (initialized) {
+				defined[i / 64] |= uint64_t(1) << (i % 64);
+			}
+		}
+		reached[0] = true;
+
+		LocalVector<uint64_t> out;
+		out.resize(words);
+		bool changed = true;
+		while (changed) {
+			changed = false;
+			for (int i = 0; i < count; i++) {
+				if (!reached[i]) {
+					continue;
+				}
+				const Decoded &d = decoded[i];
+				for (int w = 0; w < words; w++) {
+					out[w] = defined[i * words + w];
+				}
+				if (d.dst >= 0) {
+					out[d.dst / 64] |= uint64_t(1) << (d.dst % 64);
+				}
+				if (d.kind == KIND_ITERATE_BEGIN || d.kind == KIND_ITERATE) {
+					out[d.args[1] / 64] |= uint64_t(1) << (d.args[1] % 64);
+				}
+
+				int successors[2];
+				int successor_count = _get_successors(i, successors);
+				for (int j = 0; j < successor_count; j++) {
+					int s = successors[j];
+					if (!reached[s]) {
+						reached[s] = true;
+						changed = true;
+					}
+					for (int w = 0; w < words; w++) {
+						uint64_t value = defined[s * words + w] & out[w];
+						if (value != defined[s * words + w]) {
+							defined[s * words + w] = value;
+							changed = true;
+						}
+					}
+				}
+			}
+		}
+
+		LocalVector<int> uses;
+		for (int i = 0; i < count; i++) {
+			if (!reached[i]) {
+				continue;
+			}
+			_get_uses(decoded[i], uses);
+			for (uint32_t j = 0; j < uses.size(); j++) {
+				int reg = uses[j];
+				if (reg < tier->stack_size && !(defined[i * words + reg / 64] & (uint64_t(1) << (reg % 64)))) {
+					return false;
+				}
+			}
+		}
+		return true;
+	}
+
+	void _emit(Op p_op, int p_dst, int p_a = 0, int p_b = 0, int p_target = 0, uint16_t p_function = 0) {
+		Instruction instruction;
+		instruction.op = p_op;
+		instruction.function = p_function;
+		instruction.dst = p_dst;
+		instruction.a = p_a;
+		instruction.b = p_b;
+		instruction.target = p_target;
+		tier->code.push_back(instruction);
+	}
+
+	int _as_float(int p_register) {
+		if (register_types[p_register] == Variant::FLOAT) {
+			return p_register;
+		}
+		int scratch = _add_scratch(Variant::FLOAT);
+		_emit(OP_INT_TO_FLOAT, scratch, p_register);
+		return scratch;
+	}
+
+	// Registers holding ints and bools are tested directly.
+	int _as_condition(int p_register) {
+		if (register_types[p_register] != Variant::FLOAT) {
+			return p_register;
+		}
+		int scratch = _add_scratch(Variant::BOOL);
+		_emit(OP_FLOAT_TO_BOOL, scratch, p_register);
+		return scratch;
+	}
+
+	void _emit_convert(int p_dst, int p_src) {
+		Variant::Type from = register_types[p_src];
+		Variant::Type to = register_types[p_dst];
+		if (from == to || (from == Variant::BOOL && to == Variant::INT)) {
+			_emit(OP_MOVE, p_dst, p_src);
+		} else if (to == Variant::FLOAT) {
+			_emit(OP_INT_TO_FLOAT, p_dst, p_src);
+		} else if (to == Variant::INT) {
+			_emit(OP_FLOAT_TO_INT, p_dst, p_src);
+		} else {
+			_emit(from == Variant::FLOAT ? OP_FLOAT_TO_BOOL : OP_INT_TO_BOOL, p_dst, p_src);
+		}
+	}
+
+	static Op _get_arithmetic_op(Variant::Operator p_op, bool p_ints) {
+		switch (p_op) {
+			case Variant::OP_ADD:
+				return p_ints ? OP_ADD_INT : OP_ADD_FLOAT;
+			case Variant::OP_SUBTRACT:
+				return p_ints ? OP_SUBTRACT_INT : OP_SUBTRACT_FLOAT;
+			case Variant::OP_MULTIPLY:
+				return p_ints ? OP_MULTIPLY_INT : OP_MULTIPLY_FLOAT;
+			case Variant::OP_DIVIDE:
+				return p_ints ? OP_DIVIDE_INT : OP_DIVIDE_FLOAT;
+			case Variant::OP_MODULE:
+				return OP_MODULE_INT;
+			default:
+				return p_ints ? OP_POWER_INT : OP_POWER_FLOAT;
+		}
+	}
+
+	bool _emit_operator(const Decoded &p_decoded) {
+		int a = p_decoded.args[0];
+		int b = p_decoded.args[1];
+		int dst = p_decoded.dst;
+		Variant::Type left = register_types[a];
+		Variant::Type right = b < 0 ? Variant::NIL : register_types[b];
+		if (Variant::get_operator_return_type(p_decoded.op, left, right) != register_types[dst]) {
+			return false;
+		}
+
+		bool ints = left == Variant::INT && right == Variant::INT;
+		bool numbers = (left == Variant::INT || left == Variant::FLOAT) && (right == Variant::INT || right == Variant::FLOAT);
+
+		switch (p_decoded.op) {
+			case Variant::OP_ADD:
+			case Variant::OP_SUBTRACT:
+			case Variant::OP_MULTIPLY:
+			case Variant::OP_DIVIDE:
+			case Variant::OP_MODULE:
+			case Variant::OP_POWER: {
+				if (ints) {
+					if (p_decoded.op == Variant::OP_DIVIDE || p_decoded.op == Variant::OP_MODULE) {
+						// The interpreter reports division by zero, only take constant divisors.
+						if (!_is_constant(b) || _constant_value(b).i == 0) {
+							return false;
+						}
+					}
+					_emit(_get_arithmetic_op(p_decoded.op, true), dst, a, b);
+				} else if (numbers && p_decoded.op != Variant::OP_MODULE) {
+					int fa = _as_float(a);
+					int fb = _as_float(b);
+					_emit(_get_arithmetic_op(p_decoded.op, false), dst, fa, fb);
+				} else {
+					return false;
+				}
+			} break;
+			case Variant::OP_NEGATE:
+			case Variant::OP_POSITIVE: {
+				if (left != Variant::INT && left != Variant::FLOAT) {
+					return false;
+				}
+				if (p_decoded.op == Variant::OP_POSITIVE) {
+					_emit(OP_MOVE, dst, a);
+				} else {
+					_emit(left == Variant::INT ? OP_NEGATE_INT : OP_NEGATE_FLOAT, dst, a);
+				}
+			} break;
+			case Variant::OP_EQUAL:
+			case Variant::OP_NOT_EQUAL:
+			case Variant::OP_LESS:
+			case Variant::OP_LESS_EQUAL:
+			case Variant::OP_GREATER:
+			case Variant::OP_GREATER_EQUAL: {
+				static const Op int_ops[] = { OP_EQUAL_INT, OP_NOT_EQUAL_INT, OP_LESS_INT, OP_LESS_EQUAL_INT, OP_GREATER_INT, OP_GREATER_EQUAL_INT };
+				static const Op float_ops[] = { OP_EQUAL_FLOAT, OP_NOT_EQUAL_FLOAT, OP_LESS_FLOAT, OP_LESS_EQUAL_FLOAT, OP_GREATER_FLOAT, OP_GREATER_EQUAL_FLOAT };
+				int index = p_decoded.op - Variant::OP_EQUAL;
+				if (ints || (left == Variant::BOOL && right == Variant::BOOL)) {
+					_emit(int_ops[index], dst, a, b);
+				} else if (numbers) {
+					int fa = _as_float(a);
+					int fb = _as_float(b);
+					_emit(float_ops[index], dst, fa, fb);
+				} else {
+					return false;
+				}
+			} break;
+			case Variant::OP_AND:
+			case Variant::OP_OR:
+			case Variant::OP_XOR: {
+				if (b < 0) {
+					return false;
+				}
+				int ca = _as_condition(a);
+				int cb = _as_condition(b);
+				_emit(p_decoded.op == Variant::OP_AND ? OP_AND : (p_decoded.op == Variant::OP_OR ? OP_OR : OP_XOR), dst, ca, cb);
+			} break;
+			case Variant::OP_NOT: {
+				_emit(OP_NOT, dst, _as_condition(a));
+			} break;
+			case Variant::OP_BIT_AND:
+			case Variant::OP_BIT_OR:
+			case Variant::OP_BIT_XOR: {
+				if (!ints) {
+					return false;
+				}
+				_emit(p_decoded.op == Variant::OP_BIT_AND ? OP_BIT_AND : (p_decoded.op == Variant::OP_BIT_OR ? OP_BIT_OR : OP_BIT_XOR), dst, a, b);
+			} break;
+			case Variant::OP_BIT_NEGATE: {
+				if (left != Variant::INT) {
+					return false;
+				}
+				_emit(OP_BIT_NEGATE, dst, a);
+			} break;
+			default: {
+				// Shifts report negative operands, and the rest isn't numeric.
+				return false;
+			}
+		}
+		return true;
+	}
+
+	void _emit_utility(const Decoded &p_decoded) {
+		static const char *math_names[MATH_MAX] = { "sin", "cos", "tan", "sqrt", "exp", "floor", "ceil", "absf", "absi", "pow", "minf", "maxf", "mini", "maxi" };
+		const UtilityCall &call = tier->utility_calls[p_decoded.utility];
+		for (int i = 0; i < MATH_MAX; i++) {
+			if (utility_names[p_decoded.utility] == StringName(math_names[i])) {
+				_emit(OP_MATH, p_decoded.dst, call.arguments[0], call.arguments.size() > 1 ? call.arguments[1] : 0, 0, i);
+				return;
+			}
+		}
+		_emit(OP_CALL_UTILITY, p_decoded.dst, 0, 0, 0, p_decoded.utility);
+	}
+
+	bool emit() {
+		// Every register used must have a numeric type by now.
+		LocalVector<int> uses;
+		for (uint32_t i = 0; i < decoded.size(); i++) {
+			_get_uses(decoded[i], uses);
+			if (decoded[i].dst >= 0) {
+				uses.push_back(decoded[i].dst);
+			}
+			if (decoded[i].kind == KIND_ITERATE_BEGIN || decoded[i].kind == KIND_ITERATE) {
+				uses.push_back(decoded[i].args[1]);
+			}
+			for (uint32_t j = 0; j < uses.size(); j++) {
+				if (!_is_numeric(register_types[uses[j]])) {
+					return false;
+				}
+			}
+		}
+
+		LocalVector<int> emitted_at;
+		emitted_at.resize(decoded.size());
+		LocalVector<int> jumps; // Emitted instructions whose target is still a bytecode position.
+
+		for (uint32_t i = 0; i < decoded.size(); i++) {
+			const Decoded &d = decoded[i];
+			emitted_at[i] = tier->code.size();
+			switch (d.kind) {
+				case KIND_NOP:
+				case KIND_ADJUST: {
+					// Registers already have their static type.
+				} break;
+				case KIND_OPERATOR: {
+					if (!_emit_operator(d)) {
+						return false;
+					}
+					if (d.target >= 0) {
+						int condition = _as_condition(d.dst);
+						jumps.push_back(tier->code.size());
+						_emit(OP_JUMP_IF_NOT, 0, condition, 0, d.target);
+					}
+				} break;
+				case KIND_ASSIGN: {
+					if (register_types[d.dst] != register_types[d.args[0]]) {
+						return false;
+					}
+					_emit(OP_MOVE, d.dst, d.args[0]);
+				} break;
+				case KIND_CONVERT: {
+					Variant::Type from = register_types[d.args[0]];
+					if (from != d.type && !Variant::can_convert_strict(from, d.type)) {
+						return false;
+					}
+					_emit_convert(d.dst, d.args[0]);
+				} break;
+				case KIND_JUMP: {
+					jumps.push_back(tier->code.size());
+					_emit(OP_JUMP, 0, 0, 0, d.target);
+				} break;
+				case KIND_JUMP_IF:
+				case KIND_JUMP_IF_NOT: {
+					int condition = _as_condition(d.args[0]);
+					jumps.push_back(tier->code.size());
+					_emit(d.kind == KIND_JUMP_IF ? OP_JUMP_IF : OP_JUMP_IF_NOT, 0, condition, 0, d.target);
+				} break;
+				case KIND_RETURN: {
+					int value = d.args[0];
+					Variant::Type type = register_types[value];
+					if (d.type != Variant::VARIANT_MAX && d.type != type) {
+						if (!Variant::can_convert_strict(type, d.type)) {
+							return false;
+						}
+						int converted = _add_scratch(d.type);
+						_emit_convert(converted, value);
+						value = converted;
+						type = d.type;
+					}
+					_emit(type == Variant::INT ? OP_RETURN_INT : (type == Variant::FLOAT ? OP_RETURN_FLOAT : OP_RETURN_BOOL), 0, value);
+				} break;
+				case KIND_ITERATE_BEGIN:
+				case KIND_ITERATE: {
+					jumps.push_back(tier->code.size());
+					_emit(d.kind == KIND_ITERATE_BEGIN ? OP_ITERATE_BEGIN : OP_ITERATE, d.dst, d.args[0], d.args[1], d.target);
+				} break;
+				case KIND_UTILITY: {
+					_emit_utility(d);
+				} break;
+				case KIND_END: {
+					_emit(OP_RETURN_NIL, 0);
+				} break;
+			}
+		}
+
+		// Jumping to the end of the bytecode leaves the function.
+		int exit = tier->code.size();
+		_emit(OP_RETURN_NIL, 0);
+
+		for (uint32_t i = 0; i < jumps.size(); i++) {
+			Instruction &instruction = tier->code[jumps[i]];
+			instruction.target = instruction.target == code_size ? exit : emitted_at[decoded_at[instruction.target]];
+		}
+
+		tier->register_count = register_types.size();
+		return tier->register_count <= NUMERIC_TIER_MAX_REGISTERS;
+	}
+};
+
+GDScriptNumericTier *GDScriptNumericTier::create(const GDScriptFunction *p_function) {
+	if (!p_function->_code_ptr || p_function->_default_arg_count > 0 || p_function->_stack_size > NUMERIC_TIER_MAX_REGISTERS) {
+		return nullptr;
+	}
+	for (int i = 0; i < p_function->_argument_count; i++) {
+		const GDScriptDataType &type = p_function->argument_types[i];
+		if (!type.has_type || type.kind != GDScriptDataType::BUILTIN || !_is_numeric(type.builtin_type)) {
+			return nullptr;
+		}
+	}
+
+	GDScriptNumericTier *tier = memnew(GDScriptNumericTier);
+	tier->stack_size = p_function->_stack_size;
+	for (int i = 0; i < p_function->_argument_count; i++) {
+		tier->argument_types.push_back(p_function->argument_types[i].builtin_type);
+	}
+
+	Translator translator;
+	translator.function = p_function;
+	translator.tier = tier;
+	translator.code_size = p_function->_code_size;
+	translator.constant_registers.resize(p_function->_constant_count);
+	for (int i = 0; i < p_function->_constant_count; i++) {
+		translator.constant_registers[i] = -1;
+	}
+	translator.register_types.resize(tier->stack_size);
+	for (int i = 0; i < tier->stack_size; i++) {
+		translator.register_types[i] = Variant::VARIANT_MAX;
+	}
+	for (int i = 0; i < p_function->_argument_count; i++) {
+		translator.register_types[GDScriptFunction::ADDR_STACK_NIL + 1 + i] = tier->argument_types[i];
+	}
+	for (const KeyValue<int, Variant::Type> &E : p_function->temporary_slots) {
+		if (E.key < tier->stack_size) {
+			translator.register_types[E.key] = E.value;
+		}
+	}
+
+	if (!translator.decode() || !translator.infer_types() || !translator.check_definitions() || !translator.emit()) {
+		memdelete(tier);
+		return nullptr;
+	}
+	return tier;
+}
+
+void GDScriptNumericTier::_call_utility(const UtilityCall &p_call, Value *p_registers, int p_dst) {
+	Variant args[NUMERIC_TIER_MAX_UTILITY_ARGS];
+	const Variant *argptrs[NUMERIC_TIER_MAX_UTILITY_ARGS];
+	for (uint32_t i = 0; i < p_call.arguments.size(); i++) {
+		const Value &value = p_registers[p_call.arguments[i]];
+		switch (p_call.argument_types[i]) {
+			case Variant::BOOL:
+				args[i] = value.i != 0;
+				break;
+			case Variant::INT:
+				args[i] = value.i;
+				break;
+			default:
+				args[i] = value.f;
+				break;
+		}
+		argptrs[i] = &args[i];
+	}
+
+	Variant ret;
+	p_call.function(&ret, argptrs, p_call.arguments.size());
+
+	switch (p_call.return_type) {
+		case Variant::BOOL:
+			p_registers[p_dst].i = *VariantInternal::get_bool(&ret);
+			break;
+		case Variant::INT:
+			p_registers[p_dst].i = *VariantInternal::get_int(&ret);
+			break;
+		default:
+			p_registers[p_dst].f = *VariantInternal::get_float(&ret);
+			break;
+	}
+}
+
+bool GDScriptNumericTier::call(const Variant **p_args, int p_argcount, Variant &r_ret) const {
+	if (p_argcount != (int)argument_types.size()) {
+		return false;
+	}
+
+	Value *regs = (Value *)alloca(sizeof(Value) * register_count);
+	memset(regs, 0, sizeof(Value) * stack_size);
+
+	for (int i = 0; i < p_argcount; i++) {
+		const Variant *arg = p_args[i];
+		Value &reg = regs[GDScriptFunction::ADDR_STACK_NIL + 1 + i];
+		Variant::Type type = arg->get_type();
+		switch (argument_types[i]) {
+			case Variant::BOOL: {
+				if (type != Variant::BOOL) {
+					return false;
+				}
+				reg.i = *VariantInternal::get_bool(arg);
+			} break;
+			case Variant::INT: {
+				if (type != Variant::INT) {
+					return false;
+				}
+				reg.i = *VariantInternal::get_int(arg);
+			} break;
+			default: {
+				if (type == Variant::FLOAT) {
+					reg.f = *VariantInternal::get_float(arg);
+				} else if (type == Variant::INT) {
+					reg.f = (double)*VariantInternal::get_int(arg); // Same conversion as the interpreter does.
+				} else {
+					return false;
+				}
+			} break;
+		}
+	}
+
+	if (constants.size()) {
+		memcpy(&regs[stack_size], constants.ptr(), sizeof(Value) * constants.size());
+	}
+
+	const Instruction *instructions = code.ptr();
+	int ip = 0;
+
+	while (true) {
+		const Instruction &in = instructions[ip++];
+		Value &dst = regs[in.dst];
+		const Value &a = regs[in.a];
+		const Value &b = regs[in.b];
+
+		switch (in.op) {
+			case OP_MOVE:
+				dst = a;
+				break;
+			case OP_INT_TO_FLOAT:
+				dst.f = (double)a.i;
+				break;
+			case OP_FLOAT_TO_INT:
+				dst.i = (int64_t)a.f;
+				break;
+			case OP_INT_TO_BOOL:
+				dst.i = a.i != 0;
+				break;
+			case OP_FLOAT_TO_BOOL:
+				dst.i = a.f != 0.0;
+				break;
+			case OP_ADD_INT:
+				dst.i = a.i + b.i;
+				break;
+			case OP_SUBTRACT_INT:
+				dst.i = a.i - b.i;
+				break;
+			case OP_MULTIPLY_INT:
+				dst.i = a.i * b.i;
+				break;
+			case OP_DIVIDE_INT:
+				dst.i = a.i / b.i;
+				break;
+			case OP_MODULE_INT:
+				dst.i = a.i % b.i;
+				break;
+			case OP_POWER_INT:
+				dst.i = int64_t(Math::pow((double)a.i, (double)b.i));
+				break;
+			case OP_NEGATE_INT:
+				dst.i = -a.i;
+				break;
+			case OP_ADD_FLOAT:
+				dst.f = a.f + b.f;
+				break;
+			case OP_SUBTRACT_FLOAT:
+				dst.f = a.f - b.f;
+				break;
+			case OP_MULTIPLY_FLOAT:
+				dst.f = a.f * b.f;
+				break;
+			case OP_DIVIDE_FLOAT:
+				dst.f = a.f / b.f;
+				break;
+			case OP_POWER_FLOAT:
+				dst.f = Math::pow(a.f, b.f);
+				break;
+			case OP_NEGATE_FLOAT:
+				dst.f = -a.f;
+				break;
+			case OP_EQUAL_INT:
+				dst.i = a.i == b.i;
+				break;
+			case OP_NOT_EQUAL_INT:
+				dst.i = a.i != b.i;
+				break;
+			case OP_LESS_INT:
+				dst.i = a.i < b.i;
+				break;
+			case OP_LESS_EQUAL_INT:
+				dst.i = a.i <= b.i;
+				break;
+			case OP_GREATER_INT:
+				dst.i = a.i > b.i;
+				break;
+			case OP_GREATER_EQUAL_INT:
+				dst.i = a.i >= b.i;
+				break;
+			case OP_EQUAL_FLOAT:
+				dst.i = a.f == b.f;
+				break;
+			case OP_NOT_EQUAL_FLOAT:
+				dst.i = a.f != b.f;
+				break;
+			case OP_LESS_FLOAT:
+				dst.i = a.f < b.f;
+				break;
+			case OP_LESS_EQUAL_FLOAT:
+				dst.i = a.f <= b.f;
+				break;
+			case OP_GREATER_FLOAT:
+				dst.i = a.f > b.f;
+				break;
+			case OP_GREATER_EQUAL_FLOAT:
+				dst.i = a.f >= b.f;
+				break;
+			case OP_AND:
+				dst.i = a.i != 0 && b.i != 0;
+				break;
+			case OP_OR:
+				dst.i = a.i != 0 || b.i != 0;
+				break;
+			case OP_XOR:
+				dst.i = (a.i != 0) != (b.i != 0);
+				break;
+			case OP_NOT:
+				dst.i = a.i == 0;
+				break;
+			case OP_BIT_AND:
+				dst.i = a.i & b.i;
+				break;
+			case OP_BIT_OR:
+				dst.i = a.i | b.i;
+				break;
+			case OP_BIT_XOR:
+				dst.i = a.i ^ b.i;
+				break;
+			case OP_BIT_NEGATE:
+				dst.i = ~a.i;
+				break;
+			case OP_MATH: {
+				// Same implementations as the utility functions in variant_utility.cpp.
+				switch (in.function) {
+					case MATH_SIN:
+						dst.f = Math::sin(a.f);
+						break;
+					case MATH_COS:
+						dst.f = Math::cos(a.f);
+						break;
+					case MATH_TAN:
+						dst.f = Math::tan(a.f);
+						break;
+					case MATH_SQRT:
+						dst.f = Math::sqrt(a.f);
+						break;
+					case MATH_EXP:
+						dst.f = Math::exp(a.f);
+						break;
+					case MATH_FLOOR:
+						dst.f = Math::floor(a.f);
+						break;
+					case MATH_CEIL:
+						dst.f = Math::ceil(a.f);
+						break;
+					case MATH_ABSF:
+						dst.f = Math::absd(a.f);
+						break;
+					case MATH_ABSI:
+						dst.i = ABS(a.i);
+						break;
+					case MATH_POW:
+						dst.f = Math::pow(a.f, b.f);
+						break;
+					case MATH_MINF:
+						dst.f = MIN(a.f, b.f);
+						break;
+					case MATH_MAXF:
+						dst.f = MAX(a.f, b.f);
+						break;
+					case MATH_MINI:
+						dst.i = MIN(a.i, b.i);
+						break;
+					case MATH_MAXI:
+						dst.i = MAX(a.i, b.i);
+						break;
+				}
+			} break;
+			case OP_CALL_UTILITY:
+				_call_utility(utility_calls[in.function], regs, in.dst);
+				break;
+			case OP_JUMP:
+				ip = in.target;
+				break;
+			case OP_JUMP_IF:
+				if (a.i != 0) {
+					ip = in.target;
+				}
+				break;
+			case OP_JUMP_IF_NOT:
+				if (a.i == 0) {
+					ip = in.target;
+				}
+				break;
+			case OP_ITERATE_BEGIN:
+				dst.i = 0;
+				if (a.i > 0) {
+					regs[in.b].i = 0;
+				} else {
+					ip = in.target;
+				}
+				break;
+			case OP_ITERATE:
+				dst.i++;
+				if (dst.i >= a.i) {
+					ip = in.target;
+				} else {
+					regs[in.b].i = dst.i;
+				}
+				break;
+			case OP_RETURN_INT:
+				r_ret = a.i;
+				return true;
+			case OP_RETURN_FLOAT:
+				r_ret = a.f;
+				return true;
+			case OP_RETURN_BOOL:
+				r_ret = a.i != 0;
+				return true;
+			case OP_RETURN_NIL:
+				r_ret = Variant();
+				return true;
+		}
+	}
+}
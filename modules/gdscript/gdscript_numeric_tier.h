@@ -0,0 +1,169 @@
+/*************************************************************************/
+/*  gdscript_numeric_tier.h                                              */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2022 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2022 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef GDSCRIPT_NUMERIC_TIER_H
+#define GDSCRIPT_NUMERIC_TIER_H
+
+#include "core/templates/local_vector.h"
+#include "core/variant/variant.h"
+
+class GDScriptFunction;
+
+// Second execution tier for hot functions that only deal with `int`, `float`
+// and `bool`. The bytecode of such a function is translated once into a
+// register program over unboxed 64-bit values, so arithmetic, comparisons and
+// loops run without touching a Variant. Functions using anything else (calls,
+// members, objects, other built-in types, await...) stay in the interpreter.
+class GDScriptNumericTier {
+public:
+	enum {
+		HOT_CALL_COUNT = 64, // Calls before a function is translated.
+	};
+
+private:
+	union Value {
+		int64_t i; // Also holds bools, as 0 or 1.
+		double f;
+	};
+
+	enum Op : uint16_t {
+		OP_MOVE,
+		OP_INT_TO_FLOAT,
+		OP_FLOAT_TO_INT,
+		OP_INT_TO_BOOL,
+		OP_FLOAT_TO_BOOL,
+		OP_ADD_INT,
+		OP_SUBTRACT_INT,
+		OP_MULTIPLY_INT,
+		OP_DIVIDE_INT,
+		OP_MODULE_INT,
+		OP_POWER_INT,
+		OP_NEGATE_INT,
+		OP_ADD_FLOAT,
+		OP_SUBTRACT_FLOAT,
+		OP_MULTIPLY_FLOAT,
+		OP_DIVIDE_FLOAT,
+		OP_POWER_FLOAT,
+		OP_NEGATE_FLOAT,
+		OP_EQUAL_INT,
+		OP_NOT_EQUAL_INT,
+		OP_LESS_INT,
+		OP_LESS_EQUAL_INT,
+		OP_GREATER_INT,
+		OP_GREATER_EQUAL_INT,
+		OP_EQUAL_FLOAT,
+		OP_NOT_EQUAL_FLOAT,
+		OP_LESS_FLOAT,
+		OP_LESS_EQUAL_FLOAT,
+		OP_GREATER_FLOAT,
+		OP_GREATER_EQUAL_FLOAT,
+		OP_AND,
+		OP_OR,
+		OP_XOR,
+		OP_NOT,
+		OP_BIT_AND,
+		OP_BIT_OR,
+		OP_BIT_XOR,
+		OP_BIT_NEGATE,
+		OP_MATH,
+		OP_CALL_UTILITY,
+		OP_JUMP,
+		OP_JUMP_IF,
+		OP_JUMP_IF_NOT,
+		OP_ITERATE_BEGIN,
+		OP_ITERATE,
+		OP_RETURN_INT,
+		OP_RETURN_FLOAT,
+		OP_RETURN_BOOL,
+		OP_RETURN_NIL,
+	};
+
+	// Utility functions common enough in numeric code to be evaluated inline.
+	// Other utilities taking and returning numbers go through OP_CALL_UTILITY.
+	enum MathFunction : uint16_t {
+		MATH_SIN,
+		MATH_COS,
+		MATH_TAN,
+		MATH_SQRT,
+		MATH_EXP,
+		MATH_FLOOR,
+		MATH_CEIL,
+		MATH_ABSF,
+		MATH_ABSI,
+		MATH_POW,
+		MATH_MINF,
+		MATH_MAXF,
+		MATH_MINI,
+		MATH_MAXI,
+		MATH_MAX,
+	};
+
+	struct Instruction {
+		Op op = OP_RETURN_NIL;
+		uint16_t function = 0; // MathFunction or index in `utility_calls`.
+		int32_t dst = 0;
+		int32_t a = 0;
+		int32_t b = 0;
+		int32_t target = 0; // Jump target.
+	};
+
+	struct UtilityCall {
+		Variant::ValidatedUtilityFunction function = nullptr;
+		Variant::Type return_type = Variant::NIL;
+		LocalVector<int32_t> arguments;
+		LocalVector<Variant::Type> argument_types;
+	};
+
+	struct Translator;
+
+	LocalVector<Instruction> code;
+	LocalVector<Value> constants; // Loaded right after the stack slots.
+	LocalVector<UtilityCall> utility_calls;
+	LocalVector<Variant::Type> argument_types;
+	int stack_size = 0;
+	int register_count = 0;
+
+	static bool enabled;
+
+	static void _call_utility(const UtilityCall &p_call, Value *p_registers, int p_dst);
+
+public:
+	static void set_enabled(bool p_enabled) { enabled = p_enabled; }
+	static bool is_enabled() { return enabled; }
+
+	// Returns nullptr if the function can't run in this tier.
+	static GDScriptNumericTier *create(const GDScriptFunction *p_function);
+
+	// Returns false, without side effects, when the arguments don't have the
+	// exact expected types, so the caller can fall back to the interpreter.
+	bool call(const Variant **p_args, int p_argcount, Variant &r_ret) const;
+};
+
+#endif // GDSCRIPT_NUMERIC_TIER_H
@@ -47,56 +47,118 @@
 #endif // TOOLS_ENABLED
 
 static HashMap<StringName, Variant::Type> builtin_types;
+static SafeFlag builtin_types_initialized;
+static BinaryMutex builtin_types_mutex;
 Variant::Type GDScriptParser::get_builtin_type(const StringName &p_type) {
-	if (builtin_types.is_empty()) {
-		builtin_types["bool"] = Variant::BOOL;
-		builtin_types["int"] = Variant::INT;
-		builtin_types["float"] = Variant::FLOAT;
-		builtin_types["String"] = Variant::STRING;
-		builtin_types["Vector2"] = Variant::VECTOR2;
-		builtin_types["Vector2i"] = Variant::VECTOR2I;
-		builtin_types["Rect2"] = Variant::RECT2;
-		builtin_types["Rect2i"] = Variant::RECT2I;
-		builtin_types["Transform2D"] = Variant::TRANSFORM2D;
-		builtin_types["Vector3"] = Variant::VECTOR3;
-		builtin_types["Vector3i"] = Variant::VECTOR3I;
-		builtin_types["AABB"] = Variant::AABB;
-		builtin_types["Plane"] = Variant::PLANE;
-		builtin_types["Quaternion"] = Variant::QUATERNION;
-		builtin_types["Basis"] = Variant::BASIS;
-		builtin_types["Transform3D"] = Variant::TRANSFORM3D;
-		builtin_types["Color"] = Variant::COLOR;
-		builtin_types["RID"] = Variant::RID;
-		builtin_types["Object"] = Variant::OBJECT;
-		builtin_types["StringName"] = Variant::STRING_NAME;
-		builtin_types["NodePath"] = Variant::NODE_PATH;
-		builtin_types["Dictionary"] = Variant::DICTIONARY;
-		builtin_types["Callable"] = Variant::CALLABLE;
-		builtin_types["Signal"] = Variant::SIGNAL;
-		builtin_types["Array"] = Variant::ARRAY;
-		builtin_types["PackedByteArray"] = Variant::PACKED_BYTE_ARRAY;
-		builtin_types["PackedInt32Array"] = Variant::PACKED_INT32_ARRAY;
-		builtin_types["PackedInt64Array"] = Variant::PACKED_INT64_ARRAY;
-		builtin_types["PackedFloat32Array"] = Variant::PACKED_FLOAT32_ARRAY;
-		builtin_types["PackedFloat64Array"] = Variant::PACKED_FLOAT64_ARRAY;
-		builtin_types["PackedStringArray"] = Variant::PACKED_STRING_ARRAY;
-		builtin_types["PackedVector2Array"] = Variant::PACKED_VECTOR2_ARRAY;
-		builtin_types["PackedVector3Array"] = Variant::PACKED_VECTOR3_ARRAY;
-		builtin_types["PackedColorArray"] = Variant::PACKED_COLOR_ARRAY;
-		// NIL is not here, hence the -1.
-		if (builtin_types.size() != Variant::VARIANT_MAX - 1) {
-			ERR_PRINT("Outdated parser: amount of built-in types don't match the amount of types in Variant.");
-		}
-	}
-
-	if (builtin_types.has(p_type)) {
-		return builtin_types[p_type];
+	// Scripts may be parsed on several threads at once.
+	if (unlikely(!builtin_types_initialized.is_set())) {
+		MutexLock lock(builtin_types_mutex);
+		if (!builtin_types_initialized.is_set()) {
+			builtin_types["bool"] = Variant::BOOL;
+			builtin_types["int"] = Variant::INT;
+			builtin_types["float"] = Variant::FLOAT;
+			builtin_types["String"] = Variant::STRING;
+			builtin_types["Vector2"] = Variant::VECTOR2;
+			builtin_types["Vector2i"] = Variant::VECTOR2I;
+			builtin_types["Rect2"] = Variant::RECT2;
+			builtin_types["Rect2i"] = Variant::RECT2I;
+			builtin_types["Transform2D"] = Variant::TRANSFORM2D;
+			builtin_types["Vector3"] = Variant::VECTOR3;
+			builtin_types["Vector3i"] = Variant::VECTOR3I;
+			builtin_types["AABB"] = Variant::AABB;
+			builtin_types["Plane"] = Variant::PLANE;
+			builtin_types["Quaternion"] = Variant::QUATERNION;
+			builtin_types["Basis"] = Variant::BASIS;
+			builtin_types["Transform3D"] = Variant::TRANSFORM3D;
+			builtin_types["Color"] = Variant::COLOR;
+			builtin_types["RID"] = Variant::RID;
+			builtin_types["Object"] = Variant::OBJECT;
+			builtin_types["StringName"] = Variant::STRING_NAME;
+			builtin_types["NodePath"] = Variant::NODE_PATH;
+			builtin_types["Dictionary"] = Variant::DICTIONARY;
+			builtin_types["Callable"] = Variant::CALLABLE;
+			builtin_types["Signal"] = Variant::SIGNAL;
+			builtin_types["Array"] = Variant::ARRAY;
+			builtin_types["PackedByteArray"] = Variant::PACKED_BYTE_ARRAY;
+			builtin_types["PackedInt32Array"] = Variant::PACKED_INT32_ARRAY;
+			builtin_types["PackedInt64Array"] = Variant::PACKED_INT64_ARRAY;
+			builtin_types["PackedFloat32Array"] = Variant::PACKED_FLOAT32_ARRAY;
+			builtin_types["PackedFloat64Array"] = Variant::PACKED_FLOAT64_ARRAY;
+			builtin_types["PackedStringArray"] = Variant::PACKED_STRING_ARRAY;
+			builtin_types["PackedVector2Array"] = Variant::PACKED_VECTOR2_ARRAY;
+			builtin_types["PackedVector3Array"] = Variant::PACKED_VECTOR3_ARRAY;
+			builtin_types["PackedColorArray"] = Variant::PACKED_COLOR_ARRAY;
+			// NIL is not here, hence the -1.
+			if (builtin_types.size() != Variant::VARIANT_MAX - 1) {
+				ERR_PRINT("Outdated parser: amount of built-in types don't match the amount of types in Variant.");
+			}
+			builtin_types_initialized.set();
+		}
+	}
+
+	const Variant::Type *type = builtin_types.getptr(p_type);
+	if (type) {
+		return *type;
 	}
 	return Variant::VARIANT_MAX;
 }
 
 void GDScriptParser::cleanup() {
+	MutexLock lock(builtin_types_mutex);
 	builtin_types.clear();
+	builtin_types_initialized.clear();
+}
+
+List<String> GDScriptParser::get_dependencies() const {
+	List<String> dependencies;
+	Set<String> found;
+	const String base_dir = script_path.get_base_dir();
+
+	for (const Node *node = list; node != nullptr; node = node->next) {
+		String path;
+		switch (node->type) {
+			case Node::CLASS: {
+				const ClassNode *class_node = static_cast<const ClassNode *>(node);
+				if (!class_node->extends_path.is_empty()) {
+					path = class_node->extends_path;
+				} else if (!class_node->extends.is_empty() && ScriptServer::is_global_class(class_node->extends[0])) {
+					path = ScriptServer::get_global_class_path(class_node->extends[0]);
+				}
+			} break;
+			case Node::PRELOAD: {
+				// Only literal paths, constant expressions are reduced by the analyzer.
+				const PreloadNode *preload = static_cast<const PreloadNode *>(node);
+				if (preload->path != nullptr && preload->path->type == Node::LITERAL) {
+					const Variant &value = static_cast<const LiteralNode *>(preload->path)->value;
+					if (value.get_type() == Variant::STRING) {
+						path = value;
+					}
+				}
+			} break;
+			case Node::IDENTIFIER: {
+				const StringName &name = static_cast<const IdentifierNode *>(node)->name;
+				if (ScriptServer::is_global_class(name)) {
+					path = ScriptServer::get_global_class_path(name);
+				}
+			} break;
+			default:
+				break;
+		}
+
+		if (path.is_empty()) {
+			continue;
+		}
+		if (path.is_relative_path()) {
+			path = base_dir.plus_file(path);
+		}
+		path = path.simplify_path();
+		if (path != script_path && !found.has(path)) {
+			found.insert(path);
+			dependencies.push_back(path);
+		}
+	}
+
+	return dependencies;
 }
 
 void GDScriptParser::get_annotation_list(List<MethodInfo> *r_annotations) const {
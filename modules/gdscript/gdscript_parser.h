@@ -1412,10 +1412,8 @@ public:
 	void get_annotation_list(List<MethodInfo> *r_annotations) const;
 
 	const List<ParserError> &get_errors() const { return errors; }
-	const List<String> get_dependencies() const {
-		// TODO: Keep track of deps.
-		return List<String>();
-	}
+	// Paths the script refers to by preload, extends or global class name.
+	List<String> get_dependencies() const;
 #ifdef DEBUG_ENABLED
 	const List<GDScriptWarning> &get_warnings() const { return warnings; }
 	const Set<int> &get_unsafe_lines() const { return unsafe_lines; }
@@ -0,0 +1,357 @@
+/*************************************************************************/
+/*  gdscript_sampling_profiler.cpp                                       */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2022 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2022 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+#include "gdscript_sampling_profiler.h"
+
+#include "gdscript_function.h"
+
+#include "core/io/file_access.h"
+#include "core/io/json.h"
+#include "core/os/os.h"
+
+#include <atomic>
+
+GDScriptSamplingProfiler *GDScriptSamplingProfiler::singleton = nullptr;
+SafeFlag GDScriptSamplingProfiler::sampling;
+SafeNumeric<uint32_t> GDScriptSamplingProfiler::current_session;
+thread_local GDScriptSamplingProfiler::ThreadHandle GDScriptSamplingProfiler::thread_stack;
+
+GDScriptSamplingProfiler::ThreadHandle::~ThreadHandle() {
+	if (!stack) {
+		return;
+	}
+	if (singleton) {
+		// The sampler may be reading the stack right now.
+		MutexLock lock(singleton->mutex);
+		stack->orphaned = true;
+	}
+	_unref_stack(stack);
+	stack = nullptr;
+}
+
+GDScriptSamplingProfiler::ThreadStack *GDScriptSamplingProfiler::_register_thread() {
+	if (!singleton) {
+		return nullptr;
+	}
+
+	ThreadStack *stack = memnew(ThreadStack);
+	stack->refcount.init(2); // This thread and the profiler.
+	stack->session.set(current_session.get());
+	stack->thread_id = Thread::get_caller_id();
+
+	singleton->mutex.lock();
+	singleton->stacks.push_back(stack);
+	singleton->mutex.unlock();
+
+	thread_stack.stack = stack;
+	return stack;
+}
+
+void GDScriptSamplingProfiler::_unref_stack(ThreadStack *p_stack) {
+	if (p_stack->refcount.unref()) {
+		memdelete(p_stack);
+	}
+}
+
+void GDScriptSamplingProfiler::_thread_func(void *p_userdata) {
+	GDScriptSamplingProfiler *profiler = (GDScriptSamplingProfiler *)p_userdata;
+	while (!profiler->exit_thread.is_set()) {
+		profiler->mutex.lock();
+		profiler->_take_samples();
+		profiler->mutex.unlock();
+		OS::get_singleton()->delay_usec(profiler->interval_usec);
+	}
+}
+
+void GDScriptSamplingProfiler::_take_samples() {
+	uint64_t time = OS::get_singleton()->get_ticks_usec() - start_time;
+	uint32_t session = current_session.get();
+
+	for (uint32_t i = 0; i < stacks.size(); i++) {
+		ThreadStack *stack = stacks[i];
+		if (stack->orphaned) {
+			stacks.remove_at_unordered(i);
+			i--;
+			_unref_stack(stack);
+			continue;
+		}
+
+		// Copy the stack, retrying a few times if its thread changed it meanwhile.
+		// Reading a line counter of a frame that is being popped is harmless, as
+		// the memory still belongs to the stack of that thread.
+		Frame snapshot[MAX_DEPTH];
+		int lines[MAX_DEPTH];
+		uint32_t depth = 0;
+		bool consistent = false;
+		for (int attempt = 0; attempt < 4 && !consistent; attempt++) {
+			uint32_t version = stack->version.get();
+			if (version & 1) {
+				continue;
+			}
+			if (stack->session.get() != session) {
+				break;
+			}
+			depth = MIN(stack->depth.get(), (uint32_t)MAX_DEPTH);
+			for (uint32_t j = 0; j < depth; j++) {
+				snapshot[j] = stack->frames[j];
+				lines[j] = *snapshot[j].line;
+			}
+			std::atomic_thread_fence(std::memory_order_acquire);
+			consistent = stack->version.get() == version;
+		}
+		if (!consistent || depth == 0) {
+			continue;
+		}
+
+		uint32_t node = _get_thread_root(stack->thread_id);
+		for (uint32_t j = 0; j < depth; j++) {
+			uint32_t frame = _get_frame(snapshot[j].function, lines[j]);
+			uint64_t key = (uint64_t(node) << 32) | frame;
+			const uint32_t *child = node_ids.getptr(key);
+			if (child) {
+				node = *child;
+			} else {
+				Node child_node;
+				child_node.parent = node;
+				child_node.frame = frame;
+				child_node.thread = nodes[node].thread;
+				nodes.push_back(child_node);
+				node = nodes.size() - 1;
+				node_ids.set(key, node);
+			}
+		}
+
+		Sample sample;
+		sample.time = time;
+		sample.node = node;
+		samples.push_back(sample);
+	}
+}
+
+uint32_t GDScriptSamplingProfiler::_get_frame(const GDScriptFunction *p_function, int p_line) {
+	uint32_t function;
+	const uint32_t *function_id = function_ids.getptr(p_function);
+	if (function_id) {
+		function = *function_id;
+	} else {
+		FunctionInfo info;
+		info.name = p_function->get_name();
+		info.file = p_function->get_source();
+		if (info.file.is_empty()) {
+			info.file = "<built-in>";
+		}
+		functions.push_back(info);
+		function = functions.size() - 1;
+		function_ids.set(p_function, function);
+	}
+
+	uint64_t key = (uint64_t(function) << 32) | uint32_t(p_line);
+	const uint32_t *frame_id = frame_ids.getptr(key);
+	if (frame_id) {
+		return *frame_id;
+	}
+	frames.push_back(key);
+	frame_ids.set(key, frames.size() - 1);
+	return frames.size() - 1;
+}
+
+uint32_t GDScriptSamplingProfiler::_get_thread_root(Thread::ID p_thread_id) {
+	const uint32_t *root = thread_roots.getptr(p_thread_id);
+	if (root) {
+		return *root;
+	}
+	Node node;
+	node.thread = thread_names.size();
+	thread_names.push_back(p_thread_id == Thread::get_main_id() ? String("Main Thread") : vformat("Thread %d", node.thread));
+	nodes.push_back(node);
+	thread_roots.set(p_thread_id, nodes.size() - 1);
+	return nodes.size() - 1;
+}
+
+String GDScriptSamplingProfiler::_get_frame_name(uint32_t p_frame) const {
+	const FunctionInfo &info = functions[frames[p_frame] >> 32];
+	return vformat("%s (%s:%d)", info.name, info.file, int(frames[p_frame] & 0xFFFFFFFF));
+}
+
+void GDScriptSamplingProfiler::forget_function(const GDScriptFunction *p_function) {
+	MutexLock lock(mutex);
+	function_ids.erase(p_function);
+}
+
+Error GDScriptSamplingProfiler::start(uint32_t p_interval_usec) {
+	ERR_FAIL_COND_V_MSG(thread.is_started(), ERR_ALREADY_IN_USE, "The GDScript sampling profiler is already running.");
+	ERR_FAIL_COND_V(p_interval_usec == 0, ERR_INVALID_PARAMETER);
+
+	clear();
+	interval_usec = p_interval_usec;
+	start_time = OS::get_singleton()->get_ticks_usec();
+	current_session.increment();
+	exit_thread.clear();
+	sampling.set();
+	thread.start(_thread_func, this);
+	return OK;
+}
+
+void GDScriptSamplingProfiler::stop() {
+	if (!thread.is_started()) {
+		return;
+	}
+	exit_thread.set();
+	thread.wait_to_finish();
+	sampling.clear();
+}
+
+void GDScriptSamplingProfiler::clear() {
+	MutexLock lock(mutex);
+	function_ids.clear();
+	functions.clear();
+	frame_ids.clear();
+	frames.clear();
+	node_ids.clear();
+	thread_roots.clear();
+	thread_names.clear();
+	nodes.clear();
+	samples.clear();
+}
+
+uint32_t GDScriptSamplingProfiler::get_sample_count() {
+	MutexLock lock(mutex);
+	return samples.size();
+}
+
+String GDScriptSamplingProfiler::get_collapsed_stacks() {
+	MutexLock lock(mutex);
+
+	LocalVector<uint32_t> counts;
+	counts.resize(nodes.size());
+	for (uint32_t i = 0; i < counts.size(); i++) {
+		counts[i] = 0;
+	}
+	for (uint32_t i = 0; i < samples.size(); i++) {
+		counts[samples[i].node]++;
+	}
+
+	Vector<String> lines;
+	for (uint32_t i = 0; i < nodes.size(); i++) {
+		if (counts[i] == 0) {
+			continue;
+		}
+		String line;
+		uint32_t node = i;
+		while (nodes[node].frame != UINT32_MAX) {
+			line = ";" + _get_frame_name(nodes[node].frame) + line;
+			node = nodes[node].parent;
+		}
+		lines.push_back(thread_names[nodes[i].thread] + line + " " + itos(counts[i]));
+	}
+	lines.sort();
+
+	String result;
+	for (int i = 0; i < lines.size(); i++) {
+		result += lines[i] + "\n";
+	}
+	return result;
+}
+
+String GDScriptSamplingProfiler::get_chrome_trace() {
+	MutexLock lock(mutex);
+
+	Array events;
+	for (uint32_t i = 0; i < thread_names.size(); i++) {
+		Dictionary args;
+		args["name"] = thread_names[i];
+		Dictionary event;
+		event["ph"] = "M";
+		event["name"] = "thread_name";
+		event["pid"] = 0;
+		event["tid"] = i;
+		event["args"] = args;
+		events.push_back(event);
+	}
+
+	// Thread roots are not frames, so their children have no parent.
+	Dictionary stack_frames;
+	for (uint32_t i = 0; i < nodes.size(); i++) {
+		if (nodes[i].frame == UINT32_MAX) {
+			continue;
+		}
+		Dictionary stack_frame;
+		stack_frame["name"] = _get_frame_name(nodes[i].frame);
+		stack_frame["category"] = "GDScript";
+		if (nodes[nodes[i].parent].frame != UINT32_MAX) {
+			stack_frame["parent"] = itos(nodes[i].parent);
+		}
+		stack_frames[itos(i)] = stack_frame;
+	}
+
+	Array trace_samples;
+	for (uint32_t i = 0; i < samples.size(); i++) {
+		Dictionary sample;
+		sample["cpu"] = 0;
+		sample["tid"] = nodes[samples[i].node].thread;
+		sample["ts"] = samples[i].time;
+		sample["name"] = "GDScript";
+		sample["weight"] = 1;
+		sample["sf"] = itos(samples[i].node);
+		trace_samples.push_back(sample);
+	}
+
+	Dictionary trace;
+	trace["traceEvents"] = events;
+	trace["stackFrames"] = stack_frames;
+	trace["samples"] = trace_samples;
+
+	JSON json;
+	return json.stringify(trace, "", false);
+}
+
+Error GDScriptSamplingProfiler::save(const String &p_path, Format p_format) {
+	String data = p_format == FORMAT_CHROME_TRACE ? get_chrome_trace() : get_collapsed_stacks();
+
+	Error err;
+	Ref<FileAccess> file = FileAccess::open(p_path, FileAccess::WRITE, &err);
+	ERR_FAIL_COND_V_MSG(err != OK, err, "Cannot open file '" + p_path + "' to save the GDScript profile.");
+	file->store_string(data);
+	return OK;
+}
+
+GDScriptSamplingProfiler::GDScriptSamplingProfiler() {
+	singleton = this;
+}
+
+GDScriptSamplingProfiler::~GDScriptSamplingProfiler() {
+	stop();
+
+	MutexLock lock(mutex);
+	for (uint32_t i = 0; i < stacks.size(); i++) {
+		_unref_stack(stacks[i]);
+	}
+	stacks.clear();
+	singleton = nullptr;
+}
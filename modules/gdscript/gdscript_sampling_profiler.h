@@ -0,0 +1,190 @@
+/*************************************************************************/
+/*  gdscript_sampling_profiler.h                                         */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2022 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2022 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+#ifndef GDSCRIPT_SAMPLING_PROFILER_H
+#define GDSCRIPT_SAMPLING_PROFILER_H
+
+#include "core/os/mutex.h"
+#include "core/os/thread.h"
+#include "core/templates/hash_map.h"
+#include "core/templates/local_vector.h"
+#include "core/templates/safe_refcount.h"
+#include "core/variant/variant.h"
+
+class GDScriptFunction;
+
+// Statistical profiler for GDScript. While a session is running, every thread
+// executing GDScript keeps a shadow stack of the functions it is in, pointing
+// at the live line counters of the interpreter. A timer thread snapshots those
+// stacks at a fixed interval, so the cost on the script side is independent of
+// the sampling rate and nothing is measured with the clock in the hot path.
+// The samples can be exported as collapsed stacks (for flamegraph tools) or as
+// a Chrome trace (for chrome://tracing, Perfetto or speedscope).
+class GDScriptSamplingProfiler {
+public:
+	enum Format {
+		FORMAT_COLLAPSED_STACKS,
+		FORMAT_CHROME_TRACE,
+	};
+
+	enum {
+		MAX_DEPTH = 128, // Deeper frames are not recorded, but keep the stack balanced.
+	};
+
+private:
+	struct Frame {
+		const GDScriptFunction *function = nullptr;
+		const int *line = nullptr;
+	};
+
+	// Only written by its owner thread. The sampler reads it under a sequence
+	// lock: `version` is odd while the owner is modifying the stack.
+	struct ThreadStack {
+		Frame frames[MAX_DEPTH];
+		SafeNumeric<uint32_t> depth;
+		SafeNumeric<uint32_t> version;
+		SafeNumeric<uint32_t> session; // Frames left over from another session are stale.
+		Thread::ID thread_id = 0;
+		SafeRefCount refcount;
+		bool orphaned = false; // The thread has exited, protected by the profiler mutex.
+	};
+
+	struct ThreadHandle {
+		ThreadStack *stack = nullptr;
+		~ThreadHandle();
+	};
+
+	struct FunctionInfo {
+		String name;
+		String file;
+	};
+
+	struct Node {
+		uint32_t parent = UINT32_MAX;
+		uint32_t frame = UINT32_MAX; // UINT32_MAX for the root node of a thread.
+		uint32_t thread = 0; // Index in `thread_names`.
+	};
+
+	struct Sample {
+		uint64_t time = 0; // Microseconds since the session started.
+		uint32_t node = 0;
+	};
+
+	static GDScriptSamplingProfiler *singleton;
+	static SafeFlag sampling;
+	static SafeNumeric<uint32_t> current_session;
+	static thread_local ThreadHandle thread_stack;
+
+	Mutex mutex;
+	Thread thread;
+	SafeFlag exit_thread;
+	uint32_t interval_usec = 1000;
+	uint64_t start_time = 0;
+
+	LocalVector<ThreadStack *> stacks;
+
+	// Functions can be freed while a session runs, so they are interned on
+	// first sight and only identified by index afterwards.
+	HashMap<const GDScriptFunction *, uint32_t> function_ids;
+	LocalVector<FunctionInfo> functions;
+	HashMap<uint64_t, uint32_t> frame_ids; // function << 32 | line.
+	LocalVector<uint64_t> frames;
+	HashMap<uint64_t, uint32_t> node_ids; // parent << 32 | frame.
+	HashMap<uint64_t, uint32_t> thread_roots; // Thread::ID.
+	LocalVector<String> thread_names;
+	LocalVector<Node> nodes;
+	LocalVector<Sample> samples;
+
+	static ThreadStack *_register_thread();
+	static void _unref_stack(ThreadStack *p_stack);
+	static void _thread_func(void *p_userdata);
+
+	void _take_samples();
+	uint32_t _get_frame(const GDScriptFunction *p_function, int p_line);
+	uint32_t _get_thread_root(Thread::ID p_thread_id);
+	String _get_frame_name(uint32_t p_frame) const;
+
+public:
+	_FORCE_INLINE_ static GDScriptSamplingProfiler *get_singleton() { return singleton; }
+	_FORCE_INLINE_ static bool is_sampling() { return sampling.is_set(); }
+
+	// Called by the VM around each function body, only while sampling.
+	_FORCE_INLINE_ static void push(const GDScriptFunction *p_function, const int *p_line) {
+		ThreadStack *stack = thread_stack.stack ? thread_stack.stack : _register_thread();
+		if (unlikely(!stack)) {
+			return;
+		}
+		uint32_t depth = stack->depth.get();
+		stack->version.increment();
+		if (unlikely(stack->session.get() != current_session.get())) {
+			stack->session.set(current_session.get());
+			depth = 0;
+		}
+		if (depth < MAX_DEPTH) {
+			stack->frames[depth].function = p_function;
+			stack->frames[depth].line = p_line;
+		}
+		stack->depth.set(depth + 1);
+		stack->version.increment();
+	}
+
+	// Frames are matched by their line counter, which is unique among the live
+	// calls of a thread, so functions entered during a previous session are
+	// ignored when they return.
+	_FORCE_INLINE_ static void pop(const int *p_line) {
+		ThreadStack *stack = thread_stack.stack;
+		if (unlikely(!stack)) {
+			return;
+		}
+		uint32_t depth = stack->depth.get();
+		if (unlikely(depth == 0 || (depth <= MAX_DEPTH && stack->frames[depth - 1].line != p_line))) {
+			return;
+		}
+		stack->version.increment();
+		stack->depth.set(depth - 1);
+		stack->version.increment();
+	}
+
+	void forget_function(const GDScriptFunction *p_function);
+
+	Error start(uint32_t p_interval_usec = 1000);
+	void stop();
+	void clear();
+	bool is_running() const { return thread.is_started(); }
+	uint32_t get_sample_count();
+
+	String get_collapsed_stacks();
+	String get_chrome_trace();
+	Error save(const String &p_path, Format p_format);
+
+	GDScriptSamplingProfiler();
+	~GDScriptSamplingProfiler();
+};
+
+#endif // GDSCRIPT_SAMPLING_PROFILER_H
@@ -34,6 +34,8 @@
 #include "core/os/os.h"
 #include "gdscript.h"
 #include "gdscript_lambda_callable.h"
+#include "gdscript_numeric_tier.h"
+#include "gdscript_sampling_profiler.h"
 
 Variant *GDScriptFunction::_get_variant(int p_address, GDScriptInstance *p_instance, Variant *p_stack, String &r_error) const {
 	int address = p_address & ADDR_MASK;
@@ -127,6 +129,41 @@ static String _get_var_type(const Variant *p_var) {
 }
 #endif // DEBUG_ENABLED
 
+// Array and dictionary literals are built into temporaries that are reused every
+// time the expression runs. When the container left there by the previous run is
+// no longer referenced from anywhere else it can't be observed anymore, so it is
+// refilled in place instead of allocating a new one.
+static _FORCE_INLINE_ bool _is_reusable_container(const Variant *p_dst, Variant **p_args, int p_argc) {
+	for (int i = 0; i < p_argc; i++) {
+		if (p_args[i] == p_dst) {
+			return false;
+		}
+	}
+	return true;
+}
+
+static _FORCE_INLINE_ Array *_get_reusable_array(Variant *p_dst, Variant **p_args, int p_argc) {
+	if (p_dst->get_type() != Variant::ARRAY) {
+		return nullptr;
+	}
+	Array *array = VariantInternal::get_array(p_dst);
+	if (array->is_shared() || !_is_reusable_container(p_dst, p_args, p_argc)) {
+		return nullptr;
+	}
+	return array;
+}
+
+static _FORCE_INLINE_ Dictionary *_get_reusable_dictionary(Variant *p_dst, Variant **p_args, int p_argc) {
+	if (p_dst->get_type() != Variant::DICTIONARY) {
+		return nullptr;
+	}
+	Dictionary *dict = VariantInternal::get_dictionary(p_dst);
+	if (dict->is_shared() || !_is_reusable_container(p_dst, p_args, p_argc)) {
+		return nullptr;
+	}
+	return dict;
+}
+
 Variant GDScriptFunction::_get_default_variant_for_data_type(const GDScriptDataType &p_data_type) {
 	if (p_data_type.kind == GDScriptDataType::BUILTIN) {
 		if (p_data_type.builtin_type == Variant::ARRAY) {
@@ -184,6 +221,132 @@ String GDScriptFunction::_get_call_error(const Callable::CallError &p_err, const
 	return err_text;
 }
 
+// Inline cache fast paths for untyped accesses and calls. They return false
+// when the generic Variant path has to run instead, which is also what fills
+// the cache on a miss when the receiver qualifies.
+
+bool GDScriptFunction::_set_named_cached(InlineCache *p_cache, Variant *p_base, const StringName &p_name, const Variant *p_value, bool &r_valid) {
+	Variant::Type type = p_base->get_type();
+	if (type == Variant::OBJECT) {
+		Object *obj = p_base->get_validated_object();
+		if (!obj || obj->get_script_instance()) {
+			return false;
+		}
+
+		MethodBind *setter = nullptr;
+		const InlineCache::Entry *entry = p_cache->find(obj->get_class_name());
+		if (entry) {
+			setter = entry->method;
+		} else {
+#ifdef TOOLS_ENABLED
+			if (Engine::get_singleton()->is_editor_hint()) {
+				return false; // Object::set() also marks the object as edited.
+			}
+#endif
+			setter = _inline_cache_property(p_cache, obj, p_name, true);
+			if (!setter) {
+				return false;
+			}
+		}
+
+		Callable::CallError ce;
+		setter->call(obj, &p_value, 1, ce);
+		r_valid = ce.error == Callable::CallError::CALL_OK;
+		return true;
+	}
+
+	const InlineCache::Entry *entry = p_cache->find(type);
+	if (!entry) {
+		entry = _inline_cache_builtin_member(p_cache, type, p_name);
+		if (!entry) {
+			return false;
+		}
+	}
+	if (!entry->setter || p_value->get_type() != entry->value_type) {
+		return false;
+	}
+
+	entry->setter(p_base, p_value);
+	r_valid = true;
+	return true;
+}
+
+bool GDScriptFunction::_get_named_cached(InlineCache *p_cache, const Variant *p_base, const StringName &p_name, Variant *r_value) {
+	Variant::Type type = p_base->get_type();
+	if (type == Variant::OBJECT) {
+		Object *obj = p_base->get_validated_object();
+		if (!obj || obj->get_script_instance()) {
+			return false;
+		}
+
+		const InlineCache::Entry *entry = p_cache->find(obj->get_class_name());
+		MethodBind *getter = entry ? entry->method : _inline_cache_property(p_cache, obj, p_name, false);
+		if (!getter) {
+			return false;
+		}
+
+		Callable::CallError ce;
+		Variant value = getter->call(obj, nullptr, 0, ce);
+		if (ce.error != Callable::CallError::CALL_OK) {
+			return false; // Let the slow path report it.
+		}
+		*r_value = value;
+		return true;
+	}
+
+	if (p_base == r_value) {
+		return false; // Validated getters write in place.
+	}
+
+	const InlineCache::Entry *entry = p_cache->find(type);
+	if (!entry) {
+		entry = _inline_cache_builtin_member(p_cache, type, p_name);
+		if (!entry) {
+			return false;
+		}
+	}
+
+	if (!entry->getter) {
+		return false;
+	}
+
+	if (r_value->get_type() != entry->value_type) {
+		VariantInternal::initialize(r_value, entry->value_type);
+	}
+	entry->getter(p_base, r_value);
+	return true;
+}
+
+bool GDScriptFunction::_call_cached(InlineCache *p_cache, Variant *p_base, const StringName &p_method, const Variant **p_args, int p_argcount, Variant &r_ret, Callable::CallError &r_error) {
+	if (p_base->get_type() != Variant::OBJECT) {
+		return false;
+	}
+
+#ifdef DEBUG_ENABLED
+	bool freed = false;
+	Object *obj = p_base->get_validated_object_with_check(freed);
+#else
+	Object *obj = *VariantInternal::get_object(p_base);
+#endif
+	if (!obj || obj->get_script_instance()) {
+		return false;
+	}
+
+	const InlineCache::Entry *entry = p_cache->find(obj->get_class_name());
+	MethodBind *method = entry ? entry->method : _inline_cache_method(p_cache, obj, p_method);
+	if (!method) {
+		return false;
+	}
+
+	r_ret = obj->callp_method_bind(method, p_args, p_argcount, r_error);
+	return true;
+}
+
+MethodBind *GDScriptFunction::_get_cached_property_accessor(InlineCache *p_cache, Object *p_object, const StringName &p_property, bool p_setter) {
+	const InlineCache::Entry *entry = p_cache->find(p_object->get_class_name());
+	return entry ? entry->method : _inline_cache_property(p_cache, p_object, p_property, p_setter);
+}
+
 void (*type_init_function_table[])(Variant *) = {
 	nullptr, // NIL (shouldn't be called).
 	&VariantInitializer<bool>::init, // BOOL.
@@ -241,6 +404,7 @@ void (*type_init_function_table[])(Variant *) = {
 		&&OPCODE_GET_NAMED_VALIDATED,                \
 		&&OPCODE_SET_MEMBER,                         \
 		&&OPCODE_GET_MEMBER,                         \
+		&&OPCODE_SET_MEMBER_OPERATOR,                \
 		&&OPCODE_ASSIGN,                             \
 		&&OPCODE_ASSIGN_TRUE,                        \
 		&&OPCODE_ASSIGN_FALSE,                       \
@@ -310,6 +474,8 @@ void (*type_init_function_table[])(Variant *) = {
 		&&OPCODE_JUMP,                               \
 		&&OPCODE_JUMP_IF,                            \
 		&&OPCODE_JUMP_IF_NOT,                        \
+		&&OPCODE_OPERATOR_JUMP_IF_NOT,               \
+		&&OPCODE_OPERATOR_VALIDATED_JUMP_IF_NOT,     \
 		&&OPCODE_JUMP_TO_DEF_ARGUMENT,               \
 		&&OPCODE_RETURN,                             \
 		&&OPCODE_RETURN_TYPED_BUILTIN,               \
@@ -467,6 +633,32 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 
 	r_err.error = Callable::CallError::CALL_OK;
 
+	if (!p_state && GDScriptNumericTier::is_enabled()) {
+#ifdef DEBUG_ENABLED
+		// Breakpoints, stepping and the profiler need the interpreter.
+		bool can_use_tier = !EngineDebugger::is_active() && !GDScriptLanguage::get_singleton()->profiling;
+#else
+		bool can_use_tier = true;
+#endif
+		GDScriptNumericTier *tier = can_use_tier ? _get_numeric_tier() : nullptr;
+		if (tier) {
+			// The tier has no line information, samples land on the first line.
+			const int tier_line = _initial_line;
+			const bool tier_sampled = GDScriptSamplingProfiler::is_sampling();
+			if (tier_sampled) {
+				GDScriptSamplingProfiler::push(this, &tier_line);
+			}
+			Variant ret;
+			bool done = tier->call(p_args, p_argcount, ret);
+			if (tier_sampled) {
+				GDScriptSamplingProfiler::pop(&tier_line);
+			}
+			if (done) {
+				return ret;
+			}
+		}
+	}
+
 	Variant retvalue;
 	Variant *stack = nullptr;
 	Variant **instruction_args = nullptr;
@@ -576,6 +768,11 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 
 	String err_text;
 
+	const bool sampled = GDScriptSamplingProfiler::is_sampling();
+	if (sampled) {
+		GDScriptSamplingProfiler::push(this, &line);
+	}
+
 #ifdef DEBUG_ENABLED
 
 	if (EngineDebugger::is_active()) {
@@ -640,8 +837,10 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 		}
 
 		OPCODE_SWITCH(_code_ptr[ip] & INSTR_MASK) {
+			OPCODE(OPCODE_OPERATOR_JUMP_IF_NOT)
 			OPCODE(OPCODE_OPERATOR) {
-				CHECK_SPACE(5);
+				bool jump_if_not = (_code_ptr[ip] & INSTR_MASK) == OPCODE_OPERATOR_JUMP_IF_NOT;
+				CHECK_SPACE(jump_if_not ? 6 : 5);
 
 				bool valid;
 				Variant::Operator op = (Variant::Operator)_code_ptr[ip + 4];
@@ -671,7 +870,15 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 				}
 				*dst = ret;
 #endif
-				ip += 5;
+				if (!jump_if_not) {
+					ip += 5;
+				} else if (!dst->booleanize()) {
+					int to = _code_ptr[ip + 5];
+					GD_ERR_BREAK(to < 0 || to > _code_size);
+					ip = to;
+				} else {
+					ip += 6;
+				}
 			}
 			DISPATCH_OPCODE;
 
@@ -692,6 +899,29 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 			}
 			DISPATCH_OPCODE;
 
+			OPCODE(OPCODE_OPERATOR_VALIDATED_JUMP_IF_NOT) {
+				CHECK_SPACE(6);
+
+				int operator_idx = _code_ptr[ip + 4];
+				GD_ERR_BREAK(operator_idx < 0 || operator_idx >= _operator_funcs_count);
+				Variant::ValidatedOperatorEvaluator operator_func = _operator_funcs_ptr[operator_idx];
+
+				GET_INSTRUCTION_ARG(a, 0);
+				GET_INSTRUCTION_ARG(b, 1);
+				GET_INSTRUCTION_ARG(dst, 2);
+
+				operator_func(a, b, dst);
+
+				if (!dst->booleanize()) {
+					int to = _code_ptr[ip + 5];
+					GD_ERR_BREAK(to < 0 || to > _code_size);
+					ip = to;
+				} else {
+					ip += 6;
+				}
+			}
+			DISPATCH_OPCODE;
+
 			OPCODE(OPCODE_EXTENDS_TEST) {
 				CHECK_SPACE(4);
 
@@ -970,7 +1200,7 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 			DISPATCH_OPCODE;
 
 			OPCODE(OPCODE_SET_NAMED) {
-				CHECK_SPACE(3);
+				CHECK_SPACE(5);
 
 				GET_INSTRUCTION_ARG(dst, 0);
 				GET_INSTRUCTION_ARG(value, 1);
@@ -980,8 +1210,13 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 				GD_ERR_BREAK(indexname < 0 || indexname >= _global_names_count);
 				const StringName *index = &_global_names_ptr[indexname];
 
+				int cache_idx = _code_ptr[ip + 4];
+				GD_ERR_BREAK(cache_idx < 0 || cache_idx >= _inline_caches_count);
+
 				bool valid;
-				dst->set_named(*index, *value, valid);
+				if (!_set_named_cached(&_inline_caches_ptr[cache_idx], dst, *index, value, valid)) {
+					dst->set_named(*index, *value, valid);
+				}
 
 #ifdef DEBUG_ENABLED
 				if (!valid) {
@@ -990,7 +1225,7 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 					OPCODE_BREAK;
 				}
 #endif
-				ip += 4;
+				ip += 5;
 			}
 			DISPATCH_OPCODE;
 
@@ -1010,7 +1245,7 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 			DISPATCH_OPCODE;
 
 			OPCODE(OPCODE_GET_NAMED) {
-				CHECK_SPACE(4);
+				CHECK_SPACE(5);
 
 				GET_INSTRUCTION_ARG(src, 0);
 				GET_INSTRUCTION_ARG(dst, 1);
@@ -1020,6 +1255,14 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 				GD_ERR_BREAK(indexname < 0 || indexname >= _global_names_count);
 				const StringName *index = &_global_names_ptr[indexname];
 
+				int cache_idx = _code_ptr[ip + 4];
+				GD_ERR_BREAK(cache_idx < 0 || cache_idx >= _inline_caches_count);
+
+				if (_get_named_cached(&_inline_caches_ptr[cache_idx], src, *index, dst)) {
+					ip += 5;
+					DISPATCH_OPCODE;
+				}
+
 				bool valid;
 #ifdef DEBUG_ENABLED
 				//allow better error message in cases where src and dst are the same stack position
@@ -1039,7 +1282,7 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 				}
 				*dst = ret;
 #endif
-				ip += 4;
+				ip += 5;
 			}
 			DISPATCH_OPCODE;
 
@@ -1059,17 +1302,31 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 			DISPATCH_OPCODE;
 
 			OPCODE(OPCODE_SET_MEMBER) {
-				CHECK_SPACE(3);
+				CHECK_SPACE(4);
 				GET_INSTRUCTION_ARG(src, 0);
 				int indexname = _code_ptr[ip + 2];
 				GD_ERR_BREAK(indexname < 0 || indexname >= _global_names_count);
 				const StringName *index = &_global_names_ptr[indexname];
+				int cache_idx = _code_ptr[ip + 3];
+				GD_ERR_BREAK(cache_idx < 0 || cache_idx >= _inline_caches_count);
 
 				bool valid;
+#ifdef DEBUG_ENABLED
+				bool ok = true;
+#endif
+				MethodBind *setter = _get_cached_property_accessor(&_inline_caches_ptr[cache_idx], p_instance->owner, *index, true);
+				if (setter) {
+					Callable::CallError ce;
+					setter->call(p_instance->owner, (const Variant **)&src, 1, ce);
+					valid = ce.error == Callable::CallError::CALL_OK;
+				} else {
 #ifndef DEBUG_ENABLED
-				ClassDB::set_property(p_instance->owner, *index, *src, &valid);
+					ClassDB::set_property(p_instance->owner, *index, *src, &valid);
 #else
-				bool ok = ClassDB::set_property(p_instance->owner, *index, *src, &valid);
+					ok = ClassDB::set_property(p_instance->owner, *index, *src, &valid);
+#endif
+				}
+#ifdef DEBUG_ENABLED
 				if (!ok) {
 					err_text = "Internal error setting property: " + String(*index);
 					OPCODE_BREAK;
@@ -1078,26 +1335,110 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 					OPCODE_BREAK;
 				}
 #endif
-				ip += 3;
+				ip += 4;
 			}
 			DISPATCH_OPCODE;
 
 			OPCODE(OPCODE_GET_MEMBER) {
-				CHECK_SPACE(3);
+				CHECK_SPACE(4);
 				GET_INSTRUCTION_ARG(dst, 0);
 				int indexname = _code_ptr[ip + 2];
 				GD_ERR_BREAK(indexname < 0 || indexname >= _global_names_count);
 				const StringName *index = &_global_names_ptr[indexname];
+				int cache_idx = _code_ptr[ip + 3];
+				GD_ERR_BREAK(cache_idx < 0 || cache_idx >= _inline_caches_count);
+
+				MethodBind *getter = _get_cached_property_accessor(&_inline_caches_ptr[cache_idx], p_instance->owner, *index, false);
+				if (getter) {
+					Callable::CallError ce;
+					*dst = getter->call(p_instance->owner, nullptr, 0, ce);
+				} else {
 #ifndef DEBUG_ENABLED
-				ClassDB::get_property(p_instance->owner, *index, *dst);
+					ClassDB::get_property(p_instance->owner, *index, *dst);
 #else
-				bool ok = ClassDB::get_property(p_instance->owner, *index, *dst);
+					bool ok = ClassDB::get_property(p_instance->owner, *index, *dst);
+					if (!ok) {
+						err_text = "Internal error getting property: " + String(*index);
+						OPCODE_BREAK;
+					}
+#endif
+				}
+				ip += 4;
+			}
+			DISPATCH_OPCODE;
+
+			OPCODE(OPCODE_SET_MEMBER_OPERATOR) {
+				CHECK_SPACE(6);
+				GET_INSTRUCTION_ARG(value, 0);
+				int indexname = _code_ptr[ip + 2];
+				GD_ERR_BREAK(indexname < 0 || indexname >= _global_names_count);
+				const StringName *index = &_global_names_ptr[indexname];
+				Variant::Operator op = (Variant::Operator)_code_ptr[ip + 3];
+				GD_ERR_BREAK(op >= Variant::OP_MAX);
+				int getter_cache_idx = _code_ptr[ip + 4];
+				GD_ERR_BREAK(getter_cache_idx < 0 || getter_cache_idx >= _inline_caches_count);
+				int setter_cache_idx = _code_ptr[ip + 5];
+				GD_ERR_BREAK(setter_cache_idx < 0 || setter_cache_idx >= _inline_caches_count);
+
+				Object *owner = p_instance->owner;
+
+				Variant member;
+				MethodBind *getter = _get_cached_property_accessor(&_inline_caches_ptr[getter_cache_idx], owner, *index, false);
+				if (getter) {
+					Callable::CallError ce;
+					member = getter->call(owner, nullptr, 0, ce);
+				} else {
+#ifndef DEBUG_ENABLED
+					ClassDB::get_property(owner, *index, member);
+#else
+					bool ok = ClassDB::get_property(owner, *index, member);
+					if (!ok) {
+						err_text = "Internal error getting property: " + String(*index);
+						OPCODE_BREAK;
+					}
+#endif
+				}
+
+				bool valid;
+				Variant result;
+				Variant::evaluate(op, member, *value, result, valid);
+#ifdef DEBUG_ENABLED
+				if (!valid) {
+					if (result.get_type() == Variant::STRING) {
+						//return a string when invalid with the error
+						err_text = result;
+						err_text += " in operator '" + Variant::get_operator_name(op) + "'.";
+					} else {
+						err_text = "Invalid operands '" + Variant::get_type_name(member.get_type()) + "' and '" + Variant::get_type_name(value->get_type()) + "' in operator '" + Variant::get_operator_name(op) + "'.";
+					}
+					OPCODE_BREAK;
+				}
+				bool ok = true;
+#endif
+
+				MethodBind *setter = _get_cached_property_accessor(&_inline_caches_ptr[setter_cache_idx], owner, *index, true);
+				if (setter) {
+					Callable::CallError ce;
+					const Variant *arg = &result;
+					setter->call(owner, &arg, 1, ce);
+					valid = ce.error == Callable::CallError::CALL_OK;
+				} else {
+#ifndef DEBUG_ENABLED
+					ClassDB::set_property(owner, *index, result, &valid);
+#else
+					ok = ClassDB::set_property(owner, *index, result, &valid);
+#endif
+				}
+#ifdef DEBUG_ENABLED
 				if (!ok) {
-					err_text = "Internal error getting property: " + String(*index);
+					err_text = "Internal error setting property: " + String(*index);
+					OPCODE_BREAK;
+				} else if (!valid) {
+					err_text = "Error setting property '" + String(*index) + "' with value of type " + Variant::get_type_name(result.get_type()) + ".";
 					OPCODE_BREAK;
 				}
 #endif
-				ip += 3;
+				ip += 6;
 			}
 			DISPATCH_OPCODE;
 
@@ -1424,17 +1765,26 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 				ip += instr_arg_count;
 
 				int argc = _code_ptr[ip + 1];
-				Array array;
-				array.resize(argc);
+				GET_INSTRUCTION_ARG(dst, argc);
 
-				for (int i = 0; i < argc; i++) {
-					array[i] = *(instruction_args[i]);
-				}
+				Array *reused = _get_reusable_array(dst, instruction_args, argc);
+				if (reused && !reused->is_typed()) {
+					reused->resize(argc);
+					for (int i = 0; i < argc; i++) {
+						(*reused)[i] = *(instruction_args[i]);
+					}
+				} else {
+					Array array;
+					array.resize(argc);
 
-				GET_INSTRUCTION_ARG(dst, argc);
-				*dst = Variant(); // Clear potential previous typed array.
+					for (int i = 0; i < argc; i++) {
+						array[i] = *(instruction_args[i]);
+					}
+
+					*dst = Variant(); // Clear potential previous typed array.
 
-				*dst = array;
+					*dst = array;
+				}
 
 				ip += 2;
 			}
@@ -1452,18 +1802,27 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 				GD_ERR_BREAK(native_type_idx < 0 || native_type_idx >= _global_names_count);
 				const StringName native_type = _global_names_ptr[native_type_idx];
 
-				Array array;
-				array.set_typed(builtin_type, native_type, *script_type);
-				array.resize(argc);
+				GET_INSTRUCTION_ARG(dst, argc);
 
-				for (int i = 0; i < argc; i++) {
-					array[i] = *(instruction_args[i]);
-				}
+				Array *reused = _get_reusable_array(dst, instruction_args, argc);
+				if (reused && reused->get_typed_builtin() == (uint32_t)builtin_type && reused->get_typed_class_name() == native_type && reused->get_typed_script() == *script_type) {
+					reused->resize(argc);
+					for (int i = 0; i < argc; i++) {
+						(*reused)[i] = *(instruction_args[i]);
+					}
+				} else {
+					Array array;
+					array.set_typed(builtin_type, native_type, *script_type);
+					array.resize(argc);
 
-				GET_INSTRUCTION_ARG(dst, argc);
-				*dst = Variant(); // Clear potential previous typed array.
+					for (int i = 0; i < argc; i++) {
+						array[i] = *(instruction_args[i]);
+					}
 
-				*dst = array;
+					*dst = Variant(); // Clear potential previous typed array.
+
+					*dst = array;
+				}
 
 				ip += 4;
 			}
@@ -1475,17 +1834,27 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 				ip += instr_arg_count;
 
 				int argc = _code_ptr[ip + 1];
-				Dictionary dict;
+				GET_INSTRUCTION_ARG(dst, argc * 2);
 
-				for (int i = 0; i < argc; i++) {
-					GET_INSTRUCTION_ARG(k, i * 2 + 0);
-					GET_INSTRUCTION_ARG(v, i * 2 + 1);
-					dict[*k] = *v;
-				}
+				Dictionary *reused = _get_reusable_dictionary(dst, instruction_args, argc * 2);
+				if (reused) {
+					reused->clear();
+					for (int i = 0; i < argc; i++) {
+						GET_INSTRUCTION_ARG(k, i * 2 + 0);
+						GET_INSTRUCTION_ARG(v, i * 2 + 1);
+						(*reused)[*k] = *v;
+					}
+				} else {
+					Dictionary dict;
 
-				GET_INSTRUCTION_ARG(dst, argc * 2);
+					for (int i = 0; i < argc; i++) {
+						GET_INSTRUCTION_ARG(k, i * 2 + 0);
+						GET_INSTRUCTION_ARG(v, i * 2 + 1);
+						dict[*k] = *v;
+					}
 
-				*dst = dict;
+					*dst = dict;
+				}
 
 				ip += 2;
 			}
@@ -1494,7 +1863,7 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 			OPCODE(OPCODE_CALL_ASYNC)
 			OPCODE(OPCODE_CALL_RETURN)
 			OPCODE(OPCODE_CALL) {
-				CHECK_SPACE(3 + instr_arg_count);
+				CHECK_SPACE(4 + instr_arg_count);
 				bool call_ret = (_code_ptr[ip] & INSTR_MASK) != OPCODE_CALL;
 #ifdef DEBUG_ENABLED
 				bool call_async = (_code_ptr[ip] & INSTR_MASK) == OPCODE_CALL_ASYNC;
@@ -1509,6 +1878,10 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 				GD_ERR_BREAK(methodname_idx < 0 || methodname_idx >= _global_names_count);
 				const StringName *methodname = &_global_names_ptr[methodname_idx];
 
+				int cache_idx = _code_ptr[ip + 3];
+				GD_ERR_BREAK(cache_idx >= _inline_caches_count);
+				InlineCache *cache = cache_idx < 0 ? nullptr : &_inline_caches_ptr[cache_idx];
+
 				GET_INSTRUCTION_ARG(base, argc);
 				Variant **argptrs = instruction_args;
 
@@ -1523,7 +1896,9 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 				Callable::CallError err;
 				if (call_ret) {
 					GET_INSTRUCTION_ARG(ret, argc + 1);
-					base->callp(*methodname, (const Variant **)argptrs, argc, *ret, err);
+					if (!cache || !_call_cached(cache, base, *methodname, (const Variant **)argptrs, argc, *ret, err)) {
+						base->callp(*methodname, (const Variant **)argptrs, argc, *ret, err);
+					}
 #ifdef DEBUG_ENABLED
 					if (!call_async && ret->get_type() == Variant::OBJECT) {
 						// Check if getting a function state without await.
@@ -1542,7 +1917,9 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 #endif
 				} else {
 					Variant ret;
-					base->callp(*methodname, (const Variant **)argptrs, argc, ret, err);
+					if (!cache || !_call_cached(cache, base, *methodname, (const Variant **)argptrs, argc, ret, err)) {
+						base->callp(*methodname, (const Variant **)argptrs, argc, ret, err);
+					}
 				}
 #ifdef DEBUG_ENABLED
 				if (GDScriptLanguage::get_singleton()->profiling) {
@@ -1587,7 +1964,7 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 				}
 #endif
 
-				ip += 3;
+				ip += 4;
 			}
 			DISPATCH_OPCODE;
 
@@ -3441,6 +3818,10 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 	}
 
 	OPCODES_OUT
+	if (sampled) {
+		GDScriptSamplingProfiler::pop(&line);
+	}
+
 #ifdef DEBUG_ENABLED
 	if (GDScriptLanguage::get_singleton()->profiling) {
 		uint64_t time_taken = OS::get_singleton()->get_ticks_usec() - function_start_time;
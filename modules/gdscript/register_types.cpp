@@ -85,7 +85,19 @@ public:
 			return;
 		}
 
-		// TODO: Re-add compiled GDScript on export.
+		if (script_mode == EditorExportPreset::MODE_SCRIPT_COMPILED) {
+			Ref<GDScript> script = ResourceLoader::load(p_path, "GDScript");
+			if (script.is_valid()) {
+				Vector<uint8_t> bytecode = script->get_as_byte_code();
+				// Scripts that can't be stored as bytecode are exported as text.
+				if (!bytecode.is_empty()) {
+					add_file(p_path.get_basename() + ".gdc", bytecode, true);
+				}
+			}
+			return;
+		}
+
+		// TODO: Re-add encrypted GDScript on export.
 		return;
 	}
 };
@@ -31,6 +31,12 @@
 #ifndef GDSCRIPT_TEST_RUNNER_SUITE_H
 #define GDSCRIPT_TEST_RUNNER_SUITE_H
 
+#include "../gdscript_bytecode_format.h"
+#include "../gdscript_cache.h"
+#include "../gdscript_numeric_tier.h"
+#include "../gdscript_sampling_profiler.h"
+#include "core/io/file_access.h"
+#include "core/os/os.h"
 #include "gdscript_test_runner.h"
 #include "tests/test_macros.h"
 
@@ -69,6 +75,225 @@ func _init():
 	CHECK_MESSAGE(int(ref_counted->get_meta("result")) == 42, "The script should assign object metadata successfully.");
 }
 
+TEST_CASE("[Modules][GDScript] Store compiled script as bytecode and run it") {
+	Ref<GDScript> gdscript = memnew(GDScript);
+	gdscript->set_source_code(R"(
+extends RefCounted
+
+const VALUES = [1, 2, 3]
+
+class Inner:
+	var factor := 2
+
+	func scale(value: int) -> int:
+		return value * factor
+
+func _init():
+	var inner := Inner.new()
+	var total := 0
+	for value in VALUES:
+		total += inner.scale(value)
+	set_meta("result", total)
+
+	var add_one = func(value): return value + 1
+	set_meta("lambda_result", add_one.call(41))
+)");
+	ERR_PRINT_OFF;
+	const Error error = gdscript->reload();
+	ERR_PRINT_ON;
+	REQUIRE_MESSAGE(error == OK, "The script should parse successfully.");
+
+	const Vector<uint8_t> bytecode = gdscript->get_as_byte_code();
+	REQUIRE_MESSAGE(!bytecode.is_empty(), "The compiled script should be stored as bytecode.");
+
+	String source;
+	CHECK(GDScriptBytecodeFormat::get_source(bytecode, source) == OK);
+	CHECK_MESSAGE(source == gdscript->get_source_code(), "The bytecode should embed the script source.");
+
+	Ref<GDScript> loaded = memnew(GDScript);
+	REQUIRE_MESSAGE(GDScriptBytecodeFormat::deserialize(bytecode, loaded.ptr()) == OK, "The bytecode should load back.");
+	CHECK(loaded->is_valid());
+	CHECK(loaded->get_subclasses().has("Inner"));
+
+	Ref<RefCounted> ref_counted = memnew(RefCounted);
+	ref_counted->set_script(loaded);
+	CHECK_MESSAGE(int(ref_counted->get_meta("result")) == 12, "The loaded script should run like the compiled one.");
+	CHECK_MESSAGE(int(ref_counted->get_meta("lambda_result")) == 42, "Lambdas should be stored with their function.");
+
+	// Bytecode from another engine build is rejected, but its source stays readable.
+	Vector<uint8_t> mismatched = bytecode;
+	mismatched.write[8] ^= 0xFF;
+	Ref<GDScript> rejected = memnew(GDScript);
+	CHECK(GDScriptBytecodeFormat::deserialize(mismatched, rejected.ptr()) == ERR_FILE_UNRECOGNIZED);
+	CHECK(GDScriptBytecodeFormat::get_source(mismatched, source) == OK);
+	CHECK(source == gdscript->get_source_code());
+}
+
+static void write_script(const String &p_path, const String &p_source) {
+	Ref<FileAccess> file = FileAccess::open(p_path, FileAccess::WRITE);
+	REQUIRE(file.is_valid());
+	file->store_string(p_source);
+}
+
+TEST_CASE("[Modules][GDScript] Cache keeps analyzed parsers until their sources change") {
+	const String base_path = OS::get_singleton()->get_cache_path().plus_file("gdscript_cache_base.gd");
+	const String derived_path = OS::get_singleton()->get_cache_path().plus_file("gdscript_cache_derived.gd");
+	write_script(base_path, "extends RefCounted\n\nfunc value() -> int:\n\treturn 1\n");
+	write_script(derived_path, "extends \"gdscript_cache_base.gd\"\n\nfunc twice() -> int:\n\treturn value() * 2\n");
+
+	Error err;
+	Ref<GDScriptParserRef> derived = GDScriptCache::get_parser(derived_path, GDScriptParserRef::INTERFACE_SOLVED, err);
+	REQUIRE(err == OK);
+	Ref<GDScriptParserRef> base = GDScriptCache::get_parser(base_path, GDScriptParserRef::EMPTY, err);
+	REQUIRE(base.is_valid());
+	CHECK_MESSAGE(base->get_status() >= GDScriptParserRef::PARSED, "Dependencies should be parsed along with the script.");
+
+	GDScriptCache::check_for_changes();
+	CHECK_MESSAGE(GDScriptCache::get_parser(derived_path, GDScriptParserRef::EMPTY, err) == derived, "Unchanged scripts should keep their analysis.");
+
+	write_script(base_path, "extends RefCounted\n\nfunc value() -> int:\n\treturn 2\n");
+	GDScriptCache::check_for_changes();
+	CHECK_MESSAGE(GDScriptCache::get_parser(derived_path, GDScriptParserRef::EMPTY, err) != derived, "Changing a script should invalidate the scripts depending on it.");
+	CHECK(GDScriptCache::get_parser(base_path, GDScriptParserRef::EMPTY, err) != base);
+}
+
+TEST_CASE("[Modules][GDScript] Sampling profiler records running functions") {
+	Ref<GDScript> gdscript = memnew(GDScript);
+	gdscript->set_source_code(R"(
+extends RefCounted
+
+func spin(count: int) -> String:
+	var text := ""
+	for i in count:
+		text = str(i)
+	return text
+)");
+	ERR_PRINT_OFF;
+	const Error error = gdscript->reload();
+	ERR_PRINT_ON;
+	REQUIRE_MESSAGE(error == OK, "The script should parse successfully.");
+
+	Ref<RefCounted> object = memnew(RefCounted);
+	object->set_script(gdscript);
+
+	GDScriptSamplingProfiler *profiler = GDScriptSamplingProfiler::get_singleton();
+	REQUIRE(profiler);
+	REQUIRE(profiler->start(100) == OK);
+	const uint64_t begin = OS::get_singleton()->get_ticks_msec();
+	while (profiler->get_sample_count() < 10 && OS::get_singleton()->get_ticks_msec() - begin < 5000) {
+		object->call("spin", 10000);
+	}
+	profiler->stop();
+	REQUIRE_MESSAGE(profiler->get_sample_count() >= 10, "The profiler should record samples while the script runs.");
+
+	const String collapsed = profiler->get_collapsed_stacks();
+	CHECK_MESSAGE(collapsed.begins_with("Main Thread;spin (<built-in>:"), "Stacks should start with the thread and name the function.");
+	const bool in_loop = collapsed.contains(":6) ") || collapsed.contains(":7) ");
+	CHECK_MESSAGE(in_loop, "Samples should point at the lines of the loop.");
+
+	const String trace = profiler->get_chrome_trace();
+	CHECK(trace.contains("\"stackFrames\""));
+	CHECK(trace.contains("\"samples\""));
+
+	profiler->clear();
+	CHECK(profiler->get_sample_count() == 0);
+}
+
+TEST_CASE_PENDING("[Modules][GDScript] Numeric tier benchmark") {
+	// Microbenchmark, run with `--test --no-skip`.
+	Ref<GDScript> gdscript = memnew(GDScript);
+	gdscript->set_source_code(R"(
+extends RefCounted
+
+func loop_sum(n: int) -> int:
+	var total := 0
+	for i in n:
+		total += i * i % 7
+	return total
+
+func fibonacci(n: int) -> int:
+	var a := 0
+	var b := 1
+	for _i in n:
+		var next := (a + b) % 1000000007
+		a = b
+		b = next
+	return a
+
+@warning_ignore(integer_division)
+func collatz(limit: int) -> int:
+	var longest := 0
+	for start in limit:
+		var n := start + 1
+		var steps := 0
+		while n != 1:
+			if n % 2 == 0:
+				n = n / 2
+			else:
+				n = 3 * n + 1
+			steps += 1
+		longest = maxi(longest, steps)
+	return longest
+
+func mandelbrot(size: int) -> int:
+	var inside := 0
+	for py in size:
+		for px in size:
+			var x0 := px * 3.0 / size - 2.0
+			var y0 := py * 2.0 / size - 1.0
+			var x := 0.0
+			var y := 0.0
+			var iteration := 0
+			while x * x + y * y <= 4.0 and iteration < 64:
+				var next_x := x * x - y * y + x0
+				y = 2.0 * x * y + y0
+				x = next_x
+				iteration += 1
+			if iteration == 64:
+				inside += 1
+	return inside
+)");
+	ERR_PRINT_OFF;
+	const Error error = gdscript->reload();
+	ERR_PRINT_ON;
+	REQUIRE_MESSAGE(error == OK, "The script should parse successfully.");
+
+	Ref<RefCounted> object = memnew(RefCounted);
+	object->set_script(gdscript);
+
+	struct Benchmark {
+		const char *method;
+		int argument;
+	};
+	const Benchmark benchmarks[] = {
+		{ "loop_sum", 5000000 },
+		{ "fibonacci", 5000000 },
+		{ "collatz", 100000 },
+		{ "mandelbrot", 400 },
+	};
+
+	const bool was_enabled = GDScriptNumericTier::is_enabled();
+	for (const Benchmark &benchmark : benchmarks) {
+		GDScriptNumericTier::set_enabled(false);
+		uint64_t begin = OS::get_singleton()->get_ticks_usec();
+		const Variant interpreted = object->call(benchmark.method, benchmark.argument);
+		const uint64_t interpreter_usec = OS::get_singleton()->get_ticks_usec() - begin;
+
+		// Cheap calls to make the function hot.
+		GDScriptNumericTier::set_enabled(true);
+		for (int i = 0; i < GDScriptNumericTier::HOT_CALL_COUNT; i++) {
+			object->call(benchmark.method, 1);
+		}
+		begin = OS::get_singleton()->get_ticks_usec();
+		const Variant tiered = object->call(benchmark.method, benchmark.argument);
+		const uint64_t tier_usec = OS::get_singleton()->get_ticks_usec() - begin;
+
+		CHECK_MESSAGE(interpreted == tiered, "Both tiers should compute the same result.");
+		MESSAGE(benchmark.method, ": interpreter ", interpreter_usec, " usec, numeric tier ", tier_usec, " usec.");
+	}
+	GDScriptNumericTier::set_enabled(was_enabled);
+}
+
 } // namespace GDScriptTests
 
 #endif // GDSCRIPT_TEST_RUNNER_SUITE_H
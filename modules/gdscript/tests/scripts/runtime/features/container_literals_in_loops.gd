@@ -0,0 +1,46 @@
+func test():
+	# Literals that escape the loop must stay distinct.
+	var kept := []
+	for i in 3:
+		kept.append([i, i + 1])
+	print(kept)
+
+	var dicts := []
+	for i in 3:
+		var d := {"index": i}
+		if i != 1:
+			dicts.append(d)
+	print(dicts)
+
+	var typed_arrays := []
+	for i in 2:
+		var typed: Array[int] = [i, i * 2]
+		typed_arrays.append(typed)
+	print(typed_arrays)
+
+	# Literals only used by the loop are refilled on each run.
+	var total := 0
+	for i in 4:
+		for value in [i, i * 2, i * 3]:
+			total += value
+	print(total)
+
+	var found := -1
+	for i in 3:
+		for value in [i, 10]:
+			if value == 10:
+				break
+			found = value
+	print(found)
+
+	var keys := ""
+	for i in 2:
+		for key in {"x": i, "y": i}:
+			keys += key + str(i)
+	print(keys)
+
+	var names := ""
+	for _round in 2:
+		for name in ["a", "b", 3]:
+			names += str(name)
+	print(names)
@@ -0,0 +1,72 @@
+# Hot functions that only use int, float and bool run in the numeric tier
+# after a few calls. Results must match the interpreter exactly.
+func sum_to(n: int) -> int:
+	var total := 0
+	for i in n:
+		total += i
+	return total
+
+@warning_ignore(integer_division)
+func collatz_steps(start: int) -> int:
+	var n := start
+	var steps := 0
+	while n != 1:
+		if n % 2 == 0:
+			n = n / 2
+		else:
+			n = 3 * n + 1
+		steps += 1
+	return steps
+
+func fibonacci(n: int) -> int:
+	var a := 0
+	var b := 1
+	for _i in n:
+		var next := a + b
+		a = b
+		b = next
+	return a
+
+func average(a: float, b: int) -> float:
+	return (a + b) / 2
+
+func length(x: float, y: float) -> float:
+	return sqrt(x * x + y * y)
+
+func is_inside(x: float, y: float, radius: float) -> bool:
+	return x * x + y * y <= radius * radius and not (x == 0.0 and y == 0.0)
+
+# The divisor isn't constant, so this one stays in the interpreter.
+@warning_ignore(integer_division)
+func divide(a: int, b: int) -> int:
+	return a / b
+
+func test():
+	var sums := 0
+	var steps := 0
+	var averages := 0.0
+	var lengths := 0.0
+	var quotients := 0
+	for i in 100:
+		sums += sum_to(i)
+		steps += collatz_steps(i + 1)
+		averages += average(i * 0.5, i)
+		lengths += length(3.0, 4)
+		quotients += divide(1000, i + 1)
+	print(sums)
+	print(steps)
+	print(int(averages * 2))
+	print(lengths == 500.0)
+	print(quotients)
+
+	var inside := 0
+	for x in 11:
+		for y in 11:
+			if is_inside(x - 5, y - 5, 3.0):
+				inside += 1
+	print(inside)
+
+	var fibonacci_sum := 0
+	for i in 80:
+		fibonacci_sum += fibonacci(i)
+	print(fibonacci_sum)
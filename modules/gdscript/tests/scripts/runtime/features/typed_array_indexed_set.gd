@@ -0,0 +1,10 @@
+func test():
+	var ints: Array[int] = [1, 2, 3]
+	for i in ints.size():
+		ints[i] = ints[i] * 10
+	print(ints)
+
+	var untyped: Array = [1, "a"]
+	untyped[1] = Vector2(1, 2)
+	untyped[-2] = "b"
+	print(untyped)
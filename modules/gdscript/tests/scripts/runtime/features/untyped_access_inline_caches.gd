@@ -0,0 +1,37 @@
+# Untyped named accesses and calls go through per-callsite caches, so the
+# same call site sees several receiver types here, more than it can cache.
+func get_name_of(object):
+	return object.name
+
+func set_name_of(object, value):
+	object.name = value
+
+func get_x(vector):
+	return vector.x
+
+func test():
+	var objects = [Node.new(), Node2D.new(), Node3D.new(), Timer.new()]
+	for i in 2:
+		for object in objects:
+			set_name_of(object, object.get_class() + str(i))
+			print(get_name_of(object))
+			print(object.get_child_count())
+	for object in objects:
+		object.free()
+
+	var vectors = [Vector2(1, 2), Vector3(3, 4, 5), Vector2i(6, 7), Vector3i(8, 9, 10), Vector2(11, 12)]
+	for vector in vectors:
+		print(get_x(vector))
+
+	var value = Vector2(1, 2)
+	value.x = 5
+	value.y = value.x
+	print(value)
+
+	var count = 0
+	var i = 0
+	while i < 5:
+		if i % 2 == 0:
+			count += 1
+		i += 1
+	print(count)
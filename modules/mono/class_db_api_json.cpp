@@ -66,10 +66,8 @@ void class_db_api_to_json(const String &p_output_file, ClassDB::APIType p_api) {
 
 			List<StringName> snames;
 
-			k = nullptr;
-
-			while ((k = t->method_map.next(k))) {
-				String name = k->operator String();
+			for (OAHashMap<StringName, MethodBind *>::Iterator it = t->method_map.iter(); it.valid; it = t->method_map.next_iter(it)) {
+				String name = it.key->operator String();
 
 				ERR_CONTINUE(name.is_empty());
 
@@ -77,7 +75,7 @@ void class_db_api_to_json(const String &p_output_file, ClassDB::APIType p_api) {
 					continue; // Ignore non-virtual methods that start with an underscore
 				}
 
-				snames.push_back(*k);
+				snames.push_back(*it.key);
 			}
 
 			snames.sort_custom<StringName::AlphCompare>();
@@ -88,7 +86,7 @@ void class_db_api_to_json(const String &p_output_file, ClassDB::APIType p_api) {
 				Dictionary method_dict;
 				methods.push_back(method_dict);
 
-				MethodBind *mb = t->method_map[F];
+				MethodBind *mb = *t->method_map.lookup_ptr(F);
 				method_dict["name"] = mb->get_name();
 				method_dict["argument_count"] = mb->get_argument_count();
 				method_dict["return_type"] = mb->get_argument_type(-1);
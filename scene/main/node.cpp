@@ -206,8 +206,9 @@ void Node::_propagate_enter_tree() {
 
 	data.inside_tree = true;
 
-	for (KeyValue<StringName, GroupData> &E : data.grouped) {
-		E.value.group = data.tree->add_to_group(E.key, this);
+	VMap<StringName, GroupData>::Pair *groups = data.grouped.get_array();
+	for (int i = 0; i < data.grouped.size(); i++) {
+		groups[i].value.group = data.tree->add_to_group(groups[i].key, this);
 	}
 
 	notification(NOTIFICATION_ENTER_TREE);
@@ -305,9 +306,10 @@ void Node::_propagate_exit_tree() {
 
 	// exit groups
 
-	for (KeyValue<StringName, GroupData> &E : data.grouped) {
-		data.tree->remove_from_group(E.key, this);
-		E.value.group = nullptr;
+	VMap<StringName, GroupData>::Pair *groups = data.grouped.get_array();
+	for (int i = 0; i < data.grouped.size(); i++) {
+		data.tree->remove_from_group(groups[i].key, this);
+		groups[i].value.group = nullptr;
 	}
 
 	data.viewport = nullptr;
@@ -384,9 +386,10 @@ void Node::_move_child(Node *p_child, int p_pos, bool p_ignore_end) {
 	for (int i = motion_from; i <= motion_to; i++) {
 		data.children[i]->notification(NOTIFICATION_MOVED_IN_PARENT);
 	}
-	for (const KeyValue<StringName, GroupData> &E : p_child->data.grouped) {
-		if (E.value.group) {
-			E.value.group->changed = true;
+	const VMap<StringName, GroupData>::Pair *groups = p_child->data.grouped.get_array();
+	for (int i = 0; i < p_child->data.grouped.size(); i++) {
+		if (groups[i].value.group) {
+			groups[i].value.group->changed = true;
 		}
 	}
 
@@ -816,6 +819,11 @@ int Node::get_process_priority() const {
 	return data.process_priority;
 }
 
+void Node::set_process_thread_group(int p_group) {
+	ERR_FAIL_COND(p_group < 0);
+	data.process_thread_group = p_group;
+}
+
 void Node::set_process_input(bool p_enable) {
 	if (p_enable == data.input) {
 		return;
@@ -1304,15 +1312,15 @@ Node *Node::get_node_or_null(const NodePath &p_path) const {
 			}
 
 		} else if (name.is_node_unique_name()) {
-			if (current->data.owned_unique_nodes.size()) {
+			if (!current->data.owned_unique_nodes.is_empty()) {
 				// Has unique nodes in ownership
-				Node **unique = current->data.owned_unique_nodes.getptr(name);
+				Node **unique = current->data.owned_unique_nodes.lookup_ptr(name);
 				if (!unique) {
 					return nullptr;
 				}
 				next = *unique;
 			} else if (current->data.owner) {
-				Node **unique = current->data.owner->data.owned_unique_nodes.getptr(name);
+				Node **unique = current->data.owner->data.owned_unique_nodes.lookup_ptr(name);
 				if (!unique) {
 					return nullptr;
 				}
@@ -1549,17 +1557,17 @@ void Node::_set_owner_nocheck(Node *p_owner) {
 void Node::_release_unique_name_in_owner() {
 	ERR_FAIL_NULL(data.owner); // Sanity check.
 	StringName key = StringName(UNIQUE_NODE_PREFIX + data.name.operator String());
-	Node **which = data.owner->data.owned_unique_nodes.getptr(key);
+	Node **which = data.owner->data.owned_unique_nodes.lookup_ptr(key);
 	if (which == nullptr || *which != this) {
 		return; // Ignore.
 	}
-	data.owner->data.owned_unique_nodes.erase(key);
+	data.owner->data.owned_unique_nodes.remove(key);
 }
 
 void Node::_acquire_unique_name_in_owner() {
 	ERR_FAIL_NULL(data.owner); // Sanity check.
 	StringName key = StringName(UNIQUE_NODE_PREFIX + data.name.operator String());
-	Node **which = data.owner->data.owned_unique_nodes.getptr(key);
+	Node **which = data.owner->data.owned_unique_nodes.lookup_ptr(key);
 	if (which != nullptr && *which != this) {
 		String which_path = is_inside_tree() ? (*which)->get_path() : data.owner->get_path_to(*which);
 		WARN_PRINT(vformat(RTR("Setting node name '%s' to be unique within scene for '%s', but it's already claimed by '%s'.\n'%s' is no longer set as having a unique name."),
@@ -1567,7 +1575,7 @@ void Node::_acquire_unique_name_in_owner() {
 		data.unique_name_in_owner = false;
 		return;
 	}
-	data.owner->data.owned_unique_nodes[key] = this;
+	data.owner->data.owned_unique_nodes.set(key, this);
 }
 
 void Node::set_unique_name_in_owner(bool p_enabled) {
@@ -1757,21 +1765,17 @@ void Node::add_to_group(const StringName &p_identifier, bool p_persistent) {
 
 	gd.persistent = p_persistent;
 
-	data.grouped[p_identifier] = gd;
+	data.grouped.insert(p_identifier, gd);
 }
 
 void Node::remove_from_group(const StringName &p_identifier) {
 	ERR_FAIL_COND(!data.grouped.has(p_identifier));
 
-	Map<StringName, GroupData>::Element *E = data.grouped.find(p_identifier);
-
-	ERR_FAIL_COND(!E);
-
 	if (data.tree) {
-		data.tree->remove_from_group(E->key(), this);
+		data.tree->remove_from_group(p_identifier, this);
 	}
 
-	data.grouped.erase(E);
+	data.grouped.erase(p_identifier);
 }
 
 Array Node::_get_groups() const {
@@ -1786,10 +1790,11 @@ Array Node::_get_groups() const {
 }
 
 void Node::get_groups(List<GroupInfo> *p_groups) const {
-	for (const KeyValue<StringName, GroupData> &E : data.grouped) {
+	const VMap<StringName, GroupData>::Pair *groups = data.grouped.get_array();
+	for (int i = 0; i < data.grouped.size(); i++) {
 		GroupInfo gi;
-		gi.name = E.key;
-		gi.persistent = E.value.persistent;
+		gi.name = groups[i].key;
+		gi.persistent = groups[i].value.persistent;
 		p_groups->push_back(gi);
 	}
 }
@@ -1797,8 +1802,9 @@ void Node::get_groups(List<GroupInfo> *p_groups) const {
 int Node::get_persistent_group_count() const {
 	int count = 0;
 
-	for (const KeyValue<StringName, GroupData> &E : data.grouped) {
-		if (E.value.persistent) {
+	const VMap<StringName, GroupData>::Pair *groups = data.grouped.get_array();
+	for (int i = 0; i < data.grouped.size(); i++) {
+		if (groups[i].value.persistent) {
 			count += 1;
 		}
 	}
@@ -2131,9 +2137,9 @@ Node *Node::_duplicate(int p_flags, Map<const Node *, Node *> *r_duplimap) const
 
 	StringName script_property_name = CoreStringNames::get_singleton()->_script;
 
-	List<const Node *> hidden_roots;
-	List<const Node *> node_tree;
-	node_tree.push_front(this);
+	LocalVector<const Node *> hidden_roots;
+	LocalVector<const Node *> node_tree;
+	node_tree.push_back(this);
 
 	if (instantiated) {
 		// Since nodes in the instantiated hierarchy won't be duplicated explicitly, we need to make an inventory
@@ -2142,9 +2148,10 @@ Node *Node::_duplicate(int p_flags, Map<const Node *, Node *> *r_duplimap) const
 		Vector<const Node *> instance_roots;
 		instance_roots.push_back(this);
 
-		for (List<const Node *>::Element *N = node_tree.front(); N; N = N->next()) {
-			for (int i = 0; i < N->get()->get_child_count(); ++i) {
-				Node *descendant = N->get()->get_child(i);
+		for (uint32_t n = 0; n < node_tree.size(); n++) {
+			const Node *N = node_tree[n];
+			for (int i = 0; i < N->get_child_count(); ++i) {
+				Node *descendant = N->get_child(i);
 				// Skip nodes not really belonging to the instantiated hierarchy; they'll be processed normally later
 				// but remember non-instantiated nodes that are hidden below instantiated ones
 				if (!instance_roots.has(descendant->get_owner())) {
@@ -2163,20 +2170,21 @@ Node *Node::_duplicate(int p_flags, Map<const Node *, Node *> *r_duplimap) const
 		}
 	}
 
-	for (List<const Node *>::Element *N = node_tree.front(); N; N = N->next()) {
-		Node *current_node = node->get_node(get_path_to(N->get()));
+	for (uint32_t n = 0; n < node_tree.size(); n++) {
+		const Node *N = node_tree[n];
+		Node *current_node = node->get_node(get_path_to(N));
 		ERR_CONTINUE(!current_node);
 
 		if (p_flags & DUPLICATE_SCRIPTS) {
 			bool is_valid = false;
-			Variant script = N->get()->get(script_property_name, &is_valid);
+			Variant script = N->get(script_property_name, &is_valid);
 			if (is_valid) {
 				current_node->set(script_property_name, script);
 			}
 		}
 
 		List<PropertyInfo> plist;
-		N->get()->get_property_list(&plist);
+		N->get_property_list(&plist);
 
 		for (const PropertyInfo &E : plist) {
 			if (!(E.usage & PROPERTY_USAGE_STORAGE)) {
@@ -2187,7 +2195,7 @@ Node *Node::_duplicate(int p_flags, Map<const Node *, Node *> *r_duplimap) const
 				continue;
 			}
 
-			Variant value = N->get()->get(name).duplicate(true);
+			Variant value = N->get(name).duplicate(true);
 
 			if (E.usage & PROPERTY_USAGE_DO_NOT_SHARE_ON_DUPLICATE) {
 				Resource *res = Object::cast_to<Resource>(value);
@@ -2245,7 +2253,8 @@ Node *Node::_duplicate(int p_flags, Map<const Node *, Node *> *r_duplimap) const
 		}
 	}
 
-	for (const Node *&E : hidden_roots) {
+	for (uint32_t n = 0; n < hidden_roots.size(); n++) {
+		const Node *E = hidden_roots[n];
 		Node *parent = node->get_node(get_path_to(E->data.parent));
 		if (!parent) {
 			memdelete(node);
@@ -2828,6 +2837,8 @@ void Node::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("set_process", "enable"), &Node::set_process);
 	ClassDB::bind_method(D_METHOD("set_process_priority", "priority"), &Node::set_process_priority);
 	ClassDB::bind_method(D_METHOD("get_process_priority"), &Node::get_process_priority);
+	ClassDB::bind_method(D_METHOD("set_process_thread_group", "group"), &Node::set_process_thread_group);
+	ClassDB::bind_method(D_METHOD("get_process_thread_group"), &Node::get_process_thread_group);
 	ClassDB::bind_method(D_METHOD("is_processing"), &Node::is_processing);
 	ClassDB::bind_method(D_METHOD("set_process_input", "enable"), &Node::set_process_input);
 	ClassDB::bind_method(D_METHOD("is_processing_input"), &Node::is_processing_input);
@@ -2983,6 +2994,7 @@ void Node::_bind_methods() {
 	ADD_GROUP("Process", "process_");
 	ADD_PROPERTY(PropertyInfo(Variant::INT, "process_mode", PROPERTY_HINT_ENUM, "Inherit,Pausable,When Paused,Always,Disabled"), "set_process_mode", "get_process_mode");
 	ADD_PROPERTY(PropertyInfo(Variant::INT, "process_priority"), "set_process_priority", "get_process_priority");
+	ADD_PROPERTY(PropertyInfo(Variant::INT, "process_thread_group", PROPERTY_HINT_RANGE, "0,1024,1,or_greater"), "set_process_thread_group", "get_process_thread_group");
 
 	ADD_GROUP("Editor Description", "editor_");
 	ADD_PROPERTY(PropertyInfo(Variant::STRING, "editor_description", PROPERTY_HINT_MULTILINE_TEXT), "set_editor_description", "get_editor_description");
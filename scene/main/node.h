@@ -33,6 +33,8 @@
 
 #include "core/string/node_path.h"
 #include "core/templates/map.h"
+#include "core/templates/oa_hash_map.h"
+#include "core/templates/vmap.h"
 #include "core/variant/typed_array.h"
 #include "scene/main/scene_tree.h"
 
@@ -99,7 +101,7 @@ private:
 		Node *parent = nullptr;
 		Node *owner = nullptr;
 		Vector<Node *> children;
-		HashMap<StringName, Node *> owned_unique_nodes;
+		OAHashMap<StringName, Node *> owned_unique_nodes;
 		bool unique_name_in_owner = false;
 
 		int internal_children_front = 0;
@@ -119,7 +121,7 @@ private:
 
 		Viewport *viewport = nullptr;
 
-		Map<StringName, GroupData> grouped;
+		VMap<StringName, GroupData> grouped;
 		List<Node *>::Element *OW = nullptr; // Owned element.
 		List<Node *> owned;
 
@@ -134,6 +136,7 @@ private:
 		bool physics_process = false;
 		bool process = false;
 		int process_priority = 0;
+		int process_thread_group = 0; // 0 runs on the main thread.
 
 		bool physics_process_internal = false;
 		bool process_internal = false;
@@ -406,6 +409,9 @@ public:
 	void set_process_priority(int p_priority);
 	int get_process_priority() const;
 
+	void set_process_thread_group(int p_group);
+	_FORCE_INLINE_ int get_process_thread_group() const { return data.process_thread_group; }
+
 	void set_process_input(bool p_enable);
 	bool is_processing_input() const;
 
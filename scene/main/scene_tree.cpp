@@ -40,6 +40,7 @@
 #include "core/object/message_queue.h"
 #include "core/os/keyboard.h"
 #include "core/os/os.h"
+#include "core/os/worker_thread_pool.h"
 #include "core/string/print_string.h"
 #include "node.h"
 #include "scene/animation/tween.h"
@@ -129,32 +130,32 @@ void SceneTree::node_renamed(Node *p_node) {
 }
 
 SceneTree::Group *SceneTree::add_to_group(const StringName &p_group, Node *p_node) {
-	Map<StringName, Group>::Element *E = group_map.find(p_group);
+	Group *E = group_map.getptr(p_group);
 	if (!E) {
-		E = group_map.insert(p_group, Group());
+		E = &group_map.set(p_group, Group())->value();
 	}
 
-	ERR_FAIL_COND_V_MSG(E->get().nodes.has(p_node), &E->get(), "Already in group: " + p_group + ".");
-	E->get().nodes.push_back(p_node);
-	//E->get().last_tree_version=0;
-	E->get().changed = true;
-	return &E->get();
+	ERR_FAIL_COND_V_MSG(E->nodes.has(p_node), E, "Already in group: " + p_group + ".");
+	E->nodes.push_back(p_node);
+	//E->last_tree_version=0;
+	E->changed = true;
+	return E;
 }
 
 void SceneTree::remove_from_group(const StringName &p_group, Node *p_node) {
-	Map<StringName, Group>::Element *E = group_map.find(p_group);
+	Group *E = group_map.getptr(p_group);
 	ERR_FAIL_COND(!E);
 
-	E->get().nodes.erase(p_node);
-	if (E->get().nodes.is_empty()) {
-		group_map.erase(E);
+	E->nodes.erase(p_node);
+	if (E->nodes.is_empty()) {
+		group_map.erase(p_group);
 	}
 }
 
 void SceneTree::make_group_changed(const StringName &p_group) {
-	Map<StringName, Group>::Element *E = group_map.find(p_group);
+	Group *E = group_map.getptr(p_group);
 	if (E) {
-		E->get().changed = true;
+		E->changed = true;
 	}
 }
 
@@ -211,11 +212,11 @@ void SceneTree::_update_group_order(Group &g, bool p_use_priority) {
 }
 
 void SceneTree::call_group_flagsp(uint32_t p_call_flags, const StringName &p_group, const StringName &p_function, const Variant **p_args, int p_argcount) {
-	Map<StringName, Group>::Element *E = group_map.find(p_group);
+	Group *E = group_map.getptr(p_group);
 	if (!E) {
 		return;
 	}
-	Group &g = E->get();
+	Group &g = *E;
 	if (g.nodes.is_empty()) {
 		return;
 	}
@@ -284,11 +285,11 @@ void SceneTree::call_group_flagsp(uint32_t p_call_flags, const StringName &p_gro
 }
 
 void SceneTree::notify_group_flags(uint32_t p_call_flags, const StringName &p_group, int p_notification) {
-	Map<StringName, Group>::Element *E = group_map.find(p_group);
+	Group *E = group_map.getptr(p_group);
 	if (!E) {
 		return;
 	}
-	Group &g = E->get();
+	Group &g = *E;
 	if (g.nodes.is_empty()) {
 		return;
 	}
@@ -335,11 +336,11 @@ void SceneTree::notify_group_flags(uint32_t p_call_flags, const StringName &p_gr
 }
 
 void SceneTree::set_group_flags(uint32_t p_call_flags, const StringName &p_group, const String &p_name, const Variant &p_value) {
-	Map<StringName, Group>::Element *E = group_map.find(p_group);
+	Group *E = group_map.getptr(p_group);
 	if (!E) {
 		return;
 	}
-	Group &g = E->get();
+	Group &g = *E;
 	if (g.nodes.is_empty()) {
 		return;
 	}
@@ -401,6 +402,8 @@ void SceneTree::initialize() {
 }
 
 bool SceneTree::physics_process(double p_time) {
+	MemoryTagScope memory_tag(Memory::TAG_SCENE);
+
 	root_lock++;
 
 	current_frame++;
@@ -430,6 +433,8 @@ bool SceneTree::physics_process(double p_time) {
 }
 
 bool SceneTree::process(double p_time) {
+	MemoryTagScope memory_tag(Memory::TAG_SCENE);
+
 	root_lock++;
 
 	MainLoop::process(p_time);
@@ -818,12 +823,60 @@ bool SceneTree::is_paused() const {
 	return paused;
 }
 
+void SceneTree::_process_thread_group_task(uint32_t p_index, void *p_userdata) {
+	const LocalVector<Node *> &nodes = process_thread_groups[p_index];
+	for (uint32_t i = 0; i < nodes.size(); i++) {
+		nodes[i]->notification(process_thread_notification);
+	}
+}
+
+bool SceneTree::_process_thread_groups(Node **p_nodes, int p_node_count, int p_notification) {
+	process_thread_group_count = 0;
+	process_thread_group_indices.clear();
+
+	for (int i = 0; i < p_node_count; i++) {
+		Node *n = p_nodes[i];
+		int thread_group = n->get_process_thread_group();
+		if (thread_group == 0) {
+			continue;
+		}
+		if (call_lock && call_skip.has(n)) {
+			continue;
+		}
+		if (!n->can_process() || !n->can_process_notification(p_notification)) {
+			continue;
+		}
+
+		uint32_t *index = process_thread_group_indices.lookup_ptr(thread_group);
+		if (!index) {
+			if (process_thread_group_count == process_thread_groups.size()) {
+				process_thread_groups.resize(process_thread_group_count + 1);
+			}
+			process_thread_groups[process_thread_group_count].clear();
+			process_thread_group_indices.insert(thread_group, process_thread_group_count);
+			index = process_thread_group_indices.lookup_ptr(thread_group);
+			process_thread_group_count++;
+		}
+		// Nodes come in priority order, so each bucket keeps it.
+		process_thread_groups[*index].push_back(n);
+	}
+
+	if (process_thread_group_count == 0) {
+		return false;
+	}
+
+	process_thread_notification = p_notification;
+	WorkerThreadPool::TaskID group_task = WorkerThreadPool::get_singleton()->add_template_group_task(this, &SceneTree::_process_thread_group_task, (void *)nullptr, process_thread_group_count);
+	WorkerThreadPool::get_singleton()->wait_for_group_task_completion(group_task);
+	return true;
+}
+
 void SceneTree::_notify_group_pause(const StringName &p_group, int p_notification) {
-	Map<StringName, Group>::Element *E = group_map.find(p_group);
+	Group *E = group_map.getptr(p_group);
 	if (!E) {
 		return;
 	}
-	Group &g = E->get();
+	Group &g = *E;
 	if (g.nodes.is_empty()) {
 		return;
 	}
@@ -839,21 +892,44 @@ void SceneTree::_notify_group_pause(const StringName &p_group, int p_notificatio
 
 	call_lock++;
 
-	for (int i = 0; i < node_count; i++) {
-		Node *n = nodes[i];
-		if (call_lock && call_skip.has(n)) {
-			continue;
+	// Only user processing may be dispatched to thread groups. Nodes are sorted by process priority then,
+	// so each priority runs its thread groups to completion, then its main thread nodes, before the next one.
+	bool dispatch = p_notification == Node::NOTIFICATION_PROCESS || p_notification == Node::NOTIFICATION_PHYSICS_PROCESS;
+
+	int from = 0;
+	while (from < node_count) {
+		int to = node_count;
+		bool threaded = false;
+		if (dispatch) {
+			int priority = nodes[from]->get_process_priority();
+			to = from + 1;
+			while (to < node_count && nodes[to]->get_process_priority() == priority) {
+				to++;
+			}
+			threaded = _process_thread_groups(nodes + from, to - from, p_notification);
 		}
 
-		if (!n->can_process()) {
-			continue;
-		}
-		if (!n->can_process_notification(p_notification)) {
-			continue;
+		for (int i = from; i < to; i++) {
+			Node *n = nodes[i];
+			if (threaded && n->get_process_thread_group() != 0) {
+				continue;
+			}
+			if (call_lock && call_skip.has(n)) {
+				continue;
+			}
+
+			if (!n->can_process()) {
+				continue;
+			}
+			if (!n->can_process_notification(p_notification)) {
+				continue;
+			}
+
+			n->notification(p_notification);
+			//ERR_FAIL_COND(node_count != g.nodes.size());
 		}
 
-		n->notification(p_notification);
-		//ERR_FAIL_COND(node_count != g.nodes.size());
+		from = to;
 	}
 
 	call_lock--;
@@ -863,11 +939,11 @@ void SceneTree::_notify_group_pause(const StringName &p_group, int p_notificatio
 }
 
 void SceneTree::_call_input_pause(const StringName &p_group, CallInputType p_call_type, const Ref<InputEvent> &p_input, Viewport *p_viewport) {
-	Map<StringName, Group>::Element *E = group_map.find(p_group);
+	Group *E = group_map.getptr(p_group);
 	if (!E) {
 		return;
 	}
-	Group &g = E->get();
+	Group &g = *E;
 	if (g.nodes.is_empty()) {
 		return;
 	}
@@ -953,20 +1029,20 @@ int64_t SceneTree::get_frame() const {
 
 Array SceneTree::_get_nodes_in_group(const StringName &p_group) {
 	Array ret;
-	Map<StringName, Group>::Element *E = group_map.find(p_group);
+	Group *E = group_map.getptr(p_group);
 	if (!E) {
 		return ret;
 	}
 
-	_update_group_order(E->get()); //update order just in case
-	int nc = E->get().nodes.size();
+	_update_group_order(*E); //update order just in case
+	int nc = E->nodes.size();
 	if (nc == 0) {
 		return ret;
 	}
 
 	ret.resize(nc);
 
-	Node **ptr = E->get().nodes.ptrw();
+	Node **ptr = E->nodes.ptrw();
 	for (int i = 0; i < nc; i++) {
 		ret[i] = ptr[i];
 	}
@@ -979,32 +1055,32 @@ bool SceneTree::has_group(const StringName &p_identifier) const {
 }
 
 Node *SceneTree::get_first_node_in_group(const StringName &p_group) {
-	Map<StringName, Group>::Element *E = group_map.find(p_group);
+	Group *E = group_map.getptr(p_group);
 	if (!E) {
 		return nullptr; // No group.
 	}
 
-	_update_group_order(E->get()); // Update order just in case.
+	_update_group_order(*E); // Update order just in case.
 
-	if (E->get().nodes.is_empty()) {
+	if (E->nodes.is_empty()) {
 		return nullptr;
 	}
 
-	return E->get().nodes[0];
+	return E->nodes[0];
 }
 
 void SceneTree::get_nodes_in_group(const StringName &p_group, List<Node *> *p_list) {
-	Map<StringName, Group>::Element *E = group_map.find(p_group);
+	Group *E = group_map.getptr(p_group);
 	if (!E) {
 		return;
 	}
 
-	_update_group_order(E->get()); //update order just in case
-	int nc = E->get().nodes.size();
+	_update_group_order(*E); //update order just in case
+	int nc = E->nodes.size();
 	if (nc == 0) {
 		return;
 	}
-	Node **ptr = E->get().nodes.ptrw();
+	Node **ptr = E->nodes.ptrw();
 	for (int i = 0; i < nc; i++) {
 		p_list->push_back(ptr[i]);
 	}
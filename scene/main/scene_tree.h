@@ -33,6 +33,8 @@
 
 #include "core/os/main_loop.h"
 #include "core/os/thread_safe.h"
+#include "core/templates/local_vector.h"
+#include "core/templates/oa_hash_map.h"
 #include "core/templates/self_list.h"
 #include "scene/resources/mesh.h"
 
@@ -102,7 +104,7 @@ private:
 	bool paused = false;
 	int root_lock = 0;
 
-	Map<StringName, Group> group_map;
+	HashMap<StringName, Group> group_map;
 	bool _quit = false;
 	bool initialized = false;
 
@@ -174,6 +176,14 @@ private:
 	void remove_from_group(const StringName &p_group, Node *p_node);
 	void make_group_changed(const StringName &p_group);
 
+	// Nodes with a process thread group, bucketed per group. Kept between frames to reuse the memory.
+	LocalVector<LocalVector<Node *>> process_thread_groups;
+	OAHashMap<int, uint32_t> process_thread_group_indices;
+	uint32_t process_thread_group_count = 0;
+	int process_thread_notification = 0;
+
+	void _process_thread_group_task(uint32_t p_index, void *p_userdata);
+	bool _process_thread_groups(Node **p_nodes, int p_node_count, int p_notification);
 	void _notify_group_pause(const StringName &p_group, int p_notification);
 	void _call_group_flags(const Variant **p_args, int p_argcount, Callable::CallError &r_error);
 	void _call_group(const Variant **p_args, int p_argcount, Callable::CallError &r_error);
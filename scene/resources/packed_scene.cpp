@@ -430,13 +430,26 @@ Node *SceneState::instantiate(GenEditState p_edit_state) const {
 	return ret_nodes[0];
 }
 
-static int _nm_get_string(const String &p_string, Map<StringName, int> &name_map) {
-	if (name_map.has(p_string)) {
-		return name_map[p_string];
+static int _nm_get_string(const String &p_string, OAHashMap<StringName, int> &name_map) {
+	StringName name = p_string;
+	const int *existing = name_map.lookup_ptr(name);
+	if (existing) {
+		return *existing;
 	}
 
-	int idx = name_map.size();
-	name_map[p_string] = idx;
+	int idx = name_map.get_num_elements();
+	name_map.insert(name, idx);
+	return idx;
+}
+
+static int _nm_get_node_path(Node *p_node, OAHashMap<Node *, int> &nodepath_map) {
+	const int *existing = nodepath_map.lookup_ptr(p_node);
+	if (existing) {
+		return *existing;
+	}
+
+	int idx = nodepath_map.get_num_elements();
+	nodepath_map.insert(p_node, idx);
 	return idx;
 }
 
@@ -450,7 +463,7 @@ static int _vm_get_variant(const Variant &p_variant, HashMap<Variant, int, Varia
 	return idx;
 }
 
-Error SceneState::_parse_node(Node *p_owner, Node *p_node, int p_parent_idx, Map<StringName, int> &name_map, HashMap<Variant, int, VariantHasher, VariantComparator> &variant_map, Map<Node *, int> &node_map, Map<Node *, int> &nodepath_map) {
+Error SceneState::_parse_node(Node *p_owner, Node *p_node, int p_parent_idx, OAHashMap<StringName, int> &name_map, HashMap<Variant, int, VariantHasher, VariantComparator> &variant_map, OAHashMap<Node *, int> &node_map, OAHashMap<Node *, int> &nodepath_map) {
 	// this function handles all the work related to properly packing scenes, be it
 	// instantiated or inherited.
 	// given the complexity of this process, an attempt will be made to properly
@@ -640,17 +653,11 @@ Error SceneState::_parse_node(Node *p_owner, Node *p_node, int p_parent_idx, Map
 	if (save_node) {
 		//don't save the node if nothing and subscene
 
-		node_map[p_node] = idx;
+		node_map.insert(p_node, idx);
 
 		//ok validate parent node
 		if (p_parent_idx == NO_PARENT_SAVED) {
-			int sidx;
-			if (nodepath_map.has(p_node->get_parent())) {
-				sidx = nodepath_map[p_node->get_parent()];
-			} else {
-				sidx = nodepath_map.size();
-				nodepath_map[p_node->get_parent()] = sidx;
-			}
+			int sidx = _nm_get_node_path(p_node->get_parent(), nodepath_map);
 
 			nd.parent = FLAG_ID_IS_PATH | sidx;
 		} else {
@@ -672,7 +679,7 @@ Error SceneState::_parse_node(Node *p_owner, Node *p_node, int p_parent_idx, Map
 	return OK;
 }
 
-Error SceneState::_parse_connections(Node *p_owner, Node *p_node, Map<StringName, int> &name_map, HashMap<Variant, int, VariantHasher, VariantComparator> &variant_map, Map<Node *, int> &node_map, Map<Node *, int> &nodepath_map) {
+Error SceneState::_parse_connections(Node *p_owner, Node *p_node, OAHashMap<StringName, int> &name_map, HashMap<Variant, int, VariantHasher, VariantComparator> &variant_map, OAHashMap<Node *, int> &node_map, OAHashMap<Node *, int> &nodepath_map) {
 	if (p_node != p_owner && p_node->get_owner() && p_node->get_owner() != p_owner && !p_owner->is_editable_instance(p_node->get_owner())) {
 		return OK;
 	}
@@ -818,30 +825,20 @@ Error SceneState::_parse_connections(Node *p_owner, Node *p_node, Map<StringName
 
 			int src_id;
 
-			if (node_map.has(p_node)) {
-				src_id = node_map[p_node];
+			const int *src_idx = node_map.lookup_ptr(p_node);
+			if (src_idx) {
+				src_id = *src_idx;
 			} else {
-				if (nodepath_map.has(p_node)) {
-					src_id = FLAG_ID_IS_PATH | nodepath_map[p_node];
-				} else {
-					int sidx = nodepath_map.size();
-					nodepath_map[p_node] = sidx;
-					src_id = FLAG_ID_IS_PATH | sidx;
-				}
+				src_id = FLAG_ID_IS_PATH | _nm_get_node_path(p_node, nodepath_map);
 			}
 
 			int target_id;
 
-			if (node_map.has(target)) {
-				target_id = node_map[target];
+			const int *target_idx = node_map.lookup_ptr(target);
+			if (target_idx) {
+				target_id = *target_idx;
 			} else {
-				if (nodepath_map.has(target)) {
-					target_id = FLAG_ID_IS_PATH | nodepath_map[target];
-				} else {
-					int sidx = nodepath_map.size();
-					nodepath_map[target] = sidx;
-					target_id = FLAG_ID_IS_PATH | sidx;
-				}
+				target_id = FLAG_ID_IS_PATH | _nm_get_node_path(target, nodepath_map);
 			}
 
 			ConnectionData cd;
@@ -879,10 +876,10 @@ Error SceneState::pack(Node *p_scene) {
 
 	Node *scene = p_scene;
 
-	Map<StringName, int> name_map;
+	OAHashMap<StringName, int> name_map;
 	HashMap<Variant, int, VariantHasher, VariantComparator> variant_map;
-	Map<Node *, int> node_map;
-	Map<Node *, int> nodepath_map;
+	OAHashMap<Node *, int> node_map;
+	OAHashMap<Node *, int> nodepath_map;
 
 	// If using scene inheritance, pack the scene it inherits from.
 	if (scene->get_scene_inherited_state().is_valid()) {
@@ -906,10 +903,10 @@ Error SceneState::pack(Node *p_scene) {
 		ERR_FAIL_V(err);
 	}
 
-	names.resize(name_map.size());
+	names.resize(name_map.get_num_elements());
 
-	for (const KeyValue<StringName, int> &E : name_map) {
-		names.write[E.value] = E.key;
+	for (OAHashMap<StringName, int>::Iterator it = name_map.iter(); it.valid; it = name_map.next_iter(it)) {
+		names.write[*it.value] = *it.key;
 	}
 
 	variants.resize(variant_map.size());
@@ -919,15 +916,15 @@ Error SceneState::pack(Node *p_scene) {
 		variants.write[idx] = *K;
 	}
 
-	node_paths.resize(nodepath_map.size());
-	for (const KeyValue<Node *, int> &E : nodepath_map) {
-		node_paths.write[E.value] = scene->get_path_to(E.key);
+	node_paths.resize(nodepath_map.get_num_elements());
+	for (OAHashMap<Node *, int>::Iterator it = nodepath_map.iter(); it.valid; it = nodepath_map.next_iter(it)) {
+		node_paths.write[*it.value] = scene->get_path_to(*it.key);
 	}
 
 	if (Engine::get_singleton()->is_editor_hint()) {
 		// Build node path cache
-		for (const KeyValue<Node *, int> &E : node_map) {
-			node_path_cache[scene->get_path_to(E.key)] = E.value;
+		for (OAHashMap<Node *, int>::Iterator it = node_map.iter(); it.valid; it = node_map.next_iter(it)) {
+			node_path_cache[scene->get_path_to(*it.key)] = *it.value;
 		}
 	}
 
@@ -1213,6 +1213,9 @@ GodotSpace2D::GodotSpace2D() {
 	solver_iterations = GLOBAL_DEF("physics/2d/solver/solver_iterations", 16);
 	ProjectSettings::get_singleton()->set_custom_property_info("physics/2d/solver/solver_iterations", PropertyInfo(Variant::INT, "physics/2d/solver/solver_iterations", PROPERTY_HINT_RANGE, "1,32,1,or_greater"));
 
+	solver_island_split_threshold = GLOBAL_DEF("physics/2d/solver/island_split_threshold", 256);
+	ProjectSettings::get_singleton()->set_custom_property_info("physics/2d/solver/island_split_threshold", PropertyInfo(Variant::INT, "physics/2d/solver/island_split_threshold", PROPERTY_HINT_RANGE, "0,4096,1,or_greater"));
+
 	contact_recycle_radius = GLOBAL_DEF("physics/2d/solver/contact_recycle_radius", 1.0);
 	ProjectSettings::get_singleton()->set_custom_property_info("physics/2d/solver/contact_recycle_radius", PropertyInfo(Variant::FLOAT, "physics/2d/solver/contact_max_separation", PROPERTY_HINT_RANGE, "0,10,0.01,or_greater"));
 
@@ -33,8 +33,9 @@
 
 #include "godot_space_2d.h"
 
+#include "core/os/worker_thread_pool.h"
+#include "core/templates/hash_map.h"
 #include "core/templates/local_vector.h"
-#include "core/templates/thread_work_pool.h"
 
 class GodotStep2D {
 	uint64_t _step = 1;
@@ -42,16 +43,44 @@ class GodotStep2D {
 	int iterations = 0;
 	real_t delta = 0.0;
 
-	ThreadWorkPool work_pool;
-
 	LocalVector<LocalVector<GodotBody2D *>> body_islands;
 	LocalVector<LocalVector<GodotConstraint2D *>> constraint_islands;
 	LocalVector<GodotConstraint2D *> all_constraints;
 
+	struct IslandOrder {
+		uint32_t index = 0;
+		uint32_t size = 0;
+
+		// Biggest islands first, so they don't end up running alone at the end.
+		_FORCE_INLINE_ bool operator<(const IslandOrder &p_other) const {
+			return size > p_other.size || (size == p_other.size && index < p_other.index);
+		}
+	};
+
+	enum {
+		// Constraints of one color share no dynamic body. The last color gathers
+		// whatever did not fit in the others and is solved serially.
+		ISLAND_COLOR_MAX = 64,
+		ISLAND_BATCH_SIZE = 16,
+	};
+
+	LocalVector<IslandOrder> island_solve_order;
+	LocalVector<uint32_t> split_islands;
+
+	HashMap<uint64_t, uint64_t> body_color_masks;
+	LocalVector<uint32_t> constraint_colors;
+	LocalVector<GodotConstraint2D *> colored_constraints;
+	uint32_t color_offsets[ISLAND_COLOR_MAX + 2] = {};
+	GodotConstraint2D **batch_constraints = nullptr;
+	uint32_t batch_constraint_count = 0;
+
 	void _populate_island(GodotBody2D *p_body, LocalVector<GodotBody2D *> &p_body_island, LocalVector<GodotConstraint2D *> &p_constraint_island);
 	void _setup_contraint(uint32_t p_constraint_index, void *p_userdata = nullptr);
 	void _pre_solve_island(LocalVector<GodotConstraint2D *> &p_constraint_island) const;
 	void _solve_island(uint32_t p_island_index, void *p_userdata = nullptr) const;
+	void _color_island(LocalVector<GodotConstraint2D *> &p_constraint_island);
+	void _solve_constraint_batch(uint32_t p_batch_index, void *p_userdata = nullptr);
+	void _solve_split_island(LocalVector<GodotConstraint2D *> &p_constraint_island);
 	void _check_suspend(LocalVector<GodotBody2D *> &p_body_island) const;
 
 public:
@@ -34,6 +34,7 @@
 #include "godot_physics_server_3d.h"
 
 #include "core/config/project_settings.h"
+#include "core/os/worker_thread_pool.h"
 
 #define TEST_MOTION_MARGIN_MIN_VALUE 0.0001
 #define TEST_MOTION_MIN_CONTACT_DEPTH_FACTOR 0.05
@@ -105,17 +106,13 @@ int GodotPhysicsDirectSpaceState3D::intersect_point(const PointParameters &p_par
 	return cc;
 }
 
-bool GodotPhysicsDirectSpaceState3D::intersect_ray(const RayParameters &p_parameters, RayResult &r_result) {
-	ERR_FAIL_COND_V(space->locked, false);
-
+static bool _intersect_ray_candidates(const PhysicsDirectSpaceState3D::RayParameters &p_parameters, const Vector3 &p_from, const Vector3 &p_to, GodotCollisionObject3D *const *p_candidates, const int *p_candidate_shapes, int p_amount, PhysicsDirectSpaceState3D::RayResult &r_result) {
 	Vector3 begin, end;
 	Vector3 normal;
-	begin = p_parameters.from;
-	end = p_parameters.to;
+	begin = p_from;
+	end = p_to;
 	normal = (end - begin).normalized();
 
-	int amount = space->broadphase->cull_segment(begin, end, space->intersection_query_results, GodotSpace3D::INTERSECTION_QUERY_MAX, space->intersection_query_subindex_results);
-
 	//todo, create another array that references results, compute AABBs and check closest point to ray origin, sort, and stop evaluating results when beyond first collision
 
 	bool collided = false;
@@ -124,22 +121,22 @@ bool GodotPhysicsDirectSpaceState3D::intersect_ray(const RayParameters &p_parame
 	const GodotCollisionObject3D *res_obj;
 	real_t min_d = 1e10;
 
-	for (int i = 0; i < amount; i++) {
-		if (!_can_collide_with(space->intersection_query_results[i], p_parameters.collision_mask, p_parameters.collide_with_bodies, p_parameters.collide_with_areas)) {
+	for (int i = 0; i < p_amount; i++) {
+		if (!_can_collide_with(p_candidates[i], p_parameters.collision_mask, p_parameters.collide_with_bodies, p_parameters.collide_with_areas)) {
 			continue;
 		}
 
-		if (p_parameters.pick_ray && !(space->intersection_query_results[i]->is_ray_pickable())) {
+		if (p_parameters.pick_ray && !(p_candidates[i]->is_ray_pickable())) {
 			continue;
 		}
 
-		if (p_parameters.exclude.has(space->intersection_query_results[i]->get_self())) {
+		if (p_parameters.exclude.has(p_candidates[i]->get_self())) {
 			continue;
 		}
 
-		const GodotCollisionObject3D *col_obj = space->intersection_query_results[i];
+		const GodotCollisionObject3D *col_obj = p_candidates[i];
 
-		int shape_idx = space->intersection_query_subindex_results[i];
+		int shape_idx = p_candidate_shapes[i];
 		Transform3D inv_xform = col_obj->get_shape_inv_transform(shape_idx) * col_obj->get_inv_transform();
 
 		Vector3 local_from = inv_xform.xform(begin);
@@ -200,6 +197,72 @@ bool GodotPhysicsDirectSpaceState3D::intersect_ray(const RayParameters &p_parame
 	return true;
 }
 
+bool GodotPhysicsDirectSpaceState3D::intersect_ray(const RayParameters &p_parameters, RayResult &r_result) {
+	ERR_FAIL_COND_V(space->locked, false);
+
+	int amount = space->broadphase->cull_segment(p_parameters.from, p_parameters.to, space->intersection_query_results, GodotSpace3D::INTERSECTION_QUERY_MAX, space->intersection_query_subindex_results);
+
+	return _intersect_ray_candidates(p_parameters, p_parameters.from, p_parameters.to, space->intersection_query_results, space->intersection_query_subindex_results, amount, r_result);
+}
+
+void GodotPhysicsDirectSpaceState3D::_intersect_ray_batch(uint32_t p_batch, RayBatch *p_ray_batch) {
+	int from = p_batch * RAY_BATCH_SIZE;
+	int to = MIN(from + RAY_BATCH_SIZE, p_ray_batch->count);
+
+	// Each batch has its own candidate buffers, the space's shared ones can't be used concurrently.
+	LocalVector<GodotCollisionObject3D *> candidates;
+	candidates.resize(GodotSpace3D::INTERSECTION_QUERY_MAX);
+	LocalVector<int> candidate_shapes;
+	candidate_shapes.resize(GodotSpace3D::INTERSECTION_QUERY_MAX);
+	LocalVector<uint32_t, uint32_t, true> scratch;
+
+	for (int i = from; i < to; i++) {
+		const Vector3 &ray_from = p_ray_batch->from[i];
+		const Vector3 &ray_to = p_ray_batch->to[i];
+
+		int amount = space->broadphase->cull_segment_concurrent(ray_from, ray_to, candidates.ptr(), GodotSpace3D::INTERSECTION_QUERY_MAX, scratch, candidate_shapes.ptr());
+		p_ray_batch->collided[i] = _intersect_ray_candidates(*p_ray_batch->parameters, ray_from, ray_to, candidates.ptr(), candidate_shapes.ptr(), amount, p_ray_batch->results[i]);
+	}
+}
+
+int GodotPhysicsDirectSpaceState3D::intersect_rays(const RayParameters &p_parameters, const Vector3 *p_from, const Vector3 *p_to, int p_count, RayResult *r_results, bool *r_collided) {
+	ERR_FAIL_COND_V(space->locked, 0);
+
+	if (p_count <= 0) {
+		return 0;
+	}
+
+	RayBatch ray_batch;
+	ray_batch.parameters = &p_parameters;
+	ray_batch.from = p_from;
+	ray_batch.to = p_to;
+	ray_batch.count = p_count;
+	ray_batch.results = r_results;
+	ray_batch.collided = r_collided;
+
+	uint32_t batch_count = (p_count + RAY_BATCH_SIZE - 1) / RAY_BATCH_SIZE;
+
+	// The broadphase is not modified while queries run, so batches can cull it concurrently.
+	WorkerThreadPool *thread_pool = WorkerThreadPool::get_singleton();
+	if (batch_count > 1 && thread_pool->get_thread_count() > 1) {
+		WorkerThreadPool::TaskID group = thread_pool->add_template_group_task(this, &GodotPhysicsDirectSpaceState3D::_intersect_ray_batch, &ray_batch, batch_count);
+		thread_pool->wait_for_group_task_completion(group);
+	} else {
+		for (uint32_t i = 0; i < batch_count; i++) {
+			_intersect_ray_batch(i, &ray_batch);
+		}
+	}
+
+	int hit_count = 0;
+	for (int i = 0; i < p_count; i++) {
+		if (r_collided[i]) {
+			hit_count++;
+		}
+	}
+
+	return hit_count;
+}
+
 int GodotPhysicsDirectSpaceState3D::intersect_shape(const ShapeParameters &p_parameters, ShapeResult *r_results, int p_result_max) {
 	if (p_result_max <= 0) {
 		return 0;
@@ -1242,6 +1305,9 @@ GodotSpace3D::GodotSpace3D() {
 	solver_iterations = GLOBAL_DEF("physics/3d/solver/solver_iterations", 16);
 	ProjectSettings::get_singleton()->set_custom_property_info("physics/3d/solver/solver_iterations", PropertyInfo(Variant::INT, "physics/3d/solver/solver_iterations", PROPERTY_HINT_RANGE, "1,32,1,or_greater"));
 
+	solver_island_split_threshold = GLOBAL_DEF("physics/3d/solver/island_split_threshold", 256);
+	ProjectSettings::get_singleton()->set_custom_property_info("physics/3d/solver/island_split_threshold", PropertyInfo(Variant::INT, "physics/3d/solver/island_split_threshold", PROPERTY_HINT_RANGE, "0,4096,1,or_greater"));
+
 	contact_recycle_radius = GLOBAL_DEF("physics/3d/solver/contact_recycle_radius", 0.01);
 	ProjectSettings::get_singleton()->set_custom_property_info("physics/3d/solver/contact_recycle_radius", PropertyInfo(Variant::FLOAT, "physics/3d/solver/contact_max_separation", PROPERTY_HINT_RANGE, "0,0.1,0.01,or_greater"));
 
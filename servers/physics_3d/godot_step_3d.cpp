@@ -130,7 +130,7 @@ void GodotStep3D::_pre_solve_island(LocalVector<GodotConstraint3D *> &p_constrai
 }
 
 void GodotStep3D::_solve_island(uint32_t p_island_index, void *p_userdata) {
-	LocalVector<GodotConstraint3D *> &constraint_island = constraint_islands[p_island_index];
+	LocalVector<GodotConstraint3D *> &constraint_island = constraint_islands[island_solve_order[p_island_index].index];
 
 	int current_priority = 1;
 
@@ -157,6 +157,150 @@ void GodotStep3D::_solve_island(uint32_t p_island_index, void *p_userdata) {
 	}
 }
 
+void GodotStep3D::_color_island(LocalVector<GodotConstraint3D *> &p_constraint_island) {
+	// Greedy coloring: a constraint gets the first color none of its dynamic
+	// bodies is already using. Static and kinematic bodies are never written
+	// by the solver, so they don't create conflicts.
+	uint32_t constraint_count = p_constraint_island.size();
+	constraint_colors.resize(constraint_count);
+	body_color_masks.clear();
+
+	for (uint32_t i = 0; i < ISLAND_COLOR_MAX + 2; i++) {
+		color_offsets[i] = 0;
+	}
+
+	for (uint32_t constraint_index = 0; constraint_index < constraint_count; ++constraint_index) {
+		GodotConstraint3D *constraint = p_constraint_island[constraint_index];
+
+		uint64_t used_colors = 0;
+		for (int i = 0; i < constraint->get_body_count(); i++) {
+			GodotBody3D *body = constraint->get_body_ptr()[i];
+			if (body->get_mode() > PhysicsServer3D::BODY_MODE_KINEMATIC) {
+				const uint64_t *mask = body_color_masks.getptr((uint64_t)body);
+				if (mask) {
+					used_colors |= *mask;
+				}
+			}
+		}
+		for (int i = 0; i < constraint->get_soft_body_count(); i++) {
+			const uint64_t *mask = body_color_masks.getptr((uint64_t)constraint->get_soft_body_ptr(i));
+			if (mask) {
+				used_colors |= *mask;
+			}
+		}
+
+		uint32_t color = 0;
+		while (color < ISLAND_COLOR_MAX && (used_colors & (uint64_t(1) << color))) {
+			color++;
+		}
+		constraint_colors[constraint_index] = color;
+		color_offsets[color + 1]++;
+
+		if (color == ISLAND_COLOR_MAX) {
+			continue;
+		}
+
+		uint64_t color_bit = uint64_t(1) << color;
+		for (int i = 0; i < constraint->get_body_count(); i++) {
+			GodotBody3D *body = constraint->get_body_ptr()[i];
+			if (body->get_mode() > PhysicsServer3D::BODY_MODE_KINEMATIC) {
+				uint64_t *mask = body_color_masks.getptr((uint64_t)body);
+				if (mask) {
+					*mask |= color_bit;
+				} else {
+					body_color_masks.set((uint64_t)body, color_bit);
+				}
+			}
+		}
+		for (int i = 0; i < constraint->get_soft_body_count(); i++) {
+			uint64_t key = (uint64_t)constraint->get_soft_body_ptr(i);
+			uint64_t *mask = body_color_masks.getptr(key);
+			if (mask) {
+				*mask |= color_bit;
+			} else {
+				body_color_masks.set(key, color_bit);
+			}
+		}
+	}
+
+	for (uint32_t color = 0; color <= ISLAND_COLOR_MAX; color++) {
+		color_offsets[color + 1] += color_offsets[color];
+	}
+
+	// Stable counting sort, keeps the island order within each color.
+	colored_constraints.resize(constraint_count);
+	uint32_t write_offsets[ISLAND_COLOR_MAX + 1];
+	for (uint32_t color = 0; color <= ISLAND_COLOR_MAX; color++) {
+		write_offsets[color] = color_offsets[color];
+	}
+	for (uint32_t constraint_index = 0; constraint_index < constraint_count; ++constraint_index) {
+		colored_constraints[write_offsets[constraint_colors[constraint_index]]++] = p_constraint_island[constraint_index];
+	}
+	for (uint32_t constraint_index = 0; constraint_index < constraint_count; ++constraint_index) {
+		p_constraint_island[constraint_index] = colored_constraints[constraint_index];
+	}
+}
+
+void GodotStep3D::_solve_constraint_batch(uint32_t p_batch_index, void *p_userdata) {
+	uint32_t from = p_batch_index * ISLAND_BATCH_SIZE;
+	uint32_t to = MIN(from + ISLAND_BATCH_SIZE, batch_constraint_count);
+	for (uint32_t constraint_index = from; constraint_index < to; ++constraint_index) {
+		batch_constraints[constraint_index]->solve(delta);
+	}
+}
+
+void GodotStep3D::_solve_split_island(LocalVector<GodotConstraint3D *> &p_constraint_island) {
+	// Same as _solve_island, but each color is solved across threads. The
+	// constraints of a color are independent, so the result does not depend
+	// on how many threads take part.
+	_color_island(p_constraint_island);
+
+	WorkerThreadPool *thread_pool = WorkerThreadPool::get_singleton();
+
+	int current_priority = 1;
+
+	while (color_offsets[ISLAND_COLOR_MAX + 1] > 0) {
+		for (int i = 0; i < iterations; i++) {
+			for (uint32_t color = 0; color <= ISLAND_COLOR_MAX; color++) {
+				uint32_t from = color_offsets[color];
+				uint32_t to = color_offsets[color + 1];
+				if (color == ISLAND_COLOR_MAX || to - from <= ISLAND_BATCH_SIZE) {
+					for (uint32_t constraint_index = from; constraint_index < to; ++constraint_index) {
+						p_constraint_island[constraint_index]->solve(delta);
+					}
+					continue;
+				}
+
+				batch_constraints = p_constraint_island.ptr() + from;
+				batch_constraint_count = to - from;
+				uint32_t batch_count = (batch_constraint_count + ISLAND_BATCH_SIZE - 1) / ISLAND_BATCH_SIZE;
+				WorkerThreadPool::TaskID group = thread_pool->add_template_group_task(this, &GodotStep3D::_solve_constraint_batch, nullptr, batch_count);
+				thread_pool->wait_for_group_task_completion(group);
+			}
+		}
+
+		// Check priority to keep only higher priority constraints, color by color.
+		uint32_t priority_constraint_count = 0;
+		++current_priority;
+		for (uint32_t color = 0; color <= ISLAND_COLOR_MAX; color++) {
+			uint32_t from = color_offsets[color];
+			uint32_t to = color_offsets[color + 1];
+			color_offsets[color] = priority_constraint_count;
+			for (uint32_t constraint_index = from; constraint_index < to; ++constraint_index) {
+				GodotConstraint3D *constraint = p_constraint_island[constraint_index];
+				if (constraint->get_priority() >= current_priority) {
+					// Keep this constraint for the next iteration.
+					p_constraint_island[priority_constraint_count++] = constraint;
+				}
+			}
+		}
+		color_offsets[ISLAND_COLOR_MAX + 1] = priority_constraint_count;
+	}
+
+	batch_constraints = nullptr;
+	batch_constraint_count = 0;
+}
+
 void GodotStep3D::_check_suspend(const LocalVector<GodotBody3D *> &p_body_island) const {
 	bool can_sleep = true;
 
@@ -182,6 +326,8 @@ void GodotStep3D::_check_suspend(const LocalVector<GodotBody3D *> &p_body_island
 }
 
 void GodotStep3D::step(GodotSpace3D *p_space, real_t p_delta) {
+	MemoryTagScope memory_tag(Memory::TAG_PHYSICS);
+
 	p_space->lock(); // can't access space during this
 
 	p_space->setup(); //update inertias, etc
@@ -342,8 +488,11 @@ void GodotStep3D::step(GodotSpace3D *p_space, real_t p_delta) {
 
 	/* SETUP CONSTRAINTS / PROCESS COLLISIONS */
 
+	WorkerThreadPool *thread_pool = WorkerThreadPool::get_singleton();
+
 	uint32_t total_contraint_count = all_constraints.size();
-	work_pool.do_work(total_contraint_count, this, &GodotStep3D::_setup_contraint, nullptr);
+	WorkerThreadPool::TaskID setup_group = thread_pool->add_template_group_task(this, &GodotStep3D::_setup_contraint, nullptr, total_contraint_count);
+	thread_pool->wait_for_group_task_completion(setup_group);
 
 	{ //profile
 		profile_endtime = OS::get_singleton()->get_ticks_usec();
@@ -362,7 +511,32 @@ void GodotStep3D::step(GodotSpace3D *p_space, real_t p_delta) {
 
 	// Warning: _solve_island modifies the constraint islands for optimization purpose,
 	// their content is not reliable after these calls and shouldn't be used anymore.
-	work_pool.do_work(island_count, this, &GodotStep3D::_solve_island, nullptr);
+
+	// Islands are independent from each other, so solving them in parallel gives
+	// the same result whatever the thread count. Islands above the split threshold
+	// are solved here, spread across threads by graph coloring, while the pool
+	// works on the other ones.
+	uint32_t split_threshold = (uint32_t)MAX(p_space->get_solver_island_split_threshold(), 0);
+	island_solve_order.clear();
+	split_islands.clear();
+	for (uint32_t island_index = 0; island_index < island_count; ++island_index) {
+		uint32_t island_size = constraint_islands[island_index].size();
+		if (split_threshold > 0 && island_size >= split_threshold) {
+			split_islands.push_back(island_index);
+		} else {
+			IslandOrder order;
+			order.index = island_index;
+			order.size = island_size;
+			island_solve_order.push_back(order);
+		}
+	}
+	island_solve_order.sort();
+
+	WorkerThreadPool::TaskID solve_group = thread_pool->add_template_group_task(this, &GodotStep3D::_solve_island, nullptr, island_solve_order.size());
+	for (uint32_t i = 0; i < split_islands.size(); ++i) {
+		_solve_split_island(constraint_islands[split_islands[i]]);
+	}
+	thread_pool->wait_for_group_task_completion(solve_group);
 
 	{ //profile
 		profile_endtime = OS::get_singleton()->get_ticks_usec();
@@ -409,10 +583,7 @@ GodotStep3D::GodotStep3D() {
 	body_islands.reserve(BODY_ISLAND_COUNT_RESERVE);
 	constraint_islands.reserve(ISLAND_COUNT_RESERVE);
 	all_constraints.reserve(CONSTRAINT_COUNT_RESERVE);
-
-	work_pool.init();
 }
 
 GodotStep3D::~GodotStep3D() {
-	work_pool.finish();
 }
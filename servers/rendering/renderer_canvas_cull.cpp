@@ -31,6 +31,7 @@
 #include "renderer_canvas_cull.h"
 
 #include "core/math/geometry_2d.h"
+#include "core/templates/arena_allocator.h"
 #include "renderer_viewport.h"
 #include "rendering_server_default.h"
 #include "rendering_server_globals.h"
@@ -291,7 +292,9 @@ void RendererCanvasCull::_cull_canvas_item(Item *p_canvas_item, const Transform2
 			}
 
 			child_item_count = ci->ysort_children_count + 1;
-			child_items = (Item **)alloca(child_item_count * sizeof(Item *));
+			// Y-sorted subtrees can be arbitrarily large, so don't put them on the stack.
+			ArenaAllocator::Scope scratch;
+			child_items = scratch.get_arena().alloc_array<Item *>(child_item_count);
 
 			child_items[0] = ci;
 			int i = 1;
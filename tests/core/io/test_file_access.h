@@ -32,6 +32,8 @@
 #define TEST_FILE_ACCESS_H
 
 #include "core/io/file_access.h"
+#include "core/io/file_access_compressed.h"
+#include "core/os/os.h"
 #include "tests/test_macros.h"
 #include "tests/test_utils.h"
 
@@ -78,6 +80,163 @@ TEST_CASE("[FileAccess] CSV read") {
 	CHECK(row5[1] == "tab separated");
 	CHECK(row5[2] == "lines, good?");
 }
+
+TEST_CASE("[FileAccess] Borrowing buffers") {
+	const String path = OS::get_singleton()->get_cache_path().plus_file("file_access_borrow.bin");
+	Vector<uint8_t> contents;
+	for (int i = 0; i < 1000; i++) {
+		contents.push_back(i % 256);
+	}
+	{
+		Ref<FileAccess> f = FileAccess::open(path, FileAccess::WRITE);
+		REQUIRE(f.is_valid());
+		f->store_buffer(contents.ptr(), contents.size());
+	}
+
+	Ref<FileAccess> f = FileAccess::open(path, FileAccess::READ);
+	REQUIRE(f.is_valid());
+	f->seek(100);
+	Ref<FileMapping> mapping;
+	const uint8_t *data = f->borrow_buffer(500, mapping);
+	if (!data) {
+		// Not every platform can map files, callers fall back to get_buffer() then.
+		CHECK(f->get_position() == 100);
+		return;
+	}
+
+	CHECK(mapping.is_valid());
+	CHECK_MESSAGE(f->get_position() == 600, "Borrowing should advance the position like reading.");
+	CHECK(f->get_8() == contents[600]);
+
+	Ref<FileMapping> unused;
+	CHECK_MESSAGE(f->borrow_buffer(1000, unused) == nullptr, "Borrowing past the end should fail.");
+
+	f = Ref<FileAccess>();
+	CHECK_MESSAGE(memcmp(data, contents.ptr() + 100, 500) == 0, "Borrowed data should stay valid after the file is closed.");
+}
+
+TEST_CASE("[FileAccessCompressed] Reading across blocks") {
+	const String path = OS::get_singleton()->get_cache_path().plus_file("file_access_compressed.bin");
+	Vector<uint8_t> contents;
+	for (int i = 0; i < 100000; i++) {
+		contents.push_back((i * 7 + i / 1000) % 251);
+	}
+	{
+		Ref<FileAccessCompressed> fac;
+		fac.instantiate();
+		fac->configure("GCPF", Compression::MODE_ZSTD, 4096);
+		REQUIRE(fac->_open(path, FileAccess::WRITE) == OK);
+		fac->store_buffer(contents.ptr(), contents.size());
+	}
+
+	// Small enough to use several windows, read ahead as soon as reading is sequential.
+	uint32_t read_ahead_size = FileAccessCompressed::read_ahead_size;
+	FileAccessCompressed::read_ahead_size = 4096 * 3;
+
+	Ref<FileAccessCompressed> fac;
+	fac.instantiate();
+	fac->configure("GCPF");
+	REQUIRE(fac->_open(path, FileAccess::READ) == OK);
+	CHECK(fac->get_length() == (uint64_t)contents.size());
+
+	Vector<uint8_t> data;
+	data.resize(contents.size());
+	CHECK(fac->get_buffer(data.ptrw(), 50000) == 50000);
+	for (int i = 50000; i < 60000; i++) {
+		data.write[i] = fac->get_8();
+	}
+	CHECK(fac->get_buffer(data.ptrw() + 60000, 50000) == 40000);
+	CHECK(fac->eof_reached());
+	CHECK_MESSAGE(data == contents, "Sequential reads should return the original data.");
+
+	fac->seek(12345);
+	CHECK(fac->get_8() == contents[12345]);
+	fac->seek(99999);
+	CHECK(fac->get_8() == contents[99999]);
+	fac->seek(4095);
+	uint8_t across[2];
+	CHECK(fac->get_buffer(across, 2) == 2);
+	CHECK(across[0] == contents[4095]);
+	CHECK(across[1] == contents[4096]);
+
+	fac = Ref<FileAccessCompressed>();
+	FileAccessCompressed::read_ahead_size = read_ahead_size;
+}
+
+TEST_CASE("[FileAccessCompressed] Dictionary") {
+	const String path = OS::get_singleton()->get_cache_path().plus_file("file_access_compressed_dict.bin");
+	Vector<uint8_t> dictionary = String("[gd_resource type=\"Resource\" format=3]").to_utf8_buffer();
+	Vector<uint8_t> contents = String("[gd_resource type=\"Resource\" format=3]\n\n[resource]\n").to_utf8_buffer();
+	{
+		Ref<FileAccessCompressed> fac;
+		fac.instantiate();
+		fac->configure("GCPF", Compression::MODE_ZSTD);
+		fac->set_dictionary(dictionary);
+		REQUIRE(fac->_open(path, FileAccess::WRITE) == OK);
+		fac->store_buffer(contents.ptr(), contents.size());
+	}
+
+	Ref<FileAccessCompressed> fac;
+	fac.instantiate();
+	fac->configure("GCPF", Compression::MODE_ZSTD);
+	fac->set_dictionary(dictionary);
+	REQUIRE(fac->_open(path, FileAccess::READ) == OK);
+	Vector<uint8_t> data;
+	data.resize(contents.size());
+	CHECK(fac->get_buffer(data.ptrw(), data.size()) == (uint64_t)data.size());
+	CHECK(data == contents);
+	fac = Ref<FileAccessCompressed>();
+
+	// Many blocks, read ahead on the worker pool, all sharing the digested dictionary.
+	const String path_blocks = OS::get_singleton()->get_cache_path().plus_file("file_access_compressed_dict_blocks.bin");
+	Vector<uint8_t> long_contents;
+	for (int i = 0; i < 512; i++) {
+		long_contents.append_array(contents);
+	}
+	{
+		Ref<FileAccessCompressed> fac_write;
+		fac_write.instantiate();
+		fac_write->configure("GCPF", Compression::MODE_ZSTD, 4096);
+		fac_write->set_dictionary(dictionary);
+		REQUIRE(fac_write->_open(path_blocks, FileAccess::WRITE) == OK);
+		fac_write->store_buffer(long_contents.ptr(), long_contents.size());
+	}
+	fac.instantiate();
+	fac->configure("GCPF", Compression::MODE_ZSTD);
+	fac->set_dictionary(dictionary);
+	REQUIRE(fac->_open(path_blocks, FileAccess::READ) == OK);
+	data.resize(long_contents.size());
+	CHECK(fac->get_buffer(data.ptrw(), data.size()) == (uint64_t)data.size());
+	CHECK(data == long_contents);
+}
+
+TEST_CASE("[FileAccessCompressed] Block size is clamped") {
+	const String path = OS::get_singleton()->get_cache_path().plus_file("file_access_compressed_small_blocks.bin");
+	uint32_t default_block_size = FileAccessCompressed::default_block_size;
+	FileAccessCompressed::default_block_size = 0;
+	{
+		Ref<FileAccessCompressed> fac;
+		fac.instantiate();
+		fac->configure("GCPF");
+		REQUIRE(fac->_open(path, FileAccess::WRITE) == OK);
+		fac->store_32(0x12345678);
+	}
+	FileAccessCompressed::default_block_size = default_block_size;
+
+	Ref<FileAccess> f = FileAccess::open(path, FileAccess::READ);
+	REQUIRE(f.is_valid());
+	f->seek(8);
+	CHECK_MESSAGE(
+			f->get_32() == uint32_t(FileAccessCompressed::MIN_BLOCK_SIZE),
+			"Block sizes should never be smaller than the minimum.");
+	f = Ref<FileAccess>();
+
+	Ref<FileAccessCompressed> fac;
+	fac.instantiate();
+	fac->configure("GCPF");
+	REQUIRE(fac->_open(path, FileAccess::READ) == OK);
+	CHECK(fac->get_32() == 0x12345678);
+}
 } // namespace TestFileAccess
 
 #endif // TEST_FILE_ACCESS_H
@@ -33,6 +33,7 @@
 
 #include "core/io/image.h"
 #include "core/os/os.h"
+#include "core/os/worker_thread_pool.h"
 
 #include "tests/test_utils.h"
 #include "thirdparty/doctest/doctest.h"
@@ -299,5 +300,116 @@ TEST_CASE("[Image] Modifying pixels of an image") {
 			image3->get_pixel(1, 0).is_equal_approx(Color(0, 0, 0, 0)),
 			"flip_y() should not leave old pixels behind.");
 }
+
+static Ref<Image> make_noise_image(int p_width, int p_height) {
+	Vector<uint8_t> data;
+	data.resize(p_width * p_height * 4);
+	uint8_t *w = data.ptrw();
+	uint32_t seed = 12345;
+	for (int i = 0; i < data.size(); i++) {
+		seed = seed * 1103515245 + 12345;
+		w[i] = seed >> 24;
+	}
+	return memnew(Image(p_width, p_height, false, Image::FORMAT_RGBA8, data));
+}
+
+TEST_CASE("[Image] Processing large images") {
+	// Big enough to be processed in bands of rows on the worker pool.
+	const int size = 512;
+	Ref<Image> image = make_noise_image(size, size);
+	const Vector<uint8_t> source = image->get_data();
+
+	Ref<Image> mipmapped = memnew(Image);
+	mipmapped->copy_internals_from(image);
+	mipmapped->generate_mipmaps();
+	int ofs, mip_size, mip_width, mip_height;
+	mipmapped->get_mipmap_offset_size_and_dimensions(1, ofs, mip_size, mip_width, mip_height);
+	REQUIRE(mip_width == size / 2);
+	REQUIRE(mip_height == size / 2);
+	const Vector<uint8_t> mipmap_data = mipmapped->get_data();
+	bool mipmap_matches = true;
+	for (int y = 0; y < mip_height && mipmap_matches; y++) {
+		for (int x = 0; x < mip_width * 4; x++) {
+			int up = (y * 2 * size) * 4 + (x / 4) * 8 + x % 4;
+			int down = up + size * 4;
+			uint8_t expected = (source[up] + source[up + 4] + source[down] + source[down + 4] + 2) >> 2;
+			if (mipmap_data[ofs + y * mip_width * 4 + x] != expected) {
+				mipmap_matches = false;
+				break;
+			}
+		}
+	}
+	CHECK_MESSAGE(mipmap_matches, "Every mipmap pixel should be the rounded average of its four source pixels.");
+
+	Ref<Image> converted = memnew(Image);
+	converted->copy_internals_from(image);
+	converted->convert(Image::FORMAT_RGB8);
+	const Vector<uint8_t> converted_data = converted->get_data();
+	bool conversion_matches = true;
+	for (int i = 0; i < size * size; i++) {
+		if (converted_data[i * 3 + 0] != source[i * 4 + 0] || converted_data[i * 3 + 1] != source[i * 4 + 1] || converted_data[i * 3 + 2] != source[i * 4 + 2]) {
+			conversion_matches = false;
+			break;
+		}
+	}
+	CHECK_MESSAGE(conversion_matches, "Every pixel should be converted, including the last rows.");
+
+	// A horizontal gradient stays the same in every row after resizing, so missed rows show up.
+	// Row 0 is left out: the cubic kernel weights of its clamped samples don't add up to 1.
+	Ref<Image> gradient = memnew(Image(size, size, false, Image::FORMAT_RGBA8));
+	for (int y = 0; y < size; y++) {
+		for (int x = 0; x < size; x++) {
+			gradient->set_pixel(x, y, Color(x / float(size), 0.5, 1.0 - x / float(size)));
+		}
+	}
+	for (int i = 0; i < 4; i++) {
+		Ref<Image> resized = memnew(Image);
+		resized->copy_internals_from(gradient);
+		resized->resize(300, 700, static_cast<Image::Interpolation>(i));
+		bool rows_match = true;
+		for (int y = 2; y < 700 && rows_match; y++) {
+			for (int x = 0; x < 300; x += 7) {
+				if (resized->get_pixel(x, y) != resized->get_pixel(x, 1)) {
+					rows_match = false;
+					break;
+				}
+			}
+		}
+		CHECK_MESSAGE(rows_match, vformat("Every row should be resized the same way with interpolation %d.", i).utf8().get_data());
+	}
+}
+
+TEST_CASE_PENDING("[Image] Large image processing benchmark") {
+	// Microbenchmark, run with `--test --no-skip`.
+	const int size = 4096;
+	Ref<Image> image = make_noise_image(size, size);
+
+	Ref<Image> resized = memnew(Image);
+	resized->copy_internals_from(image);
+	uint64_t begin = OS::get_singleton()->get_ticks_usec();
+	resized->resize(size / 2 + 1, size / 2 + 1, Image::INTERPOLATE_BILINEAR);
+	uint64_t resize_usec = OS::get_singleton()->get_ticks_usec() - begin;
+
+	Ref<Image> mipmapped = memnew(Image);
+	mipmapped->copy_internals_from(image);
+	begin = OS::get_singleton()->get_ticks_usec();
+	mipmapped->generate_mipmaps();
+	uint64_t mipmaps_usec = OS::get_singleton()->get_ticks_usec() - begin;
+
+	Ref<Image> converted = memnew(Image);
+	converted->copy_internals_from(image);
+	begin = OS::get_singleton()->get_ticks_usec();
+	converted->convert(Image::FORMAT_RGB8);
+	uint64_t convert_usec = OS::get_singleton()->get_ticks_usec() - begin;
+
+	begin = OS::get_singleton()->get_ticks_usec();
+	converted->convert(Image::FORMAT_RGBAF);
+	uint64_t convert_float_usec = OS::get_singleton()->get_ticks_usec() - begin;
+
+	MESSAGE(vformat("%dx%d RGBA8 on %d worker threads.", size, size, WorkerThreadPool::get_singleton()->get_thread_count()).utf8().get_data());
+	MESSAGE(vformat("Bilinear resize: %d usec. Mipmaps: %d usec. To RGB8: %d usec. RGB8 to RGBAF: %d usec.", resize_usec, mipmaps_usec, convert_usec, convert_float_usec).utf8().get_data());
+	CHECK(resized->get_width() == size / 2 + 1);
+}
+
 } // namespace TestImage
 #endif // TEST_IMAGE_H
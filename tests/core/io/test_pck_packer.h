@@ -117,6 +117,95 @@ TEST_CASE("[PCKPacker] Pack a PCK file with some files and directories") {
 			f->get_length() <= 35000,
 			"The generated non-empty PCK file shouldn't be too large.");
 }
+
+static String _write_test_file(const String &p_name, const String &p_contents) {
+	const String path = OS::get_singleton()->get_cache_path().plus_file(p_name);
+	Ref<FileAccess> f = FileAccess::open(path, FileAccess::WRITE);
+	f->store_string(p_contents);
+	return path;
+}
+
+static String _read_packed_file(const String &p_path) {
+	Ref<FileAccess> f = PackedData::get_singleton()->try_open_path(p_path);
+	if (f.is_null()) {
+		return String();
+	}
+	return f->get_as_utf8_string();
+}
+
+TEST_CASE("[PCKPacker] Load packs with compressed files and overrides") {
+	String text;
+	for (int i = 0; i < 2000; i++) {
+		text += "Line " + itos(i % 100) + " of a file that compresses well.\n";
+	}
+	const String text_path = _write_test_file("pck_text.txt", text);
+	const String plain_path = _write_test_file("pck_plain.txt", "Original");
+	const String patched_path = _write_test_file("pck_patched.txt", "Patched");
+
+	const String base_pck_path = OS::get_singleton()->get_cache_path().plus_file("pck_base.pck");
+	PCKPacker base_packer;
+	REQUIRE(base_packer.pck_start(base_pck_path) == OK);
+	CHECK(base_packer.add_file("res://pck_test/text.txt", text_path, false, true) == OK);
+	CHECK(base_packer.add_file("res://pck_test/plain.txt", plain_path) == OK);
+	REQUIRE(base_packer.flush() == OK);
+
+	const String patch_pck_path = OS::get_singleton()->get_cache_path().plus_file("pck_patch.pck");
+	PCKPacker patch_packer;
+	REQUIRE(patch_packer.pck_start(patch_pck_path) == OK);
+	CHECK(patch_packer.add_file("res://pck_test/plain.txt", patched_path) == OK);
+	REQUIRE(patch_packer.flush() == OK);
+
+	PackedData *packed_data = PackedData::get_singleton();
+	REQUIRE(packed_data->add_pack(base_pck_path, true, 0) == OK);
+
+	CHECK(packed_data->has_path("res://pck_test/text.txt"));
+	CHECK(_read_packed_file("res://pck_test/text.txt") == text);
+	CHECK(_read_packed_file("res://pck_test/plain.txt") == "Original");
+
+	Ref<FileAccess> f = packed_data->try_open_path("res://pck_test/text.txt");
+	REQUIRE(f.is_valid());
+	CHECK_MESSAGE(f->get_length() == (uint64_t)text.length(), "Compressed files should report their uncompressed length.");
+	f->seek(text.length() - 6);
+	uint8_t tail[6];
+	CHECK(f->get_buffer(tail, 6) == 6);
+	CHECK(memcmp(tail, "well.\n", 6) == 0);
+
+	Ref<DirAccess> da = packed_data->try_open_directory("res://pck_test");
+	REQUIRE(da.is_valid());
+	CHECK(da->file_exists("text.txt"));
+	CHECK(da->file_exists("plain.txt"));
+
+	// Packs that don't replace files only add missing ones, the others override.
+	REQUIRE(packed_data->add_pack(patch_pck_path, false, 0) == OK);
+	CHECK(_read_packed_file("res://pck_test/plain.txt") == "Original");
+	REQUIRE(packed_data->add_pack(patch_pck_path, true, 0) == OK);
+	CHECK(_read_packed_file("res://pck_test/plain.txt") == "Patched");
+	CHECK(_read_packed_file("res://pck_test/text.txt") == text);
+}
+
+TEST_CASE("[PCKPacker] Reject packs with an out of bounds index") {
+	const String plain_path = _write_test_file("pck_plain.txt", "Original");
+	const String pck_path = OS::get_singleton()->get_cache_path().plus_file("pck_corrupt.pck");
+	PCKPacker packer;
+	REQUIRE(packer.pck_start(pck_path) == OK);
+	CHECK(packer.add_file("res://pck_corrupt/plain.txt", plain_path) == OK);
+	REQUIRE(packer.flush() == OK);
+
+	{
+		// The index size follows the magic, versions, flags, file base and index offset.
+		Ref<FileAccess> f = FileAccess::open(pck_path, FileAccess::READ_WRITE);
+		REQUIRE(f.is_valid());
+		f->seek(40);
+		f->store_64(uint64_t(1) << 40);
+	}
+
+	ERR_PRINT_OFF;
+	CHECK_MESSAGE(
+			PackedData::get_singleton()->add_pack(pck_path, true, 0) != OK,
+			"A pack whose index claims to extend past the end of the file should be rejected.");
+	ERR_PRINT_ON;
+	CHECK_FALSE(PackedData::get_singleton()->has_path("res://pck_corrupt/plain.txt"));
+}
 } // namespace TestPCKPacker
 
 #endif // TEST_PCK_PACKER_H
@@ -31,10 +31,12 @@
 #ifndef TEST_RESOURCE
 #define TEST_RESOURCE
 
+#include "core/io/file_access.h"
 #include "core/io/resource.h"
 #include "core/io/resource_loader.h"
 #include "core/io/resource_saver.h"
 #include "core/os/os.h"
+#include "core/os/thread.h"
 
 #include "thirdparty/doctest/doctest.h"
 
@@ -109,6 +111,168 @@ TEST_CASE("[Resource] Saving and loading") {
 			loaded_child_resource_text->get_name() == "I'm a child resource",
 			"The loaded child resource name should be equal to the expected value.");
 }
+
+TEST_CASE("[Resource] Loading a single sub-resource from a binary file") {
+	Ref<Resource> resource = memnew(Resource);
+	resource->set_name("Library");
+	Ref<Resource> first = memnew(Resource);
+	first->set_name("First");
+	first->set_scene_unique_id("first");
+	Ref<Resource> second = memnew(Resource);
+	second->set_name("Second");
+	second->set_scene_unique_id("second");
+	Ref<Resource> shared = memnew(Resource);
+	shared->set_name("Shared");
+	shared->set_scene_unique_id("shared");
+
+	// Big enough to be copied out of the file's mapping when it has one.
+	PackedFloat32Array samples;
+	samples.resize(32768);
+	for (int i = 0; i < samples.size(); i++) {
+		samples.write[i] = i * 0.5;
+	}
+	second->set_meta("samples", samples);
+	second->set_meta("shared", shared);
+	first->set_meta("shared", shared);
+	resource->set_meta("first", first);
+	resource->set_meta("second", second);
+
+	const String save_path = OS::get_singleton()->get_cache_path().plus_file("resource_library.res");
+	REQUIRE(ResourceSaver::save(save_path, resource) == OK);
+
+	Error err;
+	Ref<Resource> loaded_second = ResourceLoader::load_sub_resource(save_path, "second", ResourceFormatLoader::CACHE_MODE_IGNORE, &err);
+	REQUIRE_MESSAGE(err == OK, "The sub-resource should load.");
+	REQUIRE(loaded_second.is_valid());
+	CHECK_MESSAGE(
+			loaded_second->get_name() == "Second",
+			"The requested sub-resource should be returned.");
+	CHECK_MESSAGE(
+			PackedFloat32Array(loaded_second->get_meta("samples")) == samples,
+			"Large packed arrays should be read back intact.");
+	const Ref<Resource> &loaded_shared = loaded_second->get_meta("shared");
+	CHECK_MESSAGE(
+			(loaded_shared.is_valid() && loaded_shared->get_name() == "Shared"),
+			"Sub-resources referenced by the requested one should be loaded along with it.");
+
+	ERR_PRINT_OFF;
+	Ref<Resource> missing = ResourceLoader::load_sub_resource(save_path, "missing", ResourceFormatLoader::CACHE_MODE_IGNORE, &err);
+	ERR_PRINT_ON;
+	CHECK_MESSAGE(
+			(missing.is_null() && err == ERR_DOES_NOT_EXIST),
+			"Requesting an unknown sub-resource ID should fail.");
+
+	const Ref<Resource> &loaded_resource = ResourceLoader::load(save_path, "", ResourceFormatLoader::CACHE_MODE_IGNORE);
+	REQUIRE(loaded_resource.is_valid());
+	const Ref<Resource> &loaded_first = loaded_resource->get_meta("first");
+	const Ref<Resource> &loaded_second_full = loaded_resource->get_meta("second");
+	CHECK_MESSAGE(
+			loaded_first->get_meta("shared") == loaded_second_full->get_meta("shared"),
+			"A sub-resource referenced twice should only be materialized once.");
+	CHECK_MESSAGE(
+			PackedFloat32Array(loaded_second_full->get_meta("samples")) == samples,
+			"Large packed arrays should be read back intact.");
+
+	// Exported projects convert text resources to binary ones and leave a remap file behind.
+	const String remapped_path = OS::get_singleton()->get_cache_path().plus_file("resource_library.tres");
+	{
+		Ref<FileAccess> f = FileAccess::open(remapped_path + ".remap", FileAccess::WRITE);
+		REQUIRE(f.is_valid());
+		f->store_line("[remap]");
+		f->store_line("");
+		f->store_line("path=\"" + save_path + "\"");
+	}
+	Ref<Resource> remapped_second = ResourceLoader::load_sub_resource(remapped_path, "second", ResourceFormatLoader::CACHE_MODE_IGNORE, &err);
+	CHECK_MESSAGE(
+			(err == OK && remapped_second.is_valid() && remapped_second->get_name() == "Second"),
+			"Sub-resources should be loaded through export remaps.");
+
+	const Ref<Resource> &cached_resource = ResourceLoader::load(save_path);
+	REQUIRE(cached_resource.is_valid());
+	const Ref<Resource> &cached_first = cached_resource->get_meta("first");
+	const Ref<Resource> &cached_shared = cached_first->get_meta("shared");
+	CHECK_MESSAGE(
+			ResourceLoader::load_sub_resource(save_path, "shared") == cached_shared,
+			"Sub-resources of a cached load should be reused from the cache.");
+}
+
+struct ThreadedGetData {
+	String path;
+	Ref<Resource> resource;
+	Error error = FAILED;
+};
+
+static void threaded_get(void *p_userdata) {
+	ThreadedGetData *data = static_cast<ThreadedGetData *>(p_userdata);
+	data->resource = ResourceLoader::load_threaded_get(data->path, &data->error);
+}
+
+TEST_CASE("[Resource] Threaded loading") {
+	const String dependency_path = OS::get_singleton()->get_cache_path().plus_file("resource_threaded_dependency.res");
+	const String save_path = OS::get_singleton()->get_cache_path().plus_file("resource_threaded.res");
+	{
+		Ref<Resource> dependency = memnew(Resource);
+		dependency->set_name("Dependency");
+		REQUIRE(ResourceSaver::save(dependency_path, dependency, ResourceSaver::FLAG_CHANGE_PATH) == OK);
+		Ref<Resource> resource = memnew(Resource);
+		resource->set_name("Resource");
+		resource->set_meta("dependency", dependency);
+		REQUIRE(ResourceSaver::save(save_path, resource) == OK);
+	}
+
+	SUBCASE("Dependencies are prefetched with the cache mode of the resource") {
+		Ref<Resource> cached_dependency = ResourceLoader::load(dependency_path);
+		REQUIRE(cached_dependency.is_valid());
+
+		REQUIRE(ResourceLoader::load_threaded_request(save_path, "", true, ResourceFormatLoader::CACHE_MODE_IGNORE) == OK);
+		Error err;
+		Ref<Resource> loaded = ResourceLoader::load_threaded_get(save_path, &err);
+		REQUIRE(err == OK);
+		REQUIRE(loaded.is_valid());
+		const Ref<Resource> &loaded_dependency = loaded->get_meta("dependency");
+		REQUIRE(loaded_dependency.is_valid());
+		CHECK(loaded_dependency->get_name() == "Dependency");
+		CHECK_MESSAGE(
+				loaded_dependency != cached_dependency,
+				"Dependencies of a resource loaded ignoring the cache should not come from the cache.");
+		CHECK_MESSAGE(
+				ResourceCache::get(dependency_path) == cached_dependency.ptr(),
+				"Dependencies loaded ignoring the cache should not replace cached ones.");
+
+		REQUIRE(ResourceLoader::load_threaded_request(save_path, "", true, ResourceFormatLoader::CACHE_MODE_REUSE) == OK);
+		loaded = ResourceLoader::load_threaded_get(save_path, &err);
+		REQUIRE(err == OK);
+		REQUIRE(loaded.is_valid());
+		CHECK_MESSAGE(
+				loaded->get_meta("dependency") == cached_dependency,
+				"Dependencies of a resource reusing the cache should come from the cache.");
+	}
+
+	SUBCASE("Several threads can get the same resource") {
+		REQUIRE(ResourceLoader::load_threaded_request(save_path, "", true, ResourceFormatLoader::CACHE_MODE_IGNORE) == OK);
+		REQUIRE(ResourceLoader::load_threaded_request(save_path, "", true, ResourceFormatLoader::CACHE_MODE_IGNORE) == OK);
+
+		ThreadedGetData data;
+		data.path = save_path;
+		Thread thread;
+		thread.start(threaded_get, &data);
+		Error err;
+		Ref<Resource> loaded = ResourceLoader::load_threaded_get(save_path, &err);
+		thread.wait_to_finish();
+
+		CHECK(err == OK);
+		CHECK(data.error == OK);
+		REQUIRE(loaded.is_valid());
+		CHECK_MESSAGE(
+				data.resource == loaded,
+				"Every caller should get the same resource.");
+		const Ref<Resource> &loaded_dependency = loaded->get_meta("dependency");
+		CHECK((loaded_dependency.is_valid() && loaded_dependency->get_name() == "Dependency"));
+		CHECK_MESSAGE(
+				ResourceLoader::load_threaded_get_status(save_path) == ResourceLoader::THREAD_LOAD_INVALID_RESOURCE,
+				"The load should be released once every request was gotten.");
+	}
+}
 } // namespace TestResource
 
 #endif // TEST_RESOURCE
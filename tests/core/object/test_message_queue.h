@@ -0,0 +1,169 @@
+/*************************************************************************/
+/*  test_message_queue.h                                                 */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2022 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2022 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef TEST_MESSAGE_QUEUE_H
+#define TEST_MESSAGE_QUEUE_H
+
+#include "core/object/message_queue.h"
+#include "core/object/object.h"
+#include "core/os/os.h"
+#include "core/os/thread.h"
+
+#include "tests/test_macros.h"
+
+namespace TestMessageQueue {
+
+// Creates a queue for the duration of a test, unless one already exists.
+class ScopedMessageQueue {
+	MessageQueue *own_queue = nullptr;
+
+public:
+	ScopedMessageQueue() {
+		if (!MessageQueue::get_singleton()) {
+			own_queue = memnew(MessageQueue);
+		}
+	}
+	~ScopedMessageQueue() {
+		if (own_queue) {
+			memdelete(own_queue);
+		}
+	}
+};
+
+TEST_CASE("[MessageQueue] Calls run in push order") {
+	ScopedMessageQueue scoped_queue;
+	Object *object = memnew(Object);
+
+	for (int i = 0; i < 100; i++) {
+		MessageQueue::get_singleton()->push_call(object, "set_meta", "value", i);
+	}
+	CHECK(!object->has_meta("value"));
+
+	MessageQueue::get_singleton()->flush();
+	CHECK(int(object->get_meta("value")) == 99);
+	CHECK(MessageQueue::get_singleton()->get_stats().last_flush_messages == 100);
+
+	memdelete(object);
+}
+
+TEST_CASE("[MessageQueue] No capacity limit") {
+	ScopedMessageQueue scoped_queue;
+	Object *object = memnew(Object);
+
+	// Several segments worth of messages.
+	const int count = 50000;
+	for (int i = 0; i < count; i++) {
+		MessageQueue::get_singleton()->push_set(object, "value_" + itos(i % 10), i);
+	}
+	MessageQueue::get_singleton()->flush();
+
+	MessageQueue::Stats stats = MessageQueue::get_singleton()->get_stats();
+	CHECK(stats.last_flush_messages == count);
+	CHECK(stats.max_flush_bytes > 64 * 1024);
+
+	memdelete(object);
+}
+
+struct ProducerData {
+	Object *object = nullptr;
+	int index = 0;
+};
+
+static const int PRODUCER_MESSAGES = 1000;
+
+static void producer_thread(void *p_userdata) {
+	ProducerData *data = (ProducerData *)p_userdata;
+	String name = "producer_" + itos(data->index);
+	for (int i = 0; i < PRODUCER_MESSAGES; i++) {
+		MessageQueue::get_singleton()->push_call(data->object, "set_meta", name, i);
+	}
+}
+
+TEST_CASE("[MessageQueue] Multiple producers keep their order") {
+	ScopedMessageQueue scoped_queue;
+	Object *object = memnew(Object);
+
+	const int producer_count = 4;
+	Thread threads[producer_count];
+	ProducerData data[producer_count];
+	for (int i = 0; i < producer_count; i++) {
+		data[i].object = object;
+		data[i].index = i;
+		threads[i].start(producer_thread, &data[i]);
+	}
+	for (int i = 0; i < producer_count; i++) {
+		threads[i].wait_to_finish();
+	}
+
+	MessageQueue::get_singleton()->flush();
+	CHECK(MessageQueue::get_singleton()->get_stats().last_flush_messages == producer_count * PRODUCER_MESSAGES);
+	for (int i = 0; i < producer_count; i++) {
+		CHECK(int(object->get_meta("producer_" + itos(i))) == PRODUCER_MESSAGES - 1);
+	}
+
+	// Exited threads no longer hold a stream once drained.
+	CHECK(MessageQueue::get_singleton()->get_stats().producers <= 1);
+
+	memdelete(object);
+}
+
+TEST_CASE_PENDING("[MessageQueue] Concurrent push benchmark") {
+	// Microbenchmark, run with `--test --no-skip`.
+	ScopedMessageQueue scoped_queue;
+	Object *object = memnew(Object);
+
+	const int producer_count = 8;
+	Thread threads[producer_count];
+	ProducerData data[producer_count];
+	uint64_t begin = OS::get_singleton()->get_ticks_usec();
+	for (int i = 0; i < producer_count; i++) {
+		data[i].object = object;
+		data[i].index = i;
+		threads[i].start(producer_thread, &data[i]);
+	}
+	for (int i = 0; i < producer_count; i++) {
+		threads[i].wait_to_finish();
+	}
+	uint64_t push_usec = OS::get_singleton()->get_ticks_usec() - begin;
+
+	begin = OS::get_singleton()->get_ticks_usec();
+	MessageQueue::get_singleton()->flush();
+	uint64_t flush_usec = OS::get_singleton()->get_ticks_usec() - begin;
+
+	MessageQueue::Stats stats = MessageQueue::get_singleton()->get_stats();
+	MESSAGE(producer_count, " threads pushed ", producer_count * PRODUCER_MESSAGES, " calls in ", push_usec, " usec, flushed in ", flush_usec, " usec.");
+	MESSAGE("Max latency: ", stats.last_flush_max_latency_usec, " usec, average: ", stats.last_flush_avg_latency_usec, " usec.");
+
+	memdelete(object);
+}
+
+} // namespace TestMessageQueue
+
+#endif // TEST_MESSAGE_QUEUE_H
@@ -0,0 +1,178 @@
+/*************************************************************************/
+/*  test_worker_thread_pool.h                                            */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2022 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2022 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef TEST_WORKER_THREAD_POOL_H
+#define TEST_WORKER_THREAD_POOL_H
+
+#include "core/os/os.h"
+#include "core/os/worker_thread_pool.h"
+#include "core/templates/thread_work_pool.h"
+
+#include "tests/test_macros.h"
+
+namespace TestWorkerThreadPool {
+
+class Counter {
+public:
+	SafeNumeric<uint64_t> sum;
+	SafeNumeric<uint32_t> order_check;
+	SafeNumeric<uint32_t> ran_outside_workers;
+	bool dependency_was_done = false;
+
+	void add_index(uint32_t p_index, uint32_t p_mul) {
+		sum.add(p_index * p_mul);
+	}
+
+	void add_value(uint32_t p_value) {
+		sum.add(p_value);
+		order_check.set(1);
+	}
+
+	void check_dependency(uint32_t p_value) {
+		dependency_was_done = order_check.get() == 1;
+	}
+
+	void record_worker(uint32_t p_value) {
+		sum.add(p_value);
+		if (WorkerThreadPool::get_current_worker_index() < 0) {
+			ran_outside_workers.increment();
+		}
+	}
+
+	void nested(uint32_t p_index, uint32_t p_elements) {
+		WorkerThreadPool *pool = WorkerThreadPool::get_singleton();
+		WorkerThreadPool::TaskID group = pool->add_template_group_task(this, &Counter::add_index, 1u, p_elements);
+		pool->wait_for_group_task_completion(group);
+	}
+};
+
+TEST_CASE("[WorkerThreadPool] Group task processes every element once") {
+	WorkerThreadPool *pool = WorkerThreadPool::get_singleton();
+	Counter counter;
+
+	WorkerThreadPool::TaskID group = pool->add_template_group_task(&counter, &Counter::add_index, 2u, 1000);
+	pool->wait_for_group_task_completion(group);
+
+	CHECK_MESSAGE(
+			counter.sum.get() == 999000,
+			"Every element should have been processed exactly once.");
+}
+
+TEST_CASE("[WorkerThreadPool] Empty group task completes") {
+	WorkerThreadPool *pool = WorkerThreadPool::get_singleton();
+	Counter counter;
+
+	WorkerThreadPool::TaskID group = pool->add_template_group_task(&counter, &Counter::add_index, 1u, 0);
+	CHECK(pool->is_group_task_completed(group));
+	pool->wait_for_group_task_completion(group);
+	CHECK(counter.sum.get() == 0);
+}
+
+TEST_CASE("[WorkerThreadPool] Dependencies run in order") {
+	WorkerThreadPool *pool = WorkerThreadPool::get_singleton();
+	Counter counter;
+
+	WorkerThreadPool::TaskID first = pool->add_template_task(&counter, &Counter::add_value, 5u);
+	Vector<WorkerThreadPool::TaskID> dependencies;
+	dependencies.push_back(first);
+	WorkerThreadPool::TaskID second = pool->add_template_task(&counter, &Counter::check_dependency, 0u, dependencies);
+
+	pool->wait_for_task_completion(second);
+	pool->wait_for_task_completion(first);
+
+	CHECK(counter.sum.get() == 5);
+	CHECK_MESSAGE(
+			counter.dependency_was_done,
+			"A task should only start once its dependencies completed.");
+}
+
+TEST_CASE("[WorkerThreadPool] Nested groups") {
+	WorkerThreadPool *pool = WorkerThreadPool::get_singleton();
+	Counter counter;
+
+	WorkerThreadPool::TaskID group = pool->add_template_group_task(&counter, &Counter::nested, 100u, 64);
+	pool->wait_for_group_task_completion(group);
+
+	CHECK_MESSAGE(
+			counter.sum.get() == 64 * 4950,
+			"Groups added from inside tasks should complete.");
+}
+
+TEST_CASE("[WorkerThreadPool] Threads outside the pool only run what they wait on") {
+	WorkerThreadPool *pool = WorkerThreadPool::get_singleton();
+	Counter counter;
+
+	Vector<WorkerThreadPool::TaskID> unrelated;
+	for (int i = 0; i < 64; i++) {
+		unrelated.push_back(pool->add_template_task(&counter, &Counter::record_worker, 1u));
+	}
+	WorkerThreadPool::TaskID awaited = pool->add_template_task(&counter, &Counter::add_value, 1u);
+	pool->wait_for_task_completion(awaited);
+	uint32_t ran_outside = counter.ran_outside_workers.get();
+	for (int i = 0; i < unrelated.size(); i++) {
+		pool->wait_for_task_completion(unrelated[i]);
+	}
+
+	CHECK(counter.sum.get() == 65);
+	if (pool->get_thread_count() > 0) {
+		CHECK_MESSAGE(
+				ran_outside == 0,
+				"Waiting from outside the pool should not run unrelated tasks.");
+	}
+}
+
+TEST_CASE("[ThreadWorkPool] Compatibility wrapper") {
+	ThreadWorkPool work_pool;
+	work_pool.init();
+	Counter counter;
+
+	work_pool.begin_work(1000, &counter, &Counter::add_index, 1u);
+	CHECK(work_pool.is_working());
+	if (WorkerThreadPool::get_singleton()->get_thread_count() > 0) {
+		while (!work_pool.is_done_dispatching()) {
+			OS::get_singleton()->delay_usec(1);
+		}
+		CHECK_MESSAGE(
+				work_pool.get_work_index() == 1000,
+				"The work index should count dispatched elements, capped to the element count.");
+	}
+	work_pool.end_work();
+	CHECK_FALSE(work_pool.is_working());
+	CHECK(counter.sum.get() == 499500);
+
+	work_pool.do_work(10, &counter, &Counter::add_index, 1u);
+	CHECK(counter.sum.get() == 499500 + 45);
+
+	work_pool.finish();
+}
+
+} // namespace TestWorkerThreadPool
+
+#endif // TEST_WORKER_THREAD_POOL_H
@@ -0,0 +1,122 @@
+/*************************************************************************/
+/*  test_string_name.h                                                   */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2022 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2022 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef TEST_STRING_NAME_H
+#define TEST_STRING_NAME_H
+
+#include "core/os/os.h"
+#include "core/os/worker_thread_pool.h"
+#include "core/string/string_name.h"
+
+#include "tests/test_macros.h"
+
+namespace TestStringName {
+
+TEST_CASE("[StringName] Interning") {
+	const StringName a = "test_string_name_interning";
+	const StringName b = String("test_string_name_interning");
+	const StringName c = StringName(StaticCString::create("test_string_name_interning"));
+
+	CHECK(a.data_unique_pointer() == b.data_unique_pointer());
+	CHECK(a.data_unique_pointer() == c.data_unique_pointer());
+	CHECK(StringName::search("test_string_name_interning") == a);
+	CHECK(String(a) == "test_string_name_interning");
+
+	CHECK(StringName("") == StringName());
+	CHECK(StringName::search("test_string_name_never_interned") == StringName());
+}
+
+class Interner {
+public:
+	Vector<String> names;
+	LocalVector<StringName> interned;
+	SafeFlag mismatch;
+	int rounds = 1;
+
+	void intern(uint32_t p_index, void *p_userdata) {
+		for (int round = 0; round < rounds; round++) {
+			for (int i = 0; i < names.size(); i++) {
+				// Start at a different name on each task so shards are hit concurrently.
+				int name_index = (i + p_index * 7) % names.size();
+				StringName name = names[name_index];
+				const StringName &expected = interned[name_index];
+				bool matches = expected == StringName() ? String(name) == names[name_index] : name == expected;
+				if (!matches) {
+					mismatch.set();
+				}
+			}
+		}
+	}
+};
+
+TEST_CASE("[StringName] Concurrent interning") {
+	Interner interner;
+	for (int i = 0; i < 512; i++) {
+		interner.names.push_back("test_string_name_concurrent_" + itos(i));
+	}
+	// Half of the names stay alive, the others are created and freed by the tasks.
+	for (int i = 0; i < interner.names.size(); i++) {
+		interner.interned.push_back(i % 2 ? StringName(interner.names[i]) : StringName());
+	}
+
+	WorkerThreadPool *pool = WorkerThreadPool::get_singleton();
+	WorkerThreadPool::TaskID group = pool->add_template_group_task(&interner, &Interner::intern, nullptr, 64);
+	pool->wait_for_group_task_completion(group);
+
+	CHECK_FALSE(interner.mismatch.is_set());
+}
+
+TEST_CASE_PENDING("[StringName] Intern throughput under contention") {
+	// Microbenchmark, run with `--test --no-skip`.
+	Interner interner;
+	for (int i = 0; i < 4096; i++) {
+		interner.names.push_back("test_string_name_benchmark_" + itos(i));
+	}
+	for (int i = 0; i < interner.names.size(); i++) {
+		interner.interned.push_back(StringName(interner.names[i]));
+	}
+	interner.rounds = 64;
+
+	WorkerThreadPool *pool = WorkerThreadPool::get_singleton();
+	int tasks = MAX(pool->get_thread_count(), 1);
+
+	uint64_t begin = OS::get_singleton()->get_ticks_usec();
+	WorkerThreadPool::TaskID group = pool->add_template_group_task(&interner, &Interner::intern, nullptr, tasks);
+	pool->wait_for_group_task_completion(group);
+	uint64_t elapsed = MAX(OS::get_singleton()->get_ticks_usec() - begin, (uint64_t)1);
+
+	uint64_t lookups = uint64_t(tasks) * interner.rounds * interner.names.size();
+	MESSAGE(vformat("%d lookups on %d threads in %d usec (%d lookups/msec).", lookups, tasks, elapsed, lookups * 1000 / elapsed).utf8().get_data());
+	CHECK_FALSE(interner.mismatch.is_set());
+}
+
+} // namespace TestStringName
+
+#endif // TEST_STRING_NAME_H
@@ -0,0 +1,150 @@
+/*************************************************************************/
+/*  test_arena_allocator.h                                               */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2022 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2022 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef TEST_ARENA_ALLOCATOR_H
+#define TEST_ARENA_ALLOCATOR_H
+
+#include "core/os/os.h"
+#include "core/templates/arena_allocator.h"
+#include "core/templates/list.h"
+#include "core/templates/paged_allocator.h"
+
+#include "tests/test_macros.h"
+
+namespace TestArenaAllocator {
+
+TEST_CASE("[ArenaAllocator] Alignment and growth") {
+	ArenaAllocator arena(256);
+	uint8_t *byte = arena.alloc_array<uint8_t>(1);
+	double *doubles = arena.alloc_array<double>(4);
+	CHECK(byte != nullptr);
+	CHECK(((uintptr_t)doubles % alignof(double)) == 0);
+
+	// Doesn't fit in the first block.
+	uint32_t *big = arena.alloc_array<uint32_t>(1000);
+	for (uint32_t i = 0; i < 1000; i++) {
+		big[i] = i;
+	}
+	CHECK(big[999] == 999);
+	CHECK(arena.get_capacity() >= 256 + 4000);
+}
+
+TEST_CASE("[ArenaAllocator] Rewind to mark") {
+	ArenaAllocator arena(256);
+	int *first = arena.alloc_array<int>(8);
+	ArenaAllocator::Mark mark = arena.get_mark();
+
+	int *second = arena.alloc_array<int>(8);
+	arena.alloc_array<int>(1000);
+	arena.rewind(mark);
+
+	// Memory after the mark is handed out again, memory before it is kept.
+	CHECK(arena.alloc_array<int>(8) == second);
+	CHECK(first != second);
+}
+
+TEST_CASE("[ArenaAllocator] Reset merges blocks") {
+	ArenaAllocator arena(256);
+	for (int i = 0; i < 16; i++) {
+		arena.alloc(200);
+	}
+	uint64_t capacity = arena.get_capacity();
+	arena.reset();
+
+	// The next cycle fits into a single block, without allocating.
+	void *first = arena.alloc(200);
+	for (int i = 1; i < 16; i++) {
+		arena.alloc(200);
+	}
+	CHECK(arena.get_capacity() <= capacity);
+	arena.reset();
+	CHECK(arena.alloc(200) == first);
+}
+
+TEST_CASE("[ArenaAllocator] Thread arena scope") {
+	ArenaAllocator &arena = ArenaAllocator::get_thread_arena();
+	ArenaAllocator::Mark before = arena.get_mark();
+	{
+		ArenaAllocator::Scope scope;
+		scope.get_arena().alloc(64);
+		CHECK(arena.get_mark().used != before.used);
+	}
+	CHECK(arena.get_mark().block == before.block);
+	CHECK(arena.get_mark().used == before.used);
+}
+
+TEST_CASE("[PagedSizeClassAllocator] Use as container allocator") {
+	List<int, PagedSizeClassAllocator<64>> list;
+	for (int i = 0; i < 1000; i++) {
+		list.push_back(i);
+	}
+	for (int i = 0; i < 500; i++) {
+		list.pop_front();
+	}
+	CHECK(list.size() == 500);
+	CHECK(list.front()->get() == 500);
+	CHECK(list.back()->get() == 999);
+}
+
+TEST_CASE_PENDING("[ArenaAllocator] Scratch allocation benchmark") {
+	// Microbenchmark, run with `--test --no-skip`.
+	const int rounds = 1000;
+	const int count = 256;
+
+	uint64_t malloc_count = Memory::get_tag_alloc_count(Memory::TAG_DEFAULT);
+	uint64_t begin = OS::get_singleton()->get_ticks_usec();
+	for (int round = 0; round < rounds; round++) {
+		for (int i = 0; i < count; i++) {
+			void *mem = memalloc(64 + i);
+			memfree(mem);
+		}
+	}
+	uint64_t malloc_usec = OS::get_singleton()->get_ticks_usec() - begin;
+	malloc_count = Memory::get_tag_alloc_count(Memory::TAG_DEFAULT) - malloc_count;
+
+	ArenaAllocator arena;
+	uint64_t arena_count = Memory::get_tag_alloc_count(Memory::TAG_DEFAULT);
+	begin = OS::get_singleton()->get_ticks_usec();
+	for (int round = 0; round < rounds; round++) {
+		for (int i = 0; i < count; i++) {
+			arena.alloc(64 + i);
+		}
+		arena.reset();
+	}
+	uint64_t arena_usec = OS::get_singleton()->get_ticks_usec() - begin;
+	arena_count = Memory::get_tag_alloc_count(Memory::TAG_DEFAULT) - arena_count;
+
+	MESSAGE("memalloc: ", malloc_usec, " usec, ", malloc_count, " allocations.");
+	MESSAGE("ArenaAllocator: ", arena_usec, " usec, ", arena_count, " allocations.");
+}
+
+} // namespace TestArenaAllocator
+
+#endif // TEST_ARENA_ALLOCATOR_H
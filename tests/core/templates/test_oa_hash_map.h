@@ -0,0 +1,176 @@
+/*************************************************************************/
+/*  test_oa_hash_map.h                                                   */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2022 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2022 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef TEST_OA_HASH_MAP_H
+#define TEST_OA_HASH_MAP_H
+
+#include "core/os/os.h"
+#include "core/templates/hash_map.h"
+#include "core/templates/oa_hash_map.h"
+
+#include "tests/test_macros.h"
+
+namespace TestOAHashMap {
+
+TEST_CASE("[OAHashMap] Empty map doesn't allocate") {
+	OAHashMap<int, int> map;
+	CHECK(map.get_capacity() == 0);
+	CHECK(map.is_empty());
+	CHECK(!map.has(42));
+	CHECK(map.lookup_ptr(42) == nullptr);
+	map.remove(42);
+
+	CHECK(!map.iter().valid);
+}
+
+TEST_CASE("[OAHashMap] Insert, set and lookup") {
+	OAHashMap<int, int> map;
+	map.insert(42, 84);
+	map.set(42, 1234);
+	map.set(1, 2);
+
+	int value = 0;
+	CHECK(map.lookup(42, value));
+	CHECK(value == 1234);
+	CHECK(*map.lookup_ptr(1) == 2);
+	CHECK(map.get_num_elements() == 2);
+	CHECK(map.get_capacity() >= 8);
+	CHECK(next_power_of_2(map.get_capacity()) == map.get_capacity());
+}
+
+TEST_CASE("[OAHashMap] Remove") {
+	OAHashMap<int, int> map;
+	for (int i = 0; i < 100; i++) {
+		map.set(i, i * 2);
+	}
+	for (int i = 0; i < 100; i += 2) {
+		map.remove(i);
+	}
+
+	CHECK(map.get_num_elements() == 50);
+	for (int i = 0; i < 100; i++) {
+		CHECK(map.has(i) == (i % 2 == 1));
+	}
+}
+
+TEST_CASE("[OAHashMap] Clustered keys") {
+	// Keys sharing their low bits must still be spread over the table.
+	OAHashMap<uint32_t, uint32_t> map;
+	for (uint32_t i = 0; i < 4096; i++) {
+		map.set(i << 16, i);
+	}
+
+	CHECK(map.get_num_elements() == 4096);
+	bool all_found = true;
+	for (uint32_t i = 0; i < 4096; i++) {
+		const uint32_t *value = map.lookup_ptr(i << 16);
+		all_found = all_found && value && *value == i;
+	}
+	CHECK(all_found);
+}
+
+TEST_CASE("[OAHashMap] Iteration and copy") {
+	OAHashMap<int, int> map;
+	for (int i = 0; i < 20; i++) {
+		map.set(i, i);
+	}
+
+	OAHashMap<int, int> copy = map;
+	int sum = 0;
+	for (OAHashMap<int, int>::Iterator it = copy.iter(); it.valid; it = copy.next_iter(it)) {
+		CHECK(*it.key == *it.value);
+		sum += *it.value;
+	}
+	CHECK(sum == 190);
+
+	copy = OAHashMap<int, int>();
+	CHECK(copy.is_empty());
+	CHECK(map.get_num_elements() == 20);
+}
+
+TEST_CASE("[OAHashMap] Remove while iterating") {
+	OAHashMap<String, int> map;
+	for (int i = 0; i < 20; i++) {
+		map.set(itos(i), i);
+	}
+
+	// Removing invalidates iterators, so iteration restarts after each removal.
+	for (OAHashMap<String, int>::Iterator it = map.iter(); it.valid; it = map.iter()) {
+		map.remove(String(*it.key));
+	}
+	CHECK(map.is_empty());
+}
+
+TEST_CASE_PENDING("[OAHashMap] Lookup benchmark against HashMap") {
+	// Microbenchmark, run with `--test --no-skip`.
+	const int count = 100000;
+	Vector<StringName> names;
+	for (int i = 0; i < count; i++) {
+		names.push_back(StringName("oa_hash_map_benchmark_" + itos(i)));
+	}
+
+	uint64_t memory_before = Memory::get_mem_usage();
+	HashMap<StringName, int> hash_map;
+	for (int i = 0; i < count; i++) {
+		hash_map[names[i]] = i;
+	}
+	uint64_t hash_map_memory = Memory::get_mem_usage() - memory_before;
+
+	memory_before = Memory::get_mem_usage();
+	OAHashMap<StringName, int> oa_hash_map;
+	for (int i = 0; i < count; i++) {
+		oa_hash_map.set(names[i], i);
+	}
+	uint64_t oa_hash_map_memory = Memory::get_mem_usage() - memory_before;
+
+	int64_t sum = 0;
+	uint64_t begin = OS::get_singleton()->get_ticks_usec();
+	for (int round = 0; round < 10; round++) {
+		for (int i = 0; i < count; i++) {
+			sum += *hash_map.getptr(names[i]);
+		}
+	}
+	uint64_t hash_map_usec = OS::get_singleton()->get_ticks_usec() - begin;
+
+	begin = OS::get_singleton()->get_ticks_usec();
+	for (int round = 0; round < 10; round++) {
+		for (int i = 0; i < count; i++) {
+			sum -= *oa_hash_map.lookup_ptr(names[i]);
+		}
+	}
+	uint64_t oa_hash_map_usec = OS::get_singleton()->get_ticks_usec() - begin;
+
+	MESSAGE(vformat("HashMap: %d bytes, %d usec. OAHashMap: %d bytes, %d usec.", hash_map_memory, hash_map_usec, oa_hash_map_memory, oa_hash_map_usec).utf8().get_data());
+	CHECK(sum == 0);
+}
+
+} // namespace TestOAHashMap
+
+#endif // TEST_OA_HASH_MAP_H
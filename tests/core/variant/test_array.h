@@ -97,6 +97,39 @@ TEST_CASE("[Array] append_array()") {
 	CHECK(int(arr1[1]) == 2);
 }
 
+TEST_CASE("[Array] append_array() and typed_assign() on typed arrays") {
+	Array typed;
+	typed.set_typed(Variant::INT, StringName(), Variant());
+
+	Array ints;
+	ints.push_back(1);
+	ints.push_back(2);
+	typed.append_array(ints);
+	CHECK(typed.size() == 2);
+
+	Array mixed;
+	mixed.push_back(3);
+	mixed.push_back("four");
+	ERR_PRINT_OFF;
+	typed.append_array(mixed);
+	ERR_PRINT_ON;
+	CHECK_MESSAGE(typed.size() == 2, "Elements of the wrong type should be rejected.");
+
+	Array assigned;
+	assigned.set_typed(Variant::INT, StringName(), Variant());
+	CHECK(assigned.typed_assign(ints));
+	CHECK(assigned == ints);
+
+	Array floats;
+	floats.push_back(1.0);
+	floats.push_back(2.5);
+	Array converted;
+	converted.set_typed(Variant::INT, StringName(), Variant());
+	CHECK(converted.typed_assign(floats));
+	CHECK(converted[1].get_type() == Variant::INT);
+	CHECK(int(converted[1]) == 2);
+}
+
 TEST_CASE("[Array] resize(), insert(), and erase()") {
 	Array arr;
 	arr.resize(2);
@@ -0,0 +1,162 @@
+/*************************************************************************/
+/*  test_packed_array_math.h                                             */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2022 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2022 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef TEST_PACKED_ARRAY_MATH_H
+#define TEST_PACKED_ARRAY_MATH_H
+
+#include "core/os/os.h"
+#include "core/variant/variant.h"
+#include "tests/test_macros.h"
+
+namespace TestPackedArrayMath {
+
+static PackedFloat32Array make_floats(int p_size) {
+	PackedFloat32Array floats;
+	floats.resize(p_size);
+	for (int i = 0; i < p_size; i++) {
+		floats.set(i, i);
+	}
+	return floats;
+}
+
+TEST_CASE("[PackedFloat32Array] Bulk math") {
+	Variant v = make_floats(5);
+
+	v.call("add_scalar", 1.0);
+	v.call("multiply_scalar", 2.0);
+	PackedFloat32Array r = v;
+	CHECK(r == Vector<float>({ 2, 4, 6, 8, 10 }));
+
+	v.call("add_array", make_floats(5));
+	r = v;
+	CHECK(r == Vector<float>({ 2, 5, 8, 11, 14 }));
+
+	v.call("multiply_array", make_floats(5));
+	r = v;
+	CHECK(r == Vector<float>({ 0, 5, 16, 33, 56 }));
+
+	v.call("lerp_array", make_floats(5), 1.0);
+	r = v;
+	CHECK(r == make_floats(5));
+
+	CHECK(double(v.call("sum")) == doctest::Approx(10.0));
+	CHECK(double(v.call("dot", make_floats(5))) == doctest::Approx(30.0));
+	CHECK(double(v.call("min")) == doctest::Approx(0.0));
+	CHECK(double(v.call("max")) == doctest::Approx(4.0));
+
+	ERR_PRINT_OFF;
+	v.call("add_array", make_floats(2));
+	ERR_PRINT_ON;
+	r = v;
+	CHECK_MESSAGE(r == make_floats(5), "Arrays of different sizes should be rejected.");
+}
+
+TEST_CASE("[PackedFloat32Array] Bulk math doesn't modify copies") {
+	PackedFloat32Array original = make_floats(3);
+	Variant v = original;
+	v.call("add_scalar", 1.0);
+	CHECK(original == make_floats(3));
+}
+
+TEST_CASE("[PackedVector3Array] Bulk math") {
+	PackedVector3Array points;
+	points.push_back(Vector3(1, 0, 0));
+	points.push_back(Vector3(0, 2, 0));
+	points.push_back(Vector3(0, 0, 3));
+	Variant v = points;
+
+	Transform3D xform(Basis(), Vector3(1, 1, 1));
+	v.call("transform", xform);
+	PackedVector3Array r = v;
+	for (int i = 0; i < points.size(); i++) {
+		CHECK(r[i].is_equal_approx(xform.xform(points[i])));
+	}
+
+	v.call("translate", Vector3(-1, -1, -1));
+	v.call("multiply_scalar", 2.0);
+	v.call("add_array", points);
+	v.call("multiply_array", points);
+	r = v;
+	CHECK(r[0].is_equal_approx(Vector3(3, 0, 0)));
+	CHECK(r[1].is_equal_approx(Vector3(0, 12, 0)));
+	CHECK(r[2].is_equal_approx(Vector3(0, 0, 27)));
+
+	CHECK(Vector3(v.call("sum")).is_equal_approx(Vector3(3, 12, 27)));
+	CHECK(Vector3(v.call("min")).is_equal_approx(Vector3(0, 0, 0)));
+	CHECK(Vector3(v.call("max")).is_equal_approx(Vector3(3, 12, 27)));
+
+	PackedFloat32Array dots = v.call("dot", points);
+	CHECK(dots == Vector<float>({ 3, 24, 81 }));
+
+	v.call("normalize");
+	r = v;
+	CHECK(r[1].is_equal_approx(Vector3(0, 1, 0)));
+
+	v.call("lerp_array", points, 0.5);
+	r = v;
+	CHECK(r[2].is_equal_approx(Vector3(0, 0, 2)));
+}
+
+TEST_CASE_PENDING("[PackedVector3Array] Bulk math benchmark") {
+	// Microbenchmark, run with `--test --no-skip`.
+	const int count = 100000;
+	PackedVector3Array points;
+	points.resize(count);
+	for (int i = 0; i < count; i++) {
+		points.set(i, Vector3(i, i * 2, i * 3));
+	}
+	Transform3D xform(Basis(Vector3(0, 1, 0), 0.5), Vector3(1, 2, 3));
+
+	// Element by element through Variant, as a script loop would.
+	Variant element_wise = points;
+	Variant xform_variant = xform;
+	uint64_t begin = OS::get_singleton()->get_ticks_usec();
+	for (int i = 0; i < count; i++) {
+		bool valid = false;
+		bool oob = false;
+		Variant point = element_wise.get_indexed(i, valid, oob);
+		Variant result;
+		Variant::evaluate(Variant::OP_MULTIPLY, xform_variant, point, result, valid);
+		element_wise.set_indexed(i, result, valid, oob);
+	}
+	uint64_t element_wise_usec = OS::get_singleton()->get_ticks_usec() - begin;
+
+	Variant bulk = points;
+	begin = OS::get_singleton()->get_ticks_usec();
+	bulk.call("transform", xform);
+	uint64_t bulk_usec = OS::get_singleton()->get_ticks_usec() - begin;
+
+	MESSAGE(vformat("Transforming %d points. Element by element: %d usec. Bulk: %d usec.", count, element_wise_usec, bulk_usec).utf8().get_data());
+	CHECK(element_wise == bulk);
+}
+
+} // namespace TestPackedArrayMath
+
+#endif // TEST_PACKED_ARRAY_MATH_H
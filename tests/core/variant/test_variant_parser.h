@@ -0,0 +1,158 @@
+/*************************************************************************/
+/*  test_variant_parser.h                                                */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2022 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2022 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef TEST_VARIANT_PARSER_H
+#define TEST_VARIANT_PARSER_H
+
+#include "core/io/file_access.h"
+#include "core/os/os.h"
+#include "core/variant/variant_parser.h"
+#include "tests/test_macros.h"
+
+namespace TestVariantParser {
+
+static Dictionary parse_assignments(VariantParser::Stream *p_stream) {
+	// Keyed by the enclosing tag and the property, since property names repeat across tags.
+	Dictionary result;
+	int lines = 0;
+	String error_text;
+	String section;
+
+	while (true) {
+		String assign;
+		Variant value;
+		VariantParser::Tag next_tag;
+		Error err = VariantParser::parse_tag_assign_eof(p_stream, lines, error_text, next_tag, assign, value, nullptr, true);
+		if (err == ERR_FILE_EOF) {
+			break;
+		}
+		REQUIRE_MESSAGE(err == OK, vformat("Parse error at line %d: %s", lines, error_text).utf8().get_data());
+		if (!assign.is_empty()) {
+			result[section + "/" + assign] = value;
+		} else {
+			section = next_tag.name;
+		}
+	}
+
+	return result;
+}
+
+static Dictionary parse_file(const String &p_path, bool p_readahead) {
+	VariantParser::StreamFile stream;
+	stream.f = FileAccess::open(p_path, FileAccess::READ);
+	stream.readahead_enabled = p_readahead;
+	REQUIRE(stream.f.is_valid());
+	return parse_assignments(&stream);
+}
+
+TEST_CASE("[VariantParser] Files and strings parse the same") {
+	String long_string;
+	for (int i = 0; i < 100; i++) {
+		long_string += String::chr(0x00e9) + "ab";
+	}
+	String many_floats;
+	for (int i = 0; i < 1000; i++) {
+		many_floats += (i > 0 ? ", " : "") + rtos(i * 0.25);
+	}
+
+	const String text = "[gd_resource type=\"Resource\" format=3]\n\n[resource]\n"
+						"name = \"H" + String::chr(0x00e9) + "llo \\\"w" + String::chr(0x00f6) + "rld\\\"\\n\\u00e9\"\n"
+						"floats = PackedFloat32Array(1, -2.5, 3e2, ; comment\n inf, inf_neg)\n"
+						"ints = PackedInt32Array( 1,2 , -3 )\n"
+						"empty = PackedFloat64Array()\n"
+						"vectors = PackedVector2Array(1, 2, 3.5, -4)\n"
+						"many = PackedFloat64Array(" + many_floats + ")\n"
+						"long_string = \"" + long_string + "\"\n"
+						"name_after = &\"after\"\n";
+
+	const String path = OS::get_singleton()->get_cache_path().plus_file("variant_parser_test.tres");
+	{
+		Ref<FileAccess> f = FileAccess::open(path, FileAccess::WRITE);
+		REQUIRE(f.is_valid());
+		f->store_string(text);
+	}
+
+	VariantParser::StreamString ss;
+	ss.s = text;
+	Dictionary from_string = parse_assignments(&ss);
+
+	CHECK(String(from_string["resource/name"]) == "H" + String::chr(0x00e9) + "llo \"w" + String::chr(0x00f6) + "rld\"\n" + String::chr(0x00e9));
+	CHECK(PackedFloat32Array(from_string["resource/floats"]) == Vector<float>({ 1, -2.5, 300, INFINITY, -INFINITY }));
+	CHECK(PackedInt32Array(from_string["resource/ints"]) == Vector<int32_t>({ 1, 2, -3 }));
+	CHECK(PackedFloat64Array(from_string["resource/empty"]).is_empty());
+	CHECK(PackedVector2Array(from_string["resource/vectors"]) == Vector<Vector2>({ Vector2(1, 2), Vector2(3.5, -4) }));
+	PackedFloat64Array many = from_string["resource/many"];
+	REQUIRE(many.size() == 1000);
+	CHECK(many[999] == 249.75);
+	CHECK(String(from_string["resource/long_string"]) == long_string);
+	CHECK(from_string["resource/name_after"] == Variant(StringName("after")));
+
+	CHECK_MESSAGE(parse_file(path, true) == from_string, "Parsing a file with readahead should give the same values as parsing a string.");
+	CHECK_MESSAGE(parse_file(path, false) == from_string, "Parsing a file without readahead should give the same values as parsing a string.");
+}
+
+TEST_CASE_PENDING("[VariantParser] Large scene benchmark") {
+	// Microbenchmark, run with `--test --no-skip`.
+	const int resource_count = 2000;
+	const String path = OS::get_singleton()->get_cache_path().plus_file("variant_parser_benchmark.tscn");
+	{
+		Ref<FileAccess> f = FileAccess::open(path, FileAccess::WRITE);
+		REQUIRE(f.is_valid());
+		f->store_line("[gd_scene load_steps=" + itos(resource_count + 1) + " format=3]\n");
+		for (int i = 0; i < resource_count; i++) {
+			String samples;
+			for (int j = 0; j < 64; j++) {
+				samples += (j > 0 ? ", " : "") + rtos((i * 64 + j) * 0.125);
+			}
+			f->store_line("[sub_resource type=\"Animation\" id=\"Animation_" + itos(i) + "\"]");
+			f->store_line("resource_name = \"animation_" + itos(i) + "\"");
+			f->store_line("length = " + rtos(i * 0.5));
+			f->store_line("tracks/0/path = NodePath(\"Node" + itos(i) + ":position\")");
+			f->store_line("tracks/0/keys = PackedFloat32Array(" + samples + ")");
+			f->store_line("tracks/0/offset = Vector3(" + itos(i) + ", 1.5, -2)\n");
+		}
+	}
+
+	// Reading one character at a time, as the parser did before streams were buffered.
+	uint64_t begin = OS::get_singleton()->get_ticks_usec();
+	Dictionary unbuffered = parse_file(path, false);
+	uint64_t unbuffered_usec = OS::get_singleton()->get_ticks_usec() - begin;
+
+	begin = OS::get_singleton()->get_ticks_usec();
+	Dictionary buffered = parse_file(path, true);
+	uint64_t buffered_usec = OS::get_singleton()->get_ticks_usec() - begin;
+
+	MESSAGE(vformat("Parsing %d sub-resources. Unbuffered: %d usec. Buffered: %d usec.", resource_count, unbuffered_usec, buffered_usec).utf8().get_data());
+	CHECK(unbuffered == buffered);
+}
+
+} // namespace TestVariantParser
+
+#endif // TEST_VARIANT_PARSER_H
@@ -0,0 +1,119 @@
+/*************************************************************************/
+/*  test_node.h                                                          */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2022 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2022 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef TEST_NODE_H
+#define TEST_NODE_H
+
+#include "core/os/mutex.h"
+#include "core/templates/local_vector.h"
+#include "scene/main/node.h"
+#include "scene/main/scene_tree.h"
+#include "scene/main/window.h"
+
+#include "tests/test_macros.h"
+
+// Declared in global namespace because of GDCLASS macro warning (Windows):
+// "Unqualified friend declaration referring to type outside of the nearest enclosing namespace
+// is a Microsoft extension; add a nested name specifier".
+class _TestProcessOrderNode : public Node {
+	GDCLASS(_TestProcessOrderNode, Node);
+
+public:
+	Mutex *log_mutex = nullptr;
+	LocalVector<StringName> *log = nullptr;
+
+protected:
+	void _notification(int p_what) {
+		if (p_what == NOTIFICATION_PROCESS) {
+			MutexLock lock(*log_mutex);
+			log->push_back(get_name());
+		}
+	}
+};
+
+namespace TestNode {
+
+TEST_CASE("[SceneTree][Node] Thread groups keep the process priority order") {
+	Mutex log_mutex;
+	LocalVector<StringName> log;
+
+	struct Setup {
+		const char *name;
+		int thread_group;
+		int priority;
+	};
+	const Setup setups[] = {
+		{ "A", 0, 0 },
+		{ "B", 1, 1 },
+		{ "C", 0, 2 },
+		{ "D", 2, -1 },
+		{ "E", 1, 1 },
+		{ "F", 2, 1 },
+	};
+
+	Window *root = SceneTree::get_singleton()->get_root();
+	LocalVector<Node *> nodes;
+	for (const Setup &setup : setups) {
+		_TestProcessOrderNode *node = memnew(_TestProcessOrderNode);
+		node->set_name(setup.name);
+		node->log_mutex = &log_mutex;
+		node->log = &log;
+		node->set_process_thread_group(setup.thread_group);
+		node->set_process_priority(setup.priority);
+		root->add_child(node);
+		node->set_process(true);
+		nodes.push_back(node);
+	}
+
+	SceneTree::get_singleton()->process(0.016);
+
+	REQUIRE(log.size() == 6);
+	int64_t a = log.find("A");
+	int64_t b = log.find("B");
+	int64_t c = log.find("C");
+	int64_t d = log.find("D");
+	int64_t e = log.find("E");
+	int64_t f = log.find("F");
+
+	CHECK_MESSAGE(d < a, "A thread group node with a lower priority should run before main thread nodes.");
+	CHECK_MESSAGE(a < b, "A thread group node with a higher priority should run after main thread nodes.");
+	CHECK_MESSAGE(a < f, "A thread group node with a higher priority should run after main thread nodes.");
+	CHECK_MESSAGE(b < e, "Nodes of the same thread group should keep their order.");
+	CHECK_MESSAGE(e < c, "Main thread nodes with a higher priority should run after thread groups.");
+	CHECK_MESSAGE(f < c, "Main thread nodes with a higher priority should run after thread groups.");
+
+	for (uint32_t i = 0; i < nodes.size(); i++) {
+		memdelete(nodes[i]);
+	}
+}
+
+} // namespace TestNode
+
+#endif // TEST_NODE_H
@@ -0,0 +1,121 @@
+/*************************************************************************/
+/*  test_physics_server_3d.h                                             */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2022 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2022 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef TEST_PHYSICS_SERVER_3D_H
+#define TEST_PHYSICS_SERVER_3D_H
+
+#include "servers/physics_server_3d.h"
+#include "tests/test_macros.h"
+
+namespace TestPhysicsServer3D {
+
+TEST_CASE("[SceneTree][PhysicsDirectSpaceState3D] Batched ray queries") {
+	PhysicsServer3D *physics_server = PhysicsServer3D::get_singleton();
+
+	RID space = physics_server->space_create();
+	physics_server->space_set_active(space, true);
+
+	RID shape = physics_server->box_shape_create();
+	physics_server->shape_set_data(shape, Vector3(1, 1, 1));
+
+	RID body = physics_server->body_create();
+	physics_server->body_set_mode(body, PhysicsServer3D::BODY_MODE_STATIC);
+	physics_server->body_set_space(body, space);
+	physics_server->body_add_shape(body, shape);
+
+	// Let the body reach the broadphase.
+	physics_server->step(0.016);
+
+	PhysicsDirectSpaceState3D *space_state = physics_server->space_get_direct_state(space);
+	REQUIRE(space_state != nullptr);
+
+	Ref<PhysicsRayQueryParameters3D> query;
+	query.instantiate();
+
+	PackedVector3Array from;
+	PackedVector3Array to;
+	from.push_back(Vector3(0, 5, 0));
+	to.push_back(Vector3(0, -5, 0));
+	from.push_back(Vector3(5, 5, 0));
+	to.push_back(Vector3(5, -5, 0));
+
+	SUBCASE("Packed results match the rays") {
+		Dictionary result = space_state->call("intersect_rays", query, from, to);
+		PackedVector3Array positions = result["position"];
+		PackedVector3Array normals = result["normal"];
+		PackedInt64Array collider_ids = result["collider_id"];
+		PackedInt32Array shapes = result["shape"];
+		REQUIRE(positions.size() == 2);
+		REQUIRE(normals.size() == 2);
+		REQUIRE(collider_ids.size() == 2);
+		REQUIRE(shapes.size() == 2);
+
+		CHECK(positions[0].is_equal_approx(Vector3(0, 1, 0)));
+		CHECK(normals[0].is_equal_approx(Vector3(0, 1, 0)));
+		CHECK(shapes[0] == 0);
+
+		CHECK_MESSAGE(shapes[1] == -1, "A ray missing everything should report no shape.");
+		CHECK(collider_ids[1] == 0);
+		CHECK(positions[1] == Vector3());
+	}
+
+	SUBCASE("Native batch matches single rays") {
+		PhysicsDirectSpaceState3D::RayParameters parameters = query->get_parameters();
+		PhysicsDirectSpaceState3D::RayResult results[2];
+		bool collided[2] = { false, true };
+		int hits = space_state->intersect_rays(parameters, from.ptr(), to.ptr(), 2, results, collided);
+		CHECK(hits == 1);
+		CHECK(collided[0]);
+		CHECK_FALSE(collided[1]);
+
+		PhysicsDirectSpaceState3D::RayResult single;
+		parameters.from = from[0];
+		parameters.to = to[0];
+		REQUIRE(space_state->intersect_ray(parameters, single));
+		CHECK(results[0].position.is_equal_approx(single.position));
+		CHECK(results[0].rid == single.rid);
+	}
+
+	SUBCASE("Mismatched arrays are rejected") {
+		to.push_back(Vector3());
+		ERR_PRINT_OFF;
+		Dictionary result = space_state->call("intersect_rays", query, from, to);
+		ERR_PRINT_ON;
+		CHECK(result.is_empty());
+	}
+
+	physics_server->free(body);
+	physics_server->free(shape);
+	physics_server->free(space);
+}
+
+} // namespace TestPhysicsServer3D
+
+#endif // TEST_PHYSICS_SERVER_3D_H